@@ -0,0 +1,63 @@
+/*
+ * GameServerApp.cpp
+ * This file defines the main function of the game server.
+ * The server listens on the given endpoint and plays hex board games with many clients at once in a text protocol
+ * similar to GTP, the moves of all sessions are searched by one pool of worker threads.
+ * Please refer to the USAGE to know how to execute this application.
+ */
+
+#include <string>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+
+#include "Global.h"
+#include "GameServer.h"
+
+#include <boost/thread/thread.hpp>
+
+using namespace std;
+
+const char *USAGE =
+    "\n\nServe hex board games to many clients in a text protocol similar to GTP\n\n"
+        "Usage:\n\n"
+        "./GameServerApp <endpoint> [numofthreads] [numberoftrials] [timelimit]\n\n"
+        "endpoint                      : unix:<path> for Unix domain socket or <ip>:<port> for TCP, e.g. unix:/tmp/hexserver.sock or 0.0.0.0:7000\n"
+        "numofthreads(hardware threads by default): the number of worker threads searching the moves of all sessions\n"
+        "numberoftrials(2048 by default): the number of simulated games per move\n"
+        "timelimit(0 by default)       : the time limit per move in milliseconds, 0 for no limit\n";
+
+//the server stopped by SIGINT or SIGTERM
+GameServer* ptrtoserver = nullptr;
+
+void stopServer(int) {
+  if (ptrtoserver != nullptr)
+    ptrtoserver->stop();
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2 || argc > 5) {
+    cout << USAGE << endl;
+    return 1;
+  }
+  size_t numofthreads =
+      (argc > 2) ?
+          strtoul(argv[2], NULL, 10) : boost::thread::hardware_concurrency();
+  size_t numberoftrials = (argc > 3) ? strtoul(argv[3], NULL, 10) : 2048;
+  size_t timelimit = (argc > 4) ? strtoul(argv[4], NULL, 10) : 0;
+  WorkStealingScheduler scheduler(numofthreads);
+  GameServer server(scheduler, argv[1], numberoftrials, timelimit);
+  if (!server.isListening()) {
+    cerr << "fail to listen on " << argv[1] << endl;
+    return 1;
+  }
+  ptrtoserver = &server;
+  signal(SIGINT, stopServer);
+  signal(SIGTERM, stopServer);
+  signal(SIGPIPE, SIG_IGN);
+  cout << "listening on " << argv[1] << endl;
+  size_t numofcommands = server.serve();
+  ptrtoserver = nullptr;
+  cout << "answered " << numofcommands << " commands" << endl;
+  return 0;
+}
@@ -19,6 +19,7 @@
 #include "Player.h"
 #include "HexBoard.h"
 #include "Strategy.h"
+#include "OpeningBook.h"
 #include "MonteCarloTreeSearch.h"
 #include "MultiMonteCarloTreeSearch.h"
 
@@ -34,7 +35,16 @@ int numofhexgon = 11;
 int main(int argc, char **argv) {
 
   bool isstop = false;
-  if (argc == 2) {
+  OpeningBook book;
+  if (argc == 3 && string(argv[1]) == "--book") {
+    //the board takes the size of book, e.g. a 13 x 13 book built by OpeningBookBuilder
+    if (book.open(argv[2]))
+      numofhexgon = book.getNumofhexgons();
+    else {
+      cout << "Unable to use opening book " << argv[2] << endl;
+      book.close();
+    }
+  } else if (argc == 2) {
     numofhexgon = atoi(argv[1]);
 
     cout << "Doing Simulation for two virtual players" << endl;
@@ -97,6 +107,8 @@ int main(int argc, char **argv) {
       else {
         ::selectStrategy(static_cast<AIStrategyKind>(aistrategykind),
                          watsonstrategy, *babywatson, board);
+        if (book.isOpen())
+          watsonstrategy->setOpeningBook(&book);
         break;
       }
     }
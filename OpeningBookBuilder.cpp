@@ -0,0 +1,236 @@
+/*
+ * OpeningBookBuilder.cpp
+ * This file defines the main function for building an opening book offline.
+ * All positions up to the given number of stones are enumerated for both players to move, positions identical under
+ * 180 degree rotation are searched only once and the searches are distributed over all threads of the machine.
+ * Each search is a single thread Monte Carlo Tree Search with the given number of simulated games.
+ * Please refer to the USAGE to know how to execute this application.
+ */
+
+#include <set>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "Global.h"
+#include "Player.h"
+#include "HexBoard.h"
+#include "OpeningBook.h"
+#include "PositionHash.h"
+#include "MonteCarloTreeSearch.h"
+
+using namespace std;
+
+const char *USAGE =
+    "\n\nBuild an opening book for hex board game via parallel Monte Carlo Tree Search\n\n"
+        "Usage:\n\n"
+        "./OpeningBookBuilder <numofhexgon> <output_book_file> [maxstones] [numberoftrials] [numberofthreads]\n\n"
+        "numofhexgon                   : the number of hexgons per side, e.g. 11 or 13\n"
+        "output_book_file              : the path of binary book file to be written\n"
+        "maxstones(1 by default)       : the maximal number of stones on board of book positions\n"
+        "numberoftrials(65536 by default): the number of simulated games per book position\n"
+        "numberofthreads(hardware concurrency by default): the number of positions searched concurrently\n";
+
+/**
+ * BookPosition is one position to be searched by the builder
+ */
+struct BookPosition {
+  std::vector<int> redmoves;  ///< the indices of hexgons occupied by red player
+  std::vector<int> bluemoves;  ///< the indices of hexgons occupied by blue player
+  hexgonValKind tomove;  ///< the color of player to move
+};
+
+//Enumerate all positions up to maxstones stones and remove the rotated duplicates
+void enumeratePositions(int numofhexgon, int maxstones,
+                        vector<BookPosition>& positions);
+//Search the positions taken from the shared work index
+void searchPositions(int numofhexgon, size_t numberoftrials,
+                     const vector<BookPosition>& positions,
+                     hexgame::atomic<size_t>& nextposition,
+                     vector<OpeningBook::BookEntry>& results);
+
+int main(int argc, char **argv) {
+  if (argc < 3 || argc > 6) {
+    cout << USAGE << endl;
+    return 1;
+  }
+  int numofhexgon = atoi(argv[1]);
+  string filename(argv[2]);
+  int maxstones = (argc > 3) ? atoi(argv[3]) : 1;
+  size_t numberoftrials = (argc > 4) ? strtoul(argv[4], NULL, 10) : 65536;
+  size_t numberofthreads =
+      (argc > 5) ?
+          strtoul(argv[5], NULL, 10) : boost::thread::hardware_concurrency();
+  if (numofhexgon < 2 || maxstones < 0 || numberoftrials == 0) {
+    cout << USAGE << endl;
+    return 1;
+  }
+  if (numberofthreads == 0)
+    numberofthreads = 1;
+
+  vector<BookPosition> positions;
+  enumeratePositions(numofhexgon, maxstones, positions);
+  cout << "searching " << positions.size() << " positions on " << numofhexgon
+       << "x" << numofhexgon << " board with " << numberofthreads
+       << " threads" << endl;
+
+  //every searched position produces itself and its rotation
+  vector<OpeningBook::BookEntry> results(2 * positions.size());
+  hexgame::atomic<size_t> nextposition(0);
+  boost::thread_group threads;
+  for (size_t i = 0; i < numberofthreads; ++i)
+    threads.create_thread(
+        boost::bind(&searchPositions, numofhexgon, numberoftrials,
+                    boost::cref(positions), boost::ref(nextposition),
+                    boost::ref(results)));
+  threads.join_all();
+
+  if (!OpeningBook::write(filename, numofhexgon, maxstones, results)) {
+    cerr << "fail to write opening book " << filename << endl;
+    return 1;
+  }
+  OpeningBook book(filename);
+  cout << "wrote " << book.getSizeofEntries() << " entries to " << filename
+       << endl;
+  return 0;
+}
+///Get the canonical key of a position which is the same for the position and its 180 degree rotation
+///@param numofhexgon is the number of hexgons per side
+///@param position is the position
+///@return the smaller key of the position and the rotated position
+boost::uint64_t canonicalKey(int numofhexgon, const BookPosition& position) {
+  vector<int> rotatedred, rotatedblue;
+  for (size_t i = 0; i < position.redmoves.size(); ++i)
+    rotatedred.push_back(
+        PositionHash::rotateHexgon(numofhexgon, position.redmoves[i]));
+  for (size_t i = 0; i < position.bluemoves.size(); ++i)
+    rotatedblue.push_back(
+        PositionHash::rotateHexgon(numofhexgon, position.bluemoves[i]));
+  boost::uint64_t key = PositionHash::hashPosition(numofhexgon,
+                                                   position.redmoves,
+                                                   position.bluemoves,
+                                                   position.tomove);
+  boost::uint64_t rotatedkey = PositionHash::hashPosition(numofhexgon,
+                                                          rotatedred,
+                                                          rotatedblue,
+                                                          position.tomove);
+  return key < rotatedkey ? key : rotatedkey;
+}
+///Recursively place the stones of one color on the empty hexgons in increasing order of index
+///@param numofhexgon is the number of hexgons per side
+///@param numofstones is the number of stones left to place
+///@param start is the smallest index of hexgon for the next stone
+///@param occupied is the indicators of occupied hexgons
+///@param placed is the stones placed so far
+///@param combinations stores all the completed placements
+///@return NONE
+void placeStones(int numofhexgon, int numofstones, int start,
+                 vector<bool>& occupied, vector<int>& placed,
+                 vector<vector<int> >& combinations) {
+  if (numofstones == 0) {
+    combinations.push_back(placed);
+    return;
+  }
+  for (int i = start; i <= numofhexgon * numofhexgon; ++i) {
+    if (occupied[i])
+      continue;
+    occupied[i] = true;
+    placed.push_back(i);
+    placeStones(numofhexgon, numofstones - 1, i + 1, occupied, placed,
+                combinations);
+    placed.pop_back();
+    occupied[i] = false;
+  }
+}
+///Enumerate all positions up to maxstones stones and remove the rotated duplicates.
+///The player to move has either the same number of stones as the opponent (moved first) or one less (moved second), hence
+///the book serves either player moving first.
+///@param numofhexgon is the number of hexgons per side
+///@param maxstones is the maximal number of stones on board
+///@param positions stores the enumerated positions
+///@return NONE
+void enumeratePositions(int numofhexgon, int maxstones,
+                        vector<BookPosition>& positions) {
+  set<boost::uint64_t> visited;
+  hexgonValKind colors[] = { hexgonValKind_RED, hexgonValKind_BLUE };
+  for (int numofstones = 0; numofstones <= maxstones; ++numofstones) {
+    for (int c = 0; c < 2; ++c) {
+      hexgonValKind tomove = colors[c];
+      int numofown = numofstones / 2, numofopp = numofstones - numofown;
+      vector<bool> occupied(numofhexgon * numofhexgon + 1, false);
+      vector<int> placed;
+      vector<vector<int> > owns;
+      placeStones(numofhexgon, numofown, 1, occupied, placed, owns);
+      for (size_t i = 0; i < owns.size(); ++i) {
+        for (size_t j = 0; j < owns[i].size(); ++j)
+          occupied[owns[i][j]] = true;
+        vector<vector<int> > opps;
+        placeStones(numofhexgon, numofopp, 1, occupied, placed, opps);
+        for (size_t j = 0; j < owns[i].size(); ++j)
+          occupied[owns[i][j]] = false;
+
+        for (size_t j = 0; j < opps.size(); ++j) {
+          BookPosition position;
+          position.tomove = tomove;
+          position.redmoves = (tomove == hexgonValKind_RED) ? owns[i] : opps[j];
+          position.bluemoves = (tomove == hexgonValKind_RED) ? opps[j] : owns[i];
+          if (visited.insert(canonicalKey(numofhexgon, position)).second)
+            positions.push_back(position);
+        }
+      }
+    }
+  }
+}
+///Search the positions taken from the shared work index until no positions are left. Each position writes its entry and
+///the entry of rotated position into the slots of results owned by the position, hence no locking is required
+///@param numofhexgon is the number of hexgons per side
+///@param numberoftrials is the number of simulated games per position
+///@param positions is the positions to be searched
+///@param nextposition is the shared work index
+///@param results stores the book entries
+///@return NONE
+void searchPositions(int numofhexgon, size_t numberoftrials,
+                     const vector<BookPosition>& positions,
+                     hexgame::atomic<size_t>& nextposition,
+                     vector<OpeningBook::BookEntry>& results) {
+  size_t index;
+  while ((index = nextposition.fetch_add(1)) < positions.size()) {
+    const BookPosition& position = positions[index];
+    HexBoard board(numofhexgon);
+    Player player(board, position.tomove);
+    for (size_t i = 0; i < position.redmoves.size(); ++i)
+      board.setNodeValue(position.redmoves[i], hexgonValKind_RED);
+    for (size_t i = 0; i < position.bluemoves.size(); ++i)
+      board.setNodeValue(position.bluemoves[i], hexgonValKind_BLUE);
+
+    MonteCarloTreeSearch mcts(&board, &player, numberoftrials);
+    int move = mcts.genMove();
+    double winrate = mcts.getLastWinningRate();
+    winrate = (winrate < 0.0) ? 0.0 : ((winrate > 1.0) ? 1.0 : winrate);
+
+    OpeningBook::BookEntry entry;
+    entry.key = PositionHash::hashBoard(board, position.tomove);
+    entry.visitcount = static_cast<boost::uint32_t>(numberoftrials);
+    entry.move = static_cast<boost::uint16_t>(move);
+    entry.winrate = static_cast<boost::uint16_t>(winrate * 65535.0 + 0.5);
+    results[2 * index] = entry;
+
+    vector<int> rotatedred, rotatedblue;
+    for (size_t i = 0; i < position.redmoves.size(); ++i)
+      rotatedred.push_back(
+          PositionHash::rotateHexgon(numofhexgon, position.redmoves[i]));
+    for (size_t i = 0; i < position.bluemoves.size(); ++i)
+      rotatedblue.push_back(
+          PositionHash::rotateHexgon(numofhexgon, position.bluemoves[i]));
+    entry.key = PositionHash::hashPosition(numofhexgon, rotatedred,
+                                           rotatedblue, position.tomove);
+    entry.move = static_cast<boost::uint16_t>(PositionHash::rotateHexgon(
+        numofhexgon, move));
+    results[2 * index + 1] = entry;
+  }
+}
@@ -0,0 +1,52 @@
+/*
+ * SearchWorkerApp.cpp
+ * This file defines the main function of an engine process of search cluster.
+ * The worker listens on the given endpoint and searches the game states sent by the coordinator
+ * (ClusterMonteCarloTreeSearch), answering the visit and win counts of the moves at root.
+ * Please refer to the USAGE to know how to execute this application.
+ */
+
+#include <string>
+#include <cstdlib>
+#include <iostream>
+
+#include "Global.h"
+#include "SearchWorker.h"
+
+using namespace std;
+
+const char *USAGE =
+    "\n\nServe the searches of hex board game for the coordinator of a search cluster\n\n"
+        "Usage:\n\n"
+        "./SearchWorkerApp <endpoint> [numofconnections] [tablename] [numofentries]\n\n"
+        "endpoint                      : unix:<path> for Unix domain socket or <ip>:<port> for TCP, e.g. unix:/tmp/hexworker0.sock or 0.0.0.0:7000\n"
+        "numofconnections(0 by default): the number of coordinator connections to serve, 0 to serve until terminated\n"
+        "tablename                     : the name of shared memory transposition table shared by the workers of host\n"
+        "numofentries(1048576 by default): the number of entries of transposition table when it is created\n";
+
+int main(int argc, char **argv) {
+  if (argc < 2 || argc > 5) {
+    cout << USAGE << endl;
+    return 1;
+  }
+  size_t numofconnections = (argc > 2) ? strtoul(argv[2], NULL, 10) : 0;
+  SearchWorker worker(argv[1]);
+  if (!worker.isListening()) {
+    cerr << "fail to listen on " << argv[1] << endl;
+    return 1;
+  }
+  hexgame::shared_ptr<SharedTranspositionTable> table;
+  if (argc > 3) {
+    size_t numofentries = (argc > 4) ? strtoul(argv[4], NULL, 10) : (1 << 20);
+    table.reset(new SharedTranspositionTable(argv[3], numofentries));
+    if (!table->isAttached()) {
+      cerr << "fail to attach transposition table " << argv[3] << endl;
+      return 1;
+    }
+    worker.setTranspositionTable(table.get());
+  }
+  cout << "listening on " << argv[1] << endl;
+  size_t numofanswers = worker.serve(numofconnections);
+  cout << "answered " << numofanswers << " searches" << endl;
+  return 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * TournamentApp.cpp
+ * This file defines the main function of the tournament between two AI strategies.
+ * The games are played on all cores at once with alternating colors, the winning rate of the first strategy with its
+ * confidence interval, the throughput and the latencies of moves are reported per board size.
+ * Please refer to the USAGE to know how to execute this application.
+ */
+
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <sstream>
+#include <iostream>
+
+#include "Global.h"
+#include "TournamentRunner.h"
+
+#include <boost/thread/thread.hpp>
+
+using namespace std;
+
+const char *USAGE =
+    "\n\nPlay a tournament between two AI strategies and report the results\n\n"
+        "Usage:\n\n"
+        "./TournamentApp <first> <second> <numofgames> [numofhexgons] [timelimit] [numofthreads]\n\n"
+        "first, second                 : the strategies as kind[:numberoftrials[:numofthreads]], kind is naive, mcts or pmcts, e.g. mcts:4096 or pmcts:2048:2\n"
+        "numofgames                    : the number of games per board size, the strategies alternate colors\n"
+        "numofhexgons(11 by default)   : the board sizes separated by commas, e.g. 5,7,9\n"
+        "timelimit(0 by default)       : the time limit per move in milliseconds, 0 for no limit\n"
+        "numofthreads(hardware threads by default): the number of games played at once\n";
+
+int main(int argc, char **argv) {
+  TournamentRunner::Entrant first, second;
+  if (argc < 4 || argc > 7 || !TournamentRunner::parseEntrant(argv[1], first)
+      || !TournamentRunner::parseEntrant(argv[2], second)) {
+    cout << USAGE << endl;
+    return 1;
+  }
+  size_t numofgames = strtoul(argv[3], NULL, 10);
+  vector<int> numofhexgons;
+  stringstream strin((argc > 4) ? argv[4] : "11");
+  string field;
+  while (getline(strin, field, ',')) {
+    int numofhexgon = atoi(field.c_str());
+    if (numofhexgon < 2) {
+      cout << USAGE << endl;
+      return 1;
+    }
+    numofhexgons.push_back(numofhexgon);
+  }
+  size_t timelimit = (argc > 5) ? strtoul(argv[5], NULL, 10) : 0;
+  size_t numofthreads =
+      (argc > 6) ?
+          strtoul(argv[6], NULL, 10) : boost::thread::hardware_concurrency();
+
+  WorkStealingScheduler scheduler(numofthreads);
+  TournamentRunner runner(scheduler, first, second, timelimit);
+  for (size_t i = 0; i < numofhexgons.size(); ++i)
+    cout << runner.showReport(runner.run(numofhexgons[i], numofgames)) << endl;
+  return 0;
+}
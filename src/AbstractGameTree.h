@@ -9,10 +9,15 @@
 #define ABSTRACTGAMETREE_H_
 
 #include "Global.h"
+#include "DescentState.h"
+#include "ProgressiveWidening.h"
 
+#include <iosfwd>
 #include <string>
+#include <sstream>
 #include <utility>
 #include <vector>
+#include <boost/cstdint.hpp>
 #include <boost/graph/graph_as_tree.hpp>
 #include <boost/graph/adjacency_list.hpp>
 
@@ -25,8 +30,12 @@ enum vertex_value_t {  ///<for storing the calculation result of UTC calculation
 enum vertex_position_t {  ///<for storing the hex game board position
   vertex_position
 };
+enum vertex_untried_t {  ///<for storing the moves not expanded yet from the node
+  vertex_untried
+};
 BOOST_INSTALL_PROPERTY(vertex, value);  ///<install vertex_value_t as internal property
 BOOST_INSTALL_PROPERTY(vertex, position);///<install vertex_position_t as internal property
+BOOST_INSTALL_PROPERTY(vertex, untried);///<install vertex_untried_t as internal property
 }
 /**
  * AbstractUTCPolicy class is used to provide an abstract interface which stores information for UTC Policy calculation
@@ -46,7 +55,9 @@ class AbstractUTCPolicy {
   ///enum type serves as index for stored features in UTC Policy
   enum valuekind {
     visitcount = 0,  ///< enum type serves as index for stored value of visiting count extraction in feature holder
-    wincount  ///< enum type servers as index for stored value of winning statistics extraction in feature holder
+    wincount,  ///< enum type servers as index for stored value of winning statistics extraction in feature holder
+    amafvisitcount,  ///< enum type serves as index for stored value of all-moves-as-first (AMAF) visiting count in feature holder
+    amafwincount  ///< enum type serves as index for stored value of all-moves-as-first (AMAF) winning statistics in feature holder
   };
   ///Print out the features
   virtual std::string print() = 0;
@@ -70,9 +81,13 @@ class AbstractUTCPolicy {
 #if __cplusplus > 199711L
 #define AbstractUTCPolicy_visitcount AbstractUTCPolicy::valuekind::visitcount
 #define AbstractUTCPolicy_wincount AbstractUTCPolicy::valuekind::wincount
+#define AbstractUTCPolicy_amafvisitcount AbstractUTCPolicy::valuekind::amafvisitcount
+#define AbstractUTCPolicy_amafwincount AbstractUTCPolicy::valuekind::amafwincount
 #else
 #define AbstractUTCPolicy_visitcount AbstractUTCPolicy::visitcount
 #define AbstractUTCPolicy_wincount AbstractUTCPolicy::wincount
+#define AbstractUTCPolicy_amafvisitcount AbstractUTCPolicy::amafvisitcount
+#define AbstractUTCPolicy_amafwincount AbstractUTCPolicy::amafwincount
 #endif
 /**
  * AbstractGameTree class is used to provide abstract interface for GameTree and LockableGameTree class
@@ -96,10 +111,27 @@ class AbstractGameTree {
   virtual std::vector<std::size_t> getSiblings(std::size_t indexofnode) = 0;
   ///Getter to get the number of children of a given node
   virtual std::size_t getNumofChildren(std::size_t indexofnode) = 0;
+  ///Setter to set the maximal number of nodes kept in the tree (0 for unlimited). The least visited subtrees are pruned when reaching the budget
+  virtual void setMaxNumofNodes(std::size_t numofnodes) = 0;
+  ///Getter to get the maximal number of nodes kept in the tree (0 for unlimited)
+  virtual std::size_t getMaxNumofNodes() = 0;
+  ///Setter to set the schedule of progressive widening which bounds the number of children by visit count
+  virtual void setProgressiveWidening(const ProgressiveWidening& schedule) = 0;
+  ///Getter to get the schedule of progressive widening
+  virtual ProgressiveWidening getProgressiveWidening() = 0;
+  ///Setter to set the equivalence parameter of RAVE which blends AMAF statistics into selection (0 to disable)
+  virtual void setRaveEquivalence(double equivalence) = 0;
+  ///Getter to get the equivalence parameter of RAVE
+  virtual double getRaveEquivalence() = 0;
 
   //print out the tree
   ///Depth First Search (DFS) traversal to print tree with parenthesized representation
   virtual std::string printGameTree(int key) = 0;
+  //snapshot of the tree
+  ///Write the game tree as a compact binary snapshot (structure, positions and UTC features)
+  virtual bool saveGameTree(std::ostream& out) = 0;
+  ///Replace the game tree with the one read from a binary snapshot written by saveGameTree
+  virtual bool loadGameTree(std::istream& in) = 0;
   //for tree utility
   ///To clear up all nodes and edges
   virtual void clearAll() = 0;
@@ -111,11 +143,19 @@ class AbstractGameTree {
   ///To update UTC value according to the simulation (play-out) result
   virtual void updateNodefromSimulation(int indexofnode, int winner,
                                         int level) = 0;
+  ///To update the AMAF statistics of the children along the path from given node to root by the moves of a simulated game
+  virtual void updateAmaffromSimulation(int indexofnode, int winner,
+                                        DescentState& state) = 0;
   ///To get the best move by maximizing simulated winning statistics
   virtual std::pair<int, double> getBestMovefromSimulation() = 0;
   ///To select the node with maximal UTC balance value
   virtual std::pair<int, std::size_t> selectMaxBalanceNode(int currentempty,
                                                    bool isbreaktie) = 0;
+  ///To select the node with maximal UTC balance value and apply the moves of the selected path to the given state
+  virtual std::pair<int, std::size_t> selectMaxBalanceNode(
+      int currentempty, bool isbreaktie, DescentState& state) = 0;
+  ///To expand one child from a given node with a move taken from its untried moves and apply the move to the given state
+  virtual int expandNode(int indexofsource, DescentState& state) = 0;
   ///To get past moves (with the position information on the hex board)
   virtual void getMovesfromTreeState(
       int indexofnode, std::vector<int>& babywatsons,
@@ -137,20 +177,39 @@ class AbstractGameTree {
   virtual ~AbstractGameTree() {
   }
   ;
+  ///Generate the printable name of node, e.g. "3@12:R", which is only called when the tree is printed
+  ///@param index is the index of node
+  ///@param position is the position on hex board of node
+  ///@param color is the color of node
+  ///@return the name of node in the format of index@position:color
+  static std::string getNodeLabel(std::size_t index, std::size_t position,
+                                  boost::default_color_type color) {
+    std::stringstream namebuffer;
+    namebuffer << index << "@" << position << ":";
+    if (color == boost::black_color)
+      namebuffer << 'B';
+    else if (color == boost::red_color)
+      namebuffer << 'R';
+    else
+      namebuffer << 'W';
+    return namebuffer.str();
+  }
 
  protected:
   //setting up internal composite property for boost graph
   ///Value is use to store UTC values and features
   typedef boost::property<boost::vertex_value_t,
       hexgame::shared_ptr<AbstractUTCPolicy> > vertex_value_prop;
+  ///Untried moves are the moves not expanded yet from the node which are generated when the node is expanded at the first time
+  typedef boost::property<boost::vertex_untried_t,
+      std::vector<boost::uint16_t>, vertex_value_prop> vertex_untried_prop;
   ///Color is used to indicate the move made by which player (RED or BLUE)
   typedef boost::property<boost::vertex_color_t, boost::default_color_type,
-      vertex_value_prop> vertex_color_prop;
-  ///Name for node is used to print out information for debugging
-  typedef boost::property<boost::vertex_name_t, std::string, vertex_color_prop> vertex_name_prop;
-  ///Final composite property map which is the internal property map for boost graph
+      vertex_untried_prop> vertex_color_prop;
+  ///Final composite property map which is the internal property map for boost graph. The printable name of node is not
+  ///stored but generated by getNodeLabel only when the tree is printed
   typedef boost::property<boost::vertex_position_t, std::size_t,
-      vertex_name_prop> vertex_final_prop;
+      vertex_color_prop> vertex_final_prop;
 
   //for graph and tree
   ///Define boost adjacency_list as underlying implementation of game tree, basegraph
@@ -15,6 +15,9 @@
 #include "Global.h"
 #include "HexBoard.h"
 
+class OpeningBook;
+class SearchMonitor;
+
 #if __cplusplus > 199711L
 /**
  * Enum class AIStrategyKind is used to define the possible choices of AI MC strategies where <br/>
@@ -71,6 +74,10 @@ class AbstractStrategy {
   virtual int genMove() = 0;
   ///To return polymorphic class name
   virtual std::string name() = 0;
+  ///Attach an opening book which will be consulted before simulation
+  virtual void setOpeningBook(const OpeningBook* book) = 0;
+  ///Attach a monitor which publishes the progress of simulation and stops it on request
+  virtual void setSearchMonitor(SearchMonitor* monitor) = 0;
   ///destructor
   virtual ~AbstractStrategy() {
   }
@@ -9,18 +9,25 @@
 
 #include "Game.h"
 #include "Strategy.h"
+#include "OpeningBook.h"
 #include "MonteCarloTreeSearch.h"
 #include "AbstractStrategyImpl.h"
 #include "MultiMonteCarloTreeSearch.h"
 
 using namespace std;
 
-///genMove called by Game object in order to generate move via self-play simulation
+///genMove called by Game object in order to generate move via self-play simulation. The opening book is consulted firstly if attached
 ///@param NONE
-///@return: the next move evaluated by self-play simulation
+///@return: the next move evaluated by self-play simulation or the book move
 int AbstractStrategyImpl::genMove() {
-  if(ptrtoboard->getNumofemptyhexgons() > 0)
+  if (ptrtoboard->getNumofemptyhexgons() > 0) {
+    if (ptrtobook != nullptr) {
+      int bookmove = ptrtobook->probe(*ptrtoboard, ptrtoplayer->getPlayerlabel());
+      if (bookmove > 0)
+        return bookmove;
+    }
     return(simulation(ptrtoboard->getNumofemptyhexgons()));
+  }
   else
     return -1; //there's no empty moves
 }
@@ -30,6 +30,8 @@ class AbstractStrategyImpl : public AbstractStrategy {
   const HexBoard* const ptrtoboard;///<the actual playing board in the game. Need to ensure it not to be modified during the simulation
   const Player* const ptrtoplayer;  //<the actual player computer plays. Need to ensure it not to be modified during the simulation
   int numofhexgons; ///<number of hexgons per side. the total board should have numofhexgons*numofhexgons hexgons
+  const OpeningBook* ptrtobook; ///<the opening book consulted before simulation, nullptr if no book is used. Not owned by strategy
+  SearchMonitor* ptrtomonitor; ///<the monitor of simulation, nullptr if the simulation is not monitored. Not owned by strategy
 
  protected:
   ///To initialize required containers which store necessary information about game progress
@@ -45,11 +47,13 @@ class AbstractStrategyImpl : public AbstractStrategy {
   ///See AbstractStrategy, genNextRandom
   virtual int genNextRandom(hexgame::shared_ptr<bool>& emptyindicators, int& proportionofempty);
   ///Parameterless default constructor, initialize an empty board. This should be invoked by client to instantiate any AbstractStrategyImpl instances
-  AbstractStrategyImpl():ptrtoboard(nullptr), ptrtoplayer(nullptr),numofhexgons(0){};
+  AbstractStrategyImpl():ptrtoboard(nullptr), ptrtoplayer(nullptr),numofhexgons(0),ptrtobook(nullptr),ptrtomonitor(nullptr){};
   ///User-provided constructor which can construct AI strategy based on given HexBoard and Player objects pointers
   AbstractStrategyImpl(const HexBoard* board, const Player* aiplayer)
       : ptrtoboard(board),
-        ptrtoplayer(aiplayer) {
+        ptrtoplayer(aiplayer),
+        ptrtobook(nullptr),
+        ptrtomonitor(nullptr) {
     numofhexgons = ptrtoboard->getNumofhexgons();
   }
   ;
@@ -68,6 +72,18 @@ class AbstractStrategyImpl : public AbstractStrategy {
   virtual int genMove();
   ///See AbstractStrategy, name
   virtual std::string name() = 0;
+  ///See AbstractStrategy, setOpeningBook
+  ///@param book is the opening book which should outlive the strategy or nullptr to turn off book
+  ///@return NONE
+  void setOpeningBook(const OpeningBook* book) {
+    ptrtobook = book;
+  }
+  ///See AbstractStrategy, setSearchMonitor. The strategies without tree search ignore the requests of monitor
+  ///@param monitor is the monitor which should outlive the simulation or nullptr to turn off monitoring
+  ///@return NONE
+  void setSearchMonitor(SearchMonitor* monitor) {
+    ptrtomonitor = monitor;
+  }
 
   ///Getter to retrieve information about number of hexgons per side
   ///@param  NONE
@@ -87,5 +103,17 @@ class AbstractStrategyImpl : public AbstractStrategy {
   const Player* getPtrtoplayer() const {
     return ptrtoplayer;
   }
+  ///Getter to retrieve the opening book
+  ///@param NONE
+  ///@return pointer to the opening book or nullptr if no book is used
+  const OpeningBook* getOpeningBook() const {
+    return ptrtobook;
+  }
+  ///Getter to retrieve the monitor of simulation
+  ///@param NONE
+  ///@return pointer to the monitor or nullptr if the simulation is not monitored
+  SearchMonitor* getSearchMonitor() const {
+    return ptrtomonitor;
+  }
 };
 #endif /* ABSTRACTSTRATEGYIMPL_H_ */
@@ -0,0 +1,132 @@
+/*
+ * ArgMaxChooser.h
+ * This file defines the chooser of the child with maximal score used in selection phase of game trees.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef ARGMAXCHOOSER_H_
+#define ARGMAXCHOOSER_H_
+
+#include <vector>
+#include <cstddef>
+#include <boost/cstdint.hpp>
+
+#include "FastRandom.h"
+
+/**
+ * ArgMaxChooser class is used to choose the candidate with the maximal score.<br/>
+ * The candidates and scores are kept as two contiguous arrays (structure of arrays) which are reused across calls, so
+ * choosing among the children of a node is a scan over contiguous memory without allocation once the capacity is
+ * reached. The maximum is found by a branch-free pass which the compiler is able to vectorize, and the ties are broken
+ * uniformly at random by reservoir sampling in a second pass with a FastRandom generator owned by the chooser.<br/>
+ * ArgMaxChooser(): parameterless default constructor which seeds the generator by time<br/>
+ * ArgMaxChooser(boost::uint64_t seed): user defined constructor which seeds the generator by the given seed<br/>
+ * Sample Usage:<br/>
+ * ArgMaxChooser chooser;<br/>
+ * chooser.clear();<br/>
+ * chooser.insert(node, score);<br/>
+ * std::size_t chosen = chooser.chooseMax(true);<br/>
+ */
+class ArgMaxChooser {
+ private:
+  std::vector<std::size_t> candidates;  ///< the candidates, e.g. the indices of children
+  std::vector<double> scores;  ///< the scores of candidates
+  FastRandom generator;  ///< the generator to break ties
+
+ public:
+  ///Parameterless default constructor which seeds the generator by time
+  ArgMaxChooser() {
+  }
+  ;
+  ///User defined constructor which seeds the generator by the given seed
+  ///@param seed is the seed of generator
+  explicit ArgMaxChooser(boost::uint64_t seed)
+      : generator(seed) {
+  }
+  ;
+  ///Seed the generator
+  ///@param seed is the seed of generator
+  ///@return NONE
+  void setSeed(boost::uint64_t seed) {
+    generator.setSeed(seed);
+  }
+  ///Remove all candidates while keeping the capacity
+  ///@param NONE
+  ///@return NONE
+  void clear() {
+    candidates.clear();
+    scores.clear();
+  }
+  ///Reserve the capacity for the given number of candidates
+  ///@param numofcandidates is the number of candidates
+  ///@return NONE
+  void reserve(std::size_t numofcandidates) {
+    candidates.reserve(numofcandidates);
+    scores.reserve(numofcandidates);
+  }
+  ///Add a candidate
+  ///@param candidate is the candidate
+  ///@param score is the score of candidate
+  ///@return NONE
+  void insert(std::size_t candidate, double score) {
+    candidates.push_back(candidate);
+    scores.push_back(score);
+  }
+  ///Get the number of candidates
+  ///@param NONE
+  ///@return the number of candidates
+  std::size_t size() const {
+    return candidates.size();
+  }
+  ///Check if no candidates are added
+  ///@param NONE
+  ///@return TRUE if no candidates are added
+  bool empty() const {
+    return candidates.empty();
+  }
+  ///Get the position of the candidate with the maximal score
+  ///@param isbreaktie is the boolean variable which indicates if the ties are broken at random; otherwise the first added
+  ///candidate among the ties is chosen
+  ///@return the position of chosen candidate in the order of insertion
+  std::size_t argmax(bool isbreaktie) {
+    std::size_t numofcandidates = scores.size();
+    const double* values = &scores[0];
+    double maxvalue = values[0];
+    for (std::size_t i = 1; i < numofcandidates; ++i)
+      maxvalue = (values[i] > maxvalue) ? values[i] : maxvalue;
+
+    std::size_t chosen = 0, numofties = 0;
+    for (std::size_t i = 0; i < numofcandidates; ++i) {
+      if (values[i] != maxvalue)
+        continue;
+      if (!isbreaktie)
+        return i;
+      ++numofties;  //keep the i-th tie with probability 1/numofties
+      if (numofties == 1 || generator.nextIndex(numofties) == 0)
+        chosen = i;
+    }
+    return chosen;
+  }
+  ///Get the candidate with the maximal score. See argmax
+  ///@param isbreaktie is the boolean variable which indicates if the ties are broken at random
+  ///@return the chosen candidate
+  std::size_t chooseMax(bool isbreaktie) {
+    return candidates[argmax(isbreaktie)];
+  }
+  ///Get the score of candidate at the given position
+  ///@param position is the position of candidate in the order of insertion
+  ///@return the score of candidate
+  double getScore(std::size_t position) const {
+    return scores[position];
+  }
+  ///Get the candidate at the given position
+  ///@param position is the position of candidate in the order of insertion
+  ///@return the candidate
+  std::size_t getCandidate(std::size_t position) const {
+    return candidates[position];
+  }
+};
+
+#endif /* ARGMAXCHOOSER_H_ */
@@ -0,0 +1,83 @@
+/*
+ * AsyncSearch.cpp
+ * This file defines the non-blocking handle of a move generation running in its own thread.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "Global.h"
+#include "AsyncSearch.h"
+
+#include <boost/bind.hpp>
+
+using namespace std;
+
+///User defined constructor which takes the strategy generating the moves
+///@param strategy is the strategy which should outlive the handle
+AsyncSearch::AsyncSearch(AbstractStrategy& strategy)
+    : strategy(strategy),
+      mutex(NULL),
+      isdone(false),
+      resultmove(-1) {
+}
+///User defined constructor which takes the strategy generating the moves and the mutex held by the search
+///@param strategy is the strategy which should outlive the handle
+///@param mutex is the mutex locked by the thread of search while it runs the strategy, which should outlive the handle
+AsyncSearch::AsyncSearch(AbstractStrategy& strategy, boost::mutex& mutex)
+    : strategy(strategy),
+      mutex(&mutex),
+      isdone(false),
+      resultmove(-1) {
+}
+///destructor which stops and waits for the running search
+AsyncSearch::~AsyncSearch() {
+  if (searchthread) {
+    stop();
+    wait();
+  }
+}
+///Start the move generation in its own thread. The monitor is attached to the strategy while the thread runs it
+///@param NONE
+///@return TRUE if the search is started, FALSE if a search is already started and not waited for
+bool AsyncSearch::start() {
+  if (searchthread)
+    return false;
+  monitor.reset();
+  isdone.store(false);
+  resultmove = -1;
+  searchthread.reset(new boost::thread(boost::bind(&AsyncSearch::run, this)));
+  return true;
+}
+///Copy the progress of the search without pausing it
+///@param snapshot stores the latest snapshot published by the search
+///@return TRUE if the search has published the best move, either a snapshot or the move generated
+bool AsyncSearch::poll(SearchMonitor::Snapshot& snapshot) const {
+  monitor.getSnapshot(snapshot);
+  return snapshot.bestmove > 0;
+}
+///Wait for the move generation to return
+///@param NONE
+///@return the move generated, -1 if no search is started or the board is full
+int AsyncSearch::wait() {
+  if (!searchthread)
+    return resultmove;
+  searchthread->join();
+  searchthread.reset();
+  return resultmove;
+}
+///The body of the thread running the move generation, which holds the mutex if any while the monitor is attached
+///@param NONE
+///@return NONE
+void AsyncSearch::run() {
+  boost::unique_lock<boost::mutex> lock;
+  if (mutex != NULL)
+    lock = boost::unique_lock<boost::mutex>(*mutex);
+  strategy.setSearchMonitor(&monitor);
+  resultmove = strategy.genMove();
+  strategy.setSearchMonitor(nullptr);
+  if (lock.owns_lock())
+    lock.unlock();
+  monitor.finish(resultmove);
+  isdone.store(true);
+}
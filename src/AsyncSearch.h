@@ -0,0 +1,94 @@
+/*
+ * AsyncSearch.h
+ * This file declares the non-blocking handle of a move generation running in its own thread.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef ASYNCSEARCH_H_
+#define ASYNCSEARCH_H_
+
+#include "Global.h"
+#include "AbstractStrategy.h"
+#include "SearchMonitor.h"
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+/**
+ * AsyncSearch class runs AbstractStrategy::genMove in its own thread and observes it through a SearchMonitor.<br/>
+ * start launches the move generation and returns at once, poll copies the best move, the visit counts of the moves at root
+ * and the estimated winning rate found so far without pausing the simulation, stop requests the simulation to return the
+ * best move found so far after the running simulated game and wait returns the move generated. The board must not be
+ * modified until wait returns. The strategies without tree search (e.g. Strategy) only publish the move generated.<br/>
+ * AsyncSearch(AbstractStrategy& strategy): user defined constructor which takes the strategy generating the moves, the
+ * strategy should outlive the handle<br/>
+ * AsyncSearch(AbstractStrategy& strategy, boost::mutex& mutex): user defined constructor which also takes the mutex held by
+ * the thread of search from before the monitor is attached until it is detached, e.g. the mutex of the board shared with
+ * the blocking move generations, hence they never run the strategy at once<br/>
+ * Sample Usage:<br/>
+ * AsyncSearch search(mcst);<br/>
+ * search.start();<br/>
+ * SearchMonitor::Snapshot snapshot;<br/>
+ * search.poll(snapshot); //show snapshot.bestmove and snapshot.statistics<br/>
+ * search.stop(); //the user moves<br/>
+ * int move = search.wait();<br/>
+ */
+class AsyncSearch {
+ private:
+  AbstractStrategy& strategy;  ///< the strategy generating the moves
+  boost::mutex* mutex;  ///< the mutex held by the thread of search, NULL for none
+  SearchMonitor monitor;  ///< the monitor attached to the strategy during the search
+  hexgame::shared_ptr<boost::thread> searchthread;  ///< the thread running the move generation, empty if not started
+  hexgame::atomic<bool> isdone;  ///< TRUE when the move generation returns
+  int resultmove;  ///< the move generated, read after joining the thread
+
+  //The body of the thread running the move generation
+  void run();
+
+  ///Copy constructor which is not allowed
+  AsyncSearch(const AsyncSearch&);
+  ///Assignment operator which is not allowed
+  AsyncSearch& operator=(const AsyncSearch&);
+
+ public:
+  //User defined constructor which takes the strategy generating the moves
+  explicit AsyncSearch(AbstractStrategy& strategy);
+  //User defined constructor which takes the strategy generating the moves and the mutex held by the search
+  AsyncSearch(AbstractStrategy& strategy, boost::mutex& mutex);
+  //destructor which stops and waits for the running search
+  virtual ~AsyncSearch();
+  //Start the move generation in its own thread
+  bool start();
+  //Copy the progress of the search
+  bool poll(SearchMonitor::Snapshot& snapshot) const;
+  ///Request the search to return the best move found so far, which takes effect after the running simulated game
+  ///@param NONE
+  ///@return NONE
+  void stop() {
+    monitor.requestStop();
+  }
+  //Wait for the move generation to return
+  int wait();
+  ///Check if the search is started and not yet waited for
+  ///@param NONE
+  ///@return TRUE if the search is started and wait is not called since
+  bool isStarted() const {
+    return static_cast<bool>(searchthread);
+  }
+  ///Check if the move generation returns
+  ///@param NONE
+  ///@return TRUE if the move generation returns and wait does not block
+  bool isDone() const {
+    return isdone.load();
+  }
+  ///Getter for the monitor attached to the strategy, e.g. to set the interval of snapshots
+  ///@param NONE
+  ///@return the monitor
+  SearchMonitor& getMonitor() {
+    return monitor;
+  }
+};
+
+#endif /* ASYNCSEARCH_H_ */
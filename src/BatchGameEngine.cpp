@@ -0,0 +1,343 @@
+/*
+ * BatchGameEngine.cpp
+ * This file defines the engine which hosts many games in one process and advances their searches in slices on a shared
+ * worker pool.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "Global.h"
+#include "BatchGameEngine.h"
+
+#include <boost/bind.hpp>
+#include <boost/thread/locks.hpp>
+
+using namespace std;
+
+///User defined constructor which takes the size of board and the number of simulated games per move
+///@param numofhexgon is the number of hexgons per side
+///@param numberoftrials is the number of simulated games per move of both strategies
+///@param id is the id of game
+BatchGameEngine::HostedGame::HostedGame(int numofhexgon,
+                                        std::size_t numberoftrials, int id)
+    : board(numofhexgon),
+      redplayer(board, hexgonValKind_RED),
+      blueplayer(board, hexgonValKind_BLUE),
+      hexboardgame(board),
+      redstrategy(&board, &redplayer, numberoftrials),
+      bluestrategy(&board, &blueplayer, numberoftrials),
+      searchingcolor(0),
+      isselfplay(false),
+      isremoved(false),
+      timelimit(0),
+      lastmove(-1),
+      winner(0),
+      numofmoves(0),
+      id(id) {
+}
+///User defined constructor which takes the scheduler and the number of simulated games per slice
+///@param scheduler is the scheduler running the slices which should outlive the engine
+///@param slicetrials is the number of simulated games per slice, at least one
+BatchGameEngine::BatchGameEngine(WorkStealingScheduler& scheduler,
+                                 std::size_t slicetrials)
+    : scheduler(scheduler),
+      slicetrials(max(slicetrials, static_cast<size_t>(1))),
+      nextid(1),
+      numofslices(0),
+      numofcutoffs(0) {
+}
+///destructor which stops the searches of all games and waits for them
+BatchGameEngine::~BatchGameEngine() {
+  {
+    boost::lock_guard<boost::mutex> lock(mutex);
+    for (map<int, GamePtr>::iterator iter = games.begin(); iter != games.end();
+        ++iter) {
+      boost::lock_guard<boost::mutex> gamelock(iter->second->mutex);
+      iter->second->isremoved = true;
+    }
+  }
+  waitAll();
+}
+///Create a game with an empty board
+///@param numofhexgon is the number of hexgons per side
+///@param numberoftrials is the number of simulated games per move of both strategies
+///@return the id of game
+int BatchGameEngine::createGame(int numofhexgon, std::size_t numberoftrials) {
+  boost::lock_guard<boost::mutex> lock(mutex);
+  int id = nextid++;
+  games[id] = GamePtr(new HostedGame(numofhexgon, numberoftrials, id));
+  return id;
+}
+///Remove a game. Its running search stops after the running slice without playing its move
+///@param id is the id of game
+///@return TRUE if the game is found
+bool BatchGameEngine::removeGame(int id) {
+  GamePtr game;
+  {
+    boost::lock_guard<boost::mutex> lock(mutex);
+    map<int, GamePtr>::iterator iter = games.find(id);
+    if (iter == games.end())
+      return false;
+    game = iter->second;
+    games.erase(iter);
+  }
+  boost::lock_guard<boost::mutex> lock(game->mutex);
+  game->isremoved = true;
+  return true;
+}
+///Clear the board of a game, its board, players and strategies are reused for the next game
+///@param id is the id of game
+///@return TRUE if the board is cleared, FALSE if the game is not found or searching
+bool BatchGameEngine::resetGame(int id) {
+  GamePtr game = findGame(id);
+  if (!game)
+    return false;
+  boost::lock_guard<boost::mutex> lock(game->mutex);
+  if (game->searchingcolor != 0)
+    return false;
+  game->hexboardgame.resetGame(game->redplayer, game->blueplayer);
+  game->lastmove = -1;
+  game->winner = 0;
+  game->numofmoves = 0;
+  return true;
+}
+///Play a move given by the caller, e.g. the move of a human player
+///@param id is the id of game
+///@param color is the color of player, 'R' or 'B'
+///@param move is the index of hexgon starting from 1
+///@return TRUE if the move is played, FALSE if the game is not found, searching or over, or the move is illegal
+bool BatchGameEngine::play(int id, char color, int move) {
+  GamePtr game = findGame(id);
+  if (!game)
+    return false;
+  boost::lock_guard<boost::mutex> lock(game->mutex);
+  int numofhexgon = game->board.getNumofhexgons();
+  if (game->searchingcolor != 0 || game->winner != 0 || move < 1
+      || move > numofhexgon * numofhexgon)
+    return false;
+  Player& player = game->getPlayer(color);
+  if (!game->hexboardgame.setMove(player, (move - 1) / numofhexgon + 1,
+                                  (move - 1) % numofhexgon + 1))
+    return false;
+  ++game->numofmoves;
+  if (player.isArriveOpposite())
+    game->winner = color;
+  return true;
+}
+///Request a move generated by the strategy of the given color. The move is played on the board when generated
+///@param id is the id of game
+///@param color is the color of player, 'R' or 'B'
+///@param timelimit is the time limit of the move in milliseconds counted from now, 0 for no limit
+///@return TRUE if the search is started, FALSE if the game is not found, searching or over
+bool BatchGameEngine::requestMove(int id, char color, std::size_t timelimit) {
+  GamePtr game = findGame(id);
+  if (!game)
+    return false;
+  boost::lock_guard<boost::mutex> lock(game->mutex);
+  if (game->searchingcolor != 0 || game->winner != 0)
+    return false;
+  game->isselfplay = false;
+  game->timelimit = timelimit;
+  searchMove(game, color, false);
+  return true;
+}
+///Start the self-play of a game, the strategies of both players move in turn until the game is over. RED moves first on an
+///empty board, otherwise the player with fewer moves
+///@param id is the id of game
+///@param timelimit is the time limit of every move in milliseconds, 0 for no limit
+///@return TRUE if the self-play is started, FALSE if the game is not found, searching or over
+bool BatchGameEngine::startSelfPlay(int id, std::size_t timelimit) {
+  GamePtr game = findGame(id);
+  if (!game)
+    return false;
+  boost::lock_guard<boost::mutex> lock(game->mutex);
+  if (game->searchingcolor != 0 || game->winner != 0)
+    return false;
+  game->isselfplay = true;
+  game->timelimit = timelimit;
+  searchMove(game, (game->numofmoves % 2 == 0) ? 'R' : 'B', false);
+  return true;
+}
+///Get the move generated without blocking
+///@param id is the id of game
+///@param move stores the last move generated, -1 if none or the board is full
+///@return TRUE if the game is found and not searching
+bool BatchGameEngine::pollMove(int id, int& move) const {
+  GamePtr game = findGame(id);
+  if (!game)
+    return false;
+  boost::lock_guard<boost::mutex> lock(game->mutex);
+  if (game->searchingcolor != 0)
+    return false;
+  move = game->lastmove;
+  return true;
+}
+///Wait for the move generated, in self-play until the game is over
+///@param id is the id of game
+///@return the last move generated, -1 if none, the board is full or the game is not found
+int BatchGameEngine::waitMove(int id) const {
+  GamePtr game = findGame(id);
+  if (!game)
+    return -1;
+  boost::unique_lock<boost::mutex> guard(game->mutex);
+  while (game->searchingcolor != 0)
+    game->moved.wait(guard);
+  return game->lastmove;
+}
+///Wait until all games stop searching, including the self-play games until they are over
+///@param NONE
+///@return NONE
+void BatchGameEngine::waitAll() {
+  scheduler.wait(group);
+}
+///Get the winner of a game
+///@param id is the id of game
+///@return 'R' or 'B', 0 if the game is not over or not found
+char BatchGameEngine::getWinner(int id) const {
+  GamePtr game = findGame(id);
+  if (!game)
+    return 0;
+  boost::lock_guard<boost::mutex> lock(game->mutex);
+  return game->winner;
+}
+///Get the number of moves played in a game
+///@param id is the id of game
+///@return the number of moves of both players, 0 if the game is not found
+std::size_t BatchGameEngine::getNumofMoves(int id) const {
+  GamePtr game = findGame(id);
+  if (!game)
+    return 0;
+  boost::lock_guard<boost::mutex> lock(game->mutex);
+  return game->numofmoves;
+}
+///Get the text view of the board of a game, see Game::showView
+///@param id is the id of game
+///@return the view of board, empty if the game is not found
+std::string BatchGameEngine::showBoard(int id) const {
+  GamePtr game = findGame(id);
+  if (!game)
+    return string();
+  boost::lock_guard<boost::mutex> lock(game->mutex);
+  return game->hexboardgame.showView(game->redplayer, game->blueplayer);
+}
+///Get the strategy of a game, e.g. to change its settings before the first move. It should not be touched while searching
+///@param id is the id of game
+///@param color is the color of player, 'R' or 'B'
+///@return the strategy, nullptr if the game is not found
+MonteCarloTreeSearch* BatchGameEngine::getStrategy(int id, char color) const {
+  GamePtr game = findGame(id);
+  if (!game)
+    return nullptr;
+  return &game->getStrategy(color);
+}
+///Get the number of hosted games
+///@param NONE
+///@return the number of games created and not removed
+std::size_t BatchGameEngine::getNumofGames() const {
+  boost::lock_guard<boost::mutex> lock(mutex);
+  return games.size();
+}
+///Find the hosted game
+///@param id is the id of game
+///@return the game, empty if not found
+BatchGameEngine::GamePtr BatchGameEngine::findGame(int id) const {
+  boost::lock_guard<boost::mutex> lock(mutex);
+  map<int, GamePtr>::const_iterator iter = games.find(id);
+  return (iter == games.end()) ? GamePtr() : iter->second;
+}
+///Start the search of the given color, called with the mutex of game held
+///@param game is the game
+///@param color is the color of player, 'R' or 'B'
+///@param isdeferred is TRUE to yield to the tasks already queued, e.g. the next move of self-play
+///@return NONE
+void BatchGameEngine::searchMove(const GamePtr& game, char color,
+                                 bool isdeferred) {
+  game->searchingcolor = color;
+  game->deadline = hexgame::chrono::steady_clock::now()
+      + hexgame::chrono::milliseconds(game->timelimit);
+  WorkStealingScheduler::Task task = boost::bind(&BatchGameEngine::beginMove,
+                                                 this, game, color);
+  if (isdeferred)
+    scheduler.defer(task, group);
+  else
+    scheduler.submit(task, group);
+}
+///Begin the search of a move, the first task of every move. The move decided without simulation is played at once
+///@param game is the game
+///@param color is the color of player, 'R' or 'B'
+///@return NONE
+void BatchGameEngine::beginMove(GamePtr game, char color) {
+  bool isremoved;
+  {
+    boost::lock_guard<boost::mutex> lock(game->mutex);
+    isremoved = game->isremoved;
+  }
+  if (isremoved || game->board.getNumofemptyhexgons() == 0) {
+    finishMove(game, color, -1);
+    return;
+  }
+  int move = game->getStrategy(color).beginSearch(
+      game->board.getNumofemptyhexgons());
+  if (move > 0)
+    finishMove(game, color, move);
+  else
+    runSlice(game, color);
+}
+///Run a slice of the search of a move. The next slice is deferred until the search is done, the game is removed or the time
+///limit passes, then the best move found so far is played
+///@param game is the game
+///@param color is the color of player, 'R' or 'B'
+///@return NONE
+void BatchGameEngine::runSlice(GamePtr game, char color) {
+  MonteCarloTreeSearch& strategy = game->getStrategy(color);
+  strategy.continueSearch(slicetrials);
+  numofslices.fetch_add(1);
+  if (!strategy.isSearchDone()) {
+    bool isremoved, isexpired;
+    {
+      boost::lock_guard<boost::mutex> lock(game->mutex);
+      isremoved = game->isremoved;
+      isexpired = game->timelimit > 0
+          && hexgame::chrono::steady_clock::now() >= game->deadline;
+    }
+    if (!isremoved && !isexpired) {
+      scheduler.defer(
+          boost::bind(&BatchGameEngine::runSlice, this, game, color), group);
+      return;
+    }
+    if (isexpired)
+      numofcutoffs.fetch_add(1);
+  }
+  finishMove(game, color, strategy.endSearch());
+}
+///Play the move generated and start the search of the next move in self-play, otherwise notify the waiters and the callback
+///@param game is the game
+///@param color is the color of player, 'R' or 'B'
+///@param move is the move generated, -1 if the board is full or the game is removed
+///@return NONE
+void BatchGameEngine::finishMove(GamePtr game, char color, int move) {
+  {
+    boost::lock_guard<boost::mutex> lock(game->mutex);
+    if (move > 0 && !game->isremoved) {
+      int numofhexgon = game->board.getNumofhexgons();
+      Player& player = game->getPlayer(color);
+      game->hexboardgame.setMove(player, (move - 1) / numofhexgon + 1,
+                                 (move - 1) % numofhexgon + 1);
+      ++game->numofmoves;
+      if (player.isArriveOpposite())
+        game->winner = color;
+    }
+    game->lastmove = move;
+    if (game->isselfplay && !game->isremoved && game->winner == 0 && move > 0
+        && game->board.getNumofemptyhexgons() > 0) {
+      searchMove(game, (color == 'R') ? 'B' : 'R', true);
+      return;
+    }
+    game->isselfplay = false;
+    game->searchingcolor = 0;
+    game->moved.notify_all();
+  }
+  if (movecallback)
+    movecallback(game->id, move);
+}
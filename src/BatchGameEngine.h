@@ -0,0 +1,170 @@
+/*
+ * BatchGameEngine.h
+ * This file declares the engine which hosts many games in one process and advances their searches in slices on a shared
+ * worker pool.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef BATCHGAMEENGINE_H_
+#define BATCHGAMEENGINE_H_
+
+#include <map>
+#include <string>
+
+#include "Global.h"
+#include "Game.h"
+#include "MonteCarloTreeSearch.h"
+#include "WorkStealingScheduler.h"
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/function.hpp>
+
+/**
+ * BatchGameEngine class hosts many games, each with its own board, players and strategies, on one WorkStealingScheduler
+ * instead of running one process or thread per game.<br/>
+ * A move is generated by MonteCarloTreeSearch in slices of simulated games (see MonteCarloTreeSearch::beginSearch). Every
+ * slice defers the next one of the same game (see WorkStealingScheduler::defer), hence the searches queued on a worker take
+ * turns and no game holds a worker for a whole move. Every move has its own time limit which is checked between slices,
+ * the best move found so far is played when it passes. The searches of different games run concurrently, while the moves of
+ * one game are played in order: a game accepts a move or a request of move only when it is not searching. The callback set by
+ * setMoveCallback is called by the worker whenever a game stops searching, e.g. to wake up an event loop.<br/>
+ * The colors are 'R' (RED, north to south, moving first in self-play) and 'B' (BLUE, west to east) and the moves are the
+ * indices of hexgons starting from 1.<br/>
+ * BatchGameEngine(WorkStealingScheduler& scheduler, std::size_t slicetrials): user defined constructor which takes the
+ * scheduler running the slices, which should outlive the engine, and the number of simulated games per slice<br/>
+ * Sample Usage:<br/>
+ * WorkStealingScheduler scheduler(8);<br/>
+ * BatchGameEngine engine(scheduler);<br/>
+ * for (int i = 0; i < 1000; ++i)<br/>
+ *   engine.startSelfPlay(engine.createGame(9, 2048), 50); //50 milliseconds per move<br/>
+ * engine.waitAll();<br/>
+ */
+class BatchGameEngine {
+ public:
+  typedef boost::function<void(int, int)> MoveCallback;  ///< the type of callback taking the id of game and the move generated
+
+ private:
+  /**
+   * HostedGame is one game with its board, players and strategies and the progress of its search
+   */
+  struct HostedGame {
+    HexBoard board;  ///< the board of game
+    Player redplayer;  ///< the player of RED
+    Player blueplayer;  ///< the player of BLUE
+    Game hexboardgame;  ///< the game
+    MonteCarloTreeSearch redstrategy;  ///< the strategy of RED
+    MonteCarloTreeSearch bluestrategy;  ///< the strategy of BLUE
+    boost::mutex mutex;  ///< the mutex of the progress below
+    boost::condition_variable moved;  ///< notified when a move is generated
+    char searchingcolor;  ///< the color being searched, 0 if not searching
+    bool isselfplay;  ///< TRUE when both players are searched in turn until the game ends
+    bool isremoved;  ///< TRUE when the game is removed and its search should stop
+    std::size_t timelimit;  ///< the time limit of every move in milliseconds, 0 for no limit
+    hexgame::chrono::steady_clock::time_point deadline;  ///< the deadline of the move being searched, counted from its request
+    int lastmove;  ///< the last move generated, -1 if none
+    char winner;  ///< the color of winner, 0 if the game is not over
+    std::size_t numofmoves;  ///< the number of moves played
+    int id;  ///< the id of game
+
+    //User defined constructor which takes the size of board and the number of simulated games per move
+    HostedGame(int numofhexgon, std::size_t numberoftrials, int id);
+    ///Get the player of the given color
+    ///@param color is 'R' or 'B'
+    ///@return the player
+    Player& getPlayer(char color) {
+      return (color == 'R') ? redplayer : blueplayer;
+    }
+    ///Get the strategy of the given color
+    ///@param color is 'R' or 'B'
+    ///@return the strategy
+    MonteCarloTreeSearch& getStrategy(char color) {
+      return (color == 'R') ? redstrategy : bluestrategy;
+    }
+  };
+  typedef hexgame::shared_ptr<HostedGame> GamePtr;
+
+  WorkStealingScheduler& scheduler;  ///< the scheduler running the slices of all games
+  const std::size_t slicetrials;  ///< the number of simulated games per slice
+  MoveCallback movecallback;  ///< the callback called when a game stops searching, empty if not used
+  WorkStealingScheduler::TaskGroup group;  ///< the group of slices of all games
+  mutable boost::mutex mutex;  ///< the mutex of games
+  std::map<int, GamePtr> games;  ///< the hosted games by their ids
+  int nextid;  ///< the id of the next game created
+  hexgame::atomic<std::size_t> numofslices;  ///< the number of slices run
+  hexgame::atomic<std::size_t> numofcutoffs;  ///< the number of moves played when their time limit passed
+
+  //Find the hosted game
+  GamePtr findGame(int id) const;
+  //Start the search of the given color, called with the mutex of game held
+  void searchMove(const GamePtr& game, char color, bool isdeferred);
+  //Begin the search of a move, the first task of every move
+  void beginMove(GamePtr game, char color);
+  //Run a slice of the search of a move
+  void runSlice(GamePtr game, char color);
+  //Play the move generated and start the next search in self-play
+  void finishMove(GamePtr game, char color, int move);
+
+  ///Copy constructor which is not allowed
+  BatchGameEngine(const BatchGameEngine&);
+  ///Assignment operator which is not allowed
+  BatchGameEngine& operator=(const BatchGameEngine&);
+
+ public:
+  //User defined constructor which takes the scheduler and the number of simulated games per slice
+  explicit BatchGameEngine(WorkStealingScheduler& scheduler,
+                           std::size_t slicetrials = 256);
+  //destructor which stops the searches of all games and waits for them
+  virtual ~BatchGameEngine();
+  //Create a game
+  int createGame(int numofhexgon, std::size_t numberoftrials);
+  //Remove a game
+  bool removeGame(int id);
+  //Clear the board of a game
+  bool resetGame(int id);
+  //Play a move given by the caller
+  bool play(int id, char color, int move);
+  //Request a move generated by the strategy of the given color
+  bool requestMove(int id, char color, std::size_t timelimit);
+  //Start the self-play of a game
+  bool startSelfPlay(int id, std::size_t timelimit);
+  //Get the move generated without blocking
+  bool pollMove(int id, int& move) const;
+  //Wait for the move generated
+  int waitMove(int id) const;
+  //Wait until all games stop searching
+  void waitAll();
+  //Get the winner of a game
+  char getWinner(int id) const;
+  //Get the number of moves played in a game
+  std::size_t getNumofMoves(int id) const;
+  //Get the text view of the board of a game
+  std::string showBoard(int id) const;
+  //Get the strategy of a game, e.g. to change its settings before the first move
+  MonteCarloTreeSearch* getStrategy(int id, char color) const;
+  //Get the number of hosted games
+  std::size_t getNumofGames() const;
+  ///Setter for the callback called by the worker whenever a game stops searching, outside the locks of engine
+  ///@param callback is the callback taking the id of game and the move generated (-1 if none), which should not block. It
+  ///should be set before the first search and outlive the searches
+  ///@return NONE
+  void setMoveCallback(const MoveCallback& callback) {
+    movecallback = callback;
+  }
+  ///Get the number of slices run
+  ///@param NONE
+  ///@return the number of slices of all games since construction
+  std::size_t getNumofSlices() const {
+    return numofslices.load();
+  }
+  ///Get the number of moves cut short by their time limits
+  ///@param NONE
+  ///@return the number of moves played before all their simulated games were run
+  std::size_t getNumofCutoffs() const {
+    return numofcutoffs.load();
+  }
+};
+
+#endif /* BATCHGAMEENGINE_H_ */
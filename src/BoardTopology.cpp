@@ -0,0 +1,109 @@
+/*
+ * BoardTopology.cpp
+ * This file defines the implementation of BoardTopology class
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "BoardTopology.h"
+
+using namespace std;
+
+///User defined constructor which builds the tables of bridges and edge templates of the given board
+///@param board is the hex board whose size determines the patterns
+BoardTopology::BoardTopology(const HexBoard& board)
+    : numofhexgons(board.getNumofhexgons()),
+      numofbridges(0) {
+  int numofvertices = board.getSizeOfVertices();
+  vector<vector<int> > neighbors(numofvertices);
+  for (int i = 0; i < numofvertices; ++i)
+    neighbors[i] = board.getNeighbors(i + 1);
+
+  //collect the entries per carrier before laying them out contiguously
+  vector<vector<Intrusion> > percarrier(numofvertices);
+  const int edges[] = { NORTH, SOUTH, WEST, EAST };
+  for (int a = 1; a <= numofvertices; ++a) {
+    const vector<int>& around = neighbors[a - 1];
+    //bridge: the two carriers are adjacent and both are adjacent to another hexgon b which is not adjacent to a
+    for (size_t i = 0; i < around.size(); ++i)
+      for (size_t j = i + 1; j < around.size(); ++j) {
+        int x = around[i], y = around[j];
+        if (!board.isAdjacent(x, y))
+          continue;
+        const vector<int>& aroundx = neighbors[x - 1];
+        for (size_t k = 0; k < aroundx.size(); ++k) {
+          int b = aroundx[k];
+          if (b <= a || !board.isAdjacent(b, y) || board.isAdjacent(a, b))
+            continue;
+          Intrusion intox = { a, b, y }, intoy = { a, b, x };
+          percarrier[x - 1].push_back(intox);
+          percarrier[y - 1].push_back(intoy);
+          ++numofbridges;
+        }
+      }
+    //edge template: a is not on the edge and has exactly two neighbors on it
+    for (int e = 0; e < 4; ++e) {
+      if (isOnEdge(a, edges[e]))
+        continue;
+      vector<int> carriers;
+      for (size_t i = 0; i < around.size(); ++i)
+        if (isOnEdge(around[i], edges[e]))
+          carriers.push_back(around[i]);
+      if (carriers.size() != 2)
+        continue;
+      Intrusion intox = { a, edges[e], carriers[1] }, intoy = { a, edges[e],
+          carriers[0] };
+      percarrier[carriers[0] - 1].push_back(intox);
+      percarrier[carriers[1] - 1].push_back(intoy);
+    }
+  }
+
+  //ring: (0,+1), (-1,+1), (-1,0), (0,-1), (+1,-1), (+1,0) in (row, column), each adjacent to the next one
+  const int rowoffsets[SIZEOFRING] = { 0, -1, -1, 0, 1, 1 };
+  const int coloffsets[SIZEOFRING] = { 1, 1, 0, -1, -1, 0 };
+  rings.resize(numofvertices * SIZEOFRING);
+  for (int i = 0; i < numofvertices; ++i)
+    for (int k = 0; k < SIZEOFRING; ++k) {
+      int row = i / numofhexgons + rowoffsets[k];
+      int col = i % numofhexgons + coloffsets[k];
+      bool isoffrow = (row < 0 || row >= numofhexgons);
+      bool isoffcol = (col < 0 || col >= numofhexgons);
+      int& entry = rings[i * SIZEOFRING + k];
+      if (isoffrow && isoffcol)
+        entry = 0;
+      else if (isoffrow)
+        entry = (row < 0) ? NORTH : SOUTH;
+      else if (isoffcol)
+        entry = (col < 0) ? WEST : EAST;
+      else
+        entry = row * numofhexgons + col + 1;
+    }
+
+  offsets.assign(numofvertices + 1, 0);
+  for (int i = 0; i < numofvertices; ++i) {
+    offsets[i + 1] = offsets[i] + static_cast<int>(percarrier[i].size());
+    intrusions.insert(intrusions.end(), percarrier[i].begin(),
+                      percarrier[i].end());
+  }
+}
+///Check if the hexgon lies on the given edge
+///@param move is the position of hexgon starting from 1
+///@param edge is the edgekind of edge
+///@return TRUE if the hexgon lies on the edge
+bool BoardTopology::isOnEdge(int move, int edge) const {
+  int row = (move - 1) / numofhexgons;
+  int col = (move - 1) % numofhexgons;
+  switch (edge) {
+    case NORTH:
+      return row == 0;
+    case SOUTH:
+      return row == numofhexgons - 1;
+    case WEST:
+      return col == 0;
+    case EAST:
+      return col == numofhexgons - 1;
+    default:
+      return false;
+  }
+}
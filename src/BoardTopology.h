@@ -0,0 +1,104 @@
+/*
+ * BoardTopology.h
+ * This file declares the per-hexgon lookup tables of bridges and edge templates precomputed from the hex board.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef BOARDTOPOLOGY_H_
+#define BOARDTOPOLOGY_H_
+
+#include <vector>
+#include <cstddef>
+
+#include "HexBoard.h"
+
+/**
+ * BoardTopology class is used to look up the local patterns of a hexgon in constant time during play-out.<br/>
+ * A bridge is a pair of hexgons which are not adjacent but share two adjacent neighbors (carriers); a player who owns both
+ * hexgons keeps them connected as long as the intrusion into one carrier is answered by playing the other one. An edge
+ * template is the same pattern between a hexgon on the second row from an edge and the edge itself. All patterns only
+ * depend on the size of board, hence they are computed once when the topology is built and stored as a table of
+ * intrusions indexed by the carrier (compressed row layout), i.e. the intrusions of a hexgon are a contiguous range of
+ * entries which is scanned without allocation. The six neighbors of every hexgon are also kept in cyclic order (ring), where
+ * a neighbor off board is the edgekind of the edge, so that consecutive entries of a ring are adjacent to each other.<br/>
+ * BoardTopology(): parameterless default constructor which constructs an empty topology<br/>
+ * BoardTopology(const HexBoard& board): user defined constructor which builds the tables of the given board<br/>
+ * Sample Usage:<br/>
+ * BoardTopology topology(board);<br/>
+ * for (const BoardTopology::Intrusion* entry = topology.beginIntrusions(move); entry != topology.endIntrusions(move); ++entry)<br/>
+ *   //entry->response is the other carrier of the bridge between entry->first and entry->second<br/>
+ */
+class BoardTopology {
+ public:
+  ///enum type serves as the pseudo hexgon of board edges which is stored as the second end of an edge template
+  enum edgekind {
+    NORTH = -1,  ///< the edge of row 0
+    SOUTH = -2,  ///< the edge of the last row
+    WEST = -3,  ///< the edge of column 0
+    EAST = -4  ///< the edge of the last column
+  };
+  static const int SIZEOFRING = 6;  ///< the number of neighbors of a hexgon including the edges
+
+  /**
+   * Intrusion is the entry of one bridge or edge template which has the indexed hexgon as one carrier
+   */
+  struct Intrusion {
+    int first;  ///< the hexgon at one end of the bridge
+    int second;  ///< the hexgon at the other end of the bridge or the edgekind of an edge template
+    int response;  ///< the other carrier which restores the connection
+  };
+
+  ///Parameterless default constructor which constructs an empty topology
+  BoardTopology()
+      : numofhexgons(0),
+        numofbridges(0) {
+  }
+  ;
+  //User defined constructor which builds the tables of the given board
+  explicit BoardTopology(const HexBoard& board);
+
+  ///Get the number of hexgons per side
+  ///@param NONE
+  ///@return the number of hexgons per side
+  int getNumofhexgons() const {
+    return numofhexgons;
+  }
+  ///Get the first intrusion entry which has the given hexgon as a carrier
+  ///@param move is the position of hexgon starting from 1
+  ///@return the pointer to the first entry
+  const Intrusion* beginIntrusions(int move) const {
+    return intrusions.empty() ? NULL : &intrusions[0] + offsets[move - 1];
+  }
+  ///Get the entry past the last intrusion entry which has the given hexgon as a carrier
+  ///@param move is the position of hexgon starting from 1
+  ///@return the pointer past the last entry
+  const Intrusion* endIntrusions(int move) const {
+    return intrusions.empty() ? NULL : &intrusions[0] + offsets[move];
+  }
+  ///Get the six neighbors of a hexgon in cyclic order. A neighbor off board is the edgekind of the edge, or 0 for the
+  ///position beyond a corner which lies on two edges
+  ///@param move is the position of hexgon starting from 1
+  ///@return the pointer to the six entries of ring
+  const int* getRing(int move) const {
+    return &rings[(move - 1) * SIZEOFRING];
+  }
+  ///Get the number of bridges between two hexgons on board
+  ///@param NONE
+  ///@return the number of bridges
+  std::size_t getNumofBridges() const {
+    return numofbridges;
+  }
+  //Check if the hexgon lies on the given edge
+  bool isOnEdge(int move, int edge) const;
+
+ private:
+  int numofhexgons;  ///< the number of hexgons per side
+  std::size_t numofbridges;  ///< the number of bridges between two hexgons
+  std::vector<int> offsets;  ///< the offset of the intrusions of each hexgon, indexed by position - 1, the last one is the total
+  std::vector<Intrusion> intrusions;  ///< the intrusion entries grouped by carrier
+  std::vector<int> rings;  ///< the neighbors of every hexgon in cyclic order, SIZEOFRING entries per hexgon
+};
+
+#endif /* BOARDTOPOLOGY_H_ */
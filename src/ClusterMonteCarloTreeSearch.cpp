@@ -0,0 +1,167 @@
+/*
+ * ClusterMonteCarloTreeSearch.cpp
+ * This file defines the coordinator of a search cluster which merges the searches of several engine processes
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "Global.h"
+#include "SearchWorker.h"
+#include "ClusterMonteCarloTreeSearch.h"
+
+#include <map>
+#include <iostream>
+#include <boost/version.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#if BOOST_VERSION < 106600
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#endif
+
+using namespace std;
+using namespace boost::asio;
+
+//the number of simulated games the coordinator runs between the checks of deadline when it searches by itself
+static const std::size_t FALLBACKSLICE = 64;
+#if BOOST_VERSION >= 106600
+//the socket iostreams expire at a time point of steady clock since Boost 1.66
+typedef boost::asio::chrono::steady_clock::time_point Deadline;
+static Deadline getNow() {
+  return boost::asio::chrono::steady_clock::now();
+}
+static Deadline getDeadline(std::size_t timelimit) {
+  return getNow() + boost::asio::chrono::milliseconds(timelimit);
+}
+#else
+//the socket iostreams expire at a universal time before Boost 1.66
+typedef boost::posix_time::ptime Deadline;
+static Deadline getNow() {
+  return boost::posix_time::microsec_clock::universal_time();
+}
+static Deadline getDeadline(std::size_t timelimit) {
+  return getNow() + boost::posix_time::milliseconds(static_cast<long>(timelimit));
+}
+#endif
+
+ClusterMonteCarloTreeSearch::ClusterMonteCarloTreeSearch(
+    const HexBoard* board, const Player* aiplayer,
+    const std::vector<std::string>& endpoints)
+    : AbstractStrategyImpl(board, aiplayer),
+      mcstimpl(MonteCarloTreeSearch(board, aiplayer)),
+      ptrtoboard(board),
+      ptrtoplayer(aiplayer),
+      endpoints(endpoints),
+      numberoftrials(2048),
+      timelimit(60000),
+      lastwinningrate(0.0),
+      numofanswers(0) {
+}
+ClusterMonteCarloTreeSearch::ClusterMonteCarloTreeSearch(
+    const HexBoard* board, const Player* aiplayer,
+    const std::vector<std::string>& endpoints, std::size_t numberoftrials)
+    : AbstractStrategyImpl(board, aiplayer),
+      mcstimpl(MonteCarloTreeSearch(board, aiplayer, numberoftrials)),
+      ptrtoboard(board),
+      ptrtoplayer(aiplayer),
+      endpoints(endpoints),
+      numberoftrials(numberoftrials),
+      timelimit(60000),
+      lastwinningrate(0.0),
+      numofanswers(0) {
+}
+///Overwritten simulation method. See AbstractStrategy.
+int ClusterMonteCarloTreeSearch::simulation(int currentempty) {
+  SearchWorker::SearchRequest request;
+  request.numofhexgon = ptrtoboard->getNumofhexgons();
+  request.tomove = ptrtoplayer->getPlayerlabel();
+  request.numberoftrials = numberoftrials;
+  request.redmoves = ptrtoboard->getRedmoves();
+  request.bluemoves = ptrtoboard->getBluemoves();
+
+  //every connection and answer expires at the deadline of move, a stream expired fails as a worker unreachable
+  Deadline deadline = getDeadline(timelimit);
+
+  //send the game state to all workers first, hence they search concurrently
+  vector<hexgame::shared_ptr<iostream> > streams;
+  for (size_t i = 0; i < endpoints.size(); ++i) {
+    string path, host, port;
+    if (!SearchWorker::parseEndpoint(endpoints[i], path, host, port))
+      continue;
+    hexgame::shared_ptr<iostream> stream;
+    if (!path.empty()) {
+      local::stream_protocol::iostream* localstream =
+          new local::stream_protocol::iostream();
+      stream.reset(localstream);
+      if (timelimit > 0)
+        localstream->expires_at(deadline);
+      localstream->connect(local::stream_protocol::endpoint(path));
+    } else {
+      ip::tcp::iostream* tcpstream = new ip::tcp::iostream();
+      stream.reset(tcpstream);
+      if (timelimit > 0)
+        tcpstream->expires_at(deadline);
+      tcpstream->connect(host, port);
+    }
+    if (!*stream)
+      continue;
+    SearchWorker::writeRequest(*stream, request);
+    if (*stream)
+      streams.push_back(stream);
+  }
+
+  //sum the statistics of each move over the workers which answered
+  map<int, pair<long long, long long> > merged;
+  numofanswers = 0;
+  for (size_t i = 0; i < streams.size(); ++i) {
+    vector<MonteCarloTreeSearch::RootStatistics> statistics;
+    if (!SearchWorker::readStatistics(*streams[i], statistics))
+      continue;
+    ++numofanswers;
+    for (size_t j = 0; j < statistics.size(); ++j) {
+      int move = statistics[j].move;
+      if (move < 1 || move > ptrtoboard->getSizeOfVertices()
+          || !ptrtoboard->getEmptyHexIndicators().get()[move - 1])
+        continue;
+      pair<long long, long long>& counts = merged[statistics[j].move];
+      counts.first += statistics[j].visitcount;
+      counts.second += statistics[j].wincount;
+    }
+    *streams[i] << "quit" << endl;
+  }
+  //the coordinator searches by itself for the time left until the deadline, hence the move still takes the time limit
+  if (merged.empty()) {
+    numofanswers = 0;
+    int move = mcstimpl.beginSearch(currentempty);
+    if (move <= 0) {
+      do
+        mcstimpl.continueSearch(timelimit > 0 ? FALLBACKSLICE : numberoftrials);
+      while (!mcstimpl.isSearchDone() && getNow() < deadline);
+      move = mcstimpl.endSearch();
+    }
+    lastwinningrate = mcstimpl.getLastWinningRate();
+    lastrootstatistics = mcstimpl.getLastRootStatistics();
+    return move;
+  }
+
+  //the move with the most visits, ties broken by the wins
+  lastrootstatistics.clear();
+  int bestmove = -1;
+  pair<long long, long long> bestcounts(-1, -1);
+  for (map<int, pair<long long, long long> >::iterator iter = merged.begin();
+      iter != merged.end(); ++iter) {
+    MonteCarloTreeSearch::RootStatistics statistics = { iter->first,
+        static_cast<int>(iter->second.first), static_cast<int>(iter->second
+            .second) };
+    lastrootstatistics.push_back(statistics);
+    if (iter->second > bestcounts) {
+      bestcounts = iter->second;
+      bestmove = iter->first;
+    }
+  }
+  lastwinningrate =
+      bestcounts.first > 0 ?
+          static_cast<double>(bestcounts.second) / bestcounts.first : 0.0;
+  assert(bestmove != -1);
+  return bestmove;
+}
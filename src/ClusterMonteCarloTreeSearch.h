@@ -0,0 +1,118 @@
+/*
+ * ClusterMonteCarloTreeSearch.h
+ * This file defines the coordinator of a search cluster which merges the searches of several engine processes
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef CLUSTERMONTECARLOTREESEARCH_H_
+#define CLUSTERMONTECARLOTREESEARCH_H_
+
+#include <string>
+#include <vector>
+
+#include "Global.h"
+#include "Player.h"
+#include "HexBoard.h"
+#include "MonteCarloTreeSearch.h"
+
+/**
+ * ClusterMonteCarloTreeSearch class defines the coordinator of a search cluster for AI player.<br/>
+ * The game state is sent to every worker process of the cluster (see SearchWorker) which may run on the same or other
+ * machines; each worker searches the game state independently by its own Monte Carlo Tree Search (root parallelization)
+ * and answers the visit and win counts of the moves at root. The coordinator sums the counts of each move over the workers
+ * and plays the move with the most visits, the ties broken by the wins. The requests are sent to all workers before any
+ * answer is read, so the workers search concurrently. The workers which cannot be connected or answer an error are left
+ * out; if no worker answers, the coordinator searches the game state by itself. The workers share a time limit per move
+ * (60 seconds by default, see setTimeLimit): the connections and answers which are not done when it passes are given up
+ * and their workers left out, hence a hung or slow worker never stalls the move. The search of coordinator itself stops at
+ * the same deadline, so a move without answers takes about the time limit too.<br/>
+ * ClusterMonteCarloTreeSearch(const HexBoard* board, const Player* aiplayer, const std::vector<std::string>& endpoints):
+ * user defined constructor which takes pointer to a hex board object, pointer to AI player and the endpoints of workers
+ * ("unix:<path>" or "<host>:<port>"); while the number of simulated games per worker (numberoftrials) is set as default
+ * value (2048)<br/>
+ * ClusterMonteCarloTreeSearch(const HexBoard* board, const Player* aiplayer, const std::vector<std::string>& endpoints,
+ * size_t numberoftrials): user defined constructor which also takes the number of simulated games per worker<br/>
+ * Sample Usage:<br/>
+ * vector<string> endpoints; endpoints.push_back("unix:/tmp/hexworker0.sock"); endpoints.push_back("10.0.0.2:7000");<br/>
+ * ClusterMonteCarloTreeSearch cluster(&board, &player, endpoints, 16384);<br/>
+ * int move = cluster.genMove();<br/>
+ */
+class ClusterMonteCarloTreeSearch : public AbstractStrategyImpl {
+ private:
+  MonteCarloTreeSearch mcstimpl;  ///< the search of coordinator itself when no worker answers
+  const HexBoard* const ptrtoboard;  ///< The actual playing board in the game. Need to ensure it not to be modified during the simulation
+  const Player* const ptrtoplayer;  ///< the actual player computer plays. Need to ensure it not to be modified during the simulation
+  const std::vector<std::string> endpoints;  ///< the endpoints of workers
+  const std::size_t numberoftrials;  ///< The number of simulated games of each worker. 2048 by default
+  std::size_t timelimit;  ///< The time limit per move for the workers to answer in milliseconds, 0 for no limit
+  double lastwinningrate;  ///< The merged winning rate of the best move returned by the last simulation
+  std::size_t numofanswers;  ///< The number of workers which answered the last simulation
+  std::vector<MonteCarloTreeSearch::RootStatistics> lastrootstatistics;  ///< The merged statistics of the moves at root of the last simulation
+
+ public:
+  ///User defined constructor which takes pointer to a hex board object, pointer to AI player and the endpoints of workers as parameters
+  ClusterMonteCarloTreeSearch(const HexBoard* board, const Player* aiplayer,
+                              const std::vector<std::string>& endpoints);
+  ///User defined constructor which takes pointer to a hex board object, pointer to AI player, the endpoints of workers and number of simulated games per worker (numberoftrials) as parameters
+  ClusterMonteCarloTreeSearch(const HexBoard* board, const Player* aiplayer,
+                              const std::vector<std::string>& endpoints,
+                              std::size_t numberoftrials);
+  ///destructor
+  virtual ~ClusterMonteCarloTreeSearch() {
+  }
+  ;
+  ///return the meaningful class name as "ClusterMonteCarloTreeSearch"
+  std::string name() {
+    return std::string("ClusterMonteCarloTreeSearch");
+  }
+  ;
+  ///Overwritten simulation method. See AbstractStrategy
+  int simulation(int currentempty);
+
+  ///Getter for retrieving number of simulated games per worker
+  ///@param NONE
+  ///@return number of simulated games per worker
+  std::size_t getNumberoftrials() const {
+    return numberoftrials;
+  }
+  ///Setter for the time limit per move for the workers to connect and answer
+  ///@param timelimit is the time limit in milliseconds, 0 for no limit
+  ///@return NONE
+  void setTimeLimit(std::size_t timelimit) {
+    this->timelimit = timelimit;
+  }
+  ///Getter for the time limit per move for the workers to connect and answer
+  ///@param NONE
+  ///@return the time limit in milliseconds, 0 for no limit
+  std::size_t getTimeLimit() const {
+    return timelimit;
+  }
+  ///Getter for retrieving the endpoints of workers
+  ///@param NONE
+  ///@return the endpoints of workers
+  const std::vector<std::string>& getEndpoints() const {
+    return endpoints;
+  }
+  ///Getter for the merged winning rate of the best move returned by the last simulation
+  ///@param NONE
+  ///@return the winning rate of AI player
+  double getLastWinningRate() const {
+    return lastwinningrate;
+  }
+  ///Getter for the number of workers which answered the last simulation
+  ///@param NONE
+  ///@return the number of workers, 0 if the coordinator searched by itself
+  std::size_t getNumofAnswers() const {
+    return numofanswers;
+  }
+  ///Getter for the merged statistics of the moves at root of the last simulation
+  ///@param NONE
+  ///@return the statistics of moves summed over the workers
+  const std::vector<MonteCarloTreeSearch::RootStatistics>& getLastRootStatistics() const {
+    return lastrootstatistics;
+  }
+};
+
+#endif /* CLUSTERMONTECARLOTREESEARCH_H_ */
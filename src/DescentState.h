@@ -0,0 +1,280 @@
+/*
+ * DescentState.h
+ * This file defines the per-thread game state which is advanced while descending the game tree in Monte Carlo Tree Search.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef DESCENTSTATE_H_
+#define DESCENTSTATE_H_
+
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <boost/cstdint.hpp>
+
+#include "Global.h"
+
+/**
+ * DescentState class is used to hold the game state of one simulated game.<br/>
+ * The state starts from the actual game state and the game tree applies the move of every node on the selected path and
+ * the expanded move during selection and expansion, hence the state is ready for the play-out phase without
+ * reconstructing the game history from the tree. Each thread owns its state and reuses it across simulated games, so
+ * reset only copies the actual game state into the buffers already allocated. When a neighbor table of hex board is given,
+ * the state also provides the prior of a move, i.e. the number of occupied neighbors as Strategy::countNeighbors, which is
+ * used by game tree to order the untried moves; the priors of the moves at the actual game state might be given instead,
+ * e.g. by TwoDistanceEvaluator::getPriors. The moves proven inferior for a player at the actual game state (see
+ * InferiorCellAnalysis) are marked once after reset, so the game tree only expands the candidates of the player to move,
+ * i.e. the empty hexgons not marked for the player. The candidates of AI player at the actual game state might be further
+ * restricted to a region, e.g. where the threat of the opponent must be stopped (see HSearch::getMustPlay), which is
+ * dropped as soon as a move is applied.<br/>
+ * DescentState(): parameterless default constructor which constructs an empty state<br/>
+ * Sample Usage:<br/>
+ * DescentState state;<br/>
+ * state.reset(emptyglobal, board.getSizeOfVertices(), bwglobal, oppglobal);<br/>
+ * pair<int, int> selectresult = gametree.selectMaxBalanceNode(currentempty, true, state);<br/>
+ * int expandednode = gametree.expandNode(selectresult.first, state);<br/>
+ */
+class DescentState {
+ private:
+  hexgame::shared_ptr<bool> emptyindicators;  ///< the indicators of empty hexgons, indexed by position - 1
+  int sizeofvertices;  ///< the number of hexgons on hex board
+  int numofempty;  ///< the number of empty hexgons
+  int lastmove;  ///< the last move applied to the state, 0 if none since reset
+  bool isbabywatsontomove;  ///< the indicator of AI player to move, TRUE after reset since AI player moves first
+  int numofcandidates[2];  ///< the number of candidates of the opponent (0) and AI player (1)
+  int numofplayed;  ///< the number of moves applied since reset
+  int numofrootcandidates;  ///< the number of candidates in the region of AI player at the actual game state, 0 if no region
+  std::vector<unsigned char> inferiors;  ///< the inferior marks indexed by position - 1, bit 1 for AI player, bit 2 for the opponent and bit 4 for the region, empty if none
+  std::vector<int> babywatsons;  ///< the moves made by AI player
+  std::vector<int> opponents;  ///< the moves made by the opponent of AI player
+  const std::vector<std::vector<int> >* neighbortable;  ///< the neighbors of every hexgon indexed by position - 1, not owned
+  const std::vector<int>* rootpriors;  ///< the priors of the moves at the actual game state indexed by position - 1, not owned
+
+  ///Get the inferior mark of a player
+  static unsigned char getInferiorMask(int isbabywatson) {
+    return isbabywatson ? 1 : 2;
+  }
+  ///Get the mark of the region of AI player at the actual game state
+  static unsigned char getRegionMask() {
+    return 4;
+  }
+  ///Compare two moves by prior only
+  static bool isLessPrior(const std::pair<int, boost::uint16_t>& lhs,
+                          const std::pair<int, boost::uint16_t>& rhs) {
+    return lhs.first < rhs.first;
+  }
+
+ public:
+  ///Parameterless default constructor which constructs an empty state
+  DescentState()
+      : sizeofvertices(0),
+        numofempty(0),
+        lastmove(0),
+        isbabywatsontomove(true),
+        numofplayed(0),
+        numofrootcandidates(0),
+        neighbortable(NULL),
+        rootpriors(NULL) {
+    numofcandidates[0] = numofcandidates[1] = 0;
+  }
+  ;
+  ///Reset the state to the actual game state
+  ///@param emptyglobal is the indicators of empty hexgons of the actual game state
+  ///@param numofvertices is the number of hexgons on hex board
+  ///@param bwglobal is the moves made by AI player in the actual game state
+  ///@param oppglobal is the moves made by the opponent in the actual game state
+  ///@return NONE
+  void reset(const hexgame::shared_ptr<bool>& emptyglobal, int numofvertices,
+             const std::vector<int>& bwglobal,
+             const std::vector<int>& oppglobal) {
+    if (!emptyindicators || sizeofvertices != numofvertices)
+      emptyindicators = hexgame::shared_ptr<bool>(
+          new bool[numofvertices], hexgame::default_delete<bool[]>());
+    sizeofvertices = numofvertices;
+    std::copy(emptyglobal.get(), emptyglobal.get() + numofvertices,
+              emptyindicators.get());
+    numofempty = static_cast<int>(std::count(emptyindicators.get(),
+                                             emptyindicators.get()
+                                                 + numofvertices,
+                                             true));
+    babywatsons.assign(bwglobal.begin(), bwglobal.end());
+    opponents.assign(oppglobal.begin(), oppglobal.end());
+    lastmove = 0;
+    isbabywatsontomove = true;
+    numofcandidates[0] = numofcandidates[1] = numofempty;
+    numofplayed = numofrootcandidates = 0;
+    inferiors.clear();
+  }
+  ///Apply a move to the state
+  ///@param move is the position of hexgon starting from 1 which should be empty
+  ///@param isbabywatson is TRUE if the move is made by AI player
+  ///@return NONE
+  void play(int move, bool isbabywatson) {
+    assert(isEmpty(move));
+    emptyindicators.get()[move - 1] = false;
+    --numofempty;
+    lastmove = move;
+    ++numofplayed;
+    isbabywatsontomove = !isbabywatson;
+    for (int side = 0; side < 2; ++side)
+      if (inferiors.empty() || !(inferiors[move - 1] & getInferiorMask(side)))
+        --numofcandidates[side];
+    if (isbabywatson)
+      babywatsons.push_back(move);
+    else
+      opponents.push_back(move);
+  }
+  ///Check if the hexgon is empty
+  ///@param move is the position of hexgon starting from 1
+  ///@return TRUE if the hexgon is empty
+  bool isEmpty(int move) const {
+    return move > 0 && move <= sizeofvertices && emptyindicators.get()[move - 1];
+  }
+  ///Mark the move as inferior for the player, so it is no longer a candidate of the player until reset
+  ///@param move is the position of hexgon starting from 1
+  ///@param isbabywatson is TRUE if the move is inferior for AI player
+  ///@return NONE
+  void setInferior(int move, bool isbabywatson) {
+    if (inferiors.empty())
+      inferiors.assign(sizeofvertices, 0);
+    unsigned char mask = getInferiorMask(isbabywatson);
+    if (inferiors[move - 1] & mask)
+      return;
+    inferiors[move - 1] |= mask;
+    if (isEmpty(move))
+      --numofcandidates[isbabywatson];
+  }
+  ///Restrict the candidates of AI player at the actual game state to a region, which should be called after the inferior
+  ///moves are marked. The region is ignored if none of its hexgons is a candidate
+  ///@param region is the positions of hexgons starting from 1
+  ///@return NONE
+  void setRootRegion(const std::vector<int>& region) {
+    assert(numofplayed == 0 && isbabywatsontomove);
+    if (region.empty())
+      return;
+    if (inferiors.empty())
+      inferiors.assign(sizeofvertices, 0);
+    int numofregion = 0;
+    for (std::size_t i = 0; i < region.size(); ++i)
+      if (isCandidate(region[i])
+          && !(inferiors[region[i] - 1] & getRegionMask())) {
+        inferiors[region[i] - 1] |= getRegionMask();
+        ++numofregion;
+      }
+    numofrootcandidates = numofregion;
+  }
+  ///Check if the hexgon is a candidate of the player to move, i.e. empty, not inferior for the player and in the region
+  ///if the state is the actual game state
+  ///@param move is the position of hexgon starting from 1
+  ///@return TRUE if the hexgon is a candidate
+  bool isCandidate(int move) const {
+    if (!isEmpty(move))
+      return false;
+    if (inferiors.empty())
+      return true;
+    if (numofplayed == 0 && numofrootcandidates > 0)
+      return (inferiors[move - 1] & getRegionMask()) != 0;
+    return !(inferiors[move - 1] & getInferiorMask(isbabywatsontomove));
+  }
+  ///Get the number of candidates of the player to move
+  ///@param NONE
+  ///@return the number of candidates which equals the number of empty hexgons if no move is inferior
+  int getNumofCandidates() const {
+    if (numofplayed == 0 && numofrootcandidates > 0)
+      return numofrootcandidates;
+    return numofcandidates[isbabywatsontomove];
+  }
+  ///Check if AI player is to move
+  ///@param NONE
+  ///@return TRUE if AI player is to move
+  bool isBabywatsonToMove() const {
+    return isbabywatsontomove;
+  }
+  ///Set the neighbor table of hex board used by getPrior. The table should outlive the state
+  ///@param table is the neighbors of every hexgon indexed by position - 1 or NULL to disable the prior
+  ///@return NONE
+  void setNeighborTable(const std::vector<std::vector<int> >* table) {
+    neighbortable = table;
+  }
+  ///Set the priors of the moves at the actual game state used by getPrior instead of the neighbor table until a move is
+  ///applied. The priors should outlive the state
+  ///@param priors is the priors indexed by position - 1 or NULL to use the neighbor table only
+  ///@return NONE
+  void setRootPriors(const std::vector<int>* priors) {
+    rootpriors = priors;
+  }
+  ///Get the prior of a move which is the prior given for the actual game state or the number of occupied neighbors of the
+  ///hexgon
+  ///@param move is the position of hexgon starting from 1
+  ///@return the prior or 0 if neither priors nor neighbor table is given
+  int getPrior(int move) const {
+    if (rootpriors != NULL && numofplayed == 0)
+      return (*rootpriors)[move - 1];
+    if (neighbortable == NULL)
+      return 0;
+    const std::vector<int>& neighbors = (*neighbortable)[move - 1];
+    int prior = 0;
+    for (std::size_t i = 0; i < neighbors.size(); ++i)
+      if (neighbors[i] > 0 && neighbors[i] <= sizeofvertices
+          && !emptyindicators.get()[neighbors[i] - 1])
+        ++prior;
+    return prior;
+  }
+  ///Order the moves by prior ascendingly, so the move with the highest prior is at the back. The order of moves with the
+  ///same prior is kept
+  ///@param moves is the moves to be ordered
+  ///@return NONE
+  void orderByPrior(std::vector<boost::uint16_t>& moves) const {
+    if (neighbortable == NULL && (rootpriors == NULL || numofplayed != 0))
+      return;
+    std::vector<std::pair<int, boost::uint16_t> > priors;
+    priors.reserve(moves.size());
+    for (std::size_t i = 0; i < moves.size(); ++i)
+      priors.push_back(std::make_pair(getPrior(moves[i]), moves[i]));
+    std::stable_sort(priors.begin(), priors.end(), isLessPrior);
+    for (std::size_t i = 0; i < moves.size(); ++i)
+      moves[i] = priors[i].second;
+  }
+  ///Get the number of hexgons on hex board
+  ///@param NONE
+  ///@return the number of hexgons
+  int getSizeofVertices() const {
+    return sizeofvertices;
+  }
+  ///Get the last move applied to the state
+  ///@param NONE
+  ///@return the last move or 0 if no move is applied since reset
+  int getLastMove() const {
+    return lastmove;
+  }
+  ///Get the number of empty hexgons which is modified by play-out phase
+  ///@param NONE
+  ///@return the reference of the number of empty hexgons
+  int& getNumofEmpty() {
+    return numofempty;
+  }
+  ///Get the indicators of empty hexgons which are modified by play-out phase
+  ///@param NONE
+  ///@return the reference of the indicators
+  hexgame::shared_ptr<bool>& getEmptyIndicators() {
+    return emptyindicators;
+  }
+  ///Get the moves made by AI player
+  ///@param NONE
+  ///@return the reference of the moves made by AI player
+  std::vector<int>& getBabywatsons() {
+    return babywatsons;
+  }
+  ///Get the moves made by the opponent of AI player
+  ///@param NONE
+  ///@return the reference of the moves made by the opponent
+  std::vector<int>& getOpponents() {
+    return opponents;
+  }
+};
+
+#endif /* DESCENTSTATE_H_ */
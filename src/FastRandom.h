@@ -0,0 +1,72 @@
+/*
+ * FastRandom.h
+ * This file defines the small and fast pseudo random number generator used on the hot path of tree search.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef FASTRANDOM_H_
+#define FASTRANDOM_H_
+
+#include <ctime>
+#include <cstddef>
+#include <boost/cstdint.hpp>
+
+/**
+ * FastRandom class is a xorshift64* pseudo random number generator.<br/>
+ * The state is a single 64-bit word owned by the generator, hence each tree or thread keeps its own generator and no
+ * engine is constructed or locked per call.<br/>
+ * FastRandom(): parameterless default constructor which seeds the generator by time and address<br/>
+ * FastRandom(boost::uint64_t seed): user defined constructor which seeds the generator by the given seed<br/>
+ * Sample Usage:<br/>
+ * FastRandom generator;<br/>
+ * std::size_t index = generator.nextIndex(candidates.size());<br/>
+ */
+class FastRandom {
+ private:
+  boost::uint64_t state;  ///< the state of generator, never zero
+
+ public:
+  ///Parameterless default constructor which seeds the generator by time and address
+  FastRandom() {
+    setSeed(static_cast<boost::uint64_t>(std::time(NULL))
+        ^ reinterpret_cast<std::size_t>(this));
+  }
+  ;
+  ///User defined constructor which seeds the generator by the given seed
+  ///@param seed is the seed of generator
+  explicit FastRandom(boost::uint64_t seed) {
+    setSeed(seed);
+  }
+  ;
+  ///Seed the generator
+  ///@param seed is the seed of generator
+  ///@return NONE
+  void setSeed(boost::uint64_t seed) {
+    state = (seed == 0) ? 0x9E3779B97F4A7C15ULL : seed;
+  }
+  ///Generate the next random number
+  ///@param NONE
+  ///@return the random number
+  boost::uint64_t next() {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+  }
+  ///Generate a random index
+  ///@param bound is the number of indices which should be positive
+  ///@return the random index in [0, bound)
+  std::size_t nextIndex(std::size_t bound) {
+    return static_cast<std::size_t>(next() % bound);
+  }
+  ///Generate a random real number
+  ///@param NONE
+  ///@return the random number in [0, 1)
+  double nextUniform() {
+    return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+  }
+};
+
+#endif /* FASTRANDOM_H_ */
@@ -0,0 +1,492 @@
+/*
+ * GameServer.cpp
+ * This file defines the server which plays many hex board games with its clients over TCP or Unix domain sockets in a
+ * text protocol similar to GTP.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "Global.h"
+#include "GameServer.h"
+#include "SearchWorker.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <boost/bind.hpp>
+#include <boost/thread/locks.hpp>
+
+using namespace std;
+
+//the commands answered by the server
+static const char* COMMANDS[] = { "protocol_version", "name", "version",
+    "known_command", "list_commands", "quit", "boardsize", "clear_board",
+    "play", "genmove", "showboard" };
+static const size_t NUMOFCOMMANDS = sizeof(COMMANDS) / sizeof(COMMANDS[0]);
+
+///Format a successful response
+///@param id is the id of command, empty if none
+///@param result is the result, empty if none
+///@return the response ended by an empty line
+static string success(const string& id, const string& result) {
+  return "=" + id + (result.empty() ? string() : " " + result) + "\n\n";
+}
+///Format a failed response
+///@param id is the id of command, empty if none
+///@param reason is the reason of failure
+///@return the response ended by an empty line
+static string failure(const string& id, const string& reason) {
+  return "?" + id + " " + reason + "\n\n";
+}
+///Watch a socket by the epoll instance
+///@param epollfd is the epoll instance
+///@param operation is EPOLL_CTL_ADD or EPOLL_CTL_MOD
+///@param fd is the socket
+///@param events is the events watched
+///@return TRUE if successful
+static bool watch(int epollfd, int operation, int fd, unsigned events) {
+  epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = events;
+  event.data.fd = fd;
+  return epoll_ctl(epollfd, operation, fd, &event) == 0;
+}
+///User defined constructor which binds and listens on the given endpoint
+///@param scheduler is the scheduler running the searches which should outlive the server
+///@param endpoint is "unix:<path>" for Unix domain socket or "<ip>:<port>" for TCP
+///@param numberoftrials is the number of simulated games per move
+///@param timelimit is the time limit per move in milliseconds, 0 for no limit
+GameServer::GameServer(WorkStealingScheduler& scheduler,
+                       const std::string& endpoint, std::size_t numberoftrials,
+                       std::size_t timelimit)
+    : engine(scheduler),
+      numberoftrials(numberoftrials),
+      timelimit(timelimit),
+      listenfd(-1),
+      epollfd(-1),
+      wakeupfd(-1),
+      numofcommands(0),
+      isstopped(false) {
+  engine.setMoveCallback(
+      boost::bind(&GameServer::onMoveFinished, this, _1, _2));
+  string path, host, port;
+  if (!SearchWorker::parseEndpoint(endpoint, path, host, port))
+    return;
+  int fd;
+  if (!path.empty()) {
+    sockaddr_un address;
+    if (path.size() >= sizeof(address.sun_path))
+      return;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    std::remove(path.c_str());
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+      return;
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || listen(fd, SOMAXCONN) != 0) {
+      close(fd);
+      return;
+    }
+    localpath = path;
+  } else {
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<unsigned short>(atoi(port.c_str())));
+    if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1)
+      return;
+    fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+      return;
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || listen(fd, SOMAXCONN) != 0) {
+      close(fd);
+      return;
+    }
+  }
+  listenfd = fd;
+  epollfd = epoll_create1(EPOLL_CLOEXEC);
+  wakeupfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (epollfd < 0 || wakeupfd < 0 || !watch(epollfd, EPOLL_CTL_ADD, listenfd, EPOLLIN)
+      || !watch(epollfd, EPOLL_CTL_ADD, wakeupfd, EPOLLIN)) {
+    if (epollfd >= 0)
+      close(epollfd);
+    if (wakeupfd >= 0)
+      close(wakeupfd);
+    epollfd = wakeupfd = -1;
+  }
+}
+///destructor which closes the sessions, waits for their searches and closes the endpoint
+GameServer::~GameServer() {
+  while (!sessions.empty())
+    closeSession(sessions.begin()->second);
+  //the callback of searches touches the eventfd
+  engine.waitAll();
+  if (wakeupfd >= 0)
+    close(wakeupfd);
+  if (epollfd >= 0)
+    close(epollfd);
+  if (listenfd >= 0) {
+    close(listenfd);
+    if (!localpath.empty())
+      std::remove(localpath.c_str());
+  }
+}
+///Run the event loop until stop is called. The sessions stay open until the server is destroyed
+///@param NONE
+///@return the number of commands answered
+std::size_t GameServer::serve() {
+  const int MAXNUMOFEVENTS = 64;
+  epoll_event events[MAXNUMOFEVENTS];
+  while (isListening()) {
+    {
+      boost::lock_guard<boost::mutex> lock(mutex);
+      if (isstopped)
+        break;
+    }
+    int numofevents = epoll_wait(epollfd, events, MAXNUMOFEVENTS, -1);
+    if (numofevents < 0) {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+    for (int i = 0; i < numofevents; ++i) {
+      int fd = events[i].data.fd;
+      if (fd == listenfd)
+        acceptSessions();
+      else if (fd == wakeupfd) {
+        boost::uint64_t counter;
+        while (read(wakeupfd, &counter, sizeof(counter)) > 0)
+          ;
+        finishSearches();
+      } else {
+        map<int, SessionPtr>::iterator iter = sessions.find(fd);
+        if (iter == sessions.end())
+          continue;
+        SessionPtr session = iter->second;
+        if ((events[i].events & EPOLLIN) && !session->isquit)
+          readSession(session);
+        else if (events[i].events & (EPOLLHUP | EPOLLERR))
+          closeSession(session);
+        else if (events[i].events & EPOLLOUT)
+          flushSession(session);
+      }
+    }
+  }
+  return numofcommands;
+}
+///Request the event loop to return, callable from any thread
+///@param NONE
+///@return NONE
+void GameServer::stop() {
+  {
+    boost::lock_guard<boost::mutex> lock(mutex);
+    isstopped = true;
+  }
+  boost::uint64_t counter = 1;
+  if (wakeupfd >= 0 && write(wakeupfd, &counter, sizeof(counter)) < 0) {
+    //the counter is already positive when the eventfd is full, hence the event loop wakes up anyway
+  }
+}
+///Called by the worker when a game stops searching, which wakes up the event loop
+///@param gameid is the id of game
+///@param move is the move generated, -1 if none
+///@return NONE
+void GameServer::onMoveFinished(int gameid, int) {
+  {
+    boost::lock_guard<boost::mutex> lock(mutex);
+    finishedgames.push_back(gameid);
+  }
+  boost::uint64_t counter = 1;
+  if (write(wakeupfd, &counter, sizeof(counter)) < 0) {
+    //the counter is already positive when the eventfd is full, hence the event loop wakes up anyway
+  }
+}
+///Accept the pending connections, each with a new game on the default board
+///@param NONE
+///@return NONE
+void GameServer::acceptSessions() {
+  while (true) {
+    int fd = accept4(listenfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0)
+      return;
+    if (!watch(epollfd, EPOLL_CTL_ADD, fd, EPOLLIN)) {
+      close(fd);
+      continue;
+    }
+    SessionPtr session(
+        new Session(fd, engine.createGame(DEFAULTNUMOFHEXGON, numberoftrials),
+                    DEFAULTNUMOFHEXGON));
+    session->watchedevents = EPOLLIN;
+    sessions[fd] = session;
+  }
+}
+///Read from a session and answer its commands. A session closed by its client for writing is closed after the commands
+///received are answered
+///@param session is the session
+///@return NONE
+void GameServer::readSession(const SessionPtr& session) {
+  char buffer[4096];
+  while (!session->isquit && session->input.size() < MAXINPUTLENGTH) {
+    ssize_t length = read(session->fd, buffer, sizeof(buffer));
+    if (length > 0)
+      session->input.append(buffer, length);
+    else if (length == 0 || (errno != EAGAIN && errno != EWOULDBLOCK
+        && errno != EINTR))
+      session->isquit = true;
+    else if (errno != EINTR)
+      break;
+  }
+  processCommands(session);
+  //the command being received is the bytes after the last line
+  size_t lastline = session->input.rfind('\n');
+  size_t partial = (lastline == string::npos) ?
+      session->input.size() : session->input.size() - lastline - 1;
+  if (partial > MAXLINELENGTH) {
+    closeSession(session);
+    return;
+  }
+  flushSession(session);
+}
+///Answer the commands received by a session until a genmove is pending or the output is full
+///@param session is the session
+///@return NONE
+void GameServer::processCommands(const SessionPtr& session) {
+  size_t begin = 0, end;
+  while (session->pendingcolor == 0 && session->output.size() < MAXOUTPUTLENGTH
+      && (end = session->input.find('\n', begin)) != string::npos) {
+    string line = session->input.substr(begin, end - begin);
+    begin = end + 1;
+    processCommand(session, line);
+    if (session->input.empty())  //cleared by quit
+      return;
+  }
+  session->input.erase(0, begin);
+}
+///Answer one command, a genmove is answered when its search finishes
+///@param session is the session
+///@param line is the command
+///@return NONE
+void GameServer::processCommand(const SessionPtr& session,
+                                const std::string& line) {
+  //the comment, control characters and the id of command are ignored as GTP
+  string command = line.substr(0, line.find('#'));
+  for (size_t i = 0; i < command.size(); ++i)
+    if (command[i] == '\t' || command[i] == '\r')
+      command[i] = ' ';
+  istringstream tokens(command);
+  string id, keyword;
+  if (!(tokens >> keyword))
+    return;
+  if (keyword.find_first_not_of("0123456789") == string::npos) {
+    id = keyword;
+    if (!(tokens >> keyword))
+      return;
+  }
+  ++numofcommands;
+  string argument, extra;
+  tokens >> argument;
+  if (keyword == "protocol_version")
+    session->output += success(id, "2");
+  else if (keyword == "name")
+    session->output += success(id, "HexGame");
+  else if (keyword == "version")
+    session->output += success(id, "1.0");
+  else if (keyword == "known_command") {
+    bool isknown = false;
+    for (size_t i = 0; i < NUMOFCOMMANDS; ++i)
+      isknown = isknown || argument == COMMANDS[i];
+    session->output += success(id, isknown ? "true" : "false");
+  } else if (keyword == "list_commands") {
+    string commands;
+    for (size_t i = 0; i < NUMOFCOMMANDS; ++i)
+      commands += (i == 0 ? "" : "\n") + string(COMMANDS[i]);
+    session->output += success(id, commands);
+  } else if (keyword == "quit") {
+    session->output += success(id, "");
+    session->input.clear();
+    session->isquit = true;
+  } else if (keyword == "boardsize") {
+    int numofhexgon = atoi(argument.c_str());
+    if (numofhexgon < 2 || numofhexgon > MAXNUMOFHEXGON)
+      session->output += failure(id, "unacceptable size");
+    else if (numofhexgon == session->numofhexgon) {
+      engine.resetGame(session->gameid);
+      session->output += success(id, "");
+    } else {
+      engine.removeGame(session->gameid);
+      session->gameid = engine.createGame(numofhexgon, numberoftrials);
+      session->numofhexgon = numofhexgon;
+      session->output += success(id, "");
+    }
+  } else if (keyword == "clear_board") {
+    engine.resetGame(session->gameid);
+    session->output += success(id, "");
+  } else if (keyword == "play") {
+    char color = parseColor(argument);
+    string vertex;
+    tokens >> vertex;
+    int move = parseVertex(vertex, session->numofhexgon);
+    if (color == 0 || move < 0)
+      session->output += failure(id, "syntax error");
+    else if (engine.getWinner(session->gameid) != 0)
+      session->output += failure(id, "game is over");
+    else if (!engine.play(session->gameid, color, move))
+      session->output += failure(id, "illegal move");
+    else
+      session->output += success(id, "");
+  } else if (keyword == "genmove") {
+    char color = parseColor(argument);
+    if (color == 0)
+      session->output += failure(id, "syntax error");
+    else if (engine.getWinner(session->gameid) != 0)
+      session->output += failure(id, "game is over");
+    else if (!engine.requestMove(session->gameid, color, timelimit))
+      session->output += failure(id, "cannot generate move");
+    else {
+      session->pendingid = id;
+      session->pendingcolor = color;
+      searching[session->gameid] = session;
+    }
+  } else if (keyword == "showboard") {
+    //the empty lines of view would end the response
+    istringstream view(engine.showBoard(session->gameid));
+    string board, row;
+    while (getline(view, row))
+      if (row.find_first_not_of(' ') != string::npos)
+        board += "\n" + row;
+    session->output += success(id, board);
+  } else
+    session->output += failure(id, "unknown command");
+}
+///Answer the genmove commands whose searches finished and continue with the commands received meanwhile
+///@param NONE
+///@return NONE
+void GameServer::finishSearches() {
+  vector<int> finished;
+  {
+    boost::lock_guard<boost::mutex> lock(mutex);
+    finished.swap(finishedgames);
+  }
+  for (size_t i = 0; i < finished.size(); ++i) {
+    map<int, SessionPtr>::iterator iter = searching.find(finished[i]);
+    if (iter == searching.end())
+      continue;
+    SessionPtr session = iter->second;
+    searching.erase(iter);
+    int move = -1;
+    engine.pollMove(session->gameid, move);
+    session->output += success(
+        session->pendingid,
+        move > 0 ? formatVertex(move, session->numofhexgon) : "resign");
+    session->pendingid.clear();
+    session->pendingcolor = 0;
+    processCommands(session);
+    flushSession(session);
+  }
+}
+///Send the output of a session, the rest is sent when the socket is writable. The commands held back by a full output
+///are answered as it drains. The session is closed when it quits and everything is sent
+///@param session is the session
+///@return NONE
+void GameServer::flushSession(const SessionPtr& session) {
+  for (;;) {
+    while (!session->output.empty()) {
+      ssize_t length = send(session->fd, session->output.data(),
+                            session->output.size(), MSG_NOSIGNAL);
+      if (length > 0)
+        session->output.erase(0, length);
+      else if (length < 0 && errno == EINTR)
+        continue;
+      else if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        break;
+      else {
+        closeSession(session);
+        return;
+      }
+    }
+    if (!session->output.empty() || session->pendingcolor != 0
+        || session->input.find('\n') == string::npos)
+      break;
+    processCommands(session);
+  }
+  if (session->isquit && session->pendingcolor == 0
+      && session->output.empty()) {
+    closeSession(session);
+    return;
+  }
+  //a session which quits is not read any more, nor is a session whose input or output is full until it drains
+  unsigned watchedevents = 0;
+  if (!session->isquit && session->input.size() < MAXINPUTLENGTH
+      && session->output.size() < MAXOUTPUTLENGTH)
+    watchedevents |= EPOLLIN;
+  if (!session->output.empty())
+    watchedevents |= EPOLLOUT;
+  if (watchedevents != session->watchedevents) {
+    watch(epollfd, EPOLL_CTL_MOD, session->fd, watchedevents);
+    session->watchedevents = watchedevents;
+  }
+}
+///Close a session and remove its game, whose search stops without answering
+///@param session is the session
+///@return NONE
+void GameServer::closeSession(const SessionPtr& session) {
+  epoll_ctl(epollfd, EPOLL_CTL_DEL, session->fd, NULL);
+  close(session->fd);
+  if (session->pendingcolor != 0)
+    searching.erase(session->gameid);
+  engine.removeGame(session->gameid);
+  sessions.erase(session->fd);
+}
+///Parse a vertex, the letter of column followed by the number of row starting from 1, e.g. c4 is the 3rd column of 4th row
+///@param vertex is the vertex, case insensitive
+///@param numofhexgon is the number of hexgons per side
+///@return the index of hexgon starting from 1, -1 if the vertex is malformed or off board
+int GameServer::parseVertex(const std::string& vertex, int numofhexgon) {
+  if (vertex.size() < 2 || !isalpha(vertex[0])
+      || vertex.find_first_not_of("0123456789", 1) != string::npos
+      || vertex.size() > 4)
+    return -1;
+  int col = tolower(vertex[0]) - 'a' + 1;
+  int row = atoi(vertex.c_str() + 1);
+  if (col < 1 || col > numofhexgon || row < 1 || row > numofhexgon)
+    return -1;
+  return (row - 1) * numofhexgon + col;
+}
+///Format the index of hexgon as vertex, see parseVertex
+///@param move is the index of hexgon starting from 1
+///@param numofhexgon is the number of hexgons per side
+///@return the vertex in lower case
+std::string GameServer::formatVertex(int move, int numofhexgon) {
+  stringstream vertex;
+  vertex << static_cast<char>('a' + (move - 1) % numofhexgon)
+         << (move - 1) / numofhexgon + 1;
+  return vertex.str();
+}
+///Parse a color
+///@param color is red, r, blue or b, case insensitive
+///@return 'R' or 'B', 0 if the color is unknown
+char GameServer::parseColor(const std::string& color) {
+  string lower(color);
+  for (size_t i = 0; i < lower.size(); ++i)
+    lower[i] = static_cast<char>(tolower(lower[i]));
+  if (lower == "red" || lower == "r")
+    return 'R';
+  if (lower == "blue" || lower == "b")
+    return 'B';
+  return 0;
+}
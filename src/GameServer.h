@@ -0,0 +1,152 @@
+/*
+ * GameServer.h
+ * This file declares the server which plays many hex board games with its clients over TCP or Unix domain sockets in a
+ * text protocol similar to GTP.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef GAMESERVER_H_
+#define GAMESERVER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Global.h"
+#include "BatchGameEngine.h"
+#include "WorkStealingScheduler.h"
+
+#include <boost/thread/mutex.hpp>
+
+/**
+ * GameServer class serves many sessions at once from one event loop (epoll) and keeps one game of its BatchGameEngine per
+ * session, hence the boards, players and strategies stay warm between the commands of a session. The moves are generated
+ * by the workers of scheduler, the I/O thread only parses commands and writes responses. It is woken up by an eventfd when
+ * a search finishes.<br/>
+ * The endpoint is "unix:&lt;path&gt;" for Unix domain socket or "&lt;ip&gt;:&lt;port&gt;" for TCP as SearchWorker. The
+ * commands are lines of text as GTP, each optionally led by a numeric id, and answered in order by "=[id] result" or
+ * "?[id] reason" followed by an empty line:<br/>
+ * protocol_version, name, version, known_command &lt;command&gt;, list_commands, quit<br/>
+ * boardsize &lt;n&gt;: start a new game on a board of n x n hexgons (11 x 11 on connection)<br/>
+ * clear_board: clear the board of the current game<br/>
+ * play &lt;color&gt; &lt;vertex&gt;: play the move of a player, the color is red (r, north to south) or blue (b, west to
+ * east), the vertex is the letter of column followed by the number of row, e.g. c4<br/>
+ * genmove &lt;color&gt;: generate and play the move of a player, the commands after it wait for its answer<br/>
+ * showboard: show the board as Game::showView<br/>
+ * Every session is flow controlled: the socket is not read while MAXINPUTLENGTH bytes wait to be answered (e.g. behind a
+ * pending genmove) or MAXOUTPUTLENGTH bytes wait to be sent, and the commands are not answered while the output is full,
+ * hence a client which sends without reading only fills its own socket buffers.<br/>
+ * GameServer(WorkStealingScheduler& scheduler, const std::string& endpoint, std::size_t numberoftrials,
+ * std::size_t timelimit): user defined constructor which takes the scheduler running the searches, the endpoint to listen
+ * on and the settings of every move<br/>
+ * Sample Usage:<br/>
+ * WorkStealingScheduler scheduler(8);<br/>
+ * GameServer server(scheduler, "0.0.0.0:7000", 2048, 1000);<br/>
+ * if (server.isListening())<br/>
+ *   server.serve(); //until stop is called by another thread<br/>
+ */
+class GameServer {
+ public:
+  static const std::size_t MAXLINELENGTH = 4096;  ///< the longest command accepted, the session is closed otherwise
+  static const std::size_t MAXINPUTLENGTH = 65536;  ///< the bytes received and not answered per session before reading pauses
+  static const std::size_t MAXOUTPUTLENGTH = 1 << 20;  ///< the bytes not sent per session before answering pauses
+  static const int MAXNUMOFHEXGON = 26;  ///< the largest board accepted, whose columns are named by letters
+  static const int DEFAULTNUMOFHEXGON = 11;  ///< the size of board of a new session
+
+ private:
+  /**
+   * Session is the state of one connection
+   */
+  struct Session {
+    int fd;  ///< the socket of connection
+    int gameid;  ///< the id of game in engine
+    int numofhexgon;  ///< the number of hexgons per side of game
+    std::string input;  ///< the bytes received and not parsed yet
+    std::string output;  ///< the bytes to be sent
+    std::string pendingid;  ///< the id of genmove command being answered
+    char pendingcolor;  ///< the color of genmove command being answered, 0 if none
+    bool isquit;  ///< TRUE when no more commands are read and the session is closed after sending the output
+    unsigned watchedevents;  ///< the events of socket watched by the epoll instance
+
+    ///User defined constructor which takes the socket, the id of game and the size of its board
+    Session(int fd, int gameid, int numofhexgon)
+        : fd(fd),
+          gameid(gameid),
+          numofhexgon(numofhexgon),
+          pendingcolor(0),
+          isquit(false),
+          watchedevents(0) {
+    }
+  };
+  typedef hexgame::shared_ptr<Session> SessionPtr;
+
+  BatchGameEngine engine;  ///< the engine hosting the games of sessions
+  const std::size_t numberoftrials;  ///< the number of simulated games per move
+  const std::size_t timelimit;  ///< the time limit per move in milliseconds, 0 for no limit
+  std::string localpath;  ///< the path of Unix domain socket, empty for TCP endpoint
+  int listenfd;  ///< the listening socket, -1 if the endpoint is not bound
+  int epollfd;  ///< the epoll instance of event loop
+  int wakeupfd;  ///< the eventfd written when a search finishes or stop is called
+  std::map<int, SessionPtr> sessions;  ///< the sessions by their sockets, touched by the I/O thread only
+  std::map<int, SessionPtr> searching;  ///< the sessions waiting for genmove by the ids of their games
+  std::size_t numofcommands;  ///< the number of commands answered
+  boost::mutex mutex;  ///< the mutex of the fields below
+  std::vector<int> finishedgames;  ///< the ids of games whose searches finished
+  bool isstopped;  ///< TRUE when stop is called
+
+  //Called by the worker when a game stops searching
+  void onMoveFinished(int gameid, int move);
+  //Accept the pending connections
+  void acceptSessions();
+  //Read from a session and answer its commands
+  void readSession(const SessionPtr& session);
+  //Answer the commands received by a session until a genmove is pending
+  void processCommands(const SessionPtr& session);
+  //Answer one command
+  void processCommand(const SessionPtr& session, const std::string& line);
+  //Answer the genmove commands whose searches finished
+  void finishSearches();
+  //Send the output of a session and close it when it quits
+  void flushSession(const SessionPtr& session);
+  //Close a session and remove its game
+  void closeSession(const SessionPtr& session);
+
+  ///Copy constructor which is not allowed
+  GameServer(const GameServer&);
+  ///Assignment operator which is not allowed
+  GameServer& operator=(const GameServer&);
+
+ public:
+  //User defined constructor which binds and listens on the given endpoint
+  GameServer(WorkStealingScheduler& scheduler, const std::string& endpoint,
+             std::size_t numberoftrials, std::size_t timelimit);
+  //destructor which closes the sessions and the endpoint
+  virtual ~GameServer();
+  ///Check if the server is listening on its endpoint
+  ///@param NONE
+  ///@return TRUE if the endpoint is bound successfully
+  bool isListening() const {
+    return listenfd >= 0 && epollfd >= 0 && wakeupfd >= 0;
+  }
+  //Run the event loop until stop is called
+  std::size_t serve();
+  //Request the event loop to return, callable from any thread
+  void stop();
+  ///Get the number of open sessions, only valid from the I/O thread or after serve returns
+  ///@param NONE
+  ///@return the number of sessions
+  std::size_t getNumofSessions() const {
+    return sessions.size();
+  }
+
+  //Parse a vertex such as c4 into the index of hexgon starting from 1
+  static int parseVertex(const std::string& vertex, int numofhexgon);
+  //Format the index of hexgon as vertex
+  static std::string formatVertex(int move, int numofhexgon);
+  //Parse a color into 'R' or 'B'
+  static char parseColor(const std::string& color);
+};
+
+#endif /* GAMESERVER_H_ */
@@ -7,18 +7,34 @@
 
 #include <cmath>
 #include <utility>
+#include <algorithm>
 #include <sstream>
+#include <boost/bind.hpp>
 
 #if __cplusplus > 199711L
 #include <chrono>
 #endif
 
 #include "GameTree.h"
-#include "PriorityQueue.h"
 
 using namespace std;
 using namespace boost;
 
+double UTCTable::logtable[UTCTable::SIZEOFTABLE];
+double UTCTable::invsqrttable[UTCTable::SIZEOFTABLE];
+const bool UTCTable::isinitialized = UTCTable::initTables();
+const int UTCTable::SIZEOFTABLE;
+
+///Fill the tables of logarithm and inverse square root
+///@param NONE
+///@return TRUE when the tables are filled
+bool UTCTable::initTables() {
+  for (int i = 0; i < SIZEOFTABLE; ++i) {
+    logtable[i] = std::log(static_cast<double>(i));
+    invsqrttable[i] = 1.0 / std::sqrt(static_cast<double>(i));
+  }
+  return true;
+}
 ///Estimate the winning rate
 ///@param NONE
 ///@return the estimated winning rate
@@ -32,14 +48,10 @@ double UTCPolicy::estimate() {
 ///@param parent is the parent node whose features will be used for UTC calculation
 ///@return the calculated balance according the UTC Policy
 double UTCPolicy::calculate(AbstractUTCPolicy& parent) {
-  double value = estimate();
   //calculate UCT value (Upper Confidence Bound applied to Tree)
-  //equation is used from Chaslot G et al,
-  double vcount = static_cast<double>(featureholder.at(visitcount));
-  double vcountofparent = static_cast<double>(parent.feature(visitcount));
-  balance = (value
-      + (std::sqrt(coefficient * std::log(vcountofparent) / vcount)));
-  return balance;
+  //equation is used from Chaslot G et al, value + sqrt(coefficient * ln(parent visits) / visits)
+  return calculate(
+      UTCTable::explorationTerm(coefficient, parent.feature(visitcount)));
 }
 ///Update the value of a given feature index or AbstractUTCPolicy::valuekind
 ///@param indexofkind is a AbstractUTCPolicy::valuekind enum type which can serve as index to access feature
@@ -97,12 +109,12 @@ GameTree::GameTree(char playerscolor, std::size_t indexofroot) {
 ///@param color is the color label for the new node
 ///@return return a newly created vertex
 GameTree::vertex_t GameTree::addNode(std::size_t positionofchild, char color) {
-  vertex_t target = add_vertex(thetree);
+  vertex_t target = recycler.hasFreeNode() ? recycler.acquire() : add_vertex(thetree);
   //TODO re-factor
   updateNodePosition(target, positionofchild);
   updateNodeColor(target, color);
   updateNodeValue(target);
-  updateNodeName(target);
+  get(vertex_untried, thetree)[target].clear();
   return target;
 }
 /// Add a new edge between source node and target node
@@ -128,6 +140,48 @@ string GameTree::printGameTree(int index) {
   treebuffer << '\n';
   return treebuffer.str();
 }
+/// Write the game tree as a compact binary snapshot. See GameTreeSnapshot for the format
+///@param out is the binary output stream
+///@return TRUE if the snapshot is written successfully
+bool GameTree::saveGameTree(ostream& out) {
+  return GameTreeSnapshot<basegraph>::save(out, thetree, _root,
+                                           getSizeofNodes());
+}
+/// Replace the game tree with the one read from a binary snapshot written by saveGameTree. The nodes are re-indexed in
+/// preorder, hence the root has index zero and the indices of the original tree are not preserved
+///@param in is the binary input stream
+///@return TRUE if the snapshot is read successfully. Otherwise FALSE and the game tree remains unchanged
+bool GameTree::loadGameTree(istream& in) {
+  basegraph previoustree;
+  previoustree.swap(thetree);
+  vertex_t previousroot = _root;
+  NodeRecycler<basegraph> previousrecycler(recycler);
+  recycler.clear();
+  if (!GameTreeSnapshot<basegraph>::load(
+      in, boost::bind(&GameTree::restoreNode, this, _1, _2))) {
+    thetree.swap(previoustree);
+    _root = previousroot;
+    recycler = previousrecycler;
+    return false;
+  }
+  return true;
+}
+/// Create one node from the record of snapshot and connect it to the parent
+///@param parent is the parental node or null_vertex if the record is root
+///@param record is the record of snapshot for the new node
+///@return the newly created node
+GameTree::vertex_t GameTree::restoreNode(
+    vertex_t parent, const GameTreeSnapshot<basegraph>::NodeRecord& record) {
+  vertex_t node = addNode(record.position, record.color);
+  get(vertex_value, thetree, node).get()->updateAll(
+      AbstractUTCPolicy_visitcount, record.visitcount, 0,
+      AbstractUTCPolicy_wincount, record.wincount, 0);
+  if (parent == graph_traits<basegraph>::null_vertex())
+    _root = node;
+  else
+    addEdge(parent, node);
+  return node;
+}
 //if level = -1, then will do back-propagate up to the root, starting from current level = 0
 /// Back propagate the play-out phase result till to the level specified
 ///@param leaf is the leaf node or starting node from which a back propagation will be executed
@@ -171,24 +225,6 @@ void GameTree::backpropagate(vertex_t leaf, int value, int level) {
       break;
   }
 }
-//update name
-/// Update node name
-///@param node is the node whose name will be updated
-///@return NONE
-void GameTree::updateNodeName(vertex_t node) {
-  stringstream namebuffer;
-  namebuffer << get(vertex_index, thetree, node);
-  namebuffer << "@";
-  namebuffer << get(vertex_position, thetree, node);
-  namebuffer << ":";
-  if (get(vertex_color, thetree, node) == black_color)
-    namebuffer << 'B';
-  else if (get(vertex_color, thetree, node) == red_color)
-    namebuffer << 'R';
-  else
-    namebuffer << 'W';
-  put(vertex_name, thetree, node, namebuffer.str());
-}
 //update value
 /// Update node value
 ///@param node is the node whose UTCPolicy value will be updated
@@ -253,6 +289,74 @@ void GameTree::updateNodefromSimulation(int indexofnode, int winner, int level)
         AbstractUTCPolicy_wincount, 0, 0);
   backpropagate(node, value, level);
 }
+/// Add virtual visits to the given node and its ancestors up to root while the simulated game of the node is played out by
+/// another thread. A virtual visit counts as a game lost by the player choosing the node, i.e. a visit without win for the
+/// nodes of AI player and a visit with an AI win for the minimizing nodes of the root color, so the selection of the other
+/// simulated games in flight is steered away from the path at every level; it should be removed by the negative increment
+/// before the result is back-propagated
+///@param indexofnode is the index of node from which the simulated game is played out
+///@param increment is the number of virtual visits to add, negative to remove them
+///@return NONE
+void GameTree::updateVirtualVisits(int indexofnode, int increment) {
+  vertex_t node = vertex(indexofnode, thetree);
+  for (;;) {
+    if (get(vertex_color, thetree, node) == get(vertex_color, thetree, _root))  //a minimizing node
+      get(vertex_value, thetree, node).get()->updateAll(
+          AbstractUTCPolicy_visitcount, 0, increment,
+          AbstractUTCPolicy_wincount, 0, -increment);
+    else
+      get(vertex_value, thetree, node).get()->update(
+          AbstractUTCPolicy_visitcount, 0, increment);
+    if (node == _root)
+      break;
+    in_edge_iter viter, viterend;
+    tie(viter, viterend) = in_edges(node, thetree);
+    assert(viter != viterend);
+    node = source(*viter, thetree);
+  }
+}
+/// Update the all-moves-as-first (AMAF) statistics by the result of a simulated game. For every node on the path from the
+/// given node to root, each child whose move is played by the same player anywhere later in the simulated game is counted
+/// as if the move were played first, hence one play-out updates the statistics of many siblings along the path. The AMAF
+/// winning count follows the sign of winning count, i.e. positive for the nodes of AI player and negative for the others
+///@param indexofnode is the index of node from which the simulated game is played out, e.g. the expanded node
+///@param winner is the play result of play-out phase. Positive if AI player wins
+///@param state is the game state at the end of play-out phase which holds all moves of the simulated game
+///@return NONE
+void GameTree::updateAmaffromSimulation(int indexofnode, int winner,
+                                        DescentState& state) {
+  amafowners.assign(state.getSizeofVertices() + 1, 0);
+  vector<int>& babywatsons = state.getBabywatsons();
+  vector<int>& opponents = state.getOpponents();
+  for (size_t i = 0; i < babywatsons.size(); ++i)
+    if (babywatsons[i] > 0)  //zero for no move left on board
+      amafowners[babywatsons[i]] = 1;
+  for (size_t i = 0; i < opponents.size(); ++i)
+    if (opponents[i] > 0)
+      amafowners[opponents[i]] = -1;
+
+  default_color_type rootcolor = get(vertex_color, thetree, _root);
+  in_edge_iter initer, initerend;
+  out_edge_iter viter, viterend;
+  for (vertex_t node = vertex(indexofnode, thetree);;) {
+    for (tie(viter, viterend) = out_edges(node, thetree); viter != viterend;
+        ++viter) {
+      vertex_t child = target(*viter, thetree);
+      signed char owner = (get(vertex_color, thetree, child) != rootcolor) ? 1 : -1;
+      if (amafowners[get(vertex_position, thetree, child)] != owner)
+        continue;
+      get(vertex_value, thetree, child)->update(AbstractUTCPolicy_amafvisitcount,
+                                                0, 1);
+      if (winner > 0)
+        get(vertex_value, thetree, child)->update(AbstractUTCPolicy_amafwincount,
+                                                  0, owner);
+    }
+    if (node == _root)
+      break;
+    tie(initer, initerend) = in_edges(node, thetree);
+    node = source(*initer, thetree);
+  }
+}
 /// Expand a new node from given source node and update its position and color information
 ///@param indexofsource is the index of source node from which a new node will be expanded
 ///@param move is the position on hex board for the new expanded node
@@ -262,6 +366,9 @@ int GameTree::expandNode(int indexofsource, int move, char color) {
   vertex_t source = vertex(indexofsource, thetree);
   int indexofchild = -1;
 
+  //keep the tree under the node budget
+  recycler.recycle(thetree, _root, source, AlwaysPrunable());
+
   //adding the different color from the parental node
   vertex_t target;
   if (get(vertex_color, thetree, source) == red_color)
@@ -277,55 +384,120 @@ int GameTree::expandNode(int indexofsource, int move, char color) {
   assert(indexofchild > 0);
   return indexofchild;
 }
+/// Expand a new node from given source node with the next move taken from the untried moves of source node and apply the
+/// move to the state. The untried moves are generated from the state when the source node is expanded at the first time,
+/// so the expansion does not reconstruct the game history from the tree
+///@param indexofsource is the index of source node from which a new node will be expanded
+///@param state is the game state of source node, i.e. advanced by selectMaxBalanceNode(int, bool, DescentState&)
+///@return the index of the new expanded node
+int GameTree::expandNode(int indexofsource, DescentState& state) {
+  int move = popUntriedMove(vertex(indexofsource, thetree), state);
+  int indexofchild = expandNode(indexofsource, move, 'W');
+  applyMove(vertex(indexofchild, thetree), state);
+  return indexofchild;
+}
+/// Take the move with the highest prior out of the untried moves of given node. The untried moves are generated from the
+/// candidates of the state excluding the moves of existing children when the list is empty, e.g. the first expansion or
+/// some children were recycled, and ordered by the prior of state with ties in random order. The memory of list is released
+/// when all moves are taken
+///@param node is the node to be expanded
+///@param state is the game state of the node
+///@return the position of move on hex board
+int GameTree::popUntriedMove(vertex_t node, DescentState& state) {
+  vector<boost::uint16_t>& untried = get(vertex_untried, thetree)[node];
+  if (untried.empty()) {
+    for (int i = 1; i <= state.getSizeofVertices(); ++i)
+      if (state.isCandidate(i))
+        untried.push_back(static_cast<boost::uint16_t>(i));
+    out_edge_iter viter, viterend;
+    for (tie(viter, viterend) = out_edges(node, thetree); viter != viterend;
+        ++viter)
+      untried.erase(
+          remove(untried.begin(), untried.end(),
+                 get(vertex_position, thetree, target(*viter, thetree))),
+          untried.end());
+    //shuffle to break the ties of prior at random, then the move with the highest prior is popped first
+    for (size_t i = untried.size(); i > 1; --i)
+      swap(untried[i - 1], untried[generator.nextIndex(i)]);
+    state.orderByPrior(untried);
+  }
+  assert(!untried.empty());
+  int move = untried.back();
+  untried.pop_back();
+  if (untried.empty())
+    vector<boost::uint16_t>().swap(untried);
+  return move;
+}
+/// Apply the move of given node to the state. The move belongs to AI player if the color of node is different from root
+///@param node is the node whose move is applied
+///@param state is the game state
+///@return NONE
+void GameTree::applyMove(vertex_t node, DescentState& state) {
+  state.play(static_cast<int>(get(vertex_position, thetree, node)),
+             get(vertex_color, thetree, node) != get(vertex_color, thetree, _root));
+}
 //called in MCST selection phase
 /// Select the node with the maximal UTC value
 ///@param currentempty is the left empty position on the hex board in actual game state
 ///@param isbreaktie is the boolean variable which indicates if should break tie by random choice.
 ///@return a pair of integer and size_t. The first in pair is the index of selected node with maximal UTC value. The second is the level or depth at which the selected node locates.
 pair<int,size_t> GameTree::selectMaxBalanceNode(int currentempty, bool isbreaktie) {
+  return descend(currentempty, isbreaktie, NULL);
+}
+/// Select the node with the maximal UTC value and apply the moves of the nodes on the selected path to the state, hence
+/// the state is the game state of the selected node when returned
+///@param currentempty is the left empty position on the hex board in actual game state
+///@param isbreaktie is the boolean variable which indicates if should break tie by random choice.
+///@param state is the game state starting from the actual game state which will be advanced along the selected path
+///@return a pair of integer and size_t. The first in pair is the index of selected node with maximal UTC value. The second is the level or depth at which the selected node locates.
+pair<int, size_t> GameTree::selectMaxBalanceNode(int currentempty,
+                                                 bool isbreaktie,
+                                                 DescentState& state) {
+  return descend(currentempty, isbreaktie, &state);
+}
+/// Descend from root by choosing the child with the maximal UTC value till reaching the node to be expanded
+///@param currentempty is the left empty position on the hex board in actual game state
+///@param isbreaktie is the boolean variable which indicates if should break tie by random choice.
+///@param state is the game state which the moves of path are applied to, or NULL if not needed
+///@return a pair of integer and size_t. The first in pair is the index of selected node with maximal UTC value. The second is the level or depth at which the selected node locates.
+pair<int, size_t> GameTree::descend(int currentempty, bool isbreaktie,
+                                    DescentState* state) {
   vertex_t parent = _root;
   out_edge_iter viter, viterend;
   size_t numofchildren = out_degree(parent, thetree);
 
   int level = 0;
-
-#if __cplusplus > 199711L
-  default_random_engine generator(
-      static_cast<unsigned>(hexgame::chrono::system_clock::now()
-          .time_since_epoch().count()));
-  uniform_real_distribution<double> distribution(0.0, 1.0);
-#else
-  srand(static_cast<unsigned>(time(NULL)));
-#endif
   while (numofchildren != 0) {  //reach leaf
     //test if the current examining node is fully expanded, if yes then return its child; otherwise, return the current node for expansion
     assert((currentempty - level) > 0);  //currentempty - level = 0 indicates the end of game
-    if (static_cast<int>(numofchildren) < currentempty - level)
+    //the nodes of GameTree always hold UTCPolicy, hence no virtual dispatch for the children
+    UTCPolicy* policyofparent = static_cast<UTCPolicy*>(get(vertex_value,
+                                                            thetree, parent)
+        .get());
+    //with progressive widening, the node is fully expanded once it has as many children as its visit count allows. The
+    //moves of node are the candidates of state if given, which exclude the inferior moves
+    int numofmoves = (state != NULL) ? state->getNumofCandidates() : currentempty - level;
+    if (static_cast<int>(numofchildren)
+        < widening.getWidth(policyofparent->feature(AbstractUTCPolicy_visitcount),
+                            numofmoves))
       break;
 
-    PriorityQueue<vertex_t, double> vertexchooser(numofchildren);
+    double explorationofparent = UTCTable::explorationTerm(
+        policyofparent->getCoefficient(),
+        policyofparent->feature(AbstractUTCPolicy_visitcount));
+    vertexchooser.clear();
     for (tie(viter, viterend) = out_edges(parent, thetree); viter != viterend;
         ++viter) {
       vertex_t node = target(*viter, thetree);
-      double value = -get(vertex_value, thetree, node).get()->calculate(
-          (*get(vertex_value, thetree, parent)));
-      if (isbreaktie && vertexchooser.containsPriority(value)) {  // break the tie
-
-#if __cplusplus > 199711L
-        double prob = distribution(generator);
-#else
-        double prob = (float) rand() / RAND_MAX;
-#endif
-
-        if (prob < 0.5)
-          value -= prob / 100.0;
-        else
-          value += prob / 100.0;
-      }
-      vertexchooser.insert(node, value);
+      vertexchooser.insert(
+          node,
+          static_cast<UTCPolicy*>(get(vertex_value, thetree, node).get())
+              ->calculate(explorationofparent, raveequivalence));
     }
-    parent = vertexchooser.minPrioirty();
+    parent = vertexchooser.chooseMax(isbreaktie);
     numofchildren = out_degree(parent, thetree);
+    if (state != NULL)
+      applyMove(parent, *state);
 
     ++level;
   }
@@ -336,21 +508,18 @@ pair<int,size_t> GameTree::selectMaxBalanceNode(int currentempty, bool isbreakti
 ///@return a pair of integer and double. The first is the position on the hex board; while the second is the maximal UTC value calculated.
 pair<int, double> GameTree::getBestMovefromSimulation() {
   //1. examine all children nodes below the root node
-  size_t numofchildren = out_degree(_root, thetree);
-  assert(numofchildren != 0);
-  PriorityQueue<vertex_t, double> vertexchooser(numofchildren);
+  assert(out_degree(_root, thetree) != 0);
+  vertexchooser.clear();
   out_edge_iter viter, viterend;
   for (tie(viter, viterend) = out_edges(_root, thetree); viter != viterend;
       ++viter) {
     vertex_t node = target(*viter, thetree);
-    vertexchooser.insert(node,
-                         -get(vertex_value, thetree, node).get()->estimate());
+    vertexchooser.insert(node, get(vertex_value, thetree, node).get()->estimate());
   }
-  //2. choose the maximal value from all children nodes of root.
-  int indexofbestmove = vertexchooser.minPrioirty();
-  double maxvalue = get(vertex_value, thetree,
-                        get(vertex_index, thetree, indexofbestmove)).get()
-      ->getValue();
+  //2. choose the maximal value from all children nodes of root, the first expanded one among the ties
+  size_t chosen = vertexchooser.argmax(false);
+  int indexofbestmove = vertexchooser.getCandidate(chosen);
+  double maxvalue = vertexchooser.getScore(chosen);
   assert(indexofbestmove > 0);
   assert(maxvalue >= 0.0);
   return make_pair(indexofbestmove, maxvalue);
@@ -441,6 +610,7 @@ void GameTree::clearAll() {
     rootscolor = 'B';
   int indexofroot = get(vertex_index, thetree, _root);
   thetree.clear();
+  recycler.clear();
   vertex_t root = addNode(indexofroot, rootscolor);
   _root = root;
 }
@@ -448,14 +618,14 @@ void GameTree::clearAll() {
 ///@param NONE
 ///@return the total size of nodes
 size_t GameTree::getSizeofNodes() {
-  return num_vertices(thetree);
+  return num_vertices(thetree) - recycler.getSizeofFreeNodes();
 }
 /// Get the total size of edges
 ///@param NONE
 ///@return the total size of edges
 size_t GameTree::getSizeofEdges() {
   size_t numofedges = num_edges(thetree);
-  assert(numofedges == num_vertices(thetree) - 1);
+  assert(numofedges == getSizeofNodes() - 1);
   return numofedges;
 }
 /// Get the depth of a given node
@@ -483,7 +653,6 @@ size_t GameTree::getNodeDepth(int indexofnode) {
 void GameTree::setNodePosition(size_t indexofnode, size_t position) {
   vertex_t node = vertex(indexofnode, thetree);
   updateNodePosition(node, position);
-  updateNodeName(node);
 }
 /// Get the siblings of a given node
 ///@param indexofnode is the index of node whose indices of siblings will be returned
@@ -502,6 +671,19 @@ vector<size_t> GameTree::getSiblings(size_t indexofnode) {
   }
   return vector<size_t>(siblings);
 }
+/// Get the children of a given node
+///@param indexofnode is the index of node whose children will be returned
+///@return the indices of children in the order of expansion
+vector<size_t> GameTree::getChildren(size_t indexofnode) {
+  vertex_t node = vertex(indexofnode, thetree);
+  vector<size_t> children;
+  children.reserve(out_degree(node, thetree));
+  out_edge_iter viter, viterend;
+  for (tie(viter, viterend) = out_edges(node, thetree); viter != viterend;
+      ++viter)
+    children.push_back(get(vertex_index, thetree, target(*viter, thetree)));
+  return children;
+}
 /// Get parent of a given node
 ///@param node is the node whose parent will be returned
 ///@return the parental node
@@ -520,6 +702,7 @@ GameTree::vertex_t GameTree::getParent(vertex_t node) {
 ///@param indexofroot is the index which will be assigned to new root node
 ///@return NONE
 void GameTree::initGameTree(char playerscolor, size_t indexofroot) {
+  raveequivalence = 0.0;
   //set the root's color label as opponent's color label
   char rootscolor = 'W';
   if (playerscolor == 'R')
@@ -536,3 +719,41 @@ size_t GameTree::getNumofChildren(size_t indexofnode) {
   vertex_t parent = vertex(indexofnode, thetree);
   return (out_degree(parent, thetree));
 }
+/// Set the maximal number of nodes kept in the tree. When the budget is reached, the subtrees of the least visited nodes are pruned and their nodes are reused by the following expansions. See NodeRecycler
+///@param numofnodes is the maximal number of nodes, 0 for unlimited
+///@return NONE
+void GameTree::setMaxNumofNodes(size_t numofnodes) {
+  recycler.setMaxNumofNodes(numofnodes);
+}
+/// Get the maximal number of nodes kept in the tree
+///@param NONE
+///@return the maximal number of nodes, 0 for unlimited
+size_t GameTree::getMaxNumofNodes() {
+  return recycler.getMaxNumofNodes();
+}
+/// Set the schedule of progressive widening. A node is expanded till the number of its children reaches the width allowed
+/// by its visit count before selection descends into its children. See ProgressiveWidening
+///@param schedule is the schedule of progressive widening, the default constructed one disables widening
+///@return NONE
+void GameTree::setProgressiveWidening(const ProgressiveWidening& schedule) {
+  widening = schedule;
+}
+/// Get the schedule of progressive widening
+///@param NONE
+///@return the schedule of progressive widening
+ProgressiveWidening GameTree::getProgressiveWidening() {
+  return widening;
+}
+/// Set the equivalence parameter of RAVE. The AMAF winning rate is blended into the UTC value in selection phase with the
+/// weight sqrt(equivalence / (3 * visitcount + equivalence)). See UTCPolicy::calculate(double, double)
+///@param equivalence is the equivalence parameter, 0 to disable RAVE
+///@return NONE
+void GameTree::setRaveEquivalence(double equivalence) {
+  raveequivalence = equivalence;
+}
+/// Get the equivalence parameter of RAVE
+///@param NONE
+///@return the equivalence parameter, 0 if RAVE is disabled
+double GameTree::getRaveEquivalence() {
+  return raveequivalence;
+}
@@ -7,14 +7,65 @@
 #ifndef GAMETREE_H_
 #define GAMETREE_H_
 
+#include "FastRandom.h"
+#include "ArgMaxChooser.h"
+#include "NodeRecycler.h"
+#include "GameTreeSnapshot.h"
 #include "AbstractGameTree.h"
 
 #include <cmath>
+#include <cassert>
 #include <iterator>
 
+/**
+ * UTCTable class provides the precomputed natural logarithm and inverse square root of small visit counts for the UTC
+ * calculation in selection phase. The visit counts beyond the table fall back to the standard math functions.<br/>
+ * Sample Usage:<br/>
+ * double exploration = UTCTable::explorationTerm(coefficient, visitcountofparent);<br/>
+ * double balance = value + exploration * UTCTable::invsqrt(visitcount);<br/>
+ */
+class UTCTable {
+ public:
+  static const int SIZEOFTABLE = 4096;  ///< the visit counts smaller than this size are looked up from the tables
+
+  ///Get the natural logarithm of visit count
+  ///@param visitcount is the visit count of node
+  ///@return ln(visitcount)
+  static double log(int visitcount) {
+    if (visitcount >= 0 && visitcount < SIZEOFTABLE)
+      return logtable[visitcount];
+    return std::log(static_cast<double>(visitcount));
+  }
+  ///Get the inverse square root of visit count
+  ///@param visitcount is the visit count of node
+  ///@return 1/sqrt(visitcount)
+  static double invsqrt(int visitcount) {
+    if (visitcount >= 0 && visitcount < SIZEOFTABLE)
+      return invsqrttable[visitcount];
+    return 1.0 / std::sqrt(static_cast<double>(visitcount));
+  }
+  ///Get the exploration term of parent which is shared by all its children and computed once per selection level
+  ///@param coefficient is the constant of UTC policy to balance exploration and exploitation
+  ///@param visitcountofparent is the visit count of parent
+  ///@return sqrt(coefficient * ln(visitcountofparent))
+  static double explorationTerm(double coefficient, int visitcountofparent) {
+    return std::sqrt(coefficient * log(visitcountofparent));
+  }
+
+ private:
+  static double logtable[SIZEOFTABLE];  ///< ln(i) for i in [0, SIZEOFTABLE)
+  static double invsqrttable[SIZEOFTABLE];  ///< 1/sqrt(i) for i in [0, SIZEOFTABLE)
+  static const bool isinitialized;  ///< the tables are filled during static initialization
+
+  //Fill the tables
+  static bool initTables();
+};
 //TODO template for featureholder
 /**
  * UTCPolicy class is used to provide implementations for UTC Policy calculation <br/>
+ * Besides visit count and winning count of the node, the policy keeps the all-moves-as-first (AMAF) visit count and winning
+ * count, i.e. the statistics of the simulated games in which the move of node is played later by the same player, which
+ * are blended into the UTC value by RAVE (Rapid Action Value Estimation) <br/>
  * UTCPolicy(): is parameterless default constructor which initialize data members <br/>
  */
 class UTCPolicy: public AbstractUTCPolicy{
@@ -31,7 +82,7 @@ class UTCPolicy: public AbstractUTCPolicy{
       : value(0.0),
         balance(value),
         coefficient(2.0),
-        numoffeatures(2),
+        numoffeatures(4),
         featureholder(std::vector<int>(numoffeatures)) {
     std::fill(featureholder.begin(), featureholder.end(), 0);
   }
@@ -56,6 +107,45 @@ class UTCPolicy: public AbstractUTCPolicy{
   double estimate();
   //Calculate the UTC value
   double calculate(AbstractUTCPolicy& parent);
+  ///Calculate the UTC value with the exploration term of parent computed by UTCTable::explorationTerm. This non-virtual
+  ///version is used in selection phase, so the parent term is computed once for all children
+  ///@param explorationofparent is the exploration term of parent
+  ///@return the calculated balance according the UTC Policy
+  double calculate(double explorationofparent) {
+    assert(featureholder[visitcount] > 0);
+    value = static_cast<double>(featureholder[wincount])
+        / static_cast<double>(featureholder[visitcount]);
+    balance = value
+        + explorationofparent * UTCTable::invsqrt(featureholder[visitcount]);
+    return balance;
+  }
+  ///Calculate the UTC value with the winning rate blended with AMAF winning rate by RAVE. The weight of AMAF winning rate
+  ///is beta = sqrt(equivalence / (3 * visitcount + equivalence)) which decreases as the node is visited more, and the
+  ///equivalence is the visit count at which both winning rates are equally weighted
+  ///@param explorationofparent is the exploration term of parent
+  ///@param equivalence is the equivalence parameter of RAVE, non-positive to disable RAVE
+  ///@return the calculated balance according the UTC Policy
+  double calculate(double explorationofparent, double equivalence) {
+    if (equivalence <= 0.0 || featureholder[amafvisitcount] == 0)
+      return calculate(explorationofparent);
+    assert(featureholder[visitcount] > 0);
+    double winrate = static_cast<double>(featureholder[wincount])
+        / static_cast<double>(featureholder[visitcount]);
+    double amafwinrate = static_cast<double>(featureholder[amafwincount])
+        / static_cast<double>(featureholder[amafvisitcount]);
+    double beta = std::sqrt(
+        equivalence / (3.0 * featureholder[visitcount] + equivalence));
+    value = (1.0 - beta) * winrate + beta * amafwinrate;
+    balance = value
+        + explorationofparent * UTCTable::invsqrt(featureholder[visitcount]);
+    return balance;
+  }
+  ///Get the constant to balance exploration and exploitation
+  ///@param NONE
+  ///@return the coefficient of UTC policy
+  double getCoefficient() const {
+    return coefficient;
+  }
   //Update the value for a given feature
   bool update(valuekind indexofkind, int value, int increment = 0);
   //Update the value for all features
@@ -84,6 +174,12 @@ class GameTree: public AbstractGameTree{
  private:
   basegraph thetree; ///< boost adjacency list which is the underlying graph structure implementation and is alternative defined as basegraph in AbstractGameTree
   vertex_t _root; ///< root node of game tree
+  NodeRecycler<basegraph> recycler; ///< node budget and free list of recycled vertices
+  ArgMaxChooser vertexchooser; ///< scratch arrays of children and their scores reused in every selection level
+  FastRandom generator; ///< generator to shuffle the untried moves for expansion
+  ProgressiveWidening widening; ///< the schedule bounding the number of children by visit count, disabled by default
+  double raveequivalence; ///< the equivalence parameter of RAVE, 0 (disabled) by default
+  std::vector<signed char> amafowners; ///< scratch owners of hexgons in a simulated game, 1 for AI player and -1 for opponent
 
 #ifndef NDEBUG
   friend class LockableGameTree;
@@ -96,9 +192,6 @@ class GameTree: public AbstractGameTree{
   vertex_t getParent(vertex_t node);
   //Add the edge between source node and target node
   bool addEdge(vertex_t source, vertex_t target);
-  //void updateNodeName(vertex_t node, std::size_t positionofchild, char color); //TODO modify this, enforce to update node color and position before update node name
-  //Update name of given node
-  void updateNodeName(vertex_t node);
   //Update the value of a given node
   void updateNodeValue(vertex_t node);
   //Update the color of a given node
@@ -109,6 +202,16 @@ class GameTree: public AbstractGameTree{
   virtual void initGameTree(char playerscolor, size_t indexofroot);
   //Propagate the calculation from the leaf up to the root
   void backpropagate(vertex_t leaf, int value, int level);
+  //Descend from root to the node to be expanded and apply the moves of the path to the state if given
+  std::pair<int, std::size_t> descend(int currentempty, bool isbreaktie,
+                                      DescentState* state);
+  //Take the move with the highest prior out of the untried moves of given node
+  int popUntriedMove(vertex_t node, DescentState& state);
+  //Apply the move of given node to the state
+  void applyMove(vertex_t node, DescentState& state);
+  //Create one node from the record of snapshot and connect it to the parent
+  vertex_t restoreNode(vertex_t parent,
+                       const GameTreeSnapshot<basegraph>::NodeRecord& record);
   ///Getter to return the root node
   vertex_t getRoot() const {
     return _root;
@@ -148,7 +251,9 @@ class GameTree: public AbstractGameTree{
     ///@return NONE
     template<typename Node, typename Tree>
     void inorder(Node n, Tree& t) {
-      *_bufiter++ = get(boost::vertex_name, t)[n]
+      *_bufiter++ = getNodeLabel(get(boost::vertex_index, t)[n],
+                                 get(boost::vertex_position, t)[n],
+                                 get(boost::vertex_color, t)[n])
           + get(boost::vertex_value, t)[n].get()->print();
     }
     ///specify an action for inorder traversal
@@ -184,11 +289,17 @@ class GameTree: public AbstractGameTree{
   std::size_t getNodePosition(std::size_t indexofnode);
   //Get the siblings of a node given the index of node
   std::vector<std::size_t> getSiblings(std::size_t indexofnode);
+  //Get the children of a node given the index of node
+  std::vector<std::size_t> getChildren(std::size_t indexofnode);
   //Set the position of board given the index of node
   void setNodePosition(std::size_t indexofnode, std::size_t position);
 
   ///Print out the tree
   std::string printGameTree(int key);
+  //Write the game tree as a compact binary snapshot
+  bool saveGameTree(std::ostream& out);
+  //Replace the game tree with the one read from a binary snapshot
+  bool loadGameTree(std::istream& in);
   //for tree utility
   //Clear out the nodes and edge
   void clearAll();
@@ -198,10 +309,21 @@ class GameTree: public AbstractGameTree{
   //for simulation
   //Update play-out simulation result for the given index of node called in Monte Carlo Tree Search back-propagation phase
   void updateNodefromSimulation(int indexofnode, int winner, int level = -1);
+  //update the AMAF statistics of the children along the path from given node to root
+  void updateAmaffromSimulation(int indexofnode, int winner,
+                                DescentState& state);
+  //add virtual visits to the given node and its ancestors while its simulated game is in flight
+  void updateVirtualVisits(int indexofnode, int increment);
   //Select the best move with maximal winning rate from the children nodes of the root after a round of play-out simulation
   std::pair<int, double> getBestMovefromSimulation();
   //select the node with the maximal UTC value called in Monte Carlo Tree Search selection phase
   std::pair<int, std::size_t> selectMaxBalanceNode(int currentempty, bool isbreaktie = true);
+  //select the node with the maximal UTC value and apply the moves of the path to the state
+  std::pair<int, std::size_t> selectMaxBalanceNode(int currentempty,
+                                                   bool isbreaktie,
+                                                   DescentState& state);
+  //Expand one node from given node with a move taken from its untried moves and apply the move to the state
+  int expandNode(int indexofsource, DescentState& state);
   //Get the moves from the given the index of node to root in order to construct the game history from game tree
   void getMovesfromTreeState(
       int indexofnode, std::vector<int>& babywatsons, std::vector<int>& opponents,
@@ -211,6 +333,18 @@ class GameTree: public AbstractGameTree{
   int getNodeValueFeature(int indexofnode, AbstractUTCPolicy::valuekind indexofkind);
   //Get the number of children for a given index of node
   std::size_t getNumofChildren(std::size_t indexofnode);
+  //Set the maximal number of nodes kept in the tree
+  void setMaxNumofNodes(std::size_t numofnodes);
+  //Get the maximal number of nodes kept in the tree
+  std::size_t getMaxNumofNodes();
+  //Set the schedule of progressive widening
+  void setProgressiveWidening(const ProgressiveWidening& schedule);
+  //Get the schedule of progressive widening
+  ProgressiveWidening getProgressiveWidening();
+  //Set the equivalence parameter of RAVE
+  void setRaveEquivalence(double equivalence);
+  //Get the equivalence parameter of RAVE
+  double getRaveEquivalence();
   //Return the meaningful class name as "GameTree"
   std::string name() {
     return std::string("GameTree");
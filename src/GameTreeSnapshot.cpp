@@ -0,0 +1,126 @@
+/*
+ * GameTreeSnapshot.cpp
+ * This file defines the implementation of GameTreeSnapshot template class
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include <cstring>
+
+template<class Graph>
+const boost::uint32_t GameTreeSnapshot<Graph>::VERSION;
+template<class Graph>
+const std::size_t GameTreeSnapshot<Graph>::SIZEOFBUFFER;
+
+namespace {
+const char SNAPSHOTMAGIC[8] = "HEXTREE";
+}
+
+///Convert the color of node to color label
+///@param graph is the underlying graph of game tree
+///@param node is the node whose color label will be returned
+///@return 'R' for red, 'B' for blue (black) and 'W' for white
+template<class Graph>
+char GameTreeSnapshot<Graph>::getColorLabel(Graph& graph, vertex_t node) {
+  if (get(boost::vertex_color, graph, node) == boost::red_color)
+    return 'R';
+  else if (get(boost::vertex_color, graph, node) == boost::black_color)
+    return 'B';
+  return 'W';
+}
+///Write the subtree rooted at the given node in preorder. The children are written in the order of expansion
+///@param out is the binary output stream
+///@param graph is the underlying graph of game tree
+///@param root is the root of the subtree to be written
+///@param numofnodes is the number of nodes in the subtree which is written in header
+///@return TRUE if all records are written successfully
+template<class Graph>
+bool GameTreeSnapshot<Graph>::save(std::ostream& out, Graph& graph,
+                                   vertex_t root, std::size_t numofnodes) {
+  SnapshotHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, SNAPSHOTMAGIC, sizeof(SNAPSHOTMAGIC));
+  header.version = VERSION;
+  header.numofnodes = numofnodes;
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  std::vector<NodeRecord> records;
+  records.reserve(SIZEOFBUFFER);
+  std::vector<vertex_t> holder(1, root), children;
+  typename boost::graph_traits<Graph>::out_edge_iterator viter, viterend;
+  std::size_t numofwritten = 0;
+  while (!holder.empty() && out) {
+    vertex_t node = holder.back();
+    holder.pop_back();
+
+    NodeRecord record;
+    memset(&record, 0, sizeof(record));
+    record.position = static_cast<boost::uint32_t>(get(boost::vertex_position,
+                                                       graph, node));
+    record.visitcount = get(boost::vertex_value, graph, node)->feature(
+        AbstractUTCPolicy::visitcount);
+    record.wincount = get(boost::vertex_value, graph, node)->feature(
+        AbstractUTCPolicy::wincount);
+    record.numofchildren = static_cast<boost::uint16_t>(out_degree(node, graph));
+    record.color = getColorLabel(graph, node);
+    records.push_back(record);
+
+    //push the children reversely, so they are popped in the order of expansion
+    children.clear();
+    for (boost::tie(viter, viterend) = out_edges(node, graph); viter != viterend;
+        ++viter)
+      children.push_back(target(*viter, graph));
+    holder.insert(holder.end(), children.rbegin(), children.rend());
+
+    if (records.size() == SIZEOFBUFFER || holder.empty()) {
+      out.write(reinterpret_cast<const char*>(&records[0]),
+                records.size() * sizeof(NodeRecord));
+      numofwritten += records.size();
+      records.clear();
+    }
+  }
+  return !out.fail() && numofwritten == numofnodes;
+}
+///Read the snapshot and rebuild the tree. The builder is called once per record in preorder with the parent already
+///built (null_vertex for root) and should return the newly created node, which is expected to be connected to the parent
+///@param in is the binary input stream
+///@param builder is the functor, vertex_t builder(vertex_t parent, const NodeRecord& record), to create one node
+///@return TRUE if the header is valid and the records form exactly one tree. Otherwise FALSE and the nodes created so far
+///are left to the caller to discard
+template<class Graph>
+template<class NodeBuilder>
+bool GameTreeSnapshot<Graph>::load(std::istream& in, NodeBuilder builder) {
+  SnapshotHeader header;
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    return false;
+  if (memcmp(header.magic, SNAPSHOTMAGIC, sizeof(SNAPSHOTMAGIC)) != 0
+      || header.version != VERSION || header.numofnodes == 0)
+    return false;
+
+  //pairs of the node and the number of its children still to be read
+  std::vector<std::pair<vertex_t, std::size_t> > holder;
+  std::vector<NodeRecord> records(SIZEOFBUFFER);
+  boost::uint64_t numofread = 0;
+  while (numofread < header.numofnodes) {
+    std::size_t numofrecords = static_cast<std::size_t>(std::min<
+        boost::uint64_t>(SIZEOFBUFFER, header.numofnodes - numofread));
+    if (!in.read(reinterpret_cast<char*>(&records[0]),
+                 numofrecords * sizeof(NodeRecord)))
+      return false;
+    for (std::size_t i = 0; i < numofrecords; ++i, ++numofread) {
+      vertex_t parent = boost::graph_traits<Graph>::null_vertex();
+      if (numofread > 0) {
+        if (holder.empty())
+          return false;  //more records than the tree has
+        parent = holder.back().first;
+        if (--holder.back().second == 0)
+          holder.pop_back();
+      }
+      vertex_t node = builder(parent, records[i]);
+      if (records[i].numofchildren > 0)
+        holder.push_back(std::make_pair(node, records[i].numofchildren));
+    }
+  }
+  return holder.empty();
+}
@@ -0,0 +1,78 @@
+/*
+ * GameTreeSnapshot.h
+ * This file defines the compact binary snapshot of game tree shared by GameTree and LockableGameTree.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef GAMETREESNAPSHOT_H_
+#define GAMETREESNAPSHOT_H_
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <boost/cstdint.hpp>
+
+#include "AbstractGameTree.h"
+
+/**
+ * GameTreeSnapshot class is used to write and read a game tree as a compact binary stream.<br/>
+ * The stream consists of a 24-byte header followed by one 16-byte record per node in preorder: 32-bit board position,
+ * 32-bit visit count, 32-bit winning count, 16-bit number of children and 8-bit color label ('R', 'B' or 'W'). Since the
+ * number of children is kept in each record, the tree is rebuilt while reading without any lookup, and both directions
+ * go through a fixed size buffer of records, hence the stream is written and read at disk bandwidth. The integers are
+ * stored in the native byte order. Only the nodes reachable from root are written, so the vertices in the free list of
+ * NodeRecycler are dropped and the restored tree is compact.<br/>
+ * The template Graph is the boost adjacency list (vecS as vertex list and bidirectionalS) used by game tree.<br/>
+ * Sample Usage:<br/>
+ * GameTreeSnapshot<basegraph>::save(out, thetree, _root, getSizeofNodes());<br/>
+ * GameTreeSnapshot<basegraph>::load(in, boost::bind(&GameTree::restoreNode, this, _1, _2));<br/>
+ */
+template<class Graph>
+class GameTreeSnapshot {
+ public:
+  ///Define vertex type of the graph
+  typedef typename boost::graph_traits<Graph>::vertex_descriptor vertex_t;
+
+  /**
+   * NodeRecord is the on-stream record of one node
+   */
+  struct NodeRecord {
+    boost::uint32_t position;  ///< the position on hex board of the node
+    boost::int32_t visitcount;  ///< the visit count of UTC policy
+    boost::int32_t wincount;  ///< the winning count of UTC policy
+    boost::uint16_t numofchildren;  ///< the number of children following this record in preorder
+    char color;  ///< the color label of the node, 'R', 'B' or 'W'
+    char reserved;  ///< reserved for future use, should be zero
+  };
+  /**
+   * SnapshotHeader is the on-stream header of the snapshot
+   */
+  struct SnapshotHeader {
+    char magic[8];  ///< the magic string "HEXTREE" terminated by null character
+    boost::uint32_t version;  ///< the version of stream format
+    boost::uint32_t reserved;  ///< reserved for future use, should be zero
+    boost::uint64_t numofnodes;  ///< the number of node records following the header
+  };
+
+  static const boost::uint32_t VERSION = 1;  ///< current version of stream format
+  static const std::size_t SIZEOFBUFFER = 4096;  ///< the number of records buffered per read or write
+
+  //Write the subtree rooted at the given node
+  static bool save(std::ostream& out, Graph& graph, vertex_t root,
+                   std::size_t numofnodes);
+  //Read the snapshot and rebuild the tree through the given node builder
+  template<class NodeBuilder>
+  static bool load(std::istream& in, NodeBuilder builder);
+
+ private:
+  //Convert the color of node to color label
+  static char getColorLabel(Graph& graph, vertex_t node);
+};
+
+#include "GameTreeSnapshot.cpp"
+
+#endif /* GAMETREESNAPSHOT_H_ */
@@ -0,0 +1,433 @@
+/*
+ * HSearch.cpp
+ * This file defines the implementation of HSearch class
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "HSearch.h"
+
+#include <cassert>
+
+using namespace std;
+
+const size_t HSearch::MAXNUMOFFULLS;
+const size_t HSearch::MAXNUMOFSEMIS;
+
+///User defined constructor which takes the tables of board and the winning condition of the player
+///@param topology is the tables of board which should outlive the search
+///@param iswesttoeast is the winning condition of the player
+HSearch::HSearch(const BoardTopology& topology, bool iswesttoeast)
+    : topology(topology),
+      iswesttoeast(iswesttoeast),
+      numofvertices(topology.getNumofhexgons() * topology.getNumofhexgons()),
+      maxnumofconnections(200000),
+      timelimit(100),
+      numofconnections(0) {
+  colors.assign(numofvertices, 0);
+  parents.resize(numofvertices + 2);
+  for (int i = 0; i < numofvertices + 2; ++i)
+    parents[i] = i + 1;
+  partners.resize(numofvertices + 2);
+}
+///Compute the connections from scratch
+///@param colors is the owner of each hexgon indexed by position - 1, 1 for the player, -1 for the other player and 0 for empty
+///@return NONE
+void HSearch::build(const vector<signed char>& colors) {
+  assert(static_cast<int>(colors.size()) == numofvertices);
+  this->colors = colors;
+  connections.clear();
+  partners.assign(numofvertices + 2, hexgame::unordered_set<int>());
+  pendings.clear();
+  numofconnections = 0;
+  for (int i = 0; i < numofvertices + 2; ++i)
+    parents[i] = i + 1;
+
+  //merge the stones of player into groups together with the edges they touch
+  int edges[2] = { iswesttoeast ? BoardTopology::WEST : BoardTopology::NORTH,
+      iswesttoeast ? BoardTopology::EAST : BoardTopology::SOUTH };
+  for (int cell = 1; cell <= numofvertices; ++cell) {
+    if (colors[cell - 1] != 1)
+      continue;
+    const int* ring = topology.getRing(cell);
+    for (int k = 0; k < BoardTopology::SIZEOFRING; ++k)
+      if (ring[k] > 0 && colors[ring[k] - 1] == 1)
+        parents[find(ring[k]) - 1] = find(cell);
+    for (int e = 0; e < 2; ++e)
+      if (topology.isOnEdge(cell, edges[e]))
+        parents[find(getEdgePoint(e == 0)) - 1] = find(cell);
+  }
+  for (int cell = 1; cell <= numofvertices; ++cell)
+    if (colors[cell - 1] != -1)
+      addAdjacency(cell);
+  combine();
+}
+///Update the connections with a move. The connections whose carrier contains the move are dropped; a move of the player
+///merges the adjacent groups and edges, then the connections around the move are combined again
+///@param move is the position of hexgon starting from 1 which should be empty
+///@param isown is TRUE if the move is made by the player
+///@return NONE
+void HSearch::play(int move, bool isown) {
+  assert(colors[move - 1] == 0);
+  colors[move - 1] = isown ? 1 : -1;
+  pendings.clear();
+
+  vector<pair<int, int> > emptypairs;
+  for (hexgame::unordered_map<boost::uint64_t, ConnectionSet>::iterator iter =
+      connections.begin(); iter != connections.end(); ++iter) {
+    vector<Connection>* lists[2] = { &iter->second.fulls, &iter->second.semis };
+    for (int j = 0; j < 2; ++j)
+      for (size_t i = lists[j]->size(); i > 0; --i)
+        if ((*lists[j])[i - 1].carrier[move - 1]) {
+          lists[j]->erase(lists[j]->begin() + (i - 1));
+          --numofconnections;
+        }
+    if (iter->second.fulls.empty() && iter->second.semis.empty())
+      emptypairs.push_back(
+          make_pair(static_cast<int>(iter->first >> 32),
+                    static_cast<int>(iter->first & 0xFFFFFFFFULL)));
+  }
+  for (size_t i = 0; i < emptypairs.size(); ++i)
+    erasePair(emptypairs[i].first, emptypairs[i].second);
+
+  if (!isown) {
+    //the hexgon is a wall now
+    vector<int> others(partners[move - 1].begin(), partners[move - 1].end());
+    for (size_t i = 0; i < others.size(); ++i)
+      erasePair(move, others[i]);
+    combine();
+    return;
+  }
+
+  //collect the connections of the points merged into the new group
+  vector<int> merged(1, move);
+  const int* ring = topology.getRing(move);
+  for (int k = 0; k < BoardTopology::SIZEOFRING; ++k)
+    if (ring[k] > 0 && colors[ring[k] - 1] == 1)
+      merged.push_back(find(ring[k]));
+  int edges[2] = { iswesttoeast ? BoardTopology::WEST : BoardTopology::NORTH,
+      iswesttoeast ? BoardTopology::EAST : BoardTopology::SOUTH };
+  for (int e = 0; e < 2; ++e)
+    if (topology.isOnEdge(move, edges[e]))
+      merged.push_back(find(getEdgePoint(e == 0)));
+  vector<pair<int, ConnectionSet> > moved;
+  for (size_t i = 0; i < merged.size(); ++i) {
+    vector<int> others(partners[merged[i] - 1].begin(),
+                       partners[merged[i] - 1].end());
+    for (size_t j = 0; j < others.size(); ++j) {
+      moved.push_back(
+          make_pair(others[j],
+                    connections[getPairKey(merged[i], others[j])]));
+      erasePair(merged[i], others[j]);
+    }
+  }
+  for (size_t i = 1; i < merged.size(); ++i)
+    parents[find(merged[i]) - 1] = find(move);
+
+  int group = find(move);
+  for (size_t i = 0; i < moved.size(); ++i) {
+    int other = find(moved[i].first);
+    for (size_t j = 0; j < moved[i].second.fulls.size(); ++j)
+      addFull(group, other, moved[i].second.fulls[j].carrier);
+    for (size_t j = 0; j < moved[i].second.semis.size(); ++j)
+      addSemi(group, other, moved[i].second.semis[j].carrier,
+              moved[i].second.semis[j].key);
+  }
+  addAdjacency(move);
+  combine();
+}
+///Bring the connections up to date with the stones. The new stones are played one by one if every stone known by the search
+///is still on board, otherwise the connections are built from scratch
+///@param colors is the owner of each hexgon indexed by position - 1, 1 for the player, -1 for the other player and 0 for empty
+///@return NONE
+void HSearch::update(const vector<signed char>& colors) {
+  assert(static_cast<int>(colors.size()) == numofvertices);
+  bool isbuilt = !connections.empty();
+  for (int i = 0; i < numofvertices && isbuilt; ++i)
+    isbuilt = (this->colors[i] == 0 || this->colors[i] == colors[i]);
+  if (!isbuilt) {
+    build(colors);
+    return;
+  }
+  for (int i = 0; i < numofvertices; ++i)
+    if (this->colors[i] == 0 && colors[i] != 0)
+      play(i + 1, colors[i] == 1);
+}
+///Check if the edges of the player are fully connected, i.e. the player wins whoever moves next
+///@param NONE
+///@return TRUE if the edges are in the same group or have a full connection
+bool HSearch::isConnected() const {
+  int first = findConst(getEdgePoint(true)), second = findConst(
+      getEdgePoint(false));
+  if (first == second)
+    return true;
+  const vector<Connection>* fulls = getConnections(first, second, true);
+  return fulls != NULL && !fulls->empty();
+}
+///Get a move which wins by the connections of the player if the player moves next
+///@param NONE
+///@return the key of the smallest semi connection between the edges, a hexgon in the carrier of full connection, or 0 if the
+///player has no winning connection
+int HSearch::getWinningMove() const {
+  int first = findConst(getEdgePoint(true)), second = findConst(
+      getEdgePoint(false));
+  if (first == second)
+    return 0;
+  const vector<Connection>* fulls = getConnections(first, second, true);
+  if (fulls != NULL)
+    for (size_t i = 0; i < fulls->size(); ++i)
+      if ((*fulls)[i].carrier.any())
+        return static_cast<int>((*fulls)[i].carrier.find_first()) + 1;
+  const vector<Connection>* semis = getConnections(first, second, false);
+  if (semis == NULL || semis->empty())
+    return 0;
+  size_t smallest = 0;
+  for (size_t i = 1; i < semis->size(); ++i)
+    if ((*semis)[i].carrier.count() < (*semis)[smallest].carrier.count())
+      smallest = i;
+  return (*semis)[smallest].key;
+}
+///Get the hexgons where the other player must play to stop the semi connections between the edges of the player, i.e. the
+///common hexgons of their carriers
+///@param region is the container of the hexgons
+///@return TRUE if the player threatens to connect the edges and the region is not empty
+bool HSearch::getMustPlay(vector<int>& region) const {
+  region.clear();
+  if (isConnected())
+    return false;
+  const vector<Connection>* semis = getConnections(getEdgePoint(true),
+                                                   getEdgePoint(false), false);
+  if (semis == NULL || semis->empty())
+    return false;
+  Carrier common = (*semis)[0].carrier;
+  for (size_t i = 1; i < semis->size(); ++i)
+    common &= (*semis)[i].carrier;
+  for (size_t i = common.find_first(); i != Carrier::npos;
+      i = common.find_next(i))
+    region.push_back(static_cast<int>(i) + 1);
+  return !region.empty();
+}
+///Get the connections between two points
+///@param first is one point, i.e. the position of hexgon or the point of edge
+///@param second is the other point
+///@param isfull is TRUE for full connections and FALSE for semi connections
+///@return the pointer to connections or NULL if the points are not connected
+const vector<HSearch::Connection>* HSearch::getConnections(int first,
+                                                           int second,
+                                                           bool isfull) const {
+  hexgame::unordered_map<boost::uint64_t, ConnectionSet>::const_iterator iter =
+      connections.find(getPairKey(findConst(first), findConst(second)));
+  if (iter == connections.end())
+    return NULL;
+  return isfull ? &iter->second.fulls : &iter->second.semis;
+}
+///Get the key of a pair of points regardless of their order
+///@param first is one point
+///@param second is the other point
+///@return the key of pair
+boost::uint64_t HSearch::getPairKey(int first, int second) {
+  if (first > second)
+    swap(first, second);
+  return (static_cast<boost::uint64_t>(first) << 32)
+      | static_cast<boost::uint64_t>(second);
+}
+///Get the representative point of a group with path compression
+///@param point is the point
+///@return the representative point
+int HSearch::find(int point) {
+  int root = point;
+  while (parents[root - 1] != root)
+    root = parents[root - 1];
+  while (parents[point - 1] != root) {
+    int next = parents[point - 1];
+    parents[point - 1] = root;
+    point = next;
+  }
+  return root;
+}
+///Get the representative point of a group without path compression
+///@param point is the point
+///@return the representative point
+int HSearch::findConst(int point) const {
+  while (parents[point - 1] != point)
+    point = parents[point - 1];
+  return point;
+}
+///Check if the point is an empty hexgon
+///@param point is the point
+///@return TRUE if the point is an empty hexgon
+bool HSearch::isEmptyPoint(int point) const {
+  return point <= numofvertices && colors[point - 1] == 0;
+}
+///Add the full connections with empty carrier between the point of hexgon and its adjacent points
+///@param cell is the position of hexgon which is empty or a stone of the player
+///@return NONE
+void HSearch::addAdjacency(int cell) {
+  Carrier empty(numofvertices);
+  const int* ring = topology.getRing(cell);
+  for (int k = 0; k < BoardTopology::SIZEOFRING; ++k)
+    if (ring[k] > 0 && colors[ring[k] - 1] != -1)
+      addFull(find(cell), find(ring[k]), empty);
+  int edges[2] = { iswesttoeast ? BoardTopology::WEST : BoardTopology::NORTH,
+      iswesttoeast ? BoardTopology::EAST : BoardTopology::SOUTH };
+  for (int e = 0; e < 2; ++e)
+    if (topology.isOnEdge(cell, edges[e]))
+      addFull(find(cell), find(getEdgePoint(e == 0)), empty);
+}
+///Add a full connection unless a connection with smaller carrier exists. The connections with larger carrier are dropped
+///@param first is one point
+///@param second is the other point
+///@param carrier is the carrier of connection
+///@return TRUE if the connection is added
+bool HSearch::addFull(int first, int second, const Carrier& carrier) {
+  first = find(first);
+  second = find(second);
+  if (first == second || numofconnections >= maxnumofconnections)
+    return false;
+  boost::uint64_t key = getPairKey(first, second);
+  hexgame::unordered_map<boost::uint64_t, ConnectionSet>::iterator iter =
+      connections.find(key);
+  if (iter != connections.end()) {
+    vector<Connection>& fulls = iter->second.fulls;
+    for (size_t i = 0; i < fulls.size(); ++i)
+      if (fulls[i].carrier.is_subset_of(carrier))
+        return false;
+    for (size_t i = fulls.size(); i > 0; --i)
+      if (carrier.is_subset_of(fulls[i - 1].carrier)) {
+        fulls.erase(fulls.begin() + (i - 1));
+        --numofconnections;
+      }
+    if (fulls.size() >= MAXNUMOFFULLS)
+      return false;
+  } else
+    iter = connections.insert(make_pair(key, ConnectionSet())).first;
+  Connection connection = { carrier, 0 };
+  iter->second.fulls.push_back(connection);
+  ++numofconnections;
+  partners[first - 1].insert(second);
+  partners[second - 1].insert(first);
+  PendingConnection pending = { first, second, carrier };
+  pendings.push_back(pending);
+  return true;
+}
+///Add a semi connection unless a connection with smaller carrier exists, then apply OR rule: the semi connections whose
+///carriers have no common hexgon make a full connection
+///@param first is one point
+///@param second is the other point
+///@param carrier is the carrier of connection including the key
+///@param key is the hexgon to play
+///@return TRUE if the connection is added
+bool HSearch::addSemi(int first, int second, const Carrier& carrier,
+                      int key) {
+  first = find(first);
+  second = find(second);
+  if (first == second || numofconnections >= maxnumofconnections)
+    return false;
+  boost::uint64_t pairkey = getPairKey(first, second);
+  hexgame::unordered_map<boost::uint64_t, ConnectionSet>::iterator iter =
+      connections.find(pairkey);
+  if (iter != connections.end()) {
+    const vector<Connection>& fulls = iter->second.fulls;
+    for (size_t i = 0; i < fulls.size(); ++i)
+      if (fulls[i].carrier.is_subset_of(carrier))
+        return false;
+    vector<Connection>& semis = iter->second.semis;
+    for (size_t i = 0; i < semis.size(); ++i)
+      if (semis[i].carrier.is_subset_of(carrier))
+        return false;
+    for (size_t i = semis.size(); i > 0; --i)
+      if (carrier.is_subset_of(semis[i - 1].carrier)) {
+        semis.erase(semis.begin() + (i - 1));
+        --numofconnections;
+      }
+    if (semis.size() >= MAXNUMOFSEMIS)
+      return false;
+  } else
+    iter = connections.insert(make_pair(pairkey, ConnectionSet())).first;
+  Connection connection = { carrier, key };
+  iter->second.semis.push_back(connection);
+  ++numofconnections;
+  partners[first - 1].insert(second);
+  partners[second - 1].insert(first);
+
+  //OR rule, starting from the new semi connection
+  const vector<Connection>& semis = iter->second.semis;
+  Carrier common = carrier, unions = carrier;
+  for (size_t i = 0; i + 1 < semis.size(); ++i) {
+    Carrier intersection = common & semis[i].carrier;
+    if (intersection == common)
+      continue;
+    common = intersection;
+    unions |= semis[i].carrier;
+    if (common.none()) {
+      addFull(first, second, unions);
+      break;
+    }
+  }
+  return true;
+}
+///Remove the connections between a pair of points
+///@param first is one point
+///@param second is the other point
+///@return NONE
+void HSearch::erasePair(int first, int second) {
+  hexgame::unordered_map<boost::uint64_t, ConnectionSet>::iterator iter =
+      connections.find(getPairKey(first, second));
+  if (iter != connections.end()) {
+    numofconnections -= iter->second.fulls.size() + iter->second.semis.size();
+    connections.erase(iter);
+  }
+  partners[first - 1].erase(second);
+  partners[second - 1].erase(first);
+}
+///Apply AND rule to the pending full connections: two full connections with disjoint carriers through a common point make
+///a full connection if the point is a group or an edge, and a semi connection keyed by the point if it is empty
+///@param NONE
+///@return NONE
+void HSearch::combine() {
+  hexgame::chrono::steady_clock::time_point deadline =
+      hexgame::chrono::steady_clock::now()
+          + hexgame::chrono::milliseconds(timelimit);
+  size_t numofsteps = 0;
+  while (!pendings.empty()) {
+    if ((++numofsteps & 63) == 0
+        && hexgame::chrono::steady_clock::now() > deadline) {
+      pendings.clear();
+      break;
+    }
+    PendingConnection pending = pendings.front();
+    pendings.pop_front();
+    for (int side = 0; side < 2; ++side) {
+      int middle = find(side == 0 ? pending.first : pending.second);
+      int other = find(side == 0 ? pending.second : pending.first);
+      if (middle == other)
+        break;
+      bool isempty = isEmptyPoint(middle);
+      vector<int> thirds(partners[middle - 1].begin(),
+                         partners[middle - 1].end());
+      for (size_t i = 0; i < thirds.size(); ++i) {
+        int third = thirds[i];
+        if (third == other || (third <= numofvertices
+            && pending.carrier[third - 1]))
+          continue;
+        hexgame::unordered_map<boost::uint64_t, ConnectionSet>::iterator iter =
+            connections.find(getPairKey(middle, third));
+        if (iter == connections.end())
+          continue;
+        const vector<Connection>& fulls = iter->second.fulls;
+        for (size_t j = 0; j < fulls.size(); ++j) {
+          if (pending.carrier.intersects(fulls[j].carrier)
+              || (other <= numofvertices && fulls[j].carrier[other - 1]))
+            continue;
+          Carrier unions = pending.carrier | fulls[j].carrier;
+          if (isempty) {
+            unions.set(middle - 1);
+            addSemi(other, third, unions, middle);
+          } else
+            addFull(other, third, unions);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,151 @@
+/*
+ * HSearch.h
+ * This file declares the virtual connections of one player computed by H-search and maintained across moves.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef HSEARCH_H_
+#define HSEARCH_H_
+
+#include <deque>
+#include <vector>
+#include <utility>
+#include <boost/cstdint.hpp>
+#include <boost/dynamic_bitset.hpp>
+
+#include "Global.h"
+#include "BoardTopology.h"
+
+/**
+ * HSearch class is used to compute the virtual connections of one player by H-search.<br/>
+ * The points are the empty hexgons, the groups of stones of the player (represented by one stone of each group) and the two
+ * edges of the player; the stones of the other player are walls. A full connection between two points holds even if the
+ * other player moves first, as long as the player answers inside the carrier (a set of empty hexgons); a semi connection
+ * holds if the player moves first at its key. Adjacent points are fully connected with an empty carrier, then the AND rule
+ * combines two full connections with disjoint carriers through a common point (a full connection through a group, a semi
+ * connection keyed by the point if it is empty), and the OR rule combines semi connections whose carriers have no common
+ * hexgon into a full connection. A bridge is found as two semi connections through its carriers, an edge template as two
+ * semi connections through the edge.<br/>
+ * The connections are kept after a move except the ones whose carrier contains the move, and the groups joined by the move
+ * are merged, so only the connections around the move are combined again. The number of connections per pair of points,
+ * the total number of connections and the time of each update are bounded, hence the search might be incomplete but fits
+ * the time budget of move.<br/>
+ * HSearch(const BoardTopology& topology, bool iswesttoeast): user defined constructor which takes the tables of board and
+ * the winning condition of the player. The topology should outlive the search<br/>
+ * Sample Usage:<br/>
+ * HSearch connections(topology, player.getWestToEastCondition());<br/>
+ * connections.build(colors); //1 for the stones of player, -1 for the other player and 0 for empty<br/>
+ * connections.play(move, false); //or connections.update(colors) with the stones of current game state<br/>
+ * int winningmove = connections.getWinningMove();<br/>
+ */
+class HSearch {
+ public:
+  ///Define the set of hexgons indexed by position - 1
+  typedef boost::dynamic_bitset<boost::uint64_t> Carrier;
+  /**
+   * Connection is one virtual connection between two points
+   */
+  struct Connection {
+    Carrier carrier;  ///< the empty hexgons needed by the connection, including the key of semi connection
+    int key;  ///< the hexgon to play for semi connection, 0 for full connection
+  };
+
+  //User defined constructor which takes the tables of board and the winning condition of the player
+  HSearch(const BoardTopology& topology, bool iswesttoeast);
+  //Compute the connections from scratch
+  void build(const std::vector<signed char>& colors);
+  //Update the connections with a move
+  void play(int move, bool isown);
+  //Bring the connections up to date with the stones
+  void update(const std::vector<signed char>& colors);
+  //Check if the edges of the player are fully connected
+  bool isConnected() const;
+  //Get a move which wins by the connections of the player
+  int getWinningMove() const;
+  //Get the hexgons where the other player must play to stop the semi connections between the edges of the player
+  bool getMustPlay(std::vector<int>& region) const;
+  //Get the connections between two points
+  const std::vector<Connection>* getConnections(int first, int second,
+                                                bool isfull) const;
+  ///Set the bounds of search
+  ///@param maxnumofconnections is the maximal number of connections kept
+  ///@param timelimit is the maximal time of each build or play in milliseconds
+  ///@return NONE
+  void setLimits(std::size_t maxnumofconnections, int timelimit) {
+    this->maxnumofconnections = maxnumofconnections;
+    this->timelimit = timelimit;
+  }
+  ///Get the number of connections kept
+  ///@param NONE
+  ///@return the number of full and semi connections
+  std::size_t getNumofConnections() const {
+    return numofconnections;
+  }
+  ///Get the point of an edge of the player
+  ///@param isfirst is TRUE for the north or west edge, FALSE for the south or east edge
+  ///@return the index of point
+  int getEdgePoint(bool isfirst) const {
+    return isfirst ? numofvertices + 1 : numofvertices + 2;
+  }
+  ///Get the stones of the player and the other player
+  ///@param NONE
+  ///@return the colors indexed by position - 1, 1 for the player, -1 for the other player and 0 for empty
+  const std::vector<signed char>& getColors() const {
+    return colors;
+  }
+
+  static const std::size_t MAXNUMOFFULLS = 4;  ///< the maximal number of full connections per pair of points
+  static const std::size_t MAXNUMOFSEMIS = 8;  ///< the maximal number of semi connections per pair of points
+
+ private:
+  /**
+   * ConnectionSet is the full and semi connections between a pair of points
+   */
+  struct ConnectionSet {
+    std::vector<Connection> fulls;  ///< the full connections
+    std::vector<Connection> semis;  ///< the semi connections
+  };
+  /**
+   * PendingConnection is a new full connection to be combined by AND rule
+   */
+  struct PendingConnection {
+    int first;  ///< one point
+    int second;  ///< the other point
+    Carrier carrier;  ///< the carrier of connection
+  };
+
+  const BoardTopology& topology;  ///< the tables of board, not owned
+  bool iswesttoeast;  ///< the winning condition of the player
+  int numofvertices;  ///< the number of hexgons on board
+  std::size_t maxnumofconnections;  ///< the maximal number of connections kept
+  int timelimit;  ///< the maximal time of each build or play in milliseconds
+  std::size_t numofconnections;  ///< the number of connections kept
+  std::vector<signed char> colors;  ///< the owner of each hexgon, 1 for the player, -1 for the other player and 0 for empty
+  std::vector<int> parents;  ///< the parent of each point in union-find of groups, indexed by point - 1
+  hexgame::unordered_map<boost::uint64_t, ConnectionSet> connections;  ///< the connections indexed by the pair of points
+  std::vector<hexgame::unordered_set<int> > partners;  ///< the points connected with each point, indexed by point - 1
+  std::deque<PendingConnection> pendings;  ///< the full connections to be combined
+
+  //Get the key of a pair of points
+  static boost::uint64_t getPairKey(int first, int second);
+  //Get the representative point of a group
+  int find(int point);
+  //Get the representative point of a group without path compression
+  int findConst(int point) const;
+  //Check if the point is empty hexgon
+  bool isEmptyPoint(int point) const;
+  //Add the full connections between adjacent points of the hexgon
+  void addAdjacency(int cell);
+  //Add a full connection
+  bool addFull(int first, int second, const Carrier& carrier);
+  //Add a semi connection and apply OR rule
+  bool addSemi(int first, int second, const Carrier& carrier, int key);
+  //Remove the connections between a pair of points
+  void erasePair(int first, int second);
+  //Apply AND rule to the pending full connections until none is left or time is up
+  void combine();
+};
+
+#endif /* HSEARCH_H_ */
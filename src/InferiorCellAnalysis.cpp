@@ -0,0 +1,226 @@
+/*
+ * InferiorCellAnalysis.cpp
+ * This file defines the implementation of InferiorCellAnalysis class
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "InferiorCellAnalysis.h"
+
+#include <algorithm>
+
+using namespace std;
+
+///User defined constructor which takes the tables of board
+///@param topology is the rings of hexgons which should outlive the analysis
+InferiorCellAnalysis::InferiorCellAnalysis(const BoardTopology& topology)
+    : topology(topology),
+      isbabywatsonwesttoeast(true) {
+}
+///Analyze the game state. The dead and captured hexgons are filled in the copy of state kept by the analysis until no more
+///is found, then the inferior moves of both players are found in the filled state. Nothing is filled if the board would be
+///full
+///@param emptyglobal is the indicators of empty hexgons of the actual game state
+///@param bwglobal is the moves made by AI player in the actual game state
+///@param oppglobal is the moves made by the opponent in the actual game state
+///@param isbabywatsonwesttoeast is the winning condition of AI player
+///@return NONE
+void InferiorCellAnalysis::analyze(const hexgame::shared_ptr<bool>& emptyglobal,
+                                   const vector<int>& bwglobal,
+                                   const vector<int>& oppglobal,
+                                   bool isbabywatsonwesttoeast) {
+  this->isbabywatsonwesttoeast = isbabywatsonwesttoeast;
+  int numofvertices = topology.getNumofhexgons() * topology.getNumofhexgons();
+  colors.assign(numofvertices, 0);
+  for (size_t i = 0; i < bwglobal.size(); ++i)
+    if (bwglobal[i] > 0)
+      colors[bwglobal[i] - 1] = 1;
+  for (size_t i = 0; i < oppglobal.size(); ++i)
+    if (oppglobal[i] > 0)
+      colors[oppglobal[i] - 1] = -1;
+#ifndef NDEBUG
+  for (int i = 0; i < numofvertices; ++i)
+    assert(emptyglobal.get()[i] == (colors[i] == 0));
+#else
+  (void) emptyglobal;  //only checked against the moves in debug builds
+#endif
+  filledbabywatsons.clear();
+  filledopponents.clear();
+  inferiorbabywatsons.clear();
+  inferioropponents.clear();
+
+  vector<signed char> original(colors);
+  while (fillOnce())
+    ;
+  if (find(colors.begin(), colors.end(), 0) == colors.end()) {
+    //the outcome is decided, keep the empty hexgons as moves
+    colors.swap(original);
+    filledbabywatsons.clear();
+    filledopponents.clear();
+  }
+  findInferiors(1, inferiorbabywatsons);
+  findInferiors(-1, inferioropponents);
+}
+///Fill the dead and captured hexgons found by analyze into the game state. The indicators are replaced by a filled copy
+///since they might be shared with the hex board
+///@param emptyglobal is the indicators of empty hexgons of the actual game state
+///@param bwglobal is the moves made by AI player in the actual game state
+///@param oppglobal is the moves made by the opponent in the actual game state
+///@return the number of filled hexgons
+int InferiorCellAnalysis::fill(hexgame::shared_ptr<bool>& emptyglobal,
+                               vector<int>& bwglobal,
+                               vector<int>& oppglobal) const {
+  if (filledbabywatsons.empty() && filledopponents.empty())
+    return 0;
+  hexgame::shared_ptr<bool> indicators(new bool[colors.size()],
+                                       hexgame::default_delete<bool[]>());
+  copy(emptyglobal.get(), emptyglobal.get() + colors.size(), indicators.get());
+  emptyglobal = indicators;
+  for (size_t i = 0; i < filledbabywatsons.size(); ++i) {
+    emptyglobal.get()[filledbabywatsons[i] - 1] = false;
+    bwglobal.push_back(filledbabywatsons[i]);
+  }
+  for (size_t i = 0; i < filledopponents.size(); ++i) {
+    emptyglobal.get()[filledopponents[i] - 1] = false;
+    oppglobal.push_back(filledopponents[i]);
+  }
+  return static_cast<int>(filledbabywatsons.size() + filledopponents.size());
+}
+///Mark the inferior moves of both players in the state, which should be called after every reset of state
+///@param state is the game state reset to the filled game state
+///@return NONE
+void InferiorCellAnalysis::apply(DescentState& state) const {
+  for (size_t i = 0; i < inferiorbabywatsons.size(); ++i)
+    state.setInferior(inferiorbabywatsons[i], true);
+  for (size_t i = 0; i < inferioropponents.size(); ++i)
+    state.setInferior(inferioropponents[i], false);
+}
+///Get the owner of a neighbor in ring. An edge is owned by the player connecting it
+///@param neighbor is the entry of ring, i.e. the position of hexgon, the edgekind of an edge or 0 beyond a corner
+///@return 1 for AI player, -1 for the opponent, 0 for empty and 2 for the position beyond a corner which matches no player
+signed char InferiorCellAnalysis::getRingColor(int neighbor) const {
+  if (neighbor > 0)
+    return colors[neighbor - 1];
+  if (neighbor == 0)
+    return 2;
+  bool iswesttoeast = (neighbor == BoardTopology::WEST
+      || neighbor == BoardTopology::EAST);
+  return (iswesttoeast == isbabywatsonwesttoeast) ? 1 : -1;
+}
+///Check if the empty hexgon is dead, i.e. a player owns four consecutive neighbors, or no neighbor is empty and the
+///neighbors of each player are consecutive
+///@param move is the position of hexgon starting from 1
+///@return TRUE if the hexgon is dead in the state analyzed
+bool InferiorCellAnalysis::isDead(int move) const {
+  const int SIZEOFRING = BoardTopology::SIZEOFRING;
+  const int* ring = topology.getRing(move);
+  signed char kinds[SIZEOFRING];
+  bool hasempty = false;
+  for (int k = 0; k < SIZEOFRING; ++k) {
+    kinds[k] = getRingColor(ring[k]);
+    hasempty = hasempty || (kinds[k] == 0);
+  }
+  for (int k = 0; k < SIZEOFRING; ++k) {
+    if (kinds[k] != 1 && kinds[k] != -1)
+      continue;
+    int length = 1;
+    while (length < SIZEOFRING && kinds[(k + length) % SIZEOFRING] == kinds[k])
+      ++length;
+    if (length >= 4)
+      return true;
+  }
+  if (hasempty)
+    return false;
+  for (signed char owner = -1; owner <= 1; owner += 2) {
+    int numofruns = 0;
+    for (int k = 0; k < SIZEOFRING; ++k)
+      if (kinds[k] == owner
+          && kinds[(k + SIZEOFRING - 1) % SIZEOFRING] != owner)
+        ++numofruns;
+    if (numofruns > 1)
+      return false;
+  }
+  return true;
+}
+///Check if the pair of adjacent empty hexgons is captured by the player, i.e. the stone of the other player in either one is
+///dead once the player answers with the other one
+///@param first is the position of one hexgon
+///@param second is the position of the other hexgon
+///@param owner is the player, 1 for AI player and -1 for the opponent
+///@return TRUE if the pair is captured by the player
+bool InferiorCellAnalysis::isCaptured(int first, int second, signed char owner) {
+  colors[first - 1] = -owner;
+  colors[second - 1] = owner;
+  bool iscaptured = isDead(first);
+  if (iscaptured) {
+    colors[first - 1] = owner;
+    colors[second - 1] = -owner;
+    iscaptured = isDead(second);
+  }
+  colors[first - 1] = colors[second - 1] = 0;
+  return iscaptured;
+}
+///Fill the dead and captured hexgons once
+///@param NONE
+///@return TRUE if any hexgon is filled
+bool InferiorCellAnalysis::fillOnce() {
+  bool isfilled = false;
+  int numofvertices = static_cast<int>(colors.size());
+  for (int move = 1; move <= numofvertices; ++move)
+    if (colors[move - 1] == 0 && isDead(move)) {
+      colors[move - 1] = -1;
+      filledopponents.push_back(move);
+      isfilled = true;
+    }
+  for (int move = 1; move <= numofvertices; ++move) {
+    const int* ring = topology.getRing(move);
+    for (int k = 0; k < BoardTopology::SIZEOFRING && colors[move - 1] == 0;
+        ++k) {
+      int neighbor = ring[k];
+      if (neighbor <= move || colors[neighbor - 1] != 0)
+        continue;
+      for (signed char owner = -1; owner <= 1; owner += 2)
+        if (isCaptured(move, neighbor, owner)) {
+          colors[move - 1] = colors[neighbor - 1] = owner;
+          vector<int>& filled =
+              (owner == 1) ? filledbabywatsons : filledopponents;
+          filled.push_back(move);
+          filled.push_back(neighbor);
+          isfilled = true;
+          break;
+        }
+    }
+  }
+  return isfilled;
+}
+///Find the moves inferior for the player. An empty hexgon is inferior if a stone of the other player next to it kills it,
+///and the killer is kept as a candidate so that at least one move of every dominated group remains
+///@param owner is the player to move, 1 for AI player and -1 for the opponent
+///@param inferiors is the container of inferior moves
+///@return NONE
+void InferiorCellAnalysis::findInferiors(signed char owner,
+                                         vector<int>& inferiors) {
+  int numofvertices = static_cast<int>(colors.size());
+  vector<char> iskiller(numofvertices, false), isinferior(numofvertices,
+                                                           false);
+  for (int move = 1; move <= numofvertices; ++move) {
+    if (colors[move - 1] != 0 || iskiller[move - 1])
+      continue;
+    const int* ring = topology.getRing(move);
+    for (int k = 0; k < BoardTopology::SIZEOFRING; ++k) {
+      int killer = ring[k];
+      if (killer <= 0 || colors[killer - 1] != 0 || isinferior[killer - 1])
+        continue;
+      colors[killer - 1] = -owner;
+      bool iskilled = isDead(move);
+      colors[killer - 1] = 0;
+      if (iskilled) {
+        inferiors.push_back(move);
+        isinferior[move - 1] = true;
+        iskiller[killer - 1] = true;
+        break;
+      }
+    }
+  }
+}
@@ -0,0 +1,83 @@
+/*
+ * InferiorCellAnalysis.h
+ * This file declares the analysis of dead, captured and dominated hexgons which reduces the moves searched by Monte Carlo Tree Search.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef INFERIORCELLANALYSIS_H_
+#define INFERIORCELLANALYSIS_H_
+
+#include <vector>
+
+#include "Global.h"
+#include "DescentState.h"
+#include "BoardTopology.h"
+
+/**
+ * InferiorCellAnalysis class is used to find the empty hexgons which cannot change the outcome of game by the local patterns
+ * of their rings (see BoardTopology::getRing), where an edge counts as a stone of the player connecting it.<br/>
+ * A hexgon is dead if a player owns four consecutive neighbors of it, or if it has no empty neighbor and the neighbors of each
+ * player are consecutive; a stone in a dead hexgon connects nothing which is not connected yet. A pair of adjacent empty
+ * hexgons is captured by a player if the player answers the intrusion into either one with the other one and the intruding
+ * stone becomes dead. Dead and captured hexgons are filled (dead ones by the opponent of AI player and captured ones by the
+ * capturer) until no more is found, which does not change the outcome of game. An empty hexgon is inferior for a player if
+ * the other player kills it with one stone next to it (vulnerable), so it is dominated by the killer which is kept as a
+ * candidate of the player. Each test is a scan over six entries of ring, hence the analysis is cheap compared with search.<br/>
+ * InferiorCellAnalysis(const BoardTopology& topology): user defined constructor which takes the tables of board. The
+ * topology should outlive the analysis<br/>
+ * Sample Usage:<br/>
+ * InferiorCellAnalysis analysis(topology);<br/>
+ * analysis.analyze(emptyglobal, bwglobal, oppglobal, player.getWestToEastCondition());<br/>
+ * analysis.fill(emptyglobal, bwglobal, oppglobal);<br/>
+ * analysis.apply(state); //after every reset of state<br/>
+ */
+class InferiorCellAnalysis {
+ private:
+  const BoardTopology& topology;  ///< the rings of hexgons, not owned
+  bool isbabywatsonwesttoeast;  ///< the winning condition of AI player
+  std::vector<signed char> colors;  ///< the owner of each hexgon, 1 for AI player, -1 for the opponent and 0 for empty
+  std::vector<int> filledbabywatsons;  ///< the dead or captured hexgons filled by AI player
+  std::vector<int> filledopponents;  ///< the dead or captured hexgons filled by the opponent
+  std::vector<int> inferiorbabywatsons;  ///< the moves inferior for AI player
+  std::vector<int> inferioropponents;  ///< the moves inferior for the opponent
+
+  //Get the owner of a neighbor in ring
+  signed char getRingColor(int neighbor) const;
+  //Check if the pair of adjacent empty hexgons is captured by the player
+  bool isCaptured(int first, int second, signed char owner);
+  //Fill the dead and captured hexgons once
+  bool fillOnce();
+  //Find the moves inferior for the player
+  void findInferiors(signed char owner, std::vector<int>& inferiors);
+
+ public:
+  //User defined constructor which takes the tables of board
+  explicit InferiorCellAnalysis(const BoardTopology& topology);
+  //Analyze the game state
+  void analyze(const hexgame::shared_ptr<bool>& emptyglobal,
+               const std::vector<int>& bwglobal,
+               const std::vector<int>& oppglobal, bool isbabywatsonwesttoeast);
+  //Fill the dead and captured hexgons into the game state
+  int fill(hexgame::shared_ptr<bool>& emptyglobal, std::vector<int>& bwglobal,
+           std::vector<int>& oppglobal) const;
+  //Mark the inferior moves of both players in the state
+  void apply(DescentState& state) const;
+  //Check if the empty hexgon is dead
+  bool isDead(int move) const;
+  ///Get the dead or captured hexgons filled by the player
+  ///@param isbabywatson is TRUE for AI player
+  ///@return the filled hexgons
+  const std::vector<int>& getFilledMoves(bool isbabywatson) const {
+    return isbabywatson ? filledbabywatsons : filledopponents;
+  }
+  ///Get the moves inferior for the player
+  ///@param isbabywatson is TRUE for AI player
+  ///@return the inferior moves
+  const std::vector<int>& getInferiorMoves(bool isbabywatson) const {
+    return isbabywatson ? inferiorbabywatsons : inferioropponents;
+  }
+};
+
+#endif /* INFERIORCELLANALYSIS_H_ */
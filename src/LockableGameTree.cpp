@@ -9,22 +9,50 @@
 #include <deque>
 #include <stack>
 #include <utility>
+#include <algorithm>
 #include <iostream>
 
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/lock_algorithms.hpp>
+#include <boost/bind.hpp>
 #include <boost/date_time/posix_time/posix_time_types.hpp>
 
 #include "Game.h"
 #include "Global.h"
 #include "Player.h"
-#include "PriorityQueue.h"
 #include "LockableGameTree.h"
 #include "MultiMonteCarloTreeSearch.h"
 
 using namespace std;
 using namespace boost;
 
+namespace {
+/**
+ * QuietNode is the predicate which allows a node to be pruned only when no thread is working on it, i.e. the node is
+ * updated by back-propagation and no thread is waiting to expand it
+ */
+template<class Graph>
+class QuietNode {
+ private:
+  Graph& thetree;  ///< the underlying graph of game tree
+ public:
+  ///constructor which takes the underlying graph of game tree
+  ///@param thetree is the underlying graph of game tree
+  explicit QuietNode(Graph& thetree)
+      : thetree(thetree) {
+  }
+  ///Check if the node can be pruned
+  ///@param node is the node in query
+  ///@return TRUE if the node is not in use by other threads
+  template<class Vertex>
+  bool operator()(Vertex node) const {
+    return get(vertex_value, thetree)[node]->getIsupdated()
+        && get(vertex_value, thetree)[node]->getNumofFutureChildren() == 0
+        && get(vertex_value, thetree)[node]->getCountforexpand() == 0;
+  }
+};
+}
+
 /// Let the thread wait for the update of feature values from back-propagation phase in MCTS
 ///@param NONE
 ///@return boolean indicator which will return true when complete waiting
@@ -113,6 +141,7 @@ bool LockableGameTree::notifyAllUpdateDone(boost::unique_lock<LockableGameTree>&
 ///@param indexofroot is the index which will be assigned to the new root node
 ///@return NONE
 void LockableGameTree::initGameTree(char playerscolor, std::size_t indexofroot) {
+  raveequivalence = 0.0;
   //set the root's color label as opponent's color label
   //TODO duplicate code
   char rootscolor = 'W';
@@ -135,12 +164,13 @@ LockableGameTree::vertex_t LockableGameTree::addNode(
     boost::unique_lock<LockableGameTree>&, std::size_t positionofchild,
     char color) {
   //TODO duplicate code
-  vertex_t target = add_vertex(thetree);
+  vertex_t target =
+      recycler.hasFreeNode() ? recycler.acquire() : add_vertex(thetree);
   updateNodeValue(target);
+  get(vertex_untried, thetree)[target].clear();
   unique_lock<LockableUTCPolicy> guard(*get(vertex_value, thetree, target));
   updateNodePosition(guard, target, positionofchild);
   updateNodeColor(guard, target, color);
-  updateNodeName(guard, target);
   return target;
 }
 ///Add Node to the game tree with internal lock
@@ -175,35 +205,6 @@ string LockableGameTree::printGameTree(int index) {
   shared_lock<LockableGameTree> guard(*this);
   return printGameTree(guard, index);
 }
-//external lock version
-//update name
-/// Update node name with external lock
-///@param unique_lock<LockableUTCPolicy>& is a reader/writer's lock which will grant exclusive right for local node of game tree access
-///@param node is the node whose name will be updated
-///@return NONE
-void LockableGameTree::updateNodeName(boost::unique_lock<LockableUTCPolicy>&,
-                                      vertex_t node) {
-  //TODO duplicate code
-  stringstream namebuffer;
-  namebuffer << get(vertex_index, thetree, node);
-  namebuffer << "@";
-  namebuffer << get(vertex_position, thetree, node);
-  namebuffer << ":";
-  if (get(vertex_color, thetree, node) == black_color)
-    namebuffer << 'B';
-  else if (get(vertex_color, thetree, node) == red_color)
-    namebuffer << 'R';
-  else
-    namebuffer << 'W';
-  put(vertex_name, thetree, node, namebuffer.str());
-}
-/// Update node color with internal lock
-///@param node is the node whose color label will be updated
-///@return NONE
-void LockableGameTree::updateNodeName(vertex_t node) {
-  unique_lock<LockableUTCPolicy> guard(*get(vertex_value, thetree, node));
-  updateNodeName(node);
-}
 //update the value of a given node
 /// Update node value with internal lock
 ///@param node is the node whose name will be updated
@@ -280,6 +281,9 @@ int LockableGameTree::expandNode(boost::unique_lock<LockableGameTree>& guard,
   while (countonwait.load() > 0)
     holdforselect.wait(guard);
 
+  //keep the tree under the node budget, only the subtrees no threads are working on are pruned
+  recycler.recycle(thetree, _root, source, QuietNode<basegraph>(thetree));
+
   //adding the different colors from the parental node
   vertex_t target;
   if (get(vertex_color, thetree, source) == red_color)
@@ -312,6 +316,74 @@ int LockableGameTree::expandNode(int indexofsource, int move, char color) {
   unique_lock<LockableGameTree> guard(*this);
   return expandNode(guard, indexofsource, move, color);
 }
+/// Expand a new node from given source node with the next move taken from the untried moves of source node and apply the
+/// move to the state with external guard. The move is taken while holding the tree lock, so the threads expanding the same
+/// source node get different moves
+///@param unique_lock<LockableGameTree>& guard is a reader/writer's lock which will grant exclusive right for game tree access
+///@param indexofsource is the index of source node from which a new node will be expanded
+///@param state is the game state of source node, i.e. advanced by selectMaxBalanceNode(int, bool, DescentState&)
+///@return the index of the new expanded node
+int LockableGameTree::expandNode(boost::unique_lock<LockableGameTree>& guard,
+                                 int indexofsource, DescentState& state) {
+  int move = popUntriedMove(guard, vertex(indexofsource, thetree), state);
+  int indexofchild = expandNode(guard, indexofsource, move, 'W');
+  applyMove(guard, vertex(indexofchild, thetree), state);
+  return indexofchild;
+}
+/// Expand a new node from given source node with the next move taken from the untried moves of source node and apply the
+/// move to the state with internal guard
+///@param indexofsource is the index of source node from which a new node will be expanded
+///@param state is the game state of source node
+///@return the index of the new expanded node
+int LockableGameTree::expandNode(int indexofsource, DescentState& state) {
+  unique_lock<LockableGameTree> guard(*this);
+  return expandNode(guard, indexofsource, state);
+}
+/// Take the move with the highest prior out of the untried moves of given node with external guard. The untried moves are
+/// generated from the candidates of the state excluding the moves of existing children when the list is empty and ordered
+/// by the prior of state with ties in random order. The moves reserved by other
+/// threads are already taken out of the list, and the list of a node with pending expansions is never dropped by recycler
+///@param unique_lock<LockableGameTree>& guard is a reader/writer's lock which will grant exclusive right for game tree access
+///@param node is the node to be expanded
+///@param state is the game state of the node
+///@return the position of move on hex board
+int LockableGameTree::popUntriedMove(boost::unique_lock<LockableGameTree>&,
+                                     vertex_t node, DescentState& state) {
+  vector<boost::uint16_t>& untried = get(vertex_untried, thetree)[node];
+  if (untried.empty()) {
+    for (int i = 1; i <= state.getSizeofVertices(); ++i)
+      if (state.isCandidate(i))
+        untried.push_back(static_cast<boost::uint16_t>(i));
+    out_edge_iter viter, viterend;
+    for (tie(viter, viterend) = out_edges(node, thetree); viter != viterend;
+        ++viter)
+      untried.erase(
+          remove(untried.begin(), untried.end(),
+                 get(vertex_position, thetree, target(*viter, thetree))),
+          untried.end());
+    //shuffle to break the ties of prior at random, then the move with the highest prior is popped first
+    for (size_t i = untried.size(); i > 1; --i)
+      swap(untried[i - 1], untried[generator.nextIndex(i)]);
+    state.orderByPrior(untried);
+  }
+  assert(!untried.empty());
+  int move = untried.back();
+  untried.pop_back();
+  if (untried.empty())
+    vector<boost::uint16_t>().swap(untried);
+  return move;
+}
+/// Apply the move of given node to the state with external guard. The move belongs to AI player if the color of node is
+/// different from root
+///@param unique_lock<LockableGameTree>& guard is a reader/writer's lock which will grant exclusive right for game tree access
+///@param node is the node whose move is applied
+///@param state is the game state
+///@return NONE
+void LockableGameTree::applyMove(boost::unique_lock<LockableGameTree>&,
+                                 vertex_t node, DescentState& state) {
+  state.play(static_cast<int>(get(vertex_position, thetree, node)),
+             get(vertex_color, thetree, node) != get(vertex_color, thetree, _root));
+}
 /// Add a new edge between source node and target node with internal lock
 ///@param source is the source node from which a new edge will be created.
 ///@param target is the target node to which a new edge will be created.
@@ -328,18 +400,45 @@ bool LockableGameTree::addEdge(vertex_t source, vertex_t target) {
 ///@return a pair of integer and size_t. The first in pair is the index of selected node with maximal UTC value. The second is the level or depth at which the selected node locates.
 pair<int,size_t> LockableGameTree::selectMaxBalanceNode(boost::unique_lock<LockableGameTree>& guard,
                                            int currentempty, bool isbreaktie) {
+  return descend(guard, currentempty, isbreaktie, NULL);
+}
+/// Select the node with the maximal UTC value and apply the moves of the nodes on the selected path to the state with
+/// external guard
+///@param unique_lock<LockableGameTree>& guard is a reader/writer's lock which will grant exclusive right for game tree access
+///@param currentempty is the left empty position on the hex board in actual game state
+///@param isbreaktie is the boolean variable which indicates if should break tie by random choice.
+///@param state is the game state starting from the actual game state which will be advanced along the selected path
+///@return a pair of integer and size_t. The first in pair is the index of selected node with maximal UTC value. The second is the level or depth at which the selected node locates.
+pair<int, size_t> LockableGameTree::selectMaxBalanceNode(
+    boost::unique_lock<LockableGameTree>& guard, int currentempty,
+    bool isbreaktie, DescentState& state) {
+  return descend(guard, currentempty, isbreaktie, &state);
+}
+/// Select the node with the maximal UTC value and apply the moves of the nodes on the selected path to the state with
+/// internal guard
+///@param currentempty is the left empty position on the hex board in actual game state
+///@param isbreaktie is the boolean variable which indicates if should break tie by random choice.
+///@param state is the game state starting from the actual game state which will be advanced along the selected path
+///@return a pair of integer and size_t. The first in pair is the index of selected node with maximal UTC value. The second is the level or depth at which the selected node locates.
+pair<int, size_t> LockableGameTree::selectMaxBalanceNode(int currentempty,
+                                                         bool isbreaktie,
+                                                         DescentState& state) {
+  unique_lock<LockableGameTree> guard(*this);
+  return descend(guard, currentempty, isbreaktie, &state);
+}
+/// Descend from root by choosing the child with the maximal UTC value till reaching the node to be expanded
+///@param unique_lock<LockableGameTree>& guard is a reader/writer's lock which will grant exclusive right for game tree access
+///@param currentempty is the left empty position on the hex board in actual game state
+///@param isbreaktie is the boolean variable which indicates if should break tie by random choice.
+///@param state is the game state which the moves of path are applied to, or NULL if not needed
+///@return a pair of integer and size_t. The first in pair is the index of selected node with maximal UTC value. The second is the level or depth at which the selected node locates.
+pair<int, size_t> LockableGameTree::descend(
+    boost::unique_lock<LockableGameTree>& guard, int currentempty,
+    bool isbreaktie, DescentState* state) {
   vertex_t parent = _root;
   out_edge_iter viter, viterend;
   assert(getNumofChildren(parent) <= static_cast<unsigned>(currentempty));
   int level = 0;
-#if __cplusplus > 199711L
-  default_random_engine generator(
-      static_cast<unsigned>(hexgame::chrono::system_clock::now()
-          .time_since_epoch().count()));
-  uniform_real_distribution<double> distribution(0.0, 1.0);
-#else
-  srand(static_cast<unsigned>(time(NULL)));
-#endif
   while (isblockingforexpand)
     holdforexpand.wait(guard);
 
@@ -348,15 +447,21 @@ pair<int,size_t> LockableGameTree::selectMaxBalanceNode(boost::unique_lock<Locka
       + get(vertex_value, thetree, parent)->getNumofFutureChildren()) != 0) {
     //test if the current examining node is fully expanded, if yes then return its child; otherwise, return the current node for expansion
     assert((currentempty - level) > 0);  //currentempty - level = 0 indicates the end of game
+    //with progressive widening, the node is fully expanded once it has as many children as its visit count allows. The
+    //moves of node are the candidates of state if given, which exclude the inferior moves
+    int width = widening.getWidth(
+        get(vertex_value, thetree, parent)->feature(
+            AbstractUTCPolicy_visitcount),
+        (state != NULL) ? state->getNumofCandidates() : currentempty - level);
     if (static_cast<int>(getNumofChildren(parent)
         + get(vertex_value, thetree, parent).get()->getNumofFutureChildren())
-        < (currentempty - level))
+        < width)
       break;
 
     if (get(vertex_value, thetree, parent).get()->getNumofFutureChildren() > 0
         && (static_cast<int>(getNumofChildren(parent)
             + get(vertex_value, thetree, parent)->getNumofFutureChildren())
-            == (currentempty - level))) {
+            >= width)) {
       get(vertex_value, thetree, parent).get()->addCountforexpand(1);
       countforexpand.fetch_add(1);
       isblockingforexpand.store(true);
@@ -369,38 +474,45 @@ pair<int,size_t> LockableGameTree::selectMaxBalanceNode(boost::unique_lock<Locka
     }
 
     countonwait.fetch_add(1);
-    PriorityQueue<vertex_t, double> vertexchooser(getNumofChildren(parent));
-    for (tie(viter, viterend) = out_edges(parent, thetree); viter != viterend;
-        ++viter) {
-      vertex_t node = target(*viter, thetree);
-      assert(get(vertex_index, thetree, node) < num_vertices(thetree));
-      //1) check point 1: if the visit count is zero, then isupdated = false;
+    //1) wait till all children are updated, the tree lock is released while waiting
+    bool iswaited = true;
+    while (iswaited) {
+      iswaited = false;
+      for (tie(viter, viterend) = out_edges(parent, thetree); viter != viterend;
+          ++viter) {
+        vertex_t node = target(*viter, thetree);
+        assert(get(vertex_index, thetree, node) < num_vertices(thetree));
+        //check point 1: if the visit count is zero, then isupdated = false;
 #ifndef NDEBUG
-      if (get(vertex_value, thetree, node).get()->feature(
-          LockableUTCPolicy::visitcount) == 0)
-        assert(!get(vertex_value, thetree, node).get()->getIsupdated());
+        if (get(vertex_value, thetree, node).get()->feature(
+            LockableUTCPolicy::visitcount) == 0)
+          assert(!get(vertex_value, thetree, node).get()->getIsupdated());
 #endif
-      while (!get(vertex_value, thetree, node).get()->getIsupdated()) {
-        holdforupdate.wait(guard);
+        while (!get(vertex_value, thetree, node).get()->getIsupdated()) {
+          holdforupdate.wait(guard);
+          iswaited = true;
+        }
       }
-      assert(countonwait.load() >= 0);
-      double value = -get(vertex_value, thetree, node).get()->calculate(
-          *get(vertex_value, thetree, parent));
-      if (isbreaktie && vertexchooser.containsPriority(value)) {  // break the tie
-#if __cplusplus > 199711L
-        double prob = distribution(generator);
-#else
-        double prob = (float) rand() / RAND_MAX;
-#endif
-        if (prob < 0.5)
-          value -= prob / 100.0;
-        else
-          value += prob / 100.0;
-      }
-      vertexchooser.insert(node, value);
+    }
+    assert(countonwait.load() >= 0);
+    //2) score all children in one pass while holding the tree lock, the exploration term of parent is shared by all children
+    double explorationofparent = UTCTable::explorationTerm(
+        get(vertex_value, thetree, parent)->getCoefficient(),
+        get(vertex_value, thetree, parent)->feature(
+            AbstractUTCPolicy_visitcount));
+    vertexchooser.clear();
+    for (tie(viter, viterend) = out_edges(parent, thetree); viter != viterend;
+        ++viter) {
+      vertex_t node = target(*viter, thetree);
+      vertexchooser.insert(
+          node,
+          get(vertex_value, thetree, node).get()->calculate(
+              explorationofparent, raveequivalence));
     }
     assert(!vertexchooser.empty());
-    parent = vertexchooser.minPrioirty();
+    parent = vertexchooser.chooseMax(isbreaktie);
+    if (state != NULL)
+      applyMove(guard, parent, *state);
     countonwait.fetch_sub(1);
     ++level;
   }
@@ -409,7 +521,7 @@ pair<int,size_t> LockableGameTree::selectMaxBalanceNode(boost::unique_lock<Locka
     holdforselect.notify_all();
   }
 
-  if ((currentempty - level) > 0)
+  if (((state != NULL) ? state->getNumofCandidates() : currentempty - level) > 0)
     get(vertex_value, thetree, parent).get()->setNumofFutureChildren(0, 1);
   else
     //end of the game
@@ -562,6 +674,20 @@ vector<size_t> LockableGameTree::getSiblings(boost::unique_lock<LockableGameTree
   }
   return vector<size_t>(siblings);
 }
+/// Get the children of a given node with internal lock
+///@param indexofnode is the index of node whose indices of children will be returned
+///@return a vector of size_t which stores the indices of children of the given node
+vector<size_t> LockableGameTree::getChildren(std::size_t indexofnode) {
+  shared_lock<LockableGameTree> guard(*this);
+  vertex_t node = vertex(indexofnode, thetree);
+  vector<size_t> children;
+  children.reserve(out_degree(node, thetree));
+  out_edge_iter viter, viterend;
+  for (tie(viter, viterend) = out_edges(node, thetree); viter != viterend;
+      ++viter)
+    children.push_back(get(vertex_index, thetree, target(*viter, thetree)));
+  return children;
+}
 /// Set the position of node with internal lock
 ///@param indexofnode is the index of node whose position will be updated
 ///@param position is the new position on hex board for the given node
@@ -579,7 +705,6 @@ void LockableGameTree::setNodePosition(std::size_t indexofnode, std::size_t posi
 void LockableGameTree::setNodePosition(boost::unique_lock<LockableUTCPolicy>& guard,
                                        vertex_t node, std::size_t position){
   updateNodePosition(guard, node, position);
-  updateNodeName(guard, node);
 }
 /// Get node position of a given index of node with internal lock
 ///@param indexofnode is the index of the node in query
@@ -631,6 +756,60 @@ void LockableGameTree::updateNodefromSimulation(int indexofnode, int winner,
   unique_lock<LockableGameTree> guard(*this);
   updateNodefromSimulation(guard, indexofnode, winner, level);
 }
+/// Update the all-moves-as-first (AMAF) statistics by the result of a simulated game with external lock. The update does not
+/// mark the nodes as updated, so the children still waiting for their own back-propagation are not selected. See
+/// GameTree::updateAmaffromSimulation
+///@param unique_lock<LockableGameTree>& guard is a reader/writer's lock which will grant exclusive right for game tree access
+///@param indexofnode is the index of node from which the simulated game is played out, e.g. the expanded node
+///@param winner is the play result of play-out phase. Positive if AI player wins
+///@param state is the game state at the end of play-out phase which holds all moves of the simulated game
+///@return NONE
+void LockableGameTree::updateAmaffromSimulation(
+    boost::unique_lock<LockableGameTree>&, int indexofnode, int winner,
+    DescentState& state) {
+  //TODO duplicate code
+  amafowners.assign(state.getSizeofVertices() + 1, 0);
+  vector<int>& babywatsons = state.getBabywatsons();
+  vector<int>& opponents = state.getOpponents();
+  for (size_t i = 0; i < babywatsons.size(); ++i)
+    if (babywatsons[i] > 0)  //zero for no move left on board
+      amafowners[babywatsons[i]] = 1;
+  for (size_t i = 0; i < opponents.size(); ++i)
+    if (opponents[i] > 0)
+      amafowners[opponents[i]] = -1;
+
+  default_color_type rootcolor = get(vertex_color, thetree, _root);
+  in_edge_iter initer, initerend;
+  out_edge_iter viter, viterend;
+  for (vertex_t node = vertex(indexofnode, thetree);;) {
+    for (tie(viter, viterend) = out_edges(node, thetree); viter != viterend;
+        ++viter) {
+      vertex_t child = target(*viter, thetree);
+      signed char owner = (get(vertex_color, thetree, child) != rootcolor) ? 1 : -1;
+      if (amafowners[get(vertex_position, thetree, child)] != owner)
+        continue;
+      get(vertex_value, thetree, child)->update(AbstractUTCPolicy_amafvisitcount,
+                                                0, 1);
+      if (winner > 0)
+        get(vertex_value, thetree, child)->update(AbstractUTCPolicy_amafwincount,
+                                                  0, owner);
+    }
+    if (node == _root)
+      break;
+    tie(initer, initerend) = in_edges(node, thetree);
+    node = source(*initer, thetree);
+  }
+}
+/// Update the all-moves-as-first (AMAF) statistics by the result of a simulated game with internal lock
+///@param indexofnode is the index of node from which the simulated game is played out, e.g. the expanded node
+///@param winner is the play result of play-out phase. Positive if AI player wins
+///@param state is the game state at the end of play-out phase which holds all moves of the simulated game
+///@return NONE
+void LockableGameTree::updateAmaffromSimulation(int indexofnode, int winner,
+                                                DescentState& state) {
+  unique_lock<LockableGameTree> guard(*this);
+  updateAmaffromSimulation(guard, indexofnode, winner, state);
+}
 /// Back propagate the play-out phase result till to the level specified with external lock
 ///@param unique_lock<LockableGameTree>& guard is a reader/writer's lock which will grant exclusive right for game tree access
 ///@param leaf is the leaf node or starting node from which a back propagation will be executed
@@ -825,19 +1004,18 @@ pair<int, double> LockableGameTree::getBestMovefromSimulation() {
   //1. examine all children nodes below the root node
   size_t numofchildren = out_degree(_root, thetree);
   assert(numofchildren != 0);
-  PriorityQueue<vertex_t, double> vertexchooser(numofchildren);
+  ArgMaxChooser rootchooser;
+  rootchooser.reserve(numofchildren);
   out_edge_iter viter, viterend;
   for (tie(viter, viterend) = out_edges(_root, thetree); viter != viterend;
       ++viter) {
     vertex_t node = target(*viter, thetree);
-    vertexchooser.insert(node,
-                         -get(vertex_value, thetree, node).get()->estimate());
+    rootchooser.insert(node, get(vertex_value, thetree, node).get()->estimate());
   }
-  //2. choose the maximal value from all children nodes of root.
-  int indexofbestmove = vertexchooser.minPrioirty();
-  double maxvalue = get(vertex_value, thetree,
-                        get(vertex_index, thetree, indexofbestmove)).get()
-      ->getValue();
+  //2. choose the maximal value from all children nodes of root, the first expanded one among the ties
+  size_t chosen = rootchooser.argmax(false);
+  int indexofbestmove = rootchooser.getCandidate(chosen);
+  double maxvalue = rootchooser.getScore(chosen);
   assert(indexofbestmove > 0);
   assert(maxvalue >= 0.0);
   return make_pair(indexofbestmove, maxvalue);
@@ -861,6 +1039,7 @@ void LockableGameTree::clearAll(boost::unique_lock<LockableGameTree>&) {
     rootscolor = 'B';
   int indexofroot = get(vertex_index, thetree, _root);
   thetree.clear();
+  recycler.clear();
   vertex_t root = addNode(indexofroot, rootscolor);
   _root = root;
 }
@@ -879,14 +1058,14 @@ int LockableGameTree::getNodeValueFeature(
 ///@param shared_lock<LockableGameTree>& is a reader's lock which will grant shared right for game tree access
 ///@return the total size of nodes
 size_t LockableGameTree::getSizeofNodes(boost::shared_lock<LockableGameTree>&) {
-  return num_vertices(thetree);
+  return num_vertices(thetree) - recycler.getSizeofFreeNodes();
 }
 /// Get the total size of nodes
 ///@param NONE
 ///@return the total size of nodes
 size_t LockableGameTree::getSizeofNodes() {
   shared_lock<LockableGameTree> guard(*this);
-  return num_vertices(thetree);
+  return getSizeofNodes(guard);
 }
 /// Get the total size of edges
 ///@param NONE
@@ -900,7 +1079,144 @@ size_t LockableGameTree::getSizeofEdges() {
 ///@return the total size of edges
 size_t LockableGameTree::getSizeofEdges(boost::shared_lock<LockableGameTree>&) {
   size_t numofedges = num_edges(thetree);
-  assert(numofedges == num_vertices(thetree) - 1);
+  assert(numofedges == num_vertices(thetree) - recycler.getSizeofFreeNodes() - 1);
   return numofedges;
 }
-
+/// Set the maximal number of nodes kept in the tree with external lock. See GameTree::setMaxNumofNodes
+///@param unique_lock<LockableGameTree>& is a reader/writer's lock which will grant exclusive right for game tree access
+///@param numofnodes is the maximal number of nodes, 0 for unlimited
+///@return NONE
+void LockableGameTree::setMaxNumofNodes(boost::unique_lock<LockableGameTree>&,
+                                        size_t numofnodes) {
+  recycler.setMaxNumofNodes(numofnodes);
+}
+/// Set the maximal number of nodes kept in the tree with internal lock. See GameTree::setMaxNumofNodes
+///@param numofnodes is the maximal number of nodes, 0 for unlimited
+///@return NONE
+void LockableGameTree::setMaxNumofNodes(size_t numofnodes) {
+  unique_lock<LockableGameTree> guard(*this);
+  setMaxNumofNodes(guard, numofnodes);
+}
+/// Get the maximal number of nodes kept in the tree
+///@param NONE
+///@return the maximal number of nodes, 0 for unlimited
+size_t LockableGameTree::getMaxNumofNodes() {
+  shared_lock<LockableGameTree> guard(*this);
+  return recycler.getMaxNumofNodes();
+}
+/// Set the schedule of progressive widening with external lock. See GameTree::setProgressiveWidening
+///@param unique_lock<LockableGameTree>& is a reader/writer's lock which will grant exclusive right for game tree access
+///@param schedule is the schedule of progressive widening, the default constructed one disables widening
+///@return NONE
+void LockableGameTree::setProgressiveWidening(
+    boost::unique_lock<LockableGameTree>&, const ProgressiveWidening& schedule) {
+  widening = schedule;
+}
+/// Set the schedule of progressive widening with internal lock. See GameTree::setProgressiveWidening
+///@param schedule is the schedule of progressive widening, the default constructed one disables widening
+///@return NONE
+void LockableGameTree::setProgressiveWidening(
+    const ProgressiveWidening& schedule) {
+  unique_lock<LockableGameTree> guard(*this);
+  setProgressiveWidening(guard, schedule);
+}
+/// Get the schedule of progressive widening
+///@param NONE
+///@return the schedule of progressive widening
+ProgressiveWidening LockableGameTree::getProgressiveWidening() {
+  shared_lock<LockableGameTree> guard(*this);
+  return widening;
+}
+/// Set the equivalence parameter of RAVE with external lock. See GameTree::setRaveEquivalence
+///@param unique_lock<LockableGameTree>& is a reader/writer's lock which will grant exclusive right for game tree access
+///@param equivalence is the equivalence parameter, 0 to disable RAVE
+///@return NONE
+void LockableGameTree::setRaveEquivalence(boost::unique_lock<LockableGameTree>&,
+                                          double equivalence) {
+  raveequivalence = equivalence;
+}
+/// Set the equivalence parameter of RAVE with internal lock. See GameTree::setRaveEquivalence
+///@param equivalence is the equivalence parameter, 0 to disable RAVE
+///@return NONE
+void LockableGameTree::setRaveEquivalence(double equivalence) {
+  unique_lock<LockableGameTree> guard(*this);
+  setRaveEquivalence(guard, equivalence);
+}
+/// Get the equivalence parameter of RAVE
+///@param NONE
+///@return the equivalence parameter, 0 if RAVE is disabled
+double LockableGameTree::getRaveEquivalence() {
+  shared_lock<LockableGameTree> guard(*this);
+  return raveequivalence;
+}
+/// Write the game tree as a compact binary snapshot with external lock. See GameTree::saveGameTree
+///@param shared_lock<LockableGameTree>& is a reader's lock which will grant shared right for game tree access
+///@param out is the binary output stream
+///@return TRUE if the snapshot is written successfully
+bool LockableGameTree::saveGameTree(boost::shared_lock<LockableGameTree>& guard,
+                                    ostream& out) {
+  return GameTreeSnapshot<basegraph>::save(out, thetree, _root,
+                                           getSizeofNodes(guard));
+}
+/// Write the game tree as a compact binary snapshot with internal lock. See GameTree::saveGameTree
+///@param out is the binary output stream
+///@return TRUE if the snapshot is written successfully
+bool LockableGameTree::saveGameTree(ostream& out) {
+  shared_lock<LockableGameTree> guard(*this);
+  return saveGameTree(guard, out);
+}
+/// Replace the game tree with the one read from a binary snapshot with external lock. See GameTree::loadGameTree.
+/// Should not be called while threads are searching on this tree
+///@param unique_lock<LockableGameTree>& is a reader/writer's lock which will grant exclusive right for game tree access
+///@param in is the binary input stream
+///@return TRUE if the snapshot is read successfully. Otherwise FALSE and the game tree remains unchanged
+bool LockableGameTree::loadGameTree(boost::unique_lock<LockableGameTree>& guard,
+                                    istream& in) {
+  basegraph previoustree;
+  previoustree.swap(thetree);
+  vertex_t previousroot = _root;
+  NodeRecycler<basegraph> previousrecycler(recycler);
+  recycler.clear();
+  if (!GameTreeSnapshot<basegraph>::load(
+      in,
+      boost::bind(&LockableGameTree::restoreNode, this, boost::ref(guard), _1,
+                  _2))) {
+    thetree.swap(previoustree);
+    _root = previousroot;
+    recycler = previousrecycler;
+    return false;
+  }
+  childrenoffuture.clear();
+  countonwait.store(0);
+  countforexpand.store(0);
+  isblockingforexpand.store(false);
+  return true;
+}
+/// Replace the game tree with the one read from a binary snapshot with internal lock. See GameTree::loadGameTree
+///@param in is the binary input stream
+///@return TRUE if the snapshot is read successfully. Otherwise FALSE and the game tree remains unchanged
+bool LockableGameTree::loadGameTree(istream& in) {
+  unique_lock<LockableGameTree> guard(*this);
+  return loadGameTree(guard, in);
+}
+/// Create one node from the record of snapshot and connect it to the parent with external lock
+///@param unique_lock<LockableGameTree>& is a reader/writer's lock which will grant exclusive right for game tree access
+///@param parent is the parental node or null_vertex if the record is root
+///@param record is the record of snapshot for the new node
+///@return the newly created node
+LockableGameTree::vertex_t LockableGameTree::restoreNode(
+    boost::unique_lock<LockableGameTree>& guard, vertex_t parent,
+    const GameTreeSnapshot<basegraph>::NodeRecord& record) {
+  vertex_t node = addNode(guard, record.position, record.color);
+  get(vertex_value, thetree, node)->update(AbstractUTCPolicy_visitcount,
+                                           record.visitcount, 0);
+  get(vertex_value, thetree, node)->update(AbstractUTCPolicy_wincount,
+                                           record.wincount, 0);
+  //the node never back-propagated should still be waited in selection phase
+  get(vertex_value, thetree, node)->setIsupdated(record.visitcount > 0);
+  if (parent == graph_traits<basegraph>::null_vertex())
+    _root = node;
+  else
+    addEdge(parent, node);
+  return node;
+}
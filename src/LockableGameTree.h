@@ -10,6 +10,10 @@
 
 #include "Global.h"
 #include "GameTree.h"
+#include "FastRandom.h"
+#include "ArgMaxChooser.h"
+#include "NodeRecycler.h"
+#include "GameTreeSnapshot.h"
 #include "AbstractGameTree.h"
 
 #ifndef NDEBUG
@@ -79,6 +83,18 @@ class LockableUTCPolicy : public lockable_share_type, public AbstractUTCPolicy {
   double estimate();
   ///See UTCPolicy::calculate
   double calculate(AbstractUTCPolicy& parent);
+  ///See UTCPolicy::calculate(double)
+  double calculate(double explorationofparent) {
+    return policy.calculate(explorationofparent);
+  }
+  ///See UTCPolicy::calculate(double, double)
+  double calculate(double explorationofparent, double equivalence) {
+    return policy.calculate(explorationofparent, equivalence);
+  }
+  ///See UTCPolicy::getCoefficient
+  double getCoefficient() const {
+    return policy.getCoefficient();
+  }
   ///See UTCPolicy::update
   bool update(valuekind indexofkind, int value, int increment = 0);
   ///See UTCPolicy::updateAll
@@ -161,11 +177,12 @@ class LockableGameTree : public lockable_share_type, public AbstractGameTree {
   //TODO remove redundancy
   typedef boost::property<boost::vertex_value_t,
       hexgame::shared_ptr<LockableUTCPolicy> > vertex_value_prop;
+  typedef boost::property<boost::vertex_untried_t,
+      std::vector<boost::uint16_t>, vertex_value_prop> vertex_untried_prop;
   typedef boost::property<boost::vertex_color_t, boost::default_color_type,
-      vertex_value_prop> vertex_color_prop;
-  typedef boost::property<boost::vertex_name_t, std::string, vertex_color_prop> vertex_name_prop;
+      vertex_untried_prop> vertex_color_prop;
   typedef boost::property<boost::vertex_position_t, std::size_t,
-      vertex_name_prop> vertex_final_prop;
+      vertex_color_prop> vertex_final_prop;
 
   //for graph and tree
   typedef boost::adjacency_list<boost::listS, boost::vecS,
@@ -180,7 +197,6 @@ class LockableGameTree : public lockable_share_type, public AbstractGameTree {
   typedef boost::graph_traits<basegraph>::out_edge_iterator out_edge_iter;
 
   //for property map
-  typedef boost::property_map<basegraph, boost::vertex_name_t>::type vertex_namemap_t;
   typedef boost::property_map<basegraph, boost::vertex_color_t>::type vertex_colormap_t;
   typedef boost::property_map<basegraph, boost::vertex_value_t>::type vertex_valuemap_t;
   typedef boost::property_map<basegraph, boost::vertex_position_t>::type vertex_positionmap_t;
@@ -193,6 +209,12 @@ class LockableGameTree : public lockable_share_type, public AbstractGameTree {
 
   vertex_t _root;
   basegraph thetree;
+  NodeRecycler<basegraph> recycler;  ///< node budget and free list of recycled vertices
+  ArgMaxChooser vertexchooser;  ///< scratch arrays of children and their scores reused in selection while holding the tree lock
+  FastRandom generator;  ///< generator to shuffle the untried moves for expansion while holding the tree lock
+  ProgressiveWidening widening;  ///< the schedule bounding the number of children by visit count, disabled by default
+  double raveequivalence;  ///< the equivalence parameter of RAVE, 0 (disabled) by default
+  std::vector<signed char> amafowners;  ///< scratch owners of hexgons in a simulated game used while holding the tree lock
   boost::condition_variable_any holdforupdate;
   boost::condition_variable_any holdforselect;
   boost::condition_variable_any holdforexpand;
@@ -210,6 +232,15 @@ class LockableGameTree : public lockable_share_type, public AbstractGameTree {
                      int value, int level);bool notifyAllUpdateDone(
       boost::unique_lock<LockableGameTree>&, vertex_t leaf, int level);
   void updateNodeValue(vertex_t node);  //update the value of a given node
+  vertex_t restoreNode(boost::unique_lock<LockableGameTree>&, vertex_t parent,
+                       const GameTreeSnapshot<basegraph>::NodeRecord& record);
+  std::pair<int, std::size_t> descend(boost::unique_lock<LockableGameTree>&,
+                                      int currentempty, bool isbreaktie,
+                                      DescentState* state);
+  int popUntriedMove(boost::unique_lock<LockableGameTree>&, vertex_t node,
+                     DescentState& state);
+  void applyMove(boost::unique_lock<LockableGameTree>&, vertex_t node,
+                 DescentState& state);
 
   //implement with global lock, internal
   vertex_t addNode(std::size_t positionofchild, char color);
@@ -219,7 +250,6 @@ class LockableGameTree : public lockable_share_type, public AbstractGameTree {
   void initGameTree(char playerscolor, size_t indexofroot);
 
   //implement with local lock, external
-  void updateNodeName(boost::unique_lock<LockableUTCPolicy>&, vertex_t node);  //update the value of a given node
   void updateNodeColor(boost::unique_lock<LockableUTCPolicy>&, vertex_t node,
                        char color);  //update the board position of a given node
   void updateNodePosition(boost::unique_lock<LockableUTCPolicy>&, vertex_t node,
@@ -230,7 +260,6 @@ class LockableGameTree : public lockable_share_type, public AbstractGameTree {
   bool addEdge(vertex_t source, vertex_t target);
 
   //no lock
-  void updateNodeName(vertex_t node);  //update the value of a given node
   void updateNodeColor(vertex_t node, char color);  //update the board position of a given node
   void updateNodePosition(vertex_t node, std::size_t position);
 
@@ -249,7 +278,9 @@ class LockableGameTree : public lockable_share_type, public AbstractGameTree {
     }
     template<typename Node, typename Tree>
     void inorder(Node n, Tree& t) {
-      *_bufiter++ = get(boost::vertex_name, t)[n]
+      *_bufiter++ = getNodeLabel(get(boost::vertex_index, t)[n],
+                                 get(boost::vertex_position, t)[n],
+                                 get(boost::vertex_color, t)[n])
           + get(boost::vertex_value, t)[n].get()->print();
     }
     template<typename Node, typename Tree>
@@ -293,13 +324,28 @@ class LockableGameTree : public lockable_share_type, public AbstractGameTree {
       std::vector<int>& opponents, hexgame::unordered_set<int>& remainingmoves);
   int expandNode(boost::unique_lock<LockableGameTree>&, int indexofsource,
                  int move, char color = 'W');
+  std::pair<int, std::size_t> selectMaxBalanceNode(
+      boost::unique_lock<LockableGameTree>&, int currentempty, bool isbreaktie,
+      DescentState& state);
+  int expandNode(boost::unique_lock<LockableGameTree>&, int indexofsource,
+                 DescentState& state);
   void updateNodefromSimulation(
       boost::unique_lock<LockableGameTree>& guard, int indexofnode, int winner, int level = -1);
+  void updateAmaffromSimulation(boost::unique_lock<LockableGameTree>&,
+                                int indexofnode, int winner,
+                                DescentState& state);
   std::string printGameTree(boost::shared_lock<LockableGameTree>&, int index);  //print out the tree
   void setIsupdatedBackpropagation(boost::unique_lock<LockableGameTree>&,
                                    vertex_t leaf);
   bool getIsupdatedBackpropagation(boost::shared_lock<LockableGameTree>&, int indexofleaf);
   std::vector<size_t> getLeaves(boost::shared_lock<LockableGameTree>&);
+  void setMaxNumofNodes(boost::unique_lock<LockableGameTree>&, std::size_t numofnodes);
+  void setProgressiveWidening(boost::unique_lock<LockableGameTree>&,
+                              const ProgressiveWidening& schedule);
+  void setRaveEquivalence(boost::unique_lock<LockableGameTree>&,
+                          double equivalence);
+  bool saveGameTree(boost::shared_lock<LockableGameTree>&, std::ostream& out);
+  bool loadGameTree(boost::unique_lock<LockableGameTree>&, std::istream& in);
 
   //implement with global lock, internal
   std::size_t getSizeofEdges();
@@ -311,8 +357,22 @@ class LockableGameTree : public lockable_share_type, public AbstractGameTree {
          int indexofnode, std::vector<int>& babywatsons, std::vector<int>& opponents,
          hexgame::unordered_set<int>& remainingmoves);
   int expandNode(int indexofsource, int move, char color = 'W');
+  std::pair<int, std::size_t> selectMaxBalanceNode(int currentempty,
+                                                   bool isbreaktie,
+                                                   DescentState& state);
+  int expandNode(int indexofsource, DescentState& state);
   void updateNodefromSimulation(int indexofnode, int winner, int level = -1);
+  void updateAmaffromSimulation(int indexofnode, int winner,
+                                DescentState& state);
   std::string printGameTree(int key);  //print out the tree
+  bool saveGameTree(std::ostream& out);
+  bool loadGameTree(std::istream& in);
+  void setMaxNumofNodes(std::size_t numofnodes);
+  std::size_t getMaxNumofNodes();
+  void setProgressiveWidening(const ProgressiveWidening& schedule);
+  ProgressiveWidening getProgressiveWidening();
+  void setRaveEquivalence(double equivalence);
+  double getRaveEquivalence();
   std::string name() {
     return std::string("LockableGameTree");
   }
@@ -328,6 +388,7 @@ class LockableGameTree : public lockable_share_type, public AbstractGameTree {
   void setNodePosition(std::size_t indexofnode, std::size_t position);
   std::vector<std::size_t> getLeaves();
   std::vector<std::size_t> getSiblings(std::size_t indexofnode);
+  std::vector<std::size_t> getChildren(std::size_t indexofnode);
   std::size_t getNodePosition(std::size_t indexofnode);
   std::size_t getNumofChildren(std::size_t indexofnode);
   std::size_t getParent(std::size_t indexofchild);
@@ -0,0 +1,130 @@
+/*
+ * MPMCQueue.h
+ * This file defines the bounded lock-free queue of multiple producers and multiple consumers used between the threads of search.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef MPMCQUEUE_H_
+#define MPMCQUEUE_H_
+
+#include <cassert>
+#include <cstddef>
+
+#include "Global.h"
+
+/**
+ * MPMCQueue class is a bounded queue of multiple producers and multiple consumers without lock (D. Vyukov's ring buffer).<br/>
+ * Each cell of the ring carries a sequence number which tells whether the cell is ready for the producer or the consumer
+ * of a given turn; a producer (consumer) claims a cell by one compare-and-swap of the enqueue (dequeue) position and
+ * publishes it by a release store of the sequence, so the element is handed over from one thread to another without
+ * lock. The positions are kept on separate cache lines to avoid false sharing between producers and consumers. Neither
+ * tryPush nor tryPop blocks: they fail when the queue is full or empty and the caller decides to retry or to do other
+ * work.<br/>
+ * MPMCQueue(std::size_t capacity): user defined constructor which takes the capacity of queue which should be a power of
+ * two<br/>
+ * Sample Usage:<br/>
+ * MPMCQueue<int> jobs(64);<br/>
+ * jobs.tryPush(slot); //producer<br/>
+ * int slot;<br/>
+ * if (jobs.tryPop(slot)) //consumer<br/>
+ */
+template<typename T>
+class MPMCQueue {
+ private:
+  static const std::size_t CACHELINESIZE = 64;  ///< the size of cache line in bytes
+  /**
+   * Cell is one element of ring with its sequence number
+   */
+  struct Cell {
+    hexgame::atomic<std::size_t> sequence;  ///< the turn of cell, position for producer and position + 1 for consumer
+    T data;  ///< the element
+  };
+
+  char padding0[CACHELINESIZE];  ///< keep the ring away from the data before the queue
+  Cell* const buffer;  ///< the ring of cells
+  const std::size_t mask;  ///< the capacity minus one
+  char padding1[CACHELINESIZE];  ///< keep the enqueue position on its own cache line
+  hexgame::atomic<std::size_t> enqueueposition;  ///< the position of the next push
+  char padding2[CACHELINESIZE];  ///< keep the dequeue position on its own cache line
+  hexgame::atomic<std::size_t> dequeueposition;  ///< the position of the next pop
+  char padding3[CACHELINESIZE];  ///< keep the dequeue position away from the data after the queue
+
+  ///Copy constructor which is not allowed
+  MPMCQueue(const MPMCQueue&);
+  ///Assignment operator which is not allowed
+  MPMCQueue& operator=(const MPMCQueue&);
+
+ public:
+  ///User defined constructor which takes the capacity of queue
+  ///@param capacity is the maximal number of elements which should be a power of two and at least 2
+  explicit MPMCQueue(std::size_t capacity)
+      : buffer(new Cell[capacity]),
+        mask(capacity - 1) {
+    assert(capacity >= 2 && (capacity & (capacity - 1)) == 0);
+    for (std::size_t i = 0; i < capacity; ++i)
+      buffer[i].sequence.store(i, hexgame::memory_order_relaxed);
+    enqueueposition.store(0, hexgame::memory_order_relaxed);
+    dequeueposition.store(0, hexgame::memory_order_relaxed);
+  }
+  ///destructor
+  ~MPMCQueue() {
+    delete[] buffer;
+  }
+  ///Push an element without blocking
+  ///@param data is the element
+  ///@return TRUE if the element is pushed, FALSE if the queue is full
+  bool tryPush(const T& data) {
+    std::size_t position = enqueueposition.load(hexgame::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = buffer[position & mask];
+      std::size_t sequence = cell.sequence.load(hexgame::memory_order_acquire);
+      std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence)
+          - static_cast<std::ptrdiff_t>(position);
+      if (difference == 0) {
+        if (enqueueposition.compare_exchange_weak(
+            position, position + 1, hexgame::memory_order_relaxed)) {
+          cell.data = data;
+          cell.sequence.store(position + 1, hexgame::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0)
+        return false;
+      else
+        position = enqueueposition.load(hexgame::memory_order_relaxed);
+    }
+  }
+  ///Pop an element without blocking
+  ///@param data is the element popped
+  ///@return TRUE if an element is popped, FALSE if the queue is empty
+  bool tryPop(T& data) {
+    std::size_t position = dequeueposition.load(hexgame::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = buffer[position & mask];
+      std::size_t sequence = cell.sequence.load(hexgame::memory_order_acquire);
+      std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence)
+          - static_cast<std::ptrdiff_t>(position + 1);
+      if (difference == 0) {
+        if (dequeueposition.compare_exchange_weak(
+            position, position + 1, hexgame::memory_order_relaxed)) {
+          data = cell.data;
+          cell.sequence.store(position + mask + 1,
+                              hexgame::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0)
+        return false;
+      else
+        position = dequeueposition.load(hexgame::memory_order_relaxed);
+    }
+  }
+  ///Get the capacity of queue
+  ///@param NONE
+  ///@return the maximal number of elements
+  std::size_t getCapacity() const {
+    return mask + 1;
+  }
+};
+
+#endif /* MPMCQUEUE_H_ */
@@ -7,6 +7,8 @@
 
 #include "Global.h"
 #include "GameTree.h"
+#include "PositionHash.h"
+#include "SearchMonitor.h"
 #include "MonteCarloTreeSearch.h"
 
 #include <algorithm>
@@ -53,38 +55,189 @@ MonteCarloTreeSearch::MonteCarloTreeSearch(const HexBoard* board,
       numberoftrials(numberoftrials) {
   init();
 }
+/**
+ * SearchContext is the state of a search kept across the slices of simulated games (see beginSearch)
+ */
+struct MonteCarloTreeSearch::SearchContext {
+  hexgame::shared_ptr<bool> emptyglobal;  ///< the empty hexgons of the actual game state
+  std::vector<int> bwglobal;  ///< the moves of AI player in the actual game state
+  std::vector<int> oppglobal;  ///< the moves of the opponent in the actual game state
+  std::vector<int> mustplay;  ///< the region of moves at root where the threat of the opponent must be stopped
+  std::vector<int> rootpriors;  ///< the priors of moves at root, empty to order them by neighbor count
+  boost::uint64_t key;  ///< the position key of transposition table, 0 if no table is used
+  int currentempty;  ///< the number of empty hexgons which are not pruned
+  InferiorCellAnalysis analysis;  ///< the analysis of inferior hexgons
+  GameTree gametree;  ///< the game tree of search
+  DescentState state;  ///< the game state reused across simulated games
+  PatternPlayout policy;  ///< the pattern play-out policy
+  TwoDistanceEvaluator evaluator;  ///< the static evaluator replacing play-out
+  FastRandom generator;  ///< the generator choosing between play-out and evaluation
+  std::size_t numofsimulated;  ///< the number of simulated games so far
+  bool isstopped;  ///< TRUE when the monitor requested to stop
+  ///User defined constructor which takes the tables of board and the color label of root
+  SearchContext(const BoardTopology& topology, char playerslabel)
+      : key(0),
+        currentempty(0),
+        analysis(topology),
+        gametree(playerslabel),
+        policy(topology),
+        evaluator(topology),
+        numofsimulated(0),
+        isstopped(false) {
+  }
+};
 ///Overwritten simulation method. See AbstractStrategy.
 int MonteCarloTreeSearch::simulation(int currentempty) {
-  hexgame::shared_ptr<bool> emptyglobal;
-  vector<int> bwglobal, oppglobal;
-  initGameState(emptyglobal, bwglobal, oppglobal);
-  GameTree gametree(ptrtoplayer->getViewLabel());
-  for (size_t i = 0; i < numberoftrials; ++i) {
-    //initialize the following containers to the current progress of playing board
-    vector<int> babywatsons(bwglobal), opponents(oppglobal);
-    hexgame::shared_ptr<bool> emptyindicators = hexgame::shared_ptr<bool>(
-        new bool[ptrtoboard->getSizeOfVertices()],
-        hexgame::default_delete<bool[]>());
-    copy(emptyglobal.get(), emptyglobal.get() + ptrtoboard->getSizeOfVertices(),
-         emptyindicators.get());
-    int proportionofempty = currentempty;
-
-    //in-tree phase
-    pair<int,int> selecresult = selection(currentempty, gametree);
-    int expandednode = expansion(selecresult, emptyindicators, proportionofempty,
-                                 babywatsons, opponents, gametree);
-    //simulation phase
-    int winner = playout(emptyindicators, proportionofempty, babywatsons,
-                         opponents);
-    assert(winner != 0);
-    //back-propagate
-    backpropagation(expandednode, winner, gametree);
+  int move = beginSearch(currentempty);
+  if (move > 0)
+    return move;
+  continueSearch(numberoftrials);
+  return endSearch();
+}
+///Begin a search of the actual game state whose simulated games are run in slices by continueSearch and whose move is
+///chosen by endSearch. The state of search is kept by the strategy, hence one search runs at a time and the board should not
+///be modified until endSearch
+///@param currentempty is the current empty hexgons or positions left in the actual game state
+///@return the move decided without simulation by transposition table or virtual connections, or 0 if the search begins
+int MonteCarloTreeSearch::beginSearch(int currentempty) {
+  context.reset(new SearchContext(topology, ptrtoplayer->getViewLabel()));
+  SearchContext& search = *context;
+  initGameState(search.emptyglobal, search.bwglobal, search.oppglobal);
+  //the position searched before by this or another process sharing the table
+  if (ptrtotable != nullptr) {
+    search.key = PositionHash::hashBoard(*ptrtoboard,
+                                         ptrtoplayer->getPlayerlabel());
+    SharedTranspositionTable::Entry entry;
+    size_t required = min(
+        numberoftrials,
+        static_cast<size_t>(SharedTranspositionTable::MAXVISITCOUNT));
+    if (ptrtotable->probe(search.key, entry)
+        && static_cast<size_t>(entry.visitcount) >= required
+        && entry.move <= ptrtoboard->getSizeOfVertices()
+        && search.emptyglobal.get()[entry.move - 1]) {
+      lastwinningrate = static_cast<double>(entry.wincount) / entry.visitcount;
+      RootStatistics statistics = { entry.move, entry.visitcount,
+          entry.wincount };
+      lastrootstatistics.assign(1, statistics);
+      context.reset();
+      return entry.move;
+    }
+  }
+  int winningmove = searchConnections(search.bwglobal, search.oppglobal,
+                                      search.mustplay);
+  if (winningmove > 0) {
+    lastwinningrate = 1.0;
+    RootStatistics statistics = { winningmove, static_cast<int>(numberoftrials),
+        static_cast<int>(numberoftrials) };
+    lastrootstatistics.assign(1, statistics);
+    if (ptrtotable != nullptr)
+      ptrtotable->store(search.key, statistics.visitcount, statistics.wincount,
+                        winningmove);
+    context.reset();
+    return winningmove;
+  }
+  search.currentempty = currentempty
+      - analyzeInferiorCells(search.emptyglobal, search.bwglobal,
+                             search.oppglobal, search.analysis);
+  search.gametree.setMaxNumofNodes(maxnumofnodes);
+  search.gametree.setProgressiveWidening(widening);
+  search.gametree.setRaveEquivalence(raveequivalence);
+  search.state.setNeighborTable(&neighbortable);
+  getRootPriors(search.bwglobal, search.oppglobal, search.rootpriors);
+  search.state.setRootPriors(
+      search.rootpriors.empty() ? NULL : &search.rootpriors);
+  return 0;
+}
+///Run a slice of simulated games of the search begun by beginSearch
+///@param numoftrials is the maximal number of simulated games of the slice
+///@return the number of simulated games run, fewer than requested when the search is done
+std::size_t MonteCarloTreeSearch::continueSearch(std::size_t numoftrials) {
+  if (isSearchDone())
+    return 0;
+  SearchContext& search = *context;
+  SearchMonitor* monitor = getSearchMonitor();
+  size_t i = 0;
+  for (; i < numoftrials && search.numofsimulated < numberoftrials; ++i) {
+    runSimulatedGame(search);
+    //the request to stop is checked after every simulated game, hence at least one game is simulated
+    if (monitor != nullptr) {
+      if (monitor->isStopRequested()) {
+        search.isstopped = true;
+        return i + 1;
+      }
+      if (search.numofsimulated % monitor->getInterval() == 0)
+        publishSnapshot(search.gametree, search.numofsimulated, false);
+    }
   }
-  int resultmove = getBestMove(gametree);
+  return i;
+}
+///Check if the search begun by beginSearch needs no more simulated games
+///@param NONE
+///@return TRUE if no search is begun, all simulated games are run or the monitor requested to stop
+bool MonteCarloTreeSearch::isSearchDone() const {
+  return !context || context->isstopped
+      || context->numofsimulated >= numberoftrials;
+}
+///Get the number of simulated games run by the search begun by beginSearch
+///@param NONE
+///@return the number of simulated games so far, 0 if no search is begun
+std::size_t MonteCarloTreeSearch::getNumofSimulated() const {
+  return context ? context->numofsimulated : 0;
+}
+///End the search begun by beginSearch, which may be cut short before all simulated games are run, e.g. by a deadline
+///@param NONE
+///@return the move with the maximal successful simulated outcome, -1 if no search is begun
+int MonteCarloTreeSearch::endSearch() {
+  if (!context)
+    return -1;
+  SearchContext& search = *context;
+  if (search.numofsimulated == 0)
+    runSimulatedGame(search);
+  recordRootStatistics(search.gametree);
+  int resultmove = getBestMove(search.gametree);
   //find the move with the maximal successful simulated outcome
   assert(resultmove != -1);
+  if (getSearchMonitor() != nullptr)
+    publishSnapshot(search.gametree, search.numofsimulated, true);
+  if (ptrtotable != nullptr)
+    ptrtotable->store(
+        search.key, static_cast<int>(search.numofsimulated),
+        static_cast<int>(lastwinningrate * search.numofsimulated + 0.5),
+        resultmove);
+  context.reset();
   return resultmove;
 }
+///Run one simulated game of a search: selection, expansion, play-out or evaluation and back-propagation
+///@param search is the state of search
+///@return NONE
+void MonteCarloTreeSearch::runSimulatedGame(SearchContext& search) {
+  //initialize the state to the current progress of playing board, the buffers are reused across simulated games
+  search.state.reset(search.emptyglobal, ptrtoboard->getSizeOfVertices(),
+                     search.bwglobal, search.oppglobal);
+  search.analysis.apply(search.state);
+  search.state.setRootRegion(search.mustplay);
+
+  //in-tree phase
+  pair<int, int> selecresult = selection(search.currentempty, search.gametree,
+                                         search.state);
+  int expandednode = expansion(selecresult, search.state, search.gametree);
+  //simulation phase
+  int winner;
+  if (evaluationrate > 0.0 && search.generator.nextUniform() < evaluationrate)
+    winner = evaluation(search.state, search.evaluator, search.generator);
+  else
+    winner =
+        ispatternplayout ?
+            playout(search.state, search.policy) :
+            playout(search.state.getEmptyIndicators(),
+                    search.state.getNumofEmpty(),
+                    search.state.getBabywatsons(),
+                    search.state.getOpponents());
+  assert(winner != 0);
+  //back-propagate
+  backpropagation(expandednode, winner, search.gametree, search.state);
+  ++search.numofsimulated;
+}
 //in-tree phase
 ///The first phase in MCTS. Selection phase is according to UTC Policy and maximizing winning rate in play-out phase
 ///@param currentempty is the current empty hexgons or positions left in the actual game state which will be the number of children nodes of root of game tree
@@ -94,6 +247,16 @@ pair<int,int> MonteCarloTreeSearch::selection(int currentempty, AbstractGameTree
   //when the board is not empty, return the node with the highest expected value
   return gametree.selectMaxBalanceNode(currentempty, true);
 }
+///The first phase in MCTS which also applies the moves of the nodes on the selected path to the game state
+///@param currentempty is the current empty hexgons or positions left in the actual game state which will be the number of children nodes of root of game tree
+///@param gametree is a game tree object which stores the simulation progress and result
+///@param state is the game state reset to the actual game state which will be the game state of the selected node
+///@return a pair of integers; the first is the index of selected node of game tree and the second is the depth or level of selected node on game tree.
+pair<int, int> MonteCarloTreeSearch::selection(int currentempty,
+                                               AbstractGameTree& gametree,
+                                               DescentState& state) {
+  return gametree.selectMaxBalanceNode(currentempty, true, state);
+}
 ///The second phase in MCTS. Expansion phase will take the result from selection phase and return the index of expanded node. Several required containers are also processed according to the game state of the selected tree node
 ///@param selectresult is the pair of integers returned by selection method
 ///@param emptyindicators stores indicator of a position on the hex board is empty or not which will be modified when a simulated game progresses
@@ -158,6 +321,27 @@ int MonteCarloTreeSearch::expansion(pair<int,int> selectresult,
 
   return indexofchild;
 }
+///The second phase in MCTS which expands the selected node with one of its untried moves. Unlike the other expansion, the
+///game state is already advanced by selection, so the game history is not reconstructed from the tree
+///@param selectresult is the pair of integers returned by selection method
+///@param state is the game state of the selected node which will be the game state of the expanded node
+///@param gametree is a game tree object which stores the simulation progress and result
+///@return the index of expanded child if the tree is still expandable or the index of selected node if the tree is unable to be expanded (reach the end of game)
+int MonteCarloTreeSearch::expansion(pair<int, int> selectresult,
+                                    DescentState& state,
+                                    AbstractGameTree& gametree) {
+  int indexofchild = selectresult.first;
+  if (state.getNumofCandidates() > 0)  //the selected node is not the end of game or of the candidates
+    indexofchild = gametree.expandNode(selectresult.first, state);
+
+  assert(
+      state.getNumofEmpty()
+          == count(state.getEmptyIndicators().get(),
+                   state.getEmptyIndicators().get()
+                       + ptrtoboard->getSizeOfVertices(),
+                   true));
+  return indexofchild;
+}
 ///The third phase in MCTS. The play-out phase will take the containers processed in expansion phase and start simulation by self-playing. The play result will back-propagate update in game tree
 ///@param emptyindicators is the number of empty hexgons left in the current actual game state which will be modified during simulated games
 ///@param portionofempty is the number of empty hexgons left in the current actual game state which will be modified during simulated games
@@ -183,6 +367,38 @@ int MonteCarloTreeSearch::playout(hexgame::shared_ptr<bool>& emptyindicators,
 
   return winner;
 }
+///The third phase in MCTS which draws the moves by the given policy, i.e. the intrusions into the bridges and edge templates
+///of the player to move are answered and other moves are uniformly random. The players alternate from the player to move
+///of the state, hence the opponent moves first when the selected path ends on a move of AI player
+///@param state is the game state advanced by selection and expansion which will be filled up during simulated games
+///@param policy is the play-out policy owned by the calling thread
+///@return an integer indicates -1, babywatson loses and 1 babywatson wins
+int MonteCarloTreeSearch::playout(DescentState& state, PatternPlayout& policy) {
+  policy.reset(state, ptrtoplayer->getWestToEastCondition());
+  int lastmove = state.getLastMove();
+  bool isbabywatson = state.isBabywatsonToMove();
+  while (state.getNumofEmpty() > 0) {
+    lastmove = policy.genMove(state, isbabywatson, lastmove);
+    isbabywatson = !isbabywatson;
+  }
+  int winner = checkWinnerExist(state.getBabywatsons(), state.getOpponents());
+  assert(winner != 0);
+
+  return winner;
+}
+///The replacement of the third phase in MCTS which evaluates the game state by the two-distances of both players instead
+///of playing it out, and draws the outcome from the winning rate of evaluation
+///@param state is the game state advanced by selection and expansion which is not modified
+///@param evaluator is the evaluator owned by the calling thread
+///@param generator is the generator owned by the calling thread to draw the outcome
+///@return an integer indicates -1, babywatson loses and 1 babywatson wins
+int MonteCarloTreeSearch::evaluation(DescentState& state,
+                                     TwoDistanceEvaluator& evaluator,
+                                     FastRandom& generator) {
+  evaluator.evaluate(state, ptrtoplayer->getWestToEastCondition());
+  double winningrate = evaluator.getWinningRate(state.isBabywatsonToMove());
+  return (generator.nextUniform() < winningrate) ? 1 : -1;
+}
 ///The fourth and last phase in MCTS. The backpropagation phase will take the simulated result from play-out phase and expanded node from expansion phase
 ///@param expandednode is the node expanded at the expansioni phase
 ///@param winner is the play result of play-out phase.
@@ -192,20 +408,169 @@ void MonteCarloTreeSearch::backpropagation(int expandednode, int winner,
                                            AbstractGameTree& gametree) {
   gametree.updateNodefromSimulation(expandednode, winner, -1);
 }
+///The fourth and last phase in MCTS which also updates the AMAF statistics of game tree by all moves of the simulated game
+///when RAVE is enabled
+///@param expandednode is the node expanded at the expansion phase
+///@param winner is the play result of play-out phase.
+///@param gametree is a game tree object which stores the simulation progress and result
+///@param state is the game state at the end of play-out phase
+///@return NONE
+void MonteCarloTreeSearch::backpropagation(int expandednode, int winner,
+                                           AbstractGameTree& gametree,
+                                           DescentState& state) {
+  gametree.updateNodefromSimulation(expandednode, winner, -1);
+  if (raveequivalence > 0.0)
+    gametree.updateAmaffromSimulation(expandednode, winner, state);
+}
+///Fill the dead and captured hexgons of the actual game state and find the inferior moves of both players when pruning is
+///enabled; otherwise the game state and the analysis are left untouched
+///@param emptyglobal is the indicators of empty hexgons of the actual game state which will be filled
+///@param bwglobal is the moves made by AI player in the actual game state which will be filled
+///@param oppglobal is the moves made by the opponent in the actual game state which will be filled
+///@param analysis is the analysis whose inferior moves will be applied to the state of every simulated game
+///@return the number of filled hexgons
+int MonteCarloTreeSearch::analyzeInferiorCells(
+    hexgame::shared_ptr<bool>& emptyglobal, vector<int>& bwglobal,
+    vector<int>& oppglobal, InferiorCellAnalysis& analysis) {
+  if (!isinferiorpruning)
+    return 0;
+  analysis.analyze(emptyglobal, bwglobal, oppglobal,
+                   ptrtoplayer->getWestToEastCondition());
+  return analysis.fill(emptyglobal, bwglobal, oppglobal);
+}
+///Search the virtual connections of both players in the actual game state when the search is enabled. The connections are
+///kept across moves, so only the stones played since the last search are applied
+///@param bwglobal is the moves made by AI player in the actual game state
+///@param oppglobal is the moves made by the opponent in the actual game state
+///@param mustplay is the hexgons where AI player must play to stop the semi connection of the opponent, empty if the
+///opponent does not threaten to win
+///@return the move which wins by the connections of AI player, 0 if none
+int MonteCarloTreeSearch::searchConnections(const vector<int>& bwglobal,
+                                            const vector<int>& oppglobal,
+                                            vector<int>& mustplay) {
+  mustplay.clear();
+  if (!isvcsearch)
+    return 0;
+  if (!babywatsonconnections) {
+    babywatsonconnections = hexgame::shared_ptr<HSearch>(
+        new HSearch(topology, ptrtoplayer->getWestToEastCondition()));
+    opponentconnections = hexgame::shared_ptr<HSearch>(
+        new HSearch(topology, !ptrtoplayer->getWestToEastCondition()));
+  }
+  vector<signed char> colors(ptrtoboard->getSizeOfVertices(), 0);
+  for (size_t i = 0; i < bwglobal.size(); ++i)
+    if (bwglobal[i] > 0)
+      colors[bwglobal[i] - 1] = 1;
+  for (size_t i = 0; i < oppglobal.size(); ++i)
+    if (oppglobal[i] > 0)
+      colors[oppglobal[i] - 1] = -1;
+  babywatsonconnections->update(colors);
+  int winningmove = babywatsonconnections->getWinningMove();
+  if (winningmove > 0)
+    return winningmove;
+  for (size_t i = 0; i < colors.size(); ++i)
+    colors[i] = -colors[i];
+  opponentconnections->update(colors);
+  opponentconnections->getMustPlay(mustplay);
+  return 0;
+}
+///Compute the priors of moves at root by the evaluators enabled, which are summed if both TwoDistanceEvaluator and
+///ResistanceEvaluator are enabled. The resistance evaluator is kept across moves, so its last solutions are the initial
+///guess of the next search
+///@param bwglobal is the moves made by AI player in the actual game state
+///@param oppglobal is the moves made by the opponent in the actual game state
+///@param rootpriors is the priors of moves indexed by position - 1, empty if no evaluator is enabled
+///@return NONE
+void MonteCarloTreeSearch::getRootPriors(const vector<int>& bwglobal,
+                                         const vector<int>& oppglobal,
+                                         vector<int>& rootpriors) {
+  rootpriors.clear();
+  if (istwodistanceprior) {
+    TwoDistanceEvaluator evaluator(topology);
+    evaluator.evaluate(bwglobal, oppglobal,
+                       ptrtoplayer->getWestToEastCondition());
+    evaluator.getPriors(rootpriors);
+  }
+  if (isresistanceprior) {
+    if (!resistanceevaluator)
+      resistanceevaluator = hexgame::shared_ptr<ResistanceEvaluator>(
+          new ResistanceEvaluator(topology));
+    resistanceevaluator->evaluate(bwglobal, oppglobal,
+                                  ptrtoplayer->getWestToEastCondition());
+    vector<int> priors;
+    resistanceevaluator->getPriors(priors);
+    if (rootpriors.empty())
+      rootpriors.swap(priors);
+    else
+      for (size_t i = 0; i < priors.size(); ++i)
+        rootpriors[i] += priors[i];
+  }
+}
 ///Get the best move according to estimation result from game tree
 ///@param gametree is a game tree object which stores the simulation progress and result
 ///@return the best move estimated by gametree which will be passed to genMove
 int MonteCarloTreeSearch::getBestMove(AbstractGameTree& gametree) {
   pair<int, double> result = gametree.getBestMovefromSimulation();
   int bestmove = gametree.getNodePosition(result.first);
+  lastwinningrate = result.second;
   assert(bestmove != -1);
   return bestmove;
 }
+///Keep the visit and win counts of the children of root which are merged with the ones of other searches of the same game
+///state (see ClusterMonteCarloTreeSearch)
+///@param gametree is a game tree object which stores the simulation progress and result
+///@return NONE
+void MonteCarloTreeSearch::recordRootStatistics(GameTree& gametree) {
+  vector<size_t> children = gametree.getChildren(0);
+  lastrootstatistics.resize(children.size());
+  for (size_t i = 0; i < children.size(); ++i) {
+    lastrootstatistics[i].move = static_cast<int>(gametree.getNodePosition(
+        children[i]));
+    lastrootstatistics[i].visitcount = gametree.getNodeValueFeature(
+        children[i], AbstractUTCPolicy_visitcount);
+    lastrootstatistics[i].wincount = gametree.getNodeValueFeature(
+        children[i], AbstractUTCPolicy_wincount);
+  }
+}
+///Publish the best move and the statistics of the moves at root of game tree to the monitor of simulation
+///@param gametree is a game tree object which stores the simulation progress and result
+///@param numofsimulated is the number of simulated games so far
+///@param isblocking is TRUE to wait for the observers copying the previous snapshot, FALSE to skip publishing instead
+///@return NONE
+void MonteCarloTreeSearch::publishSnapshot(GameTree& gametree,
+                                           std::size_t numofsimulated,
+                                           bool isblocking) {
+  SearchMonitor::Snapshot& snapshot = getSearchMonitor()->getStaging();
+  pair<int, double> result = gametree.getBestMovefromSimulation();
+  snapshot.bestmove = gametree.getNodePosition(result.first);
+  snapshot.winningrate = result.second;
+  snapshot.numoftrials = numofsimulated;
+  if (!isblocking)
+    recordRootStatistics(gametree);
+  snapshot.statistics.assign(lastrootstatistics.begin(),
+                             lastrootstatistics.end());
+  getSearchMonitor()->publish(isblocking);
+}
 ///initialize babywatsoncolor and oppoenetcolor
 ///@param NONE
 ///@return NONE
 void MonteCarloTreeSearch::init() {
   numofhexgons = ptrtoboard->getNumofhexgons();
+  lastwinningrate = 0.0;
+  maxnumofnodes = 0;
+  raveequivalence = 0.0;
+  ispatternplayout = false;
+  isinferiorpruning = false;
+  isvcsearch = false;
+  evaluationrate = 0.0;
+  istwodistanceprior = false;
+  isresistanceprior = false;
+  ptrtotable = nullptr;
+  //the untried moves of game tree are ordered by the number of occupied neighbors
+  neighbortable.resize(ptrtoboard->getSizeOfVertices());
+  for (int i = 0; i < ptrtoboard->getSizeOfVertices(); ++i)
+    neighbortable[i] = ptrtoboard->getNeighbors(i + 1);
+  topology = BoardTopology(*ptrtoboard);
   babywatsoncolor = 'B', oppoenetcolor = 'R';
   if (babywatsoncolor != ptrtoplayer->getViewLabel()) {
     oppoenetcolor = babywatsoncolor;
@@ -12,11 +12,22 @@
 #include "HexBoard.h"
 #include "AbstractGameTree.h"
 #include "AbstractStrategyImpl.h"
+#include "BoardTopology.h"
+#include "PatternPlayout.h"
+#include "InferiorCellAnalysis.h"
+#include "HSearch.h"
+#include "FastRandom.h"
+#include "TwoDistanceEvaluator.h"
+#include "ResistanceEvaluator.h"
+#include "SharedTranspositionTable.h"
 #include "MonteCarloTreeSearch.h"
 
 #ifndef NDEBUG
 #include "gtest/gtest_prod.h"
 #endif
+
+class GameTree;
+
 /** MonteCarloTreeSearch class defines a Monte Carlo Tree Search implementation for AI player
  * MonteCarloTreeSearch class is the implementation of Monte Carlo Tree Search which include four phases: select, expansion,
  * play-out and back-propagation. <br/>
@@ -31,6 +42,16 @@
  * Sample Usage: Please see Strategy (similar way to instantiate)
  */
 class MonteCarloTreeSearch : public AbstractStrategyImpl {
+ public:
+  /**
+   * RootStatistics is the outcome of the simulated games through one move at root of game tree
+   */
+  struct RootStatistics {
+    int move;  ///< the index of hexgon (starting from 1)
+    int visitcount;  ///< the number of simulated games through the move
+    int wincount;  ///< the number of simulated games through the move won by AI player
+  };
+
  private:
   int numofhexgons; ///< the actual playing board in the game. Need to ensure it not to be modified during the simulation
   const HexBoard* const ptrtoboard; ///< The actual playing board in the game. Need to ensure it not to be modified during the simulation
@@ -38,35 +59,100 @@ class MonteCarloTreeSearch : public AbstractStrategyImpl {
   const std::size_t numberoftrials; ///< The number of simulated games which affects the sampling size of Monte Carlo method. 2048 by default
   char babywatsoncolor; ///< The color of AI player which is represented as single character. For example, if color of AI player is RED, then character is 'R'. BLUE as 'B'
   char oppoenetcolor; ///< The color of AI player's opponent which is represented as single character. For example, if color of AI player is RED, then character for opponent is 'B'. BLUE as 'R'
+  double lastwinningrate; ///< The estimated winning rate of the best move returned by the last simulation
+  std::size_t maxnumofnodes; ///< The maximal number of nodes kept in game tree during simulation. 0 (unlimited) by default
+  ProgressiveWidening widening; ///< The schedule of progressive widening of game tree during simulation. Disabled by default
+  double raveequivalence; ///< The equivalence parameter of RAVE in game tree during simulation. 0 (disabled) by default
+  std::vector<std::vector<int> > neighbortable; ///< The neighbors of every hexgon used as the move prior of game tree
+  BoardTopology topology; ///< The tables of bridges and edge templates used by the pattern play-out policy
+  bool ispatternplayout; ///< The indicator of play-out phase answering bridge intrusions by PatternPlayout. FALSE (uniform) by default
+  bool isinferiorpruning; ///< The indicator of filling dead and captured hexgons and pruning inferior moves by InferiorCellAnalysis before simulation. FALSE by default
+  bool isvcsearch; ///< The indicator of searching the virtual connections of both players by HSearch before simulation. FALSE by default
+  hexgame::shared_ptr<HSearch> babywatsonconnections; ///< The virtual connections of AI player kept across moves, created by the first search
+  hexgame::shared_ptr<HSearch> opponentconnections; ///< The virtual connections of the opponent kept across moves, created by the first search
+  double evaluationrate; ///< The fraction of simulated games whose outcome is drawn from TwoDistanceEvaluator instead of play-out. 0 (play-out only) by default
+  bool istwodistanceprior; ///< The indicator of ordering the moves at root by the priors of TwoDistanceEvaluator. FALSE by default
+  bool isresistanceprior; ///< The indicator of ordering the moves at root by the priors of ResistanceEvaluator. FALSE by default
+  hexgame::shared_ptr<ResistanceEvaluator> resistanceevaluator; ///< The resistance evaluator whose solutions are kept across moves, created by the first evaluation
+  std::vector<RootStatistics> lastrootstatistics; ///< The statistics of the moves at root of game tree of the last simulation
+  SharedTranspositionTable* ptrtotable; ///< The table of position statistics shared with other processes, nullptr if not used. Not owned by strategy
+  struct SearchContext;
+  hexgame::shared_ptr<SearchContext> context; ///< The state of search begun by beginSearch, empty if no search is begun
 
  private:
   ///get the best move from game tree
   int getBestMove(AbstractGameTree& gametree);
+  ///keep the statistics of the moves at root of game tree
+  void recordRootStatistics(GameTree& gametree);
+  ///run one simulated game of a search
+  void runSimulatedGame(SearchContext& search);
+  ///publish the progress of simulation to the monitor
+  void publishSnapshot(GameTree& gametree, std::size_t numofsimulated,
+                       bool isblocking);
   ///Overwritten simulation method. See AbstractStrategy.
   int simulation(int currentempty);
   //Monte Carlo tree search steps
   //in-tree phase
   ///selection phase implementation
   std::pair<int,int> selection(int currentempty, AbstractGameTree& gametree);
+  ///selection phase implementation which advances the game state along the selected path
+  std::pair<int, int> selection(int currentempty, AbstractGameTree& gametree,
+                                DescentState& state);
   ///expansion phase implementation
   int expansion(std::pair<int,int> selectresult, hexgame::shared_ptr<bool>& emptyindicators,
                 int& portionofempty, std::vector<int>& babywatsons,
                 std::vector<int>& opponents, AbstractGameTree& gametree);
+  ///expansion phase implementation which applies the expanded move to the game state advanced by selection
+  int expansion(std::pair<int, int> selectresult, DescentState& state,
+                AbstractGameTree& gametree);
   ///play-out phase implementation
   int playout(hexgame::shared_ptr<bool>& emptyindicators, int& portionofempty,
               std::vector<int>& babywatsons, std::vector<int>& opponents);
+  ///play-out phase implementation which draws the moves from the game state advanced by expansion by the given policy
+  int playout(DescentState& state, PatternPlayout& policy);
+  ///play-out phase replacement which draws the outcome of the game state advanced by expansion from static evaluation
+  int evaluation(DescentState& state, TwoDistanceEvaluator& evaluator,
+                 FastRandom& generator);
   ///back-propagation phase implementation
   void backpropagation(int expandednode, int winner, AbstractGameTree& gametree);
+  ///back-propagation phase implementation which also updates AMAF statistics by the moves of the simulated game
+  void backpropagation(int expandednode, int winner, AbstractGameTree& gametree,
+                       DescentState& state);
+  ///fill the dead and captured hexgons of the actual game state and find the inferior moves when pruning is enabled
+  int analyzeInferiorCells(hexgame::shared_ptr<bool>& emptyglobal,
+                           std::vector<int>& bwglobal,
+                           std::vector<int>& oppglobal,
+                           InferiorCellAnalysis& analysis);
+  ///search the virtual connections of both players in the actual game state when the search is enabled
+  int searchConnections(const std::vector<int>& bwglobal,
+                        const std::vector<int>& oppglobal,
+                        std::vector<int>& mustplay);
+  ///compute the priors of moves at root by the evaluators enabled
+  void getRootPriors(const std::vector<int>& bwglobal,
+                     const std::vector<int>& oppglobal,
+                     std::vector<int>& rootpriors);
   ///initialize babywatsoncolor and oppoenetcolor
   void init();
 
   friend class MultiMonteCarloTreeSearch;
+  friend class PipelinedMonteCarloTreeSearch;
+  friend class ClusterMonteCarloTreeSearch;
 
 #ifndef NDEBUG
   //for google test framework
   friend class MinMaxTest;
   FRIEND_TEST(MinMaxTest,MCSTExpansion);
   FRIEND_TEST(MinMaxTest,SimulationCombine);
+  FRIEND_TEST(MinMaxTest,GameTreeNodeBudget);
+  FRIEND_TEST(MinMaxTest,GameTreeSnapshotRoundTrip);
+  FRIEND_TEST(MinMaxTest,MCSTDescentState);
+  FRIEND_TEST(MinMaxTest,MCSTProgressiveWidening);
+  FRIEND_TEST(MinMaxTest,MCSTRaveStatistics);
+  FRIEND_TEST(MinMaxTest,MCSTPatternPlayout);
+  FRIEND_TEST(MinMaxTest,MCSTInferiorCells);
+  FRIEND_TEST(MinMaxTest,MCSTVirtualConnections);
+  FRIEND_TEST(MinMaxTest,MCSTTwoDistance);
+  FRIEND_TEST(MinMaxTest,MCSTResistance);
 #endif
 
  public:
@@ -91,5 +177,152 @@ class MonteCarloTreeSearch : public AbstractStrategyImpl {
   std::size_t getNumberoftrials() {
     return numberoftrials;
   }
+  //Begin a search of the actual game state whose simulated games are run in slices
+  int beginSearch(int currentempty);
+  //Run a slice of simulated games of the search begun by beginSearch
+  std::size_t continueSearch(std::size_t numoftrials);
+  //Check if the search begun by beginSearch needs no more simulated games
+  bool isSearchDone() const;
+  //Get the number of simulated games run by the search begun by beginSearch
+  std::size_t getNumofSimulated() const;
+  //End the search begun by beginSearch and choose the move
+  int endSearch();
+  ///Getter for retrieving the estimated winning rate of the best move of the last simulation
+  ///@param NONE
+  ///@return the winning rate of the last best move, 0.0 if no simulation has been done
+  double getLastWinningRate() const {
+    return lastwinningrate;
+  }
+  ///Getter for retrieving the statistics of the moves at root of game tree of the last simulation
+  ///@param NONE
+  ///@return the statistics in the order of expansion, a single move with all simulated games won if the last simulation
+  ///found a winning move by virtual connections
+  const std::vector<RootStatistics>& getLastRootStatistics() const {
+    return lastrootstatistics;
+  }
+  ///Setter for the maximal number of nodes kept in game tree which bounds the memory used by simulation
+  ///@param numofnodes is the maximal number of nodes, 0 for unlimited
+  ///@return NONE
+  void setMaxNumofNodes(std::size_t numofnodes) {
+    maxnumofnodes = numofnodes;
+  }
+  ///Getter for the maximal number of nodes kept in game tree
+  ///@param NONE
+  ///@return the maximal number of nodes, 0 for unlimited
+  std::size_t getMaxNumofNodes() const {
+    return maxnumofnodes;
+  }
+  ///Setter for the schedule of progressive widening of game tree which bounds the number of children by visit count
+  ///@param schedule is the schedule of progressive widening, the default constructed one disables widening
+  ///@return NONE
+  void setProgressiveWidening(const ProgressiveWidening& schedule) {
+    widening = schedule;
+  }
+  ///Getter for the schedule of progressive widening of game tree
+  ///@param NONE
+  ///@return the schedule of progressive widening
+  const ProgressiveWidening& getProgressiveWidening() const {
+    return widening;
+  }
+  ///Setter for the equivalence parameter of RAVE which blends AMAF winning rate into selection of game tree
+  ///@param equivalence is the equivalence parameter, 0 to disable RAVE
+  ///@return NONE
+  void setRaveEquivalence(double equivalence) {
+    raveequivalence = equivalence;
+  }
+  ///Getter for the equivalence parameter of RAVE
+  ///@param NONE
+  ///@return the equivalence parameter, 0 if RAVE is disabled
+  double getRaveEquivalence() const {
+    return raveequivalence;
+  }
+  ///Setter for the play-out policy which answers bridge intrusions and edge template intrusions instead of uniform moves
+  ///@param ispattern is TRUE to use PatternPlayout in play-out phase, FALSE for uniform random moves
+  ///@return NONE
+  void setPatternPlayout(bool ispattern) {
+    ispatternplayout = ispattern;
+  }
+  ///Getter for the play-out policy
+  ///@param NONE
+  ///@return TRUE if PatternPlayout is used in play-out phase
+  bool isPatternPlayout() const {
+    return ispatternplayout;
+  }
+  ///Setter for the analysis of inferior hexgons which fills dead and captured hexgons and prunes dominated moves of game tree
+  ///@param ispruning is TRUE to analyze the actual game state by InferiorCellAnalysis before simulation
+  ///@return NONE
+  void setInferiorPruning(bool ispruning) {
+    isinferiorpruning = ispruning;
+  }
+  ///Getter for the analysis of inferior hexgons
+  ///@param NONE
+  ///@return TRUE if the actual game state is analyzed before simulation
+  bool isInferiorPruning() const {
+    return isinferiorpruning;
+  }
+  ///Setter for the search of virtual connections which plays a proven winning move at once and restricts the moves at root
+  ///to the must-play region when the opponent threatens to win
+  ///@param issearch is TRUE to search the virtual connections of both players by HSearch before simulation
+  ///@return NONE
+  void setVCSearch(bool issearch) {
+    isvcsearch = issearch;
+  }
+  ///Getter for the search of virtual connections
+  ///@param NONE
+  ///@return TRUE if the virtual connections are searched before simulation
+  bool isVCSearch() const {
+    return isvcsearch;
+  }
+  ///Setter for the fraction of simulated games evaluated by TwoDistanceEvaluator instead of played out, which trades the
+  ///accuracy of outcome for the time of simulation
+  ///@param rate is the fraction in [0, 1], 0 to play out every simulated game and 1 to evaluate every one
+  ///@return NONE
+  void setEvaluationRate(double rate) {
+    evaluationrate = rate;
+  }
+  ///Getter for the fraction of simulated games evaluated by TwoDistanceEvaluator
+  ///@param NONE
+  ///@return the fraction in [0, 1]
+  double getEvaluationRate() const {
+    return evaluationrate;
+  }
+  ///Setter for the order of moves at root of game tree
+  ///@param isprior is TRUE to order the moves at root by the priors of TwoDistanceEvaluator instead of neighbor count
+  ///@return NONE
+  void setTwoDistancePrior(bool isprior) {
+    istwodistanceprior = isprior;
+  }
+  ///Getter for the order of moves at root of game tree
+  ///@param NONE
+  ///@return TRUE if the moves at root are ordered by the priors of TwoDistanceEvaluator
+  bool isTwoDistancePrior() const {
+    return istwodistanceprior;
+  }
+  ///Setter for the order of moves at root of game tree by the currents of resistance model, which is added to the priors of
+  ///TwoDistanceEvaluator if both are enabled
+  ///@param isprior is TRUE to order the moves at root by the priors of ResistanceEvaluator
+  ///@return NONE
+  void setResistancePrior(bool isprior) {
+    isresistanceprior = isprior;
+  }
+  ///Getter for the order of moves at root of game tree by the currents of resistance model
+  ///@param NONE
+  ///@return TRUE if the moves at root are ordered by the priors of ResistanceEvaluator
+  bool isResistancePrior() const {
+    return isresistanceprior;
+  }
+  ///Setter for the table of position statistics shared with other engine processes. The position is answered from the table
+  ///if it holds at least as many simulated games as the search would spend, and the result of search is stored otherwise
+  ///@param table is the table which should outlive the strategy or nullptr to turn off the table
+  ///@return NONE
+  void setTranspositionTable(SharedTranspositionTable* table) {
+    ptrtotable = table;
+  }
+  ///Getter for the table of position statistics shared with other engine processes
+  ///@param NONE
+  ///@return the table, nullptr if not used
+  SharedTranspositionTable* getTranspositionTable() const {
+    return ptrtotable;
+  }
 };
 #endif /* MONTECARLOTREESEARCH_H_ */
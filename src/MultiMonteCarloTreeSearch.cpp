@@ -7,8 +7,10 @@
 
 #include "Global.h"
 #include "LockableGameTree.h"
+#include "SearchMonitor.h"
 #include "MultiMonteCarloTreeSearch.h"
 
+#include <map>
 #include <algorithm>
 #include <boost/thread/detail/memory.hpp>
 
@@ -33,7 +35,9 @@ mcstimpl(MonteCarloTreeSearch(board, aiplayer)),
 ptrtoboard(board),
 ptrtoplayer(aiplayer),
 numberofthreads(4),
-numberoftrials(2048) {
+numberoftrials(2048),
+isnumaplacement(false),
+ptrtoscheduler(nullptr) {
   babywatsoncolor = mcstimpl.babywatsoncolor;
   oppoenetcolor = mcstimpl.oppoenetcolor;
 }
@@ -44,7 +48,9 @@ mcstimpl(MonteCarloTreeSearch(board, aiplayer)),
 ptrtoboard(board),
 ptrtoplayer(aiplayer),
 numberofthreads(numberofthreads),
-numberoftrials(2048) {
+numberoftrials(2048),
+isnumaplacement(false),
+ptrtoscheduler(nullptr) {
   babywatsoncolor = mcstimpl.babywatsoncolor;
   oppoenetcolor = mcstimpl.oppoenetcolor;
 }
@@ -58,7 +64,9 @@ MultiMonteCarloTreeSearch::MultiMonteCarloTreeSearch(const HexBoard* board,
       ptrtoboard(board),
       ptrtoplayer(aiplayer),
       numberofthreads(numberofthreads),
-      numberoftrials(numberoftrials) {
+      numberoftrials(numberoftrials),
+      isnumaplacement(false),
+      ptrtoscheduler(nullptr) {
   babywatsoncolor = mcstimpl.babywatsoncolor;
   oppoenetcolor = mcstimpl.oppoenetcolor;
 }
@@ -67,22 +75,72 @@ int MultiMonteCarloTreeSearch::simulation(int currentempty) {
   hexgame::shared_ptr<bool> emptyglobal;
   vector<int> bwglobal, oppglobal;
   initGameState(emptyglobal, bwglobal, oppglobal);
+  //the connections and the analysis are done once and only read by the threads
+  vector<int> mustplay;
+  int winningmove = mcstimpl.searchConnections(bwglobal, oppglobal, mustplay);
+  if (winningmove > 0) {
+    mcstimpl.lastwinningrate = 1.0;
+    return winningmove;
+  }
+  InferiorCellAnalysis analysis(mcstimpl.topology);
+  currentempty -= mcstimpl.analyzeInferiorCells(emptyglobal, bwglobal,
+                                                oppglobal, analysis);
+  vector<int> rootpriors;
+  mcstimpl.getRootPriors(bwglobal, oppglobal, rootpriors);
+  if (isnumaplacement)
+    return numaSimulation(bwglobal, oppglobal, emptyglobal, currentempty,
+                          analysis, mustplay, rootpriors);
   LockableGameTree gametree(ptrtoplayer->getViewLabel());  //shared and lockable
+  gametree.setMaxNumofNodes(mcstimpl.getMaxNumofNodes());
+  gametree.setProgressiveWidening(mcstimpl.getProgressiveWidening());
+  gametree.setRaveEquivalence(mcstimpl.getRaveEquivalence());
 
-  for (size_t i = 0; i < (numberoftrials / numberofthreads); ++i) {
-    thread_group threads;
-    for (size_t j = 0; j < numberofthreads; ++j)
-      threads.create_thread(
-          boost::bind(boost::mem_fn(&MultiMonteCarloTreeSearch::task),
+  if (ptrtoscheduler != nullptr) {
+    //every simulated game is a task, the idle workers steal instead of waiting for a batch
+    WorkStealingScheduler::TaskGroup group;
+    for (size_t i = 0; i < numberoftrials; ++i)
+      ptrtoscheduler->submit(
+          boost::bind(boost::mem_fn(&MultiMonteCarloTreeSearch::stoppableTask),
                       boost::ref(*this), boost::cref(bwglobal),
                       boost::cref(oppglobal), boost::cref(emptyglobal),
-                      currentempty, boost::ref(gametree)));
-    assert(threads.size() == numberofthreads);
-    threads.join_all();
+                      currentempty, boost::ref(gametree),
+                      boost::cref(analysis), boost::cref(mustplay),
+                      boost::cref(rootpriors)),
+          group);
+    ptrtoscheduler->wait(group);
+    //the tasks are skipped once the search is requested to stop, hence one simulated game is run if none is
+    if (gametree.getNumofChildren(0) == 0)
+      task(bwglobal, oppglobal, emptyglobal, currentempty, gametree, analysis,
+           mustplay, rootpriors);
+  } else {
+    for (size_t i = 0; i < (numberoftrials / numberofthreads); ++i) {
+      thread_group threads;
+      for (size_t j = 0; j < numberofthreads; ++j)
+        threads.create_thread(
+            boost::bind(boost::mem_fn(&MultiMonteCarloTreeSearch::task),
+                        boost::ref(*this), boost::cref(bwglobal),
+                        boost::cref(oppglobal), boost::cref(emptyglobal),
+                        currentempty, boost::ref(gametree),
+                        boost::cref(analysis), boost::cref(mustplay),
+                        boost::cref(rootpriors)));
+      assert(threads.size() == numberofthreads);
+      threads.join_all();
+      //the threads of a batch are joined, hence the game tree is read without lock
+      if (getSearchMonitor() != nullptr) {
+        if (getSearchMonitor()->isStopRequested())
+          break;
+        size_t interval = getSearchMonitor()->getInterval();
+        if ((i + 1) * numberofthreads / interval
+            != i * numberofthreads / interval)
+          publishSnapshot(gametree, false);
+      }
+    }
   }
   int resultmove = mcstimpl.getBestMove(gametree);
   //find the move with the maximal successful simulated outcome
   assert(resultmove != -1);
+  if (getSearchMonitor() != nullptr)
+    publishSnapshot(gametree, true);
   return resultmove;
 }
 ///the actual task passed to each thread for execution which contains selection, expansion and backpropagation phases
@@ -91,32 +149,233 @@ int MultiMonteCarloTreeSearch::simulation(int currentempty) {
 ///@param emptyglobal stores indicator of a position on the hex board is empty or not which will be modified when a simulated game progresses
 ///@param currentempty is the current empty hexgons or positions left in the actual game state which will be the number of children nodes of root of game tree
 ///@param gametree is a game tree object which stores the simulation progress and result
+///@param analysis is the analysis of inferior hexgons whose inferior moves are marked in the state
+///@param mustplay is the region of moves at root where the threat of the opponent must be stopped, empty if none
+///@param rootpriors is the priors of moves at root indexed by position - 1, empty to order them by neighbor count
 ///@return NONE
 void MultiMonteCarloTreeSearch::task(
     const std::vector<int>& bwglobal, const std::vector<int>& oppglobal,
     const hexgame::shared_ptr<bool>& emptyglobal, int currentempty,
-    AbstractGameTree& gametree) {
-  //initialize the following containers to the current progress of playing board
-  vector<int> babywatsons(bwglobal), opponents(oppglobal);
-  hexgame::shared_ptr<bool> emptyindicators = hexgame::shared_ptr<bool>(
-      new bool[ptrtoboard->getSizeOfVertices()],
-      hexgame::default_delete<bool[]>());
-
-  copy(emptyglobal.get(), emptyglobal.get() + ptrtoboard->getSizeOfVertices(),
-       emptyindicators.get());
-
-  int proportionofempty = currentempty;
+    AbstractGameTree& gametree, const InferiorCellAnalysis& analysis,
+    const std::vector<int>& mustplay, const std::vector<int>& rootpriors) {
+  //initialize the state to the current progress of playing board
+  DescentState state;
+  state.setNeighborTable(&mcstimpl.neighbortable);
+  state.setRootPriors(rootpriors.empty() ? NULL : &rootpriors);
+  state.reset(emptyglobal, ptrtoboard->getSizeOfVertices(), bwglobal,
+              oppglobal);
+  analysis.apply(state);
+  state.setRootRegion(mustplay);
 
-  //in-tree phase
-  pair<int, int> selectresult = mcstimpl.selection(currentempty, gametree);
-  int expandednode = mcstimpl.expansion(selectresult, emptyindicators,
-                                        proportionofempty, babywatsons,
-                                        opponents, gametree);
+  //in-tree phase, the moves along the selected path are applied to the state by game tree
+  pair<int, int> selectresult = mcstimpl.selection(currentempty, gametree,
+                                                   state);
+  int expandednode = mcstimpl.expansion(selectresult, state, gametree);
 
-  //simulation phase
-  int winner = mcstimpl.playout(emptyindicators, proportionofempty, babywatsons,
-                                opponents);
+  //simulation phase, the pattern policy is owned by the thread since mcstimpl is shared
+  int winner;
+  FastRandom generator;
+  if (mcstimpl.getEvaluationRate() > 0.0
+      && generator.nextUniform() < mcstimpl.getEvaluationRate()) {
+    TwoDistanceEvaluator evaluator(mcstimpl.topology);
+    winner = mcstimpl.evaluation(state, evaluator, generator);
+  } else if (mcstimpl.isPatternPlayout()) {
+    PatternPlayout policy(mcstimpl.topology);
+    winner = mcstimpl.playout(state, policy);
+  } else
+    winner = mcstimpl.playout(state.getEmptyIndicators(), state.getNumofEmpty(),
+                              state.getBabywatsons(), state.getOpponents());
   assert(winner != 0);
   //back-propagate
-  mcstimpl.backpropagation(expandednode, winner, gametree);
+  mcstimpl.backpropagation(expandednode, winner, gametree, state);
+}
+///Simulation with the threads pinned to the NUMA nodes. Each node holding threads has its own game tree which is only
+///touched by the threads of the node, and the counts of the moves at root of the game trees are summed at last
+///@param bwglobal is the moves made by AI player in the current actual game state
+///@param oppglobal is the moves made by human player in the current actual game state
+///@param emptyglobal stores indicator of a position on the hex board is empty or not
+///@param currentempty is the current empty hexgons or positions left in the actual game state
+///@param analysis is the analysis of inferior hexgons whose inferior moves are marked in the state
+///@param mustplay is the region of moves at root where the threat of the opponent must be stopped, empty if none
+///@param rootpriors is the priors of moves at root indexed by position - 1, empty to order them by neighbor count
+///@return the move with the most simulated games over the game trees, ties broken by the wins
+int MultiMonteCarloTreeSearch::numaSimulation(
+    const std::vector<int>& bwglobal, const std::vector<int>& oppglobal,
+    const hexgame::shared_ptr<bool>& emptyglobal, int currentempty,
+    const InferiorCellAnalysis& analysis, const std::vector<int>& mustplay,
+    const std::vector<int>& rootpriors) {
+  vector<int> nodes, cpus;
+  numatopology.assign(numberofthreads, nodes, cpus);
+  //the nodes receive the threads in order, hence the nodes holding threads are the first ones
+  size_t numoftrees = nodes.empty() ? 1 : nodes.back() + 1;
+  size_t maxnumofnodes = mcstimpl.getMaxNumofNodes();
+  if (maxnumofnodes > 0)
+    maxnumofnodes = max(maxnumofnodes / numoftrees, static_cast<size_t>(1));
+  vector<hexgame::shared_ptr<LockableGameTree> > gametrees;
+  for (size_t i = 0; i < numoftrees; ++i) {
+    gametrees.push_back(
+        hexgame::shared_ptr<LockableGameTree>(
+            new LockableGameTree(ptrtoplayer->getViewLabel())));
+    gametrees.back()->setMaxNumofNodes(maxnumofnodes);
+    gametrees.back()->setProgressiveWidening(mcstimpl.getProgressiveWidening());
+    gametrees.back()->setRaveEquivalence(mcstimpl.getRaveEquivalence());
+  }
+
+  //the threads live through the whole simulation, hence they are pinned once
+  vector<ThreadPlacement> placements(numberofthreads);
+  thread_group threads;
+  for (size_t j = 0; j < numberofthreads; ++j) {
+    placements[j].gametree = gametrees[nodes[j]].get();
+    placements[j].cpu = cpus[j];
+    //the remainder is dealt to the first threads and every thread runs at least one game, hence every game tree is expanded
+    placements[j].numoftrials = max(
+        numberoftrials / numberofthreads
+            + (j < numberoftrials % numberofthreads ? 1 : 0),
+        static_cast<size_t>(1));
+    threads.create_thread(
+        boost::bind(boost::mem_fn(&MultiMonteCarloTreeSearch::nodeTask),
+                    boost::ref(*this), boost::cref(bwglobal),
+                    boost::cref(oppglobal), boost::cref(emptyglobal),
+                    currentempty, boost::cref(analysis), boost::cref(mustplay),
+                    boost::cref(rootpriors), boost::cref(placements[j])));
+  }
+  threads.join_all();
+
+  //sum the counts of each move at root over the game trees
+  map<int, pair<long long, long long> > merged;
+  for (size_t i = 0; i < gametrees.size(); ++i) {
+    vector<size_t> children = gametrees[i]->getChildren(0);
+    for (size_t j = 0; j < children.size(); ++j) {
+      pair<long long, long long>& counts = merged[static_cast<int>(gametrees[i]
+          ->getNodePosition(children[j]))];
+      counts.first += gametrees[i]->getNodeValueFeature(
+          children[j], AbstractUTCPolicy_visitcount);
+      counts.second += gametrees[i]->getNodeValueFeature(
+          children[j], AbstractUTCPolicy_wincount);
+    }
+  }
+  int resultmove = -1;
+  pair<long long, long long> bestcounts(-1, -1);
+  for (map<int, pair<long long, long long> >::iterator iter = merged.begin();
+      iter != merged.end(); ++iter)
+    if (iter->second > bestcounts) {
+      bestcounts = iter->second;
+      resultmove = iter->first;
+    }
+  mcstimpl.lastwinningrate =
+      bestcounts.first > 0 ?
+          static_cast<double>(bestcounts.second) / bestcounts.first : 0.0;
+  assert(resultmove != -1);
+  if (getSearchMonitor() != nullptr) {
+    SearchMonitor::Snapshot& snapshot = getSearchMonitor()->getStaging();
+    snapshot.bestmove = resultmove;
+    snapshot.winningrate = mcstimpl.lastwinningrate;
+    snapshot.numoftrials = 0;
+    snapshot.statistics.clear();
+    for (map<int, pair<long long, long long> >::iterator iter = merged.begin();
+        iter != merged.end(); ++iter) {
+      MonteCarloTreeSearch::RootStatistics statistics = { iter->first,
+          static_cast<int>(iter->second.first), static_cast<int>(iter->second
+              .second) };
+      snapshot.statistics.push_back(statistics);
+      snapshot.numoftrials += statistics.visitcount;
+    }
+    getSearchMonitor()->publish(true);
+  }
+  return resultmove;
+}
+///the task passed to each pinned thread which runs its share of simulated games on the game tree of its node. The scratch
+///memory of play-out is allocated after pinning, hence on the memory of the node
+///@param bwglobal is the moves made by AI player in the current actual game state
+///@param oppglobal is the moves made by human player in the current actual game state
+///@param emptyglobal stores indicator of a position on the hex board is empty or not
+///@param currentempty is the current empty hexgons or positions left in the actual game state
+///@param analysis is the analysis of inferior hexgons whose inferior moves are marked in the state
+///@param mustplay is the region of moves at root where the threat of the opponent must be stopped, empty if none
+///@param rootpriors is the priors of moves at root indexed by position - 1, empty to order them by neighbor count
+///@param placement is the game tree, CPU and share of simulated games of the thread
+///@return NONE
+void MultiMonteCarloTreeSearch::nodeTask(
+    const std::vector<int>& bwglobal, const std::vector<int>& oppglobal,
+    const hexgame::shared_ptr<bool>& emptyglobal, int currentempty,
+    const InferiorCellAnalysis& analysis, const std::vector<int>& mustplay,
+    const std::vector<int>& rootpriors, const ThreadPlacement& placement) {
+  //the thread runs unpinned if the CPU is not allowed for the process
+  NumaTopology::pinThread(placement.cpu);
+  DescentState state;
+  state.setNeighborTable(&mcstimpl.neighbortable);
+  state.setRootPriors(rootpriors.empty() ? NULL : &rootpriors);
+  PatternPlayout policy(mcstimpl.topology);
+  TwoDistanceEvaluator evaluator(mcstimpl.topology);
+  FastRandom generator;
+  AbstractGameTree& gametree = *placement.gametree;
+
+  for (size_t i = 0; i < placement.numoftrials; ++i) {
+    state.reset(emptyglobal, ptrtoboard->getSizeOfVertices(), bwglobal,
+                oppglobal);
+    analysis.apply(state);
+    state.setRootRegion(mustplay);
+    pair<int, int> selectresult = mcstimpl.selection(currentempty, gametree,
+                                                     state);
+    int expandednode = mcstimpl.expansion(selectresult, state, gametree);
+    int winner;
+    if (mcstimpl.getEvaluationRate() > 0.0
+        && generator.nextUniform() < mcstimpl.getEvaluationRate())
+      winner = mcstimpl.evaluation(state, evaluator, generator);
+    else if (mcstimpl.isPatternPlayout())
+      winner = mcstimpl.playout(state, policy);
+    else
+      winner = mcstimpl.playout(state.getEmptyIndicators(),
+                                state.getNumofEmpty(), state.getBabywatsons(),
+                                state.getOpponents());
+    assert(winner != 0);
+    mcstimpl.backpropagation(expandednode, winner, gametree, state);
+    if (getSearchMonitor() != nullptr && getSearchMonitor()->isStopRequested())
+      break;
+  }
+}
+///the task passed to the scheduler which runs one simulated game unless the search is requested to stop. See task
+///@param bwglobal is the moves made by AI player in the current actual game state
+///@param oppglobal is the moves made by human player in the current actual game state
+///@param emptyglobal stores indicator of a position on the hex board is empty or not
+///@param currentempty is the current empty hexgons or positions left in the actual game state
+///@param gametree is a game tree object which stores the simulation progress and result
+///@param analysis is the analysis of inferior hexgons whose inferior moves are marked in the state
+///@param mustplay is the region of moves at root where the threat of the opponent must be stopped, empty if none
+///@param rootpriors is the priors of moves at root indexed by position - 1, empty to order them by neighbor count
+///@return NONE
+void MultiMonteCarloTreeSearch::stoppableTask(
+    const std::vector<int>& bwglobal, const std::vector<int>& oppglobal,
+    const hexgame::shared_ptr<bool>& emptyglobal, int currentempty,
+    AbstractGameTree& gametree, const InferiorCellAnalysis& analysis,
+    const std::vector<int>& mustplay, const std::vector<int>& rootpriors) {
+  if (getSearchMonitor() != nullptr && getSearchMonitor()->isStopRequested())
+    return;
+  task(bwglobal, oppglobal, emptyglobal, currentempty, gametree, analysis,
+       mustplay, rootpriors);
+}
+///Publish the best move and the statistics of the moves at root of the shared game tree to the monitor of simulation. No
+///thread should be running on the game tree
+///@param gametree is the shared game tree
+///@param isblocking is TRUE to wait for the observers copying the previous snapshot, FALSE to skip publishing instead
+///@return NONE
+void MultiMonteCarloTreeSearch::publishSnapshot(LockableGameTree& gametree,
+                                                bool isblocking) {
+  SearchMonitor::Snapshot& snapshot = getSearchMonitor()->getStaging();
+  pair<int, double> result = gametree.getBestMovefromSimulation();
+  snapshot.bestmove = static_cast<int>(gametree.getNodePosition(result.first));
+  snapshot.winningrate = result.second;
+  snapshot.numoftrials = gametree.getNodeValueFeature(
+      0, AbstractUTCPolicy_visitcount);
+  vector<size_t> children = gametree.getChildren(0);
+  snapshot.statistics.resize(children.size());
+  for (size_t i = 0; i < children.size(); ++i) {
+    snapshot.statistics[i].move = static_cast<int>(gametree.getNodePosition(
+        children[i]));
+    snapshot.statistics[i].visitcount = gametree.getNodeValueFeature(
+        children[i], AbstractUTCPolicy_visitcount);
+    snapshot.statistics[i].wincount = gametree.getNodeValueFeature(
+        children[i], AbstractUTCPolicy_wincount);
+  }
+  getSearchMonitor()->publish(isblocking);
 }
@@ -11,6 +11,8 @@
 #include "Global.h"
 #include "Player.h"
 #include "HexBoard.h"
+#include "NumaTopology.h"
+#include "WorkStealingScheduler.h"
 #include "MonteCarloTreeSearch.h"
 
 #include <boost/thread/thread.hpp>
@@ -18,6 +20,9 @@
 #ifndef NDEBUG
 #include "gtest/gtest_prod.h"
 #endif
+
+class LockableGameTree;
+
 /** MultiMonteCarloTreeSearch class defines a Parallelized version of Mont Carlo Tree Search implementation for AI player
  * MultiMonteCarloTreeSearch class is the implementation of Parallelized Mont Carlo Tree Search which include four phases:
  * select, expansion, play-out and back-propagation. <br/>
@@ -32,6 +37,15 @@
  * MultiMonteCarloTreeSearch(const HexBoard* board, const Player* aiplayer, size_t numberofthreads, size_t numberoftrials):
  * user defined constructor which takes pointer to a hex board object and pointer to AI player. Also parameter used for the number of simulated games
  *  (numberoftrials) and number of threads (numberofthreads) <br/>
+ * With NUMA placement (see setNumaPlacement) the threads are spread over the nodes of NumaTopology and pinned to their CPUs.
+ * The threads of each node share a game tree of their own which is only touched by them, hence the nodes of tree and the
+ * scratch memory of play-out are allocated on the memory of their node and no cache line of tree bounces between the
+ * sockets. The visit and win counts of the moves at root of the game trees are summed after the simulation (root
+ * parallelization between the nodes and tree parallelization inside each node) <br/>
+ * With a WorkStealingScheduler (see setScheduler) every simulated game is one task of the scheduler instead of one thread
+ * of a batch, hence no thread waits for the slowest play-out of a batch and several searches share the same workers<br/>
+ * With a SearchMonitor (see AbstractStrategy::setSearchMonitor) the request to stop is checked after every batch, task or
+ * simulated game of a pinned thread. The snapshots are published between batches and when the simulation returns<br/>
  * Sample Usage: Please see Strategy (similar way to instantiate)
  */
 class MultiMonteCarloTreeSearch : public AbstractStrategyImpl {
@@ -44,11 +58,49 @@ class MultiMonteCarloTreeSearch : public AbstractStrategyImpl {
   const std::size_t numberoftrials;///< The number of simulated games which affects the sampling size of Parallelized Monte Carlo method. 2048 by default
   char babywatsoncolor; ///< The color of AI player which is represented as single character. For example, if color of AI player is RED, then character is 'R'. BLUE as 'B'
   char oppoenetcolor; ///< The color of AI player's opponent which is represented as single character. For example, if color of AI player is RED, then character for opponent is 'B'. BLUE as 'R'
+  bool isnumaplacement;  ///< TRUE to pin the threads to the NUMA nodes and give each node its own game tree, FALSE by default
+  NumaTopology numatopology;  ///< the nodes and CPUs which the threads are pinned to, discovered from sysfs by default
+  WorkStealingScheduler* ptrtoscheduler;  ///< the scheduler running the simulated games as tasks, nullptr to run them in batches of threads
+
+  /**
+   * ThreadPlacement is the game tree, CPU and share of simulated games of one thread under NUMA placement
+   */
+  struct ThreadPlacement {
+    AbstractGameTree* gametree;  ///< the game tree of the node of thread
+    int cpu;  ///< the CPU which the thread is pinned to
+    std::size_t numoftrials;  ///< the number of simulated games of the thread
+  };
 
   ///delegating simulation method which is passed to each thread for execution
   void task(const std::vector<int>& bwglobal, const std::vector<int>& oppglobal,
             const hexgame::shared_ptr<bool>& emptyglobal, int currentempty,
-            AbstractGameTree& gametree);
+            AbstractGameTree& gametree, const InferiorCellAnalysis& analysis,
+            const std::vector<int>& mustplay, const std::vector<int>& rootpriors);
+  ///delegating simulation method which is passed to the scheduler and skipped once the search is requested to stop
+  void stoppableTask(const std::vector<int>& bwglobal,
+                     const std::vector<int>& oppglobal,
+                     const hexgame::shared_ptr<bool>& emptyglobal,
+                     int currentempty, AbstractGameTree& gametree,
+                     const InferiorCellAnalysis& analysis,
+                     const std::vector<int>& mustplay,
+                     const std::vector<int>& rootpriors);
+  ///publish the progress of simulation to the monitor
+  void publishSnapshot(LockableGameTree& gametree, bool isblocking);
+  ///simulation with the threads pinned to the NUMA nodes, one game tree per node
+  int numaSimulation(const std::vector<int>& bwglobal,
+                     const std::vector<int>& oppglobal,
+                     const hexgame::shared_ptr<bool>& emptyglobal,
+                     int currentempty, const InferiorCellAnalysis& analysis,
+                     const std::vector<int>& mustplay,
+                     const std::vector<int>& rootpriors);
+  ///delegating simulation method which is passed to each pinned thread for execution
+  void nodeTask(const std::vector<int>& bwglobal,
+                const std::vector<int>& oppglobal,
+                const hexgame::shared_ptr<bool>& emptyglobal, int currentempty,
+                const InferiorCellAnalysis& analysis,
+                const std::vector<int>& mustplay,
+                const std::vector<int>& rootpriors,
+                const ThreadPlacement& placement);
 
 #ifndef NDEBUG
   //for google test framework
@@ -89,6 +141,150 @@ class MultiMonteCarloTreeSearch : public AbstractStrategyImpl {
   std::size_t getNumberoftrials(){
     return numberoftrials;
   }
+  ///Setter for the maximal number of nodes kept in the shared game tree which bounds the memory used by simulation
+  ///@param numofnodes is the maximal number of nodes, 0 for unlimited
+  ///@return NONE
+  void setMaxNumofNodes(std::size_t numofnodes) {
+    mcstimpl.setMaxNumofNodes(numofnodes);
+  }
+  ///Getter for the maximal number of nodes kept in the shared game tree
+  ///@param NONE
+  ///@return the maximal number of nodes, 0 for unlimited
+  std::size_t getMaxNumofNodes() const {
+    return mcstimpl.getMaxNumofNodes();
+  }
+  ///Setter for the schedule of progressive widening of the shared game tree
+  ///@param schedule is the schedule of progressive widening, the default constructed one disables widening
+  ///@return NONE
+  void setProgressiveWidening(const ProgressiveWidening& schedule) {
+    mcstimpl.setProgressiveWidening(schedule);
+  }
+  ///Getter for the schedule of progressive widening of the shared game tree
+  ///@param NONE
+  ///@return the schedule of progressive widening
+  const ProgressiveWidening& getProgressiveWidening() const {
+    return mcstimpl.getProgressiveWidening();
+  }
+  ///Setter for the equivalence parameter of RAVE of the shared game tree
+  ///@param equivalence is the equivalence parameter, 0 to disable RAVE
+  ///@return NONE
+  void setRaveEquivalence(double equivalence) {
+    mcstimpl.setRaveEquivalence(equivalence);
+  }
+  ///Getter for the equivalence parameter of RAVE of the shared game tree
+  ///@param NONE
+  ///@return the equivalence parameter, 0 if RAVE is disabled
+  double getRaveEquivalence() const {
+    return mcstimpl.getRaveEquivalence();
+  }
+  ///Setter for the play-out policy of every thread
+  ///@param ispattern is TRUE to use PatternPlayout in play-out phase, FALSE for uniform random moves
+  ///@return NONE
+  void setPatternPlayout(bool ispattern) {
+    mcstimpl.setPatternPlayout(ispattern);
+  }
+  ///Getter for the play-out policy of every thread
+  ///@param NONE
+  ///@return TRUE if PatternPlayout is used in play-out phase
+  bool isPatternPlayout() const {
+    return mcstimpl.isPatternPlayout();
+  }
+  ///Setter for the analysis of inferior hexgons before the simulation of threads
+  ///@param ispruning is TRUE to analyze the actual game state by InferiorCellAnalysis before simulation
+  ///@return NONE
+  void setInferiorPruning(bool ispruning) {
+    mcstimpl.setInferiorPruning(ispruning);
+  }
+  ///Getter for the analysis of inferior hexgons
+  ///@param NONE
+  ///@return TRUE if the actual game state is analyzed before simulation
+  bool isInferiorPruning() const {
+    return mcstimpl.isInferiorPruning();
+  }
+  ///Setter for the search of virtual connections before the simulation of threads
+  ///@param issearch is TRUE to search the virtual connections of both players by HSearch before simulation
+  ///@return NONE
+  void setVCSearch(bool issearch) {
+    mcstimpl.setVCSearch(issearch);
+  }
+  ///Getter for the search of virtual connections
+  ///@param NONE
+  ///@return TRUE if the virtual connections are searched before simulation
+  bool isVCSearch() const {
+    return mcstimpl.isVCSearch();
+  }
+  ///Setter for the fraction of simulated games of every thread evaluated by TwoDistanceEvaluator instead of played out
+  ///@param rate is the fraction in [0, 1], 0 to play out every simulated game and 1 to evaluate every one
+  ///@return NONE
+  void setEvaluationRate(double rate) {
+    mcstimpl.setEvaluationRate(rate);
+  }
+  ///Getter for the fraction of simulated games evaluated by TwoDistanceEvaluator
+  ///@param NONE
+  ///@return the fraction in [0, 1]
+  double getEvaluationRate() const {
+    return mcstimpl.getEvaluationRate();
+  }
+  ///Setter for the order of moves at root of the shared game tree
+  ///@param isprior is TRUE to order the moves at root by the priors of TwoDistanceEvaluator instead of neighbor count
+  ///@return NONE
+  void setTwoDistancePrior(bool isprior) {
+    mcstimpl.setTwoDistancePrior(isprior);
+  }
+  ///Getter for the order of moves at root of the shared game tree
+  ///@param NONE
+  ///@return TRUE if the moves at root are ordered by the priors of TwoDistanceEvaluator
+  bool isTwoDistancePrior() const {
+    return mcstimpl.isTwoDistancePrior();
+  }
+  ///Setter for the order of moves at root of the shared game tree by the currents of resistance model
+  ///@param isprior is TRUE to order the moves at root by the priors of ResistanceEvaluator
+  ///@return NONE
+  void setResistancePrior(bool isprior) {
+    mcstimpl.setResistancePrior(isprior);
+  }
+  ///Getter for the order of moves at root of the shared game tree by the currents of resistance model
+  ///@param NONE
+  ///@return TRUE if the moves at root are ordered by the priors of ResistanceEvaluator
+  bool isResistancePrior() const {
+    return mcstimpl.isResistancePrior();
+  }
+  ///Setter for the placement of threads on the NUMA nodes
+  ///@param isplacement is TRUE to pin the threads to the nodes of NUMA topology and give each node its own game tree
+  ///@return NONE
+  void setNumaPlacement(bool isplacement) {
+    isnumaplacement = isplacement;
+  }
+  ///Getter for the placement of threads on the NUMA nodes
+  ///@param NONE
+  ///@return TRUE if the threads are pinned to the nodes of NUMA topology
+  bool isNumaPlacement() const {
+    return isnumaplacement;
+  }
+  ///Setter for the NUMA topology which the threads are pinned to, e.g. to restrict the search to some CPUs
+  ///@param topology is the nodes and their CPUs
+  ///@return NONE
+  void setNumaTopology(const NumaTopology& topology) {
+    numatopology = topology;
+  }
+  ///Getter for the NUMA topology which the threads are pinned to
+  ///@param NONE
+  ///@return the nodes and their CPUs
+  const NumaTopology& getNumaTopology() const {
+    return numatopology;
+  }
+  ///Setter for the scheduler running the simulated games as tasks, which takes the place of numberofthreads
+  ///@param scheduler is the scheduler which should outlive the simulation or nullptr to run the games in batches of threads
+  ///@return NONE
+  void setScheduler(WorkStealingScheduler* scheduler) {
+    ptrtoscheduler = scheduler;
+  }
+  ///Getter for the scheduler running the simulated games as tasks
+  ///@param NONE
+  ///@return the scheduler, nullptr if the games run in batches of threads
+  WorkStealingScheduler* getScheduler() const {
+    return ptrtoscheduler;
+  }
 };
 
 #endif /* MULTIMONTECARLOTREESEARCH_H_ */
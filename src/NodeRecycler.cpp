@@ -0,0 +1,149 @@
+/*
+ * NodeRecycler.cpp
+ * This file defines the implementation of NodeRecycler template class
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+///Get the parent of given node
+///@param graph is the underlying graph of game tree
+///@param node is the node whose parent will be returned
+///@return the parent or null_vertex if the node is root or detached
+template<class Graph>
+typename NodeRecycler<Graph>::vertex_t NodeRecycler<Graph>::getParent(
+    Graph& graph, vertex_t node) {
+  vertex_t parent = boost::graph_traits<Graph>::null_vertex();
+  in_edge_iter viter, viterend;
+  for (boost::tie(viter, viterend) = in_edges(node, graph); viter != viterend;
+      ++viter)
+    parent = source(*viter, graph);
+  return parent;
+}
+///Detach the node from the graph, release its UTC policy and put it into free list. The untried moves of its parent are
+///dropped, so they are regenerated including the move of released node at the next expansion of parent
+///@param graph is the underlying graph of game tree
+///@param node is the node to be released
+///@return NONE
+template<class Graph>
+void NodeRecycler<Graph>::release(Graph& graph, vertex_t node) {
+  vertex_t parent = getParent(graph, node);
+  if (parent != boost::graph_traits<Graph>::null_vertex())
+    std::vector<boost::uint16_t>().swap(
+        get(boost::vertex_untried, graph)[parent]);
+  clear_vertex(node, graph);
+  get(boost::vertex_value, graph)[node].reset();
+  std::vector<boost::uint16_t>().swap(get(boost::vertex_untried, graph)[node]);
+  freenodes.push_back(node);
+}
+///Release all descendants of the given node. The given node becomes a leaf
+///@param graph is the underlying graph of game tree
+///@param node is the node whose descendants will be released
+///@return the number of released nodes
+template<class Graph>
+std::size_t NodeRecycler<Graph>::releaseDescendants(Graph& graph,
+                                                    vertex_t node) {
+  std::vector<vertex_t> descendants, holder;
+  out_edge_iter viter, viterend;
+  for (boost::tie(viter, viterend) = out_edges(node, graph); viter != viterend;
+      ++viter)
+    holder.push_back(target(*viter, graph));
+  while (!holder.empty()) {
+    vertex_t child = holder.back();
+    holder.pop_back();
+    descendants.push_back(child);
+    for (boost::tie(viter, viterend) = out_edges(child, graph);
+        viter != viterend; ++viter)
+      holder.push_back(target(*viter, graph));
+  }
+  for (typename std::vector<vertex_t>::iterator iter = descendants.begin();
+      iter != descendants.end(); ++iter)
+    release(graph, *iter);
+  return descendants.size();
+}
+///Prune the least visited subtrees when the number of live nodes reaches the budget. Nodes are pruned until the number of
+///live nodes drops to 7/8 of budget, so that the cost of scanning the tree is amortized over many expansions.
+///@param graph is the underlying graph of game tree
+///@param root is the root of game tree which is never pruned
+///@param protectednode is the node about to be expanded. This node and its ancestors are never pruned
+///@param isprunable is the predicate which decides if a node is allowed to be pruned, e.g. not in use by other threads.
+///A subtree is pruned only if every node in the subtree is prunable
+///@return the number of released nodes
+template<class Graph>
+template<class Prunable>
+std::size_t NodeRecycler<Graph>::recycle(Graph& graph, vertex_t root,
+                                         vertex_t protectednode,
+                                         Prunable isprunable) {
+  std::size_t numoflive = num_vertices(graph) - freenodes.size();
+  if (maxnumofnodes == 0 || numoflive < maxnumofnodes)
+    return 0;
+  std::size_t numofrequired = numoflive - (maxnumofnodes - maxnumofnodes / 8)
+      + 1;
+
+  //mark the path from the node about to be expanded to root
+  std::vector<char> isprotected(num_vertices(graph), 0);
+  for (vertex_t node = protectednode;
+      node != boost::graph_traits<Graph>::null_vertex();
+      node = getParent(graph, node)) {
+    isprotected[node] = 1;
+    if (node == root)
+      break;
+  }
+  //collect nodes in preorder, then decide the quiet subtrees (all nodes are prunable) from the bottom up
+  std::vector<vertex_t> order, holder(1, root);
+  std::vector<char> isquiet(num_vertices(graph), 0);
+  out_edge_iter viter, viterend;
+  while (!holder.empty()) {
+    vertex_t node = holder.back();
+    holder.pop_back();
+    order.push_back(node);
+    isquiet[node] = isprunable(node) ? 1 : 0;
+    for (boost::tie(viter, viterend) = out_edges(node, graph);
+        viter != viterend; ++viter)
+      holder.push_back(target(*viter, graph));
+  }
+  for (typename std::vector<vertex_t>::reverse_iterator iter = order.rbegin();
+      iter != order.rend(); ++iter)
+    if (!isquiet[*iter] && *iter != root)
+      isquiet[getParent(graph, *iter)] = 0;
+
+  //1. prune the subtrees of the least visited internal nodes
+  std::vector<std::pair<int, vertex_t> > candidates;
+  for (typename std::vector<vertex_t>::iterator iter = order.begin();
+      iter != order.end(); ++iter)
+    if (*iter != root && !isprotected[*iter] && isquiet[*iter]
+        && out_degree(*iter, graph) > 0)
+      candidates.push_back(
+          std::make_pair(
+              get(boost::vertex_value, graph)[*iter]->feature(
+                  AbstractUTCPolicy::visitcount),
+              *iter));
+  std::sort(candidates.begin(), candidates.end());
+  std::size_t numofreleased = 0;
+  for (std::size_t i = 0; i < candidates.size() && numofreleased < numofrequired;
+      ++i) {
+    if (in_degree(candidates[i].second, graph) == 0)
+      continue;  //already released as a descendant of other pruned node
+    numofreleased += releaseDescendants(graph, candidates[i].second);
+  }
+  if (numofreleased >= numofrequired)
+    return numofreleased;
+
+  //2. remove the least visited leaves whose parents are quiet
+  candidates.clear();
+  for (typename std::vector<vertex_t>::iterator iter = order.begin();
+      iter != order.end(); ++iter)
+    if (*iter != root && !isprotected[*iter]
+        && in_degree(*iter, graph) == 1 && out_degree(*iter, graph) == 0
+        && isquiet[getParent(graph, *iter)])
+      candidates.push_back(
+          std::make_pair(
+              get(boost::vertex_value, graph)[*iter]->feature(
+                  AbstractUTCPolicy::visitcount),
+              *iter));
+  std::sort(candidates.begin(), candidates.end());
+  for (std::size_t i = 0; i < candidates.size() && numofreleased < numofrequired;
+      ++i, ++numofreleased)
+    release(graph, candidates[i].second);
+  return numofreleased;
+}
@@ -0,0 +1,116 @@
+/*
+ * NodeRecycler.h
+ * This file defines the node budget and node recycling shared by GameTree and LockableGameTree.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef NODERECYCLER_H_
+#define NODERECYCLER_H_
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "AbstractGameTree.h"
+
+/**
+ * NodeRecycler class is used to keep a game tree under a given number of nodes.<br/>
+ * When the tree reaches the budget, the subtrees of the least visited nodes are pruned and their vertices are put in a
+ * free list which will be reused by the following expansions instead of growing the underlying graph. The pruned node
+ * itself is kept as a leaf, hence its statistics which already include the whole subtree via back-propagation remain in
+ * the tree and the node can be expanded again later. If no subtree can be pruned, the least visited leaves are removed
+ * whose statistics are already folded into their parents. The vertices are never removed from the underlying graph, so
+ * the indices of live nodes remain valid.<br/>
+ * The template Graph is the boost adjacency list (vecS as vertex list and bidirectionalS) used by game tree.<br/>
+ * NodeRecycler(): parameterless default constructor which constructs a recycler without budget (unlimited)<br/>
+ * Sample Usage:<br/>
+ * NodeRecycler<basegraph> recycler;<br/>
+ * recycler.setMaxNumofNodes(100000);<br/>
+ * recycler.recycle(thetree, root, selectednode, AlwaysPrunable());<br/>
+ * vertex_t node = recycler.hasFreeNode() ? recycler.acquire() : add_vertex(thetree);<br/>
+ */
+template<class Graph>
+class NodeRecycler {
+ public:
+  ///Define vertex type of the graph
+  typedef typename boost::graph_traits<Graph>::vertex_descriptor vertex_t;
+
+ private:
+  typedef typename boost::graph_traits<Graph>::in_edge_iterator in_edge_iter;
+  typedef typename boost::graph_traits<Graph>::out_edge_iterator out_edge_iter;
+
+  std::size_t maxnumofnodes;  ///< the maximal number of live nodes, 0 means unlimited
+  std::vector<vertex_t> freenodes;  ///< the vertices of pruned nodes which can be reused
+
+  //Get the parent of given node
+  vertex_t getParent(Graph& graph, vertex_t node);
+  //Detach the node from the graph and put it into free list
+  void release(Graph& graph, vertex_t node);
+  //Release all descendants of the given node
+  std::size_t releaseDescendants(Graph& graph, vertex_t node);
+
+ public:
+  ///Parameterless default constructor which constructs a recycler without budget
+  NodeRecycler()
+      : maxnumofnodes(0) {
+  }
+  ;
+  ///Setter for the maximal number of live nodes
+  ///@param numofnodes is the maximal number of live nodes, 0 means unlimited
+  ///@return NONE
+  void setMaxNumofNodes(std::size_t numofnodes) {
+    maxnumofnodes = numofnodes;
+  }
+  ///Getter for the maximal number of live nodes
+  ///@param NONE
+  ///@return the maximal number of live nodes, 0 means unlimited
+  std::size_t getMaxNumofNodes() const {
+    return maxnumofnodes;
+  }
+  ///Getter for the number of vertices in free list
+  ///@param NONE
+  ///@return the number of vertices which can be reused
+  std::size_t getSizeofFreeNodes() const {
+    return freenodes.size();
+  }
+  ///Check if any vertex can be reused
+  ///@param NONE
+  ///@return TRUE if the free list is not empty
+  bool hasFreeNode() const {
+    return !freenodes.empty();
+  }
+  ///Take a vertex out of free list. The properties of vertex should be re-initialized by caller
+  ///@param NONE
+  ///@return the vertex to be reused
+  vertex_t acquire() {
+    vertex_t node = freenodes.back();
+    freenodes.pop_back();
+    return node;
+  }
+  ///Forget all vertices in free list, called when the underlying graph is cleared
+  ///@param NONE
+  ///@return NONE
+  void clear() {
+    freenodes.clear();
+  }
+  //Prune the least visited subtrees when the budget is reached
+  template<class Prunable>
+  std::size_t recycle(Graph& graph, vertex_t root, vertex_t protectednode,
+                      Prunable isprunable);
+};
+/**
+ * AlwaysPrunable is the predicate for a single thread game tree in which every node is allowed to be pruned
+ */
+struct AlwaysPrunable {
+  ///Any node can be pruned
+  template<class Vertex>
+  bool operator()(Vertex) const {
+    return true;
+  }
+};
+
+#include "NodeRecycler.cpp"
+
+#endif /* NODERECYCLER_H_ */
@@ -0,0 +1,156 @@
+/*
+ * NumaTopology.cpp
+ * This file defines the topology of NUMA nodes of host which is used to place the threads of parallel search.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "Global.h"
+#include "NumaTopology.h"
+
+#include <map>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <dirent.h>
+#include <boost/thread/thread.hpp>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std;
+
+///Default constructor which discovers the topology from /sys/devices/system/node
+NumaTopology::NumaTopology() {
+  discover("/sys/devices/system/node");
+}
+///User defined constructor which discovers the topology from the given directory
+///@param sysfsroot is the directory which contains the directories node<N>, e.g. /sys/devices/system/node
+NumaTopology::NumaTopology(const std::string& sysfsroot) {
+  discover(sysfsroot);
+}
+///User defined constructor which takes the CPUs of each node. The nodes without CPUs are dropped
+///@param cpus is the CPUs of each node
+NumaTopology::NumaTopology(const std::vector<std::vector<int> >& cpus) {
+  for (size_t i = 0; i < cpus.size(); ++i) {
+    if (cpus[i].empty())
+      continue;
+    nodecpus.push_back(cpus[i]);
+    sort(nodecpus.back().begin(), nodecpus.back().end());
+  }
+  if (nodecpus.empty())
+    nodecpus.push_back(vector<int>(1, 0));
+}
+///Discover the nodes from the given sysfs directory. The nodes without CPUs, e.g. memory only nodes, are dropped and the
+///host is regarded as one node if none is found
+///@param sysfsroot is the directory which contains the directories node<N>
+///@return NONE
+void NumaTopology::discover(const std::string& sysfsroot) {
+  map<int, vector<int> > found;
+  DIR* directory = opendir(sysfsroot.c_str());
+  if (directory != NULL) {
+    for (struct dirent* item = readdir(directory); item != NULL; item =
+        readdir(directory)) {
+      string name(item->d_name);
+      if (name.size() <= 4 || name.compare(0, 4, "node") != 0
+          || name.find_first_not_of("0123456789", 4) != string::npos)
+        continue;
+      ifstream in((sysfsroot + "/" + name + "/cpulist").c_str());
+      string cpulist;
+      vector<int> cpus;
+      if (getline(in, cpulist) && parseCpuList(cpulist, cpus) && !cpus.empty())
+        found[atoi(name.c_str() + 4)] = cpus;
+    }
+    closedir(directory);
+  }
+  nodecpus.clear();
+  for (map<int, vector<int> >::iterator iter = found.begin();
+      iter != found.end(); ++iter)
+    nodecpus.push_back(iter->second);
+  if (nodecpus.empty()) {
+    int numofcpus = max(1, static_cast<int>(boost::thread::hardware_concurrency()));
+    nodecpus.push_back(vector<int>());
+    for (int i = 0; i < numofcpus; ++i)
+      nodecpus.back().push_back(i);
+  }
+}
+///Get the number of CPUs of all nodes
+///@param NONE
+///@return the number of CPUs
+std::size_t NumaTopology::getNumofCpus() const {
+  size_t numofcpus = 0;
+  for (size_t i = 0; i < nodecpus.size(); ++i)
+    numofcpus += nodecpus[i].size();
+  return numofcpus;
+}
+///Spread the threads over the nodes, the consecutive threads on the same node in proportion to the CPUs of each node, and
+///over the CPUs of each node round robin. The nodes get no thread only if there are fewer threads than nodes
+///@param numofthreads is the number of threads
+///@param nodes stores the node of each thread
+///@param cpus stores the CPU of each thread
+///@return NONE
+void NumaTopology::assign(std::size_t numofthreads, std::vector<int>& nodes,
+                          std::vector<int>& cpus) const {
+  nodes.assign(numofthreads, 0);
+  cpus.assign(numofthreads, 0);
+  size_t numofcpus = getNumofCpus(), thread = 0, cumulative = 0;
+  for (size_t node = 0; node < nodecpus.size(); ++node) {
+    cumulative += nodecpus[node].size();
+    //the threads up to the proportion of CPUs of nodes so far, at least one per node while threads are left
+    size_t last = max(thread + 1, numofthreads * cumulative / numofcpus);
+    if (node + 1 == nodecpus.size())
+      last = numofthreads;
+    for (size_t i = 0; thread < min(last, numofthreads); ++thread, ++i) {
+      nodes[thread] = static_cast<int>(node);
+      cpus[thread] = nodecpus[node][i % nodecpus[node].size()];
+    }
+  }
+}
+///Parse the list of CPUs of sysfs, the comma separated CPUs or ranges of CPUs, e.g. "0-3,8,10-11"
+///@param cpulist is the list of CPUs
+///@param cpus stores the CPUs in ascending order
+///@return TRUE if the list is well formed
+bool NumaTopology::parseCpuList(const std::string& cpulist,
+                                std::vector<int>& cpus) {
+  cpus.clear();
+  stringstream in(cpulist);
+  string range;
+  while (getline(in, range, ',')) {
+    range.erase(range.find_last_not_of(" \t\r\n") + 1);
+    if (range.empty())
+      continue;
+    if (range.find_first_not_of("0123456789-") != string::npos)
+      return false;
+    size_t dash = range.find('-');
+    if (dash == 0 || dash + 1 == range.size())
+      return false;
+    int first = atoi(range.c_str());
+    int last = (dash == string::npos) ? first : atoi(range.c_str() + dash + 1);
+    if (last < first)
+      return false;
+    for (int cpu = first; cpu <= last; ++cpu)
+      cpus.push_back(cpu);
+  }
+  sort(cpus.begin(), cpus.end());
+  cpus.erase(unique(cpus.begin(), cpus.end()), cpus.end());
+  return true;
+}
+///Pin the calling thread to the given CPU
+///@param cpu is the CPU
+///@return TRUE if the thread is pinned, FALSE if the CPU is not allowed for the process or pinning is not supported
+bool NumaTopology::pinThread(int cpu) {
+#ifdef __linux__
+  if (cpu < 0 || cpu >= CPU_SETSIZE)
+    return false;
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET(cpu, &cpuset);
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) == 0;
+#else
+  return false;
+#endif
+}
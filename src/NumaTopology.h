@@ -0,0 +1,77 @@
+/*
+ * NumaTopology.h
+ * This file declares the topology of NUMA nodes of host which is used to place the threads of parallel search.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef NUMATOPOLOGY_H_
+#define NUMATOPOLOGY_H_
+
+#include <string>
+#include <vector>
+
+#include "Global.h"
+
+/**
+ * NumaTopology class is the CPUs of each NUMA node (socket) of host.<br/>
+ * The topology is discovered from sysfs, one directory node&lt;N&gt; per node with the list of its CPUs in the file
+ * cpulist, e.g. "0-7,16-23". If sysfs is not available, the host is regarded as one node with all hardware threads.<br/>
+ * The threads of parallel search are spread over the nodes by assign, the consecutive threads on the same node, and each
+ * thread pins itself to its CPU by pinThread. As Linux places a page on the node of the thread touching it first, the
+ * memory allocated and written by a pinned thread is local to its node.<br/>
+ * NumaTopology(): default constructor which discovers the topology from /sys/devices/system/node<br/>
+ * NumaTopology(const std::string& sysfsroot): user defined constructor which discovers the topology from the given
+ * directory<br/>
+ * NumaTopology(const std::vector<std::vector<int> >& cpus): user defined constructor which takes the CPUs of each node,
+ * e.g. to pin the threads to a subset of CPUs<br/>
+ * Sample Usage:<br/>
+ * NumaTopology topology;<br/>
+ * std::vector<int> nodes, cpus;<br/>
+ * topology.assign(numberofthreads, nodes, cpus);<br/>
+ * NumaTopology::pinThread(cpus[i]); //in the i-th thread<br/>
+ */
+class NumaTopology {
+ private:
+  std::vector<std::vector<int> > nodecpus;  ///< the CPUs of each node, every node has at least one CPU
+
+  //Discover the nodes from the given sysfs directory
+  void discover(const std::string& sysfsroot);
+
+ public:
+  //Default constructor which discovers the topology from /sys/devices/system/node
+  NumaTopology();
+  //User defined constructor which discovers the topology from the given directory
+  explicit NumaTopology(const std::string& sysfsroot);
+  //User defined constructor which takes the CPUs of each node
+  explicit NumaTopology(const std::vector<std::vector<int> >& cpus);
+  ///destructor
+  virtual ~NumaTopology() {
+  }
+  ;
+  ///Get the number of nodes
+  ///@param NONE
+  ///@return the number of nodes, at least one
+  std::size_t getNumofNodes() const {
+    return nodecpus.size();
+  }
+  ///Get the CPUs of a node
+  ///@param node is the index of node starting from 0
+  ///@return the CPUs of the node in ascending order
+  const std::vector<int>& getCpus(std::size_t node) const {
+    return nodecpus[node];
+  }
+  //Get the number of CPUs of all nodes
+  std::size_t getNumofCpus() const;
+  //Spread the threads over the nodes and the CPUs of each node
+  void assign(std::size_t numofthreads, std::vector<int>& nodes,
+              std::vector<int>& cpus) const;
+
+  //Parse the list of CPUs of sysfs
+  static bool parseCpuList(const std::string& cpulist, std::vector<int>& cpus);
+  //Pin the calling thread to the given CPU
+  static bool pinThread(int cpu);
+};
+
+#endif /* NUMATOPOLOGY_H_ */
@@ -0,0 +1,171 @@
+/*
+ * OpeningBook.cpp
+ * This file defines the implementation of OpeningBook class
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+
+#include "OpeningBook.h"
+#include "PositionHash.h"
+
+using namespace std;
+using namespace boost::interprocess;
+
+namespace {
+const char BOOKMAGIC[8] = "HEXBOOK";
+///order the book entries by position key
+bool lessEntry(const OpeningBook::BookEntry& left,
+               const OpeningBook::BookEntry& right) {
+  return left.key < right.key;
+}
+}
+
+const boost::uint32_t OpeningBook::VERSION;
+
+///Parameterless default constructor which constructs a closed book
+OpeningBook::OpeningBook()
+    : header(nullptr),
+      entries(nullptr) {
+}
+///User defined constructor which opens the given book file. Use isOpen to check if the book is opened successfully
+///@param filename is the path of book file
+OpeningBook::OpeningBook(const string& filename)
+    : header(nullptr),
+      entries(nullptr) {
+  open(filename);
+}
+///Map the given book file into memory. The previous opened book will be closed
+///@param filename is the path of book file
+///@return TRUE if the book file exists and has a valid header, otherwise FALSE and the book remains closed
+bool OpeningBook::open(const string& filename) {
+  close();
+  try {
+    file_mapping mapping(filename.c_str(), read_only);
+    mapped_region region(mapping, read_only);
+    const BookHeader* mappedheader =
+        static_cast<const BookHeader*>(region.get_address());
+    if (!isValidHeader(mappedheader, region.get_size()))
+      return false;
+    bookfile.swap(mapping);
+    bookregion.swap(region);
+  } catch (const interprocess_exception& ex) {
+#ifndef NDEBUG
+    cerr << "fail to open opening book " << filename << ": " << ex.what()
+         << endl;
+#endif
+    return false;
+  }
+  header = static_cast<const BookHeader*>(bookregion.get_address());
+  entries = reinterpret_cast<const BookEntry*>(header + 1);
+  return true;
+}
+///Unmap the book file
+///@param NONE
+///@return NONE
+void OpeningBook::close() {
+  header = nullptr;
+  entries = nullptr;
+  mapped_region().swap(bookregion);
+  file_mapping().swap(bookfile);
+}
+///Check if the header is valid for the size of mapped region
+///@param header is the header at the beginning of mapped region
+///@param sizeofregion is the size of mapped region in bytes
+///@return TRUE if the magic, version and number of entries are consistent with the file
+bool OpeningBook::isValidHeader(const BookHeader* header,
+                                size_t sizeofregion) {
+  if (sizeofregion < sizeof(BookHeader))
+    return false;
+  if (memcmp(header->magic, BOOKMAGIC, sizeof(BOOKMAGIC)) != 0
+      || header->version != VERSION)
+    return false;
+  return (sizeofregion - sizeof(BookHeader)) / sizeof(BookEntry)
+      >= header->numofentries;
+}
+///Get the entry of given position key by binary search over the sorted entries
+///@param key is the position key computed by PositionHash
+///@return the pointer to the entry inside the mapped region or nullptr if the key is not in the book
+const OpeningBook::BookEntry* OpeningBook::lookup(boost::uint64_t key) const {
+  if (!isOpen())
+    return nullptr;
+  const BookEntry* end = entries + header->numofentries;
+  BookEntry target;
+  target.key = key;
+  const BookEntry* found = lower_bound(entries, end, target, lessEntry);
+  if (found != end && found->key == key)
+    return found;
+  return nullptr;
+}
+///Get the book move for the position on the hex board
+///@param board is the hex board whose position is looked up
+///@param tomove is the color of the player to move
+///@return the index of hexgon to play or -1 if the position is not in book
+int OpeningBook::probe(const HexBoard& board, hexgonValKind tomove) const {
+  if (!isOpen() || board.getNumofhexgons() != header->numofhexgons)
+    return -1;
+  int numofstones = board.getSizeOfVertices() - board.getNumofemptyhexgons();
+  if (numofstones > header->maxstones)
+    return -1;
+  const BookEntry* entry = lookup(PositionHash::hashBoard(board, tomove));
+  if (entry == nullptr || entry->move < 1
+      || entry->move > board.getSizeOfVertices()
+      || !board.getEmptyHexIndicators().get()[entry->move - 1])
+    return -1;  //guard against hash collision or corrupted entry
+  return entry->move;
+}
+///Get the number of hexgons per side of the book
+///@param NONE
+///@return the number of hexgons per side or 0 if the book is closed
+int OpeningBook::getNumofhexgons() const {
+  return isOpen() ? header->numofhexgons : 0;
+}
+///Get the maximal number of stones of the book positions
+///@param NONE
+///@return the maximal number of stones or 0 if the book is closed
+int OpeningBook::getMaxstones() const {
+  return isOpen() ? header->maxstones : 0;
+}
+///Get the number of entries in the book
+///@param NONE
+///@return the number of entries or 0 if the book is closed
+size_t OpeningBook::getSizeofEntries() const {
+  return isOpen() ? static_cast<size_t>(header->numofentries) : 0;
+}
+///Sort the entries and write the book file. The entries with duplicated keys are removed and the first one is kept
+///@param filename is the path of book file to be written
+///@param numofhexgons is the number of hexgons per side of the book positions
+///@param maxstones is the maximal number of stones of the book positions
+///@param bookentries is the entries to be written which will be sorted in place
+///@return TRUE if the file is written successfully
+bool OpeningBook::write(const string& filename, int numofhexgons,
+                        int maxstones, vector<BookEntry>& bookentries) {
+  stable_sort(bookentries.begin(), bookentries.end(), lessEntry);
+  vector<BookEntry> unique;
+  unique.reserve(bookentries.size());
+  for (vector<BookEntry>::iterator iter = bookentries.begin();
+      iter != bookentries.end(); ++iter)
+    if (unique.empty() || unique.back().key != iter->key)
+      unique.push_back(*iter);
+
+  BookHeader bookheader;
+  memset(&bookheader, 0, sizeof(bookheader));
+  memcpy(bookheader.magic, BOOKMAGIC, sizeof(BOOKMAGIC));
+  bookheader.version = VERSION;
+  bookheader.numofhexgons = static_cast<boost::uint16_t>(numofhexgons);
+  bookheader.maxstones = static_cast<boost::uint16_t>(maxstones);
+  bookheader.numofentries = unique.size();
+
+  ofstream out(filename.c_str(), ios::out | ios::binary | ios::trunc);
+  if (!out)
+    return false;
+  out.write(reinterpret_cast<const char*>(&bookheader), sizeof(bookheader));
+  if (!unique.empty())
+    out.write(reinterpret_cast<const char*>(&unique[0]),
+              unique.size() * sizeof(BookEntry));
+  return !out.fail();
+}
@@ -0,0 +1,101 @@
+/*
+ * OpeningBook.h
+ * This file declares the read-only, memory-mapped opening book used by AI strategies and the writer used by the offline book builder.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef OPENINGBOOK_H_
+#define OPENINGBOOK_H_
+
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "Global.h"
+#include "HexBoard.h"
+
+/**
+ * OpeningBook class is used to answer the moves of opening positions without searching.<br/>
+ * The book file is a compact binary file which consists of a 32-byte header followed by entries sorted by the position key
+ * (see PositionHash). Each entry is 16 bytes: 64-bit position key, 32-bit visit count, 16-bit move (index of hexgon) and
+ * 16-bit winning rate scaled to [0, 65535]. The file is memory-mapped read-only and looked up by binary search, hence
+ * several processes playing games share the same physical pages and no parsing is done when opening the book.<br/>
+ * OpeningBook(): parameterless default constructor which constructs a closed book<br/>
+ * OpeningBook(const std::string& filename): user defined constructor which opens the given book file<br/>
+ * Sample Usage:<br/>
+ * OpeningBook book("book11.bin");<br/>
+ * int move = book.probe(board, hexgonValKind_RED); //-1 if the position is not in book<br/>
+ */
+class OpeningBook {
+ public:
+  /**
+   * BookEntry is the on-disk record of one book position
+   */
+  struct BookEntry {
+    boost::uint64_t key;  ///< the position key computed by PositionHash
+    boost::uint32_t visitcount;  ///< the number of simulated games spent on this position by the book builder
+    boost::uint16_t move;  ///< the index of hexgon to play (starting from 1)
+    boost::uint16_t winrate;  ///< the estimated winning rate of the move scaled to [0, 65535]
+  };
+  /**
+   * BookHeader is the on-disk header of the book file
+   */
+  struct BookHeader {
+    char magic[8];  ///< the magic string "HEXBOOK" terminated by null character
+    boost::uint32_t version;  ///< the version of file format
+    boost::uint16_t numofhexgons;  ///< the number of hexgons per side of the board the book is built for
+    boost::uint16_t maxstones;  ///< the maximal number of stones on board of any book position
+    boost::uint64_t numofentries;  ///< the number of entries following the header
+    boost::uint64_t reserved;  ///< reserved for future use, should be zero
+  };
+
+ private:
+  boost::interprocess::file_mapping bookfile;  ///< the mapping of book file
+  boost::interprocess::mapped_region bookregion;  ///< the read-only mapped region of the whole book file
+  const BookHeader* header;  ///< the header inside the mapped region, nullptr when the book is closed
+  const BookEntry* entries;  ///< the sorted entries inside the mapped region
+
+  //Check if the header is valid for the size of mapped region
+  static bool isValidHeader(const BookHeader* header, std::size_t sizeofregion);
+
+ public:
+  static const boost::uint32_t VERSION = 1;  ///< current version of book file format
+
+  //Parameterless default constructor which constructs a closed book
+  OpeningBook();
+  //User defined constructor which opens the given book file
+  explicit OpeningBook(const std::string& filename);
+  ///destructor
+  virtual ~OpeningBook() {
+  }
+  ;
+  //Map the given book file into memory
+  bool open(const std::string& filename);
+  //Unmap the book file
+  void close();
+  ///Check if the book is opened successfully
+  ///@param NONE
+  ///@return TRUE if the book file is mapped and valid
+  bool isOpen() const {
+    return header != nullptr;
+  }
+  //Get the entry of given position key
+  const BookEntry* lookup(boost::uint64_t key) const;
+  //Get the book move for the position on the hex board
+  int probe(const HexBoard& board, hexgonValKind tomove) const;
+  //Get the number of hexgons per side of the book
+  int getNumofhexgons() const;
+  //Get the maximal number of stones of the book positions
+  int getMaxstones() const;
+  //Get the number of entries in the book
+  std::size_t getSizeofEntries() const;
+  //Sort the entries and write the book file
+  static bool write(const std::string& filename, int numofhexgons,
+                    int maxstones, std::vector<BookEntry>& bookentries);
+};
+
+#endif /* OPENINGBOOK_H_ */
@@ -0,0 +1,102 @@
+/*
+ * PatternPlayout.cpp
+ * This file defines the implementation of PatternPlayout class
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "PatternPlayout.h"
+
+using namespace std;
+
+///User defined constructor which takes the tables of board
+///@param topology is the tables of bridges and edge templates which should outlive the policy
+PatternPlayout::PatternPlayout(const BoardTopology& topology)
+    : topology(topology),
+      isbabywatsonwesttoeast(true) {
+}
+///Reset the policy to the given game state, the buffers are reused across simulated games
+///@param state is the game state at the beginning of play-out phase
+///@param isbabywatsonwesttoeast is the winning condition of AI player
+///@return NONE
+void PatternPlayout::reset(DescentState& state, bool isbabywatsonwesttoeast) {
+  this->isbabywatsonwesttoeast = isbabywatsonwesttoeast;
+  int numofvertices = state.getSizeofVertices();
+  emptycells.clear();
+  positions.assign(numofvertices, -1);
+  owners.assign(numofvertices, 0);
+  for (int i = 1; i <= numofvertices; ++i)
+    if (state.isEmpty(i)) {
+      positions[i - 1] = static_cast<int>(emptycells.size());
+      emptycells.push_back(i);
+    }
+  const vector<int>& babywatsons = state.getBabywatsons();
+  for (size_t i = 0; i < babywatsons.size(); ++i)
+    if (babywatsons[i] > 0)
+      owners[babywatsons[i] - 1] = 1;
+  const vector<int>& opponents = state.getOpponents();
+  for (size_t i = 0; i < opponents.size(); ++i)
+    if (opponents[i] > 0)
+      owners[opponents[i] - 1] = -1;
+}
+///Check if the end of a connection is owned by the player. An edge is owned by the player who connects it
+///@param end is the position of hexgon starting from 1 or the edgekind of BoardTopology
+///@param owner is the player, 1 for AI player and -1 for the opponent
+///@return TRUE if the end is owned by the player
+bool PatternPlayout::isConnected(int end, signed char owner) const {
+  if (end > 0)
+    return owners[end - 1] == owner;
+  bool iswesttoeast = (owner == 1) ?
+      isbabywatsonwesttoeast : !isbabywatsonwesttoeast;
+  if (end == BoardTopology::WEST || end == BoardTopology::EAST)
+    return iswesttoeast;
+  return !iswesttoeast;
+}
+///Remove the hexgon from the empty hexgons by swapping it with the last one
+///@param move is the position of hexgon starting from 1
+///@param owner is the player, 1 for AI player and -1 for the opponent
+///@return NONE
+void PatternPlayout::occupy(int move, signed char owner) {
+  int position = positions[move - 1];
+  int last = emptycells.back();
+  emptycells[position] = last;
+  positions[last - 1] = position;
+  emptycells.pop_back();
+  positions[move - 1] = -1;
+  owners[move - 1] = owner;
+}
+///Get the response which restores a bridge or an edge template of the player intruded by the last move of the opponent
+///@param isbabywatson is TRUE if AI player is to move
+///@param lastmove is the last move of the opponent, non-positive if none
+///@return the response chosen at random among the intruded connections or 0 if no connection is intruded
+int PatternPlayout::getResponse(bool isbabywatson, int lastmove) {
+  signed char owner = isbabywatson ? 1 : -1;
+  if (lastmove <= 0 || owners[lastmove - 1] != -owner)
+    return 0;
+  candidates.clear();
+  for (const BoardTopology::Intrusion* entry = topology.beginIntrusions(
+      lastmove); entry != topology.endIntrusions(lastmove); ++entry)
+    if (owners[entry->response - 1] == 0 && owners[entry->first - 1] == owner
+        && isConnected(entry->second, owner))
+      candidates.push_back(entry->response);
+  if (candidates.empty())
+    return 0;
+  return candidates[generator.nextIndex(candidates.size())];
+}
+///Generate a move which answers the intrusion of the last move or a uniformly random empty hexgon otherwise, and apply
+///it to the state
+///@param state is the game state which should have at least one empty hexgon
+///@param isbabywatson is TRUE if AI player is to move
+///@param lastmove is the last move of the opponent, non-positive if none
+///@return the generated move
+int PatternPlayout::genMove(DescentState& state, bool isbabywatson,
+                            int lastmove) {
+  assert(!emptycells.empty());
+  int move = getResponse(isbabywatson, lastmove);
+  if (move == 0)
+    move = emptycells[generator.nextIndex(emptycells.size())];
+  occupy(move, isbabywatson ? 1 : -1);
+  state.play(move, isbabywatson);
+  return move;
+}
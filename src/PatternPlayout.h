@@ -0,0 +1,65 @@
+/*
+ * PatternPlayout.h
+ * This file declares the play-out policy which answers bridge intrusions by the precomputed tables of BoardTopology.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef PATTERNPLAYOUT_H_
+#define PATTERNPLAYOUT_H_
+
+#include <vector>
+
+#include "FastRandom.h"
+#include "DescentState.h"
+#include "BoardTopology.h"
+
+/**
+ * PatternPlayout class is used to generate the moves of play-out phase in Monte Carlo Tree Search.<br/>
+ * When the last move of the opponent intrudes into a bridge or an edge template of the player to move, the policy
+ * answers with the other carrier (chosen at random if several connections are threatened); otherwise the move is drawn
+ * uniformly from the empty hexgons. The intrusions of the last move are a contiguous range of BoardTopology and the empty
+ * hexgons are kept in an array with the position of each hexgon in it, so each move costs a table scan of a few entries
+ * plus a constant time removal, which is close to the uniform policy. Each thread owns its policy and reuses the buffers
+ * across simulated games.<br/>
+ * PatternPlayout(const BoardTopology& topology): user defined constructor which takes the tables of board. The topology
+ * should outlive the policy<br/>
+ * Sample Usage:<br/>
+ * PatternPlayout policy(topology);<br/>
+ * policy.reset(state, player.getWestToEastCondition());<br/>
+ * int lastmove = policy.genMove(state, true, state.getLastMove());<br/>
+ */
+class PatternPlayout {
+ private:
+  const BoardTopology& topology;  ///< the tables of bridges and edge templates, not owned
+  FastRandom generator;  ///< the generator to draw moves
+  std::vector<int> emptycells;  ///< the empty hexgons in arbitrary order
+  std::vector<int> positions;  ///< the position of each hexgon in emptycells, indexed by position - 1, -1 if occupied
+  std::vector<signed char> owners;  ///< the owner of each hexgon, 1 for AI player, -1 for the opponent and 0 for empty
+  std::vector<int> candidates;  ///< the responses found for the last move
+  bool isbabywatsonwesttoeast;  ///< the winning condition of AI player
+
+  //Check if the end of a connection is owned by the player
+  bool isConnected(int end, signed char owner) const;
+  //Remove the hexgon from the empty hexgons
+  void occupy(int move, signed char owner);
+
+ public:
+  //User defined constructor which takes the tables of board
+  explicit PatternPlayout(const BoardTopology& topology);
+  //Reset the policy to the given game state
+  void reset(DescentState& state, bool isbabywatsonwesttoeast);
+  //Get the response which restores a connection intruded by the last move
+  int getResponse(bool isbabywatson, int lastmove);
+  //Generate a move and apply it to the state
+  int genMove(DescentState& state, bool isbabywatson, int lastmove);
+  ///Seed the generator
+  ///@param seed is the seed of generator
+  ///@return NONE
+  void setSeed(boost::uint64_t seed) {
+    generator.setSeed(seed);
+  }
+};
+
+#endif /* PATTERNPLAYOUT_H_ */
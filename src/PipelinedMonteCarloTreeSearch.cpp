@@ -0,0 +1,168 @@
+/*
+ * PipelinedMonteCarloTreeSearch.cpp
+ * This file declares a pipelined Monte Carlo Tree Search implementation for AI player
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "Global.h"
+#include "GameTree.h"
+#include "PipelinedMonteCarloTreeSearch.h"
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+using namespace std;
+using namespace boost;
+
+#if __cplusplus > 199711L
+PipelinedMonteCarloTreeSearch::PipelinedMonteCarloTreeSearch(
+    const HexBoard* board, const Player* aiplayer)
+    : PipelinedMonteCarloTreeSearch(board, aiplayer, 4, 2048) {
+}
+#else
+PipelinedMonteCarloTreeSearch::PipelinedMonteCarloTreeSearch(
+    const HexBoard* board, const Player* aiplayer)
+: AbstractStrategyImpl(board, aiplayer),
+mcstimpl(MonteCarloTreeSearch(board, aiplayer)),
+ptrtoboard(board),
+ptrtoplayer(aiplayer),
+numberofworkers(4),
+numberoftrials(2048) {
+}
+#endif
+PipelinedMonteCarloTreeSearch::PipelinedMonteCarloTreeSearch(
+    const HexBoard* board, const Player* aiplayer, size_t numberofworkers,
+    size_t numberoftrials)
+    : AbstractStrategyImpl(board, aiplayer),
+      mcstimpl(MonteCarloTreeSearch(board, aiplayer)),
+      ptrtoboard(board),
+      ptrtoplayer(aiplayer),
+      numberofworkers(numberofworkers > 0 ? numberofworkers : 1),
+      numberoftrials(numberoftrials) {
+}
+///Overwritten simulation method. See AbstractStrategy.
+int PipelinedMonteCarloTreeSearch::simulation(int currentempty) {
+  hexgame::shared_ptr<bool> emptyglobal;
+  vector<int> bwglobal, oppglobal;
+  initGameState(emptyglobal, bwglobal, oppglobal);
+  //the connections and the analysis are done once and only read by the tree thread
+  vector<int> mustplay;
+  int winningmove = mcstimpl.searchConnections(bwglobal, oppglobal, mustplay);
+  if (winningmove > 0) {
+    mcstimpl.lastwinningrate = 1.0;
+    return winningmove;
+  }
+  InferiorCellAnalysis analysis(mcstimpl.topology);
+  currentempty -= mcstimpl.analyzeInferiorCells(emptyglobal, bwglobal,
+                                                oppglobal, analysis);
+  vector<int> rootpriors;
+  mcstimpl.getRootPriors(bwglobal, oppglobal, rootpriors);
+  //owned by the tree thread only, hence no lock
+  GameTree gametree(ptrtoplayer->getViewLabel());
+  gametree.setProgressiveWidening(mcstimpl.getProgressiveWidening());
+  gametree.setRaveEquivalence(mcstimpl.getRaveEquivalence());
+
+  //the slots in flight, both queues can hold every slot so that a push never fails
+  size_t numofslots = 2 * numberofworkers;
+  size_t capacity = 2;
+  while (capacity < numofslots)
+    capacity <<= 1;
+  vector<Slot> slots(numofslots);
+  vector<int> freeslots;
+  for (size_t i = 0; i < numofslots; ++i) {
+    slots[i].state.setNeighborTable(&mcstimpl.neighbortable);
+    slots[i].state.setRootPriors(rootpriors.empty() ? NULL : &rootpriors);
+    freeslots.push_back(static_cast<int>(i));
+  }
+  MPMCQueue<int> jobs(capacity), results(capacity);
+  hexgame::atomic<bool> isstopped(false);
+  thread_group workers;
+  for (size_t i = 0; i < numberofworkers; ++i)
+    workers.create_thread(
+        boost::bind(boost::mem_fn(&PipelinedMonteCarloTreeSearch::worker),
+                    boost::ref(*this), boost::ref(slots), boost::ref(jobs),
+                    boost::ref(results), boost::cref(isstopped)));
+
+  size_t numoflaunched = 0, numoffinished = 0;
+  while (numoffinished < numberoftrials) {
+    bool isidle = true;
+    //launch: selection and expansion of the free slots
+    while (!freeslots.empty() && numoflaunched < numberoftrials) {
+      int index = freeslots.back();
+      freeslots.pop_back();
+      Slot& slot = slots[index];
+      slot.state.reset(emptyglobal, ptrtoboard->getSizeOfVertices(), bwglobal,
+                       oppglobal);
+      analysis.apply(slot.state);
+      slot.state.setRootRegion(mustplay);
+      pair<int, int> selectresult = mcstimpl.selection(currentempty, gametree,
+                                                       slot.state);
+      slot.expandednode = mcstimpl.expansion(selectresult, slot.state,
+                                             gametree);
+      gametree.updateVirtualVisits(slot.expandednode, 1);
+      bool ispushed = jobs.tryPush(index);
+      assert(ispushed);
+      (void) ispushed;
+      ++numoflaunched;
+      isidle = false;
+    }
+    //drain: back-propagation of the finished slots
+    int index;
+    while (results.tryPop(index)) {
+      Slot& slot = slots[index];
+      gametree.updateVirtualVisits(slot.expandednode, -1);
+      mcstimpl.backpropagation(slot.expandednode, slot.winner, gametree,
+                               slot.state);
+      freeslots.push_back(index);
+      ++numoffinished;
+      isidle = false;
+    }
+    if (isidle)
+      this_thread::yield();
+  }
+  isstopped.store(true, hexgame::memory_order_release);
+  workers.join_all();
+
+  int resultmove = mcstimpl.getBestMove(gametree);
+  //find the move with the maximal successful simulated outcome
+  assert(resultmove != -1);
+  return resultmove;
+}
+///the loop passed to each worker thread which plays out the simulated games until the tree thread stops it
+///@param slots is the pool of simulated games in flight
+///@param jobs is the queue of slots advanced by the tree thread to be played out
+///@param results is the queue of slots played out to be back-propagated by the tree thread
+///@param isstopped is the flag set by the tree thread when every simulated game is finished
+///@return NONE
+void PipelinedMonteCarloTreeSearch::worker(
+    std::vector<Slot>& slots, MPMCQueue<int>& jobs, MPMCQueue<int>& results,
+    const hexgame::atomic<bool>& isstopped) {
+  //the policies are owned by the worker since mcstimpl is shared
+  PatternPlayout policy(mcstimpl.topology);
+  TwoDistanceEvaluator evaluator(mcstimpl.topology);
+  FastRandom generator;
+  while (!isstopped.load(hexgame::memory_order_acquire)) {
+    int index;
+    if (!jobs.tryPop(index)) {
+      this_thread::yield();
+      continue;
+    }
+    Slot& slot = slots[index];
+    if (mcstimpl.getEvaluationRate() > 0.0
+        && generator.nextUniform() < mcstimpl.getEvaluationRate())
+      slot.winner = mcstimpl.evaluation(slot.state, evaluator, generator);
+    else if (mcstimpl.isPatternPlayout())
+      slot.winner = mcstimpl.playout(slot.state, policy);
+    else
+      slot.winner = mcstimpl.playout(slot.state.getEmptyIndicators(),
+                                     slot.state.getNumofEmpty(),
+                                     slot.state.getBabywatsons(),
+                                     slot.state.getOpponents());
+    assert(slot.winner != 0);
+    bool ispushed = results.tryPush(index);
+    assert(ispushed);
+    (void) ispushed;
+  }
+}
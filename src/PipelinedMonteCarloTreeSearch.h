@@ -0,0 +1,148 @@
+/*
+ * PipelinedMonteCarloTreeSearch.h
+ * This file defines a pipelined Monte Carlo Tree Search implementation for AI player
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef PIPELINEDMONTECARLOTREESEARCH_H_
+#define PIPELINEDMONTECARLOTREESEARCH_H_
+
+#include "Global.h"
+#include "Player.h"
+#include "HexBoard.h"
+#include "MPMCQueue.h"
+#include "DescentState.h"
+#include "MonteCarloTreeSearch.h"
+
+#include <vector>
+
+/**
+ * PipelinedMonteCarloTreeSearch class defines a pipelined version of Monte Carlo Tree Search implementation for AI player.<br/>
+ * Unlike MultiMonteCarloTreeSearch which lets every thread lock the shared game tree, only the calling thread (the tree
+ * thread) touches the game tree: it selects and expands the simulated games and back-propagates their results, while the
+ * worker threads only play out (or evaluate) the game states. Each simulated game in flight owns a slot of the pool which
+ * holds its game state, the expanded node and the winner; the indices of slots are handed over through two lock-free
+ * queues (MPMCQueue), the jobs from the tree thread to the workers and the results back, hence neither the game tree nor
+ * the game states are locked or copied. Virtual visits are added along the selected path while its game is in flight, so
+ * the following selections spread over the other branches of game tree.<br/>
+ * The number of slots is twice the number of workers which keeps the workers busy while the tree thread drains the results.
+ * The budget of nodes is not applied to the game tree since the expanded nodes of the games in flight must stay valid.<br/>
+ * PipelinedMonteCarloTreeSearch(const HexBoard* board, const Player* aiplayer): user defined constructor which takes
+ * pointer to a hex board object and pointer to AI player; while the number of workers (numberofworkers) is set as default
+ * value (4) and the number of simulated games (numberoftrials) is set as default value (2048)<br/>
+ * PipelinedMonteCarloTreeSearch(const HexBoard* board, const Player* aiplayer, size_t numberofworkers, size_t numberoftrials):
+ * user defined constructor which takes pointer to a hex board object, pointer to AI player, the number of workers and the
+ * number of simulated games<br/>
+ * Sample Usage: Please see Strategy (similar way to instantiate)
+ */
+class PipelinedMonteCarloTreeSearch : public AbstractStrategyImpl {
+ private:
+  /**
+   * Slot is one simulated game in flight between the tree thread and a worker
+   */
+  struct Slot {
+    DescentState state;  ///< the game state advanced by selection and expansion, played out by the worker
+    int expandednode;  ///< the node expanded by the tree thread
+    int winner;  ///< the winner of simulated game set by the worker
+  };
+
+  MonteCarloTreeSearch mcstimpl;  ///< the implementation of the four phases, only read by the workers
+  const HexBoard* const ptrtoboard;  ///< The actual playing board in the game. Need to ensure it not to be modified during the simulation
+  const Player* const ptrtoplayer;  ///< the actual player computer plays. Need to ensure it not to be modified during the simulation
+  const std::size_t numberofworkers;  ///< The number of worker threads which play out the simulated games. 4 by default
+  const std::size_t numberoftrials;  ///< The number of simulated games. 2048 by default
+
+  //the loop of worker thread which plays out the simulated games of the slots popped from the jobs
+  void worker(std::vector<Slot>& slots, MPMCQueue<int>& jobs,
+              MPMCQueue<int>& results, const hexgame::atomic<bool>& isstopped);
+
+ public:
+  ///User defined constructor which takes pointer to a hex board object and pointer to AI player as parameters
+  PipelinedMonteCarloTreeSearch(const HexBoard* board, const Player* aiplayer);
+  ///User defined constructor which takes pointer to a hex board object, pointer to AI player, number of workers (numberofworkers) and number of simulated games (numberoftrials) as parameters
+  PipelinedMonteCarloTreeSearch(const HexBoard* board, const Player* aiplayer,
+                                std::size_t numberofworkers,
+                                std::size_t numberoftrials);
+  ///destructor
+  virtual ~PipelinedMonteCarloTreeSearch() {
+  }
+  ;
+  ///return the meaningful class name as "PipelinedMonteCarloTreeSearch"
+  std::string name() {
+    return std::string("PipelinedMonteCarloTreeSearch");
+  }
+  ;
+  ///Overwritten simulation method. See AbstractStrategy
+  int simulation(int currentempty);
+
+  ///Getter for retrieving number of worker threads
+  ///@param NONE
+  ///@return number of worker threads
+  std::size_t getNumberofworkers() const {
+    return numberofworkers;
+  }
+  ///Getter for retrieving number of simulated games
+  ///@param NONE
+  ///@return number of simulated games
+  std::size_t getNumberoftrials() const {
+    return numberoftrials;
+  }
+  ///Getter for the estimated winning rate of the best move returned by the last simulation
+  ///@param NONE
+  ///@return the winning rate of AI player
+  double getLastWinningRate() const {
+    return mcstimpl.getLastWinningRate();
+  }
+  ///Setter for the schedule of progressive widening of the game tree
+  ///@param schedule is the schedule of progressive widening, the default constructed one disables widening
+  ///@return NONE
+  void setProgressiveWidening(const ProgressiveWidening& schedule) {
+    mcstimpl.setProgressiveWidening(schedule);
+  }
+  ///Setter for the equivalence parameter of RAVE of the game tree
+  ///@param equivalence is the equivalence parameter, 0 to disable RAVE
+  ///@return NONE
+  void setRaveEquivalence(double equivalence) {
+    mcstimpl.setRaveEquivalence(equivalence);
+  }
+  ///Setter for the play-out policy of every worker
+  ///@param ispattern is TRUE to use PatternPlayout in play-out phase, FALSE for uniform random moves
+  ///@return NONE
+  void setPatternPlayout(bool ispattern) {
+    mcstimpl.setPatternPlayout(ispattern);
+  }
+  ///Setter for the analysis of inferior hexgons before the simulation
+  ///@param ispruning is TRUE to analyze the actual game state by InferiorCellAnalysis before simulation
+  ///@return NONE
+  void setInferiorPruning(bool ispruning) {
+    mcstimpl.setInferiorPruning(ispruning);
+  }
+  ///Setter for the search of virtual connections before the simulation
+  ///@param issearch is TRUE to search the virtual connections of both players by HSearch before simulation
+  ///@return NONE
+  void setVCSearch(bool issearch) {
+    mcstimpl.setVCSearch(issearch);
+  }
+  ///Setter for the fraction of simulated games of every worker evaluated by TwoDistanceEvaluator instead of played out
+  ///@param rate is the fraction in [0, 1], 0 to play out every simulated game and 1 to evaluate every one
+  ///@return NONE
+  void setEvaluationRate(double rate) {
+    mcstimpl.setEvaluationRate(rate);
+  }
+  ///Setter for the order of moves at root by the priors of TwoDistanceEvaluator
+  ///@param isprior is TRUE to order the moves at root by the priors of TwoDistanceEvaluator instead of neighbor count
+  ///@return NONE
+  void setTwoDistancePrior(bool isprior) {
+    mcstimpl.setTwoDistancePrior(isprior);
+  }
+  ///Setter for the order of moves at root by the currents of resistance model
+  ///@param isprior is TRUE to order the moves at root by the priors of ResistanceEvaluator
+  ///@return NONE
+  void setResistancePrior(bool isprior) {
+    mcstimpl.setResistancePrior(isprior);
+  }
+};
+
+#endif /* PIPELINEDMONTECARLOTREESEARCH_H_ */
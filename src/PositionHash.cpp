@@ -0,0 +1,77 @@
+/*
+ * PositionHash.cpp
+ * This file defines the implementation of PositionHash class
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "PositionHash.h"
+
+using namespace std;
+
+///Scramble a 64-bit value with the finalizer of splitmix64 so that nearby inputs give unrelated keys
+///@param value is the value to be scrambled
+///@return the scrambled value
+boost::uint64_t PositionHash::mix(boost::uint64_t value) {
+  value += 0x9E3779B97F4A7C15ULL;
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+  return value ^ (value >> 31);
+}
+///Get the key of a hexgon occupied by the given color
+///@param numofhexgons is the number of hexgons per side
+///@param indexofhexgon is the index of hexgon (starting from 1 to number of hexgons per side squared)
+///@param kind is the color occupying the hexgon (RED or BLUE)
+///@return the 64-bit key of the hexgon
+boost::uint64_t PositionHash::cellKey(int numofhexgons, int indexofhexgon,
+                                      hexgonValKind kind) {
+  boost::uint64_t seed = (static_cast<boost::uint64_t>(numofhexgons) << 40)
+      ^ (static_cast<boost::uint64_t>(indexofhexgon) << 8)
+      ^ static_cast<boost::uint64_t>(static_cast<int>(kind));
+  return mix(seed);
+}
+///Get the key of the player to move
+///@param numofhexgons is the number of hexgons per side
+///@param tomove is the color of the player to move
+///@return the 64-bit key of the player to move
+boost::uint64_t PositionHash::sideKey(int numofhexgons, hexgonValKind tomove) {
+  boost::uint64_t seed = (static_cast<boost::uint64_t>(numofhexgons) << 40)
+      ^ (0xFFFFFULL << 8) ^ static_cast<boost::uint64_t>(static_cast<int>(tomove));
+  return mix(seed);
+}
+///Get the key of a position given the moves made by both players
+///@param numofhexgons is the number of hexgons per side
+///@param redmoves is the moves made by red player
+///@param bluemoves is the moves made by blue player
+///@param tomove is the color of the player to move
+///@return the 64-bit key of the position
+boost::uint64_t PositionHash::hashPosition(int numofhexgons,
+                                           const vector<int>& redmoves,
+                                           const vector<int>& bluemoves,
+                                           hexgonValKind tomove) {
+  boost::uint64_t key = sideKey(numofhexgons, tomove);
+  for (vector<int>::const_iterator iter = redmoves.begin();
+      iter != redmoves.end(); ++iter)
+    key ^= cellKey(numofhexgons, *iter, hexgonValKind_RED);
+  for (vector<int>::const_iterator iter = bluemoves.begin();
+      iter != bluemoves.end(); ++iter)
+    key ^= cellKey(numofhexgons, *iter, hexgonValKind_BLUE);
+  return key;
+}
+///Get the key of the position currently on the hex board
+///@param board is the hex board
+///@param tomove is the color of the player to move
+///@return the 64-bit key of the position
+boost::uint64_t PositionHash::hashBoard(const HexBoard& board,
+                                        hexgonValKind tomove) {
+  return hashPosition(board.getNumofhexgons(), board.getRedmoves(),
+                      board.getBluemoves(), tomove);
+}
+///Get the index of hexgon after rotating the board by 180 degree. The rotation keeps the winning conditions of both players.
+///@param numofhexgons is the number of hexgons per side
+///@param indexofhexgon is the index of hexgon (starting from 1 to number of hexgons per side squared)
+///@return the index of the rotated hexgon
+int PositionHash::rotateHexgon(int numofhexgons, int indexofhexgon) {
+  return numofhexgons * numofhexgons + 1 - indexofhexgon;
+}
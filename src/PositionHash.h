@@ -0,0 +1,49 @@
+/*
+ * PositionHash.h
+ * This file declares the Zobrist-style hashing used to identify hex board positions across processes.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef POSITIONHASH_H_
+#define POSITIONHASH_H_
+
+#include <vector>
+#include <boost/cstdint.hpp>
+
+#include "Global.h"
+#include "HexBoard.h"
+
+/**
+ * PositionHash class is used to compute a 64-bit key which identifies a hex board position together with the player to move.<br/>
+ * The key of a position is the exclusive-or of the keys of all occupied hexgons and the key of the player to move.
+ * Keys are derived deterministically from the size of board, the index of hexgon and the color, so that an opening book
+ * or a table shared between processes computes the same key for the same position without sharing any random table.<br/>
+ * Sample Usage:<br/>
+ * HexBoard board(11);<br/>
+ * boost::uint64_t key = PositionHash::hashBoard(board, hexgonValKind_RED);<br/>
+ */
+class PositionHash {
+ public:
+  //Get the key of a hexgon occupied by the given color
+  static boost::uint64_t cellKey(int numofhexgons, int indexofhexgon,
+                                 hexgonValKind kind);
+  //Get the key of the player to move
+  static boost::uint64_t sideKey(int numofhexgons, hexgonValKind tomove);
+  //Get the key of a position given the moves made by both players
+  static boost::uint64_t hashPosition(int numofhexgons,
+                                      const std::vector<int>& redmoves,
+                                      const std::vector<int>& bluemoves,
+                                      hexgonValKind tomove);
+  //Get the key of the position currently on the hex board
+  static boost::uint64_t hashBoard(const HexBoard& board, hexgonValKind tomove);
+  //Get the index of hexgon after rotating the board by 180 degree
+  static int rotateHexgon(int numofhexgons, int indexofhexgon);
+
+ private:
+  //Scramble a 64-bit value (splitmix64 finalizer)
+  static boost::uint64_t mix(boost::uint64_t value);
+};
+
+#endif /* POSITIONHASH_H_ */
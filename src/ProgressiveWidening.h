@@ -0,0 +1,81 @@
+/*
+ * ProgressiveWidening.h
+ * This file defines the schedule of progressive widening which bounds the number of children of a node by its visit count.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef PROGRESSIVEWIDENING_H_
+#define PROGRESSIVEWIDENING_H_
+
+#include <cmath>
+#include <algorithm>
+
+/**
+ * ProgressiveWidening class is used to decide how many children a node is allowed to have.<br/>
+ * A node visited n times is allowed to have ceil(coefficient * n ^ exponent) children (at least one), so the tree only
+ * grows the children ordered first by the move prior until the node is visited often enough, and the play-outs are spent
+ * on going deeper instead of trying every empty hexgon at every level. A non-positive coefficient disables widening, i.e.
+ * a node is allowed to have one child per empty hexgon as before.<br/>
+ * ProgressiveWidening(): parameterless default constructor which disables widening<br/>
+ * ProgressiveWidening(double coefficient, double exponent): user defined constructor which sets the schedule<br/>
+ * Sample Usage:<br/>
+ * ProgressiveWidening widening(2.0, 0.5);<br/>
+ * if (numofchildren < widening.getWidth(visitcount, currentempty - level)) //expand the node<br/>
+ */
+class ProgressiveWidening {
+ private:
+  double coefficient;  ///< the coefficient of schedule, non-positive to disable widening
+  double exponent;  ///< the exponent of schedule which is usually between 0.25 and 0.5
+
+ public:
+  ///Parameterless default constructor which disables widening
+  ProgressiveWidening()
+      : coefficient(0.0),
+        exponent(0.5) {
+  }
+  ;
+  ///User defined constructor which sets the schedule
+  ///@param coefficient is the coefficient of schedule, non-positive to disable widening
+  ///@param exponent is the exponent of schedule
+  ProgressiveWidening(double coefficient, double exponent)
+      : coefficient(coefficient),
+        exponent(exponent) {
+  }
+  ;
+  ///Check if widening is enabled
+  ///@param NONE
+  ///@return TRUE if the number of children is bounded by visit count
+  bool isEnabled() const {
+    return coefficient > 0.0;
+  }
+  ///Get the coefficient of schedule
+  ///@param NONE
+  ///@return the coefficient
+  double getCoefficient() const {
+    return coefficient;
+  }
+  ///Get the exponent of schedule
+  ///@param NONE
+  ///@return the exponent
+  double getExponent() const {
+    return exponent;
+  }
+  ///Get the number of children allowed for a node
+  ///@param visitcount is the visit count of the node
+  ///@param numofmoves is the number of legal moves from the node, i.e. the number of empty hexgons
+  ///@return the number of children allowed which is between 1 and numofmoves
+  int getWidth(int visitcount, int numofmoves) const {
+    if (!isEnabled() || numofmoves <= 1)
+      return numofmoves;
+    double width = std::ceil(
+        coefficient * std::pow(static_cast<double>(std::max(visitcount, 1)),
+                               exponent));
+    if (width >= numofmoves)
+      return numofmoves;
+    return std::max(1, static_cast<int>(width));
+  }
+};
+
+#endif /* PROGRESSIVEWIDENING_H_ */
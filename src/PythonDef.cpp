@@ -4,14 +4,116 @@
  */
 #include <boost/python.hpp>
 
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <stdexcept>
+
 #include "Game.h"
 #include "Player.h"
 #include "HexBoard.h"
 #include "Strategy.h"
 #include "AbstractStrategy.h"
+#include "AsyncSearch.h"
+#include "MonteCarloTreeSearch.h"
+#include "WorkStealingScheduler.h"
+#include "VectorEnvironment.h"
+
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 
 using namespace boost::python;
 
+/**
+ * ScopedGILRelease releases the Python GIL in its scope, hence other Python threads run while the engine searches
+ */
+class ScopedGILRelease {
+ public:
+  ScopedGILRelease()
+      : state(PyEval_SaveThread()) {
+  }
+  ~ScopedGILRelease() {
+    PyEval_RestoreThread(state);
+  }
+ private:
+  PyThreadState* state;
+  ScopedGILRelease(const ScopedGILRelease&);
+  ScopedGILRelease& operator=(const ScopedGILRelease&);
+};
+/**
+ * BufferExporter exports a buffer of its owner as read-only. It holds a reference of the owner and counts the buffers
+ * exported, hence a memoryview made of it keeps the owner alive and the owner refuses to reallocate the buffer while the
+ * count is not zero
+ */
+struct BufferExporter {
+  PyObject_HEAD
+  PyObject* owner;  //the object owning the buffer
+  void* buffer;  //the first item
+  Py_ssize_t numofitems;  //the number of items, the shape of buffer
+  Py_ssize_t itemsize;  //the size of item, the stride of buffer
+  const char* format;  //the struct format of item
+  int* numofexports;  //the count of buffers exported of the owner, NULL if the owner never reallocates
+};
+static int getExporterBuffer(PyObject* self, Py_buffer* view, int flags) {
+  BufferExporter* exporter = reinterpret_cast<BufferExporter*>(self);
+  if (PyBuffer_FillInfo(view, self, exporter->buffer,
+                        exporter->numofitems * exporter->itemsize, 1, flags) != 0)
+    return -1;
+  view->itemsize = exporter->itemsize;
+  if (flags & PyBUF_FORMAT)
+    view->format = const_cast<char*>(exporter->format);
+  if ((flags & PyBUF_ND) == PyBUF_ND)
+    view->shape = &exporter->numofitems;
+  if ((flags & PyBUF_STRIDES) == PyBUF_STRIDES)
+    view->strides = &exporter->itemsize;
+  if (exporter->numofexports != NULL)
+    ++(*exporter->numofexports);
+  return 0;
+}
+static void releaseExporterBuffer(PyObject* self, Py_buffer*) {
+  BufferExporter* exporter = reinterpret_cast<BufferExporter*>(self);
+  if (exporter->numofexports != NULL)
+    --(*exporter->numofexports);
+}
+static void deallocExporter(PyObject* self) {
+  PyTypeObject* type = Py_TYPE(self);
+  Py_XDECREF(reinterpret_cast<BufferExporter*>(self)->owner);
+  type->tp_free(self);
+  Py_DECREF(type);  //the instances of a heap type hold their type
+}
+static PyType_Slot BufferExporterSlots[] = {
+    { Py_bf_getbuffer, reinterpret_cast<void*>(getExporterBuffer) },
+    { Py_bf_releasebuffer, reinterpret_cast<void*>(releaseExporterBuffer) },
+    { Py_tp_dealloc, reinterpret_cast<void*>(deallocExporter) },
+    { Py_tp_doc, const_cast<char*>("the read-only buffer of a view, which keeps its owner alive") },
+    { 0, NULL } };
+static PyType_Spec BufferExporterSpec = { "libhexgame.BufferExporter",
+    sizeof(BufferExporter), 0, Py_TPFLAGS_DEFAULT, BufferExporterSlots };
+static PyTypeObject* BufferExporterType = NULL;  //created when the module is imported
+/**
+ * Wrap a buffer of an object of module as read-only memoryview without copying. The view keeps the owner alive, and the
+ * owner counts it in numofexports until it is released
+ */
+static object makeBufferView(object owner, void* buffer, Py_ssize_t numofitems,
+                             Py_ssize_t itemsize, const char* format,
+                             int* numofexports) {
+  BufferExporter* exporter = PyObject_New(BufferExporter, BufferExporterType);
+  if (exporter == NULL)
+    throw_error_already_set();
+  Py_INCREF(owner.ptr());
+  exporter->owner = owner.ptr();
+  exporter->buffer = buffer;
+  exporter->numofitems = numofitems;
+  exporter->itemsize = itemsize;
+  exporter->format = format;
+  exporter->numofexports = numofexports;
+  handle<> holder(reinterpret_cast<PyObject*>(exporter));
+  PyObject* memoryview = PyMemoryView_FromObject(holder.get());
+  if (memoryview == NULL)
+    throw_error_already_set();
+  return object(handle<>(memoryview));
+}
 /**
  * HexGamePyEngine
  */
@@ -22,39 +124,88 @@ class HexGamePyEngine {
       : board(HexBoard(numofhexgon)),
         redplayer(Player(board, hexgonValKind::RED)),
         blueplayer(Player(board, hexgonValKind::BLUE)),
-        hexboardgame(Game(board)) {
+        hexboardgame(Game(board)),
+        numofviews(0) {
+    syncBoard();
   }
 #else
   HexGamePyEngine(unsigned numofhexgon)
   : board(HexBoard(numofhexgon)),
   redplayer(Player(board, RED)),
   blueplayer(Player(board, BLUE)),
-  hexboardgame(Game(board)) {
+  hexboardgame(Game(board)),
+  numofviews(0) {
+    syncBoard();
   }
 #endif
   ~HexGamePyEngine() {
   }
   bool setRedPlayerMove(int indexofhexgon) {
-    if (indexofhexgon) {
-      int row = (indexofhexgon - 1) / board.getNumofhexgons() + 1;
-      int col = (indexofhexgon - 1) % board.getNumofhexgons() + 1;
-      return hexboardgame.setMove(redplayer, row, col);
-    }
-    return false;
+    finishSearch();  //the board is not modified during the search
+    EngineLock lock(*this);
+    return setMove(redplayer, indexofhexgon);
   }
   bool setBluePlayerMove(int indexofhexgon) {
-    if (indexofhexgon) {
-      int row = (indexofhexgon - 1) / board.getNumofhexgons() + 1;
-      int col = (indexofhexgon - 1) % board.getNumofhexgons() + 1;
-      return hexboardgame.setMove(blueplayer, row, col);
-    }
-    return false;
+    finishSearch();  //the board is not modified during the search
+    EngineLock lock(*this);
+    return setMove(blueplayer, indexofhexgon);
+  }
+  //set many moves of red player in one call, the illegal moves are skipped, return the number of moves set
+  int setRedPlayerMoves(object indices) {
+    return setMoves(redplayer, indices);
+  }
+  //set many moves of blue player in one call, the illegal moves are skipped, return the number of moves set
+  int setBluePlayerMoves(object indices) {
+    return setMoves(blueplayer, indices);
   }
+  //the search runs without the GIL after the running search of startSearch finishes, -1 without strategy of the player
   int genRedPlayerMove() {
-    return hexboardgame.genMove(*aistrategy['R']);
+    return genLockedMove('R');
   }
   int genBluePlayerMove() {
-    return hexboardgame.genMove(*aistrategy['B']);
+    return genLockedMove('B');
+  }
+  bool startRedPlayerSearch() {
+    return startSearch('R');
+  }
+  bool startBluePlayerSearch() {
+    return startSearch('B');
+  }
+  dict pollSearch() {
+    dict progress;
+    SearchMonitor::Snapshot snapshot;
+    if (search)
+      search->poll(snapshot);
+    progress["bestmove"] = snapshot.bestmove;
+    progress["winningrate"] = snapshot.winningrate;
+    progress["numoftrials"] = snapshot.numoftrials;
+    progress["isdone"] = snapshot.isdone;
+    dict visits;
+    for (size_t i = 0; i < snapshot.statistics.size(); ++i)
+      visits[snapshot.statistics[i].move] = snapshot.statistics[i].visitcount;
+    progress["visits"] = visits;
+    return progress;
+  }
+  void stopSearch() {
+    if (search)
+      search->stop();
+  }
+  int waitSearch() {
+    //taken from the engine first, hence another Python thread running while the GIL is released never sees it
+    hexgame::shared_ptr<AsyncSearch> waited;
+    waited.swap(search);
+    if (!waited)
+      return -1;
+    int move;
+    {
+      ScopedGILRelease release;
+      move = waited->wait();
+    }
+    SearchMonitor::Snapshot snapshot;
+    waited->poll(snapshot);
+    EngineLock lock(*this);
+    recordVisits(snapshot.statistics);
+    return move;
   }
   void showView() {
     std::string view = hexboardgame.showView(redplayer, blueplayer);
@@ -69,14 +220,52 @@ class HexGamePyEngine {
   unsigned getNumofhexgons() {
     return board.getNumofhexgons();
   }
+  //the board is not resized while a view of it exists
   void setNumofhexgons(unsigned numofhexgon) {
+    if (numofviews > 0 && static_cast<int>(numofhexgon) != board.getNumofhexgons()) {
+      PyErr_SetString(PyExc_BufferError,
+                      "the board can not be resized while its views exist");
+      throw_error_already_set();
+    }
+    finishSearch();
+    EngineLock lock(*this);
     board.setNumofhexgons(numofhexgon);
+    syncBoard();
   }
   hexgonValKind getNodeValue(int indexofhexgon) {
     return board.getNodeValue(indexofhexgon);
   }
+  //query many hexgons in one call, return the list of their values
+  boost::python::list getNodeValues(object indices) {
+    boost::python::list values;
+    int numofindices = len(indices);
+    int numofvertices = board.getSizeOfVertices();
+    for (int i = 0; i < numofindices; ++i) {
+      int indexofhexgon = extract<int>(indices[i]);
+      if (indexofhexgon < 1 || indexofhexgon > numofvertices)
+        throw std::out_of_range("index of hexgon is off board");
+      values.append(static_cast<hexgonValKind>(cells[indexofhexgon - 1]));
+    }
+    return values;
+  }
+  //the board as a read-only memoryview of int8 hexgon values (EMPTY, BLUE, RED) indexed by hexgon - 1, updated in place.
+  //the view keeps the engine alive and the board is not resized until it is released
+  static object getBoardView(object self) {
+    HexGamePyEngine& engine = extract<HexGamePyEngine&>(self);
+    return makeBufferView(self, engine.cells.data(), engine.cells.size(),
+                          sizeof(signed char), "b", &engine.numofviews);
+  }
+  //the visit counts of the moves at root of the last search as a read-only memoryview of int32 indexed by hexgon - 1
+  static object getVisitView(object self) {
+    HexGamePyEngine& engine = extract<HexGamePyEngine&>(self);
+    return makeBufferView(self, engine.visits.data(), engine.visits.size(),
+                          sizeof(int), "i", &engine.numofviews);
+  }
   void resetGame() {
+    finishSearch();
+    EngineLock lock(*this);
     hexboardgame.resetGame(redplayer, blueplayer);
+    syncBoard();
   }
   void setRedPlayerStrategy(AIStrategyKind strategykind) {
     selectStrategy(strategykind, redplayer);
@@ -84,12 +273,116 @@ class HexGamePyEngine {
   void setBluePlayerStrategy(AIStrategyKind strategykind) {
     selectStrategy(strategykind, blueplayer);
   }
+  //generate the moves of many engines at once on a shared pool of threads without the GIL
+  static boost::python::list genMoves(object engines, const std::string& colors);
  private:
+  /**
+   * EngineLock locks the engine against a search in another thread, the GIL is released only when it has to wait
+   */
+  class EngineLock {
+   public:
+    explicit EngineLock(HexGamePyEngine& engine)
+        : lock(engine.mutex, boost::try_to_lock) {
+      if (!lock.owns_lock()) {
+        ScopedGILRelease release;
+        lock.lock();
+      }
+    }
+   private:
+    boost::unique_lock<boost::mutex> lock;
+  };
   HexBoard board;
   Player redplayer;  //north to south, 'O'
   Player blueplayer;  //west to east, 'X'
   Game hexboardgame;
   hexgame::unordered_map<char, hexgame::shared_ptr<AbstractStrategy> > aistrategy;
+  hexgame::shared_ptr<AsyncSearch> search;  //the running search of either player, empty if none
+  boost::mutex mutex;  //the mutex held by a search and by the calls modifying the board
+  std::vector<signed char> cells;  //the values of hexgons exposed by getBoardView
+  std::vector<int> visits;  //the visit counts of moves at root exposed by getVisitView
+  int numofviews;  //the number of views of cells and visits not yet released
+  //the search holds the mutex while it runs, hence it never overlaps the moves generated by genMove or genMoves
+  bool startSearch(char color) {
+    if (search || aistrategy.count(color) == 0)
+      return false;
+    search.reset(new AsyncSearch(*aistrategy[color], mutex));
+    return search->start();
+  }
+  void finishSearch() {
+    hexgame::shared_ptr<AsyncSearch> finished;
+    finished.swap(search);
+    if (finished) {
+      finished->stop();
+      ScopedGILRelease release;
+      finished->wait();
+    }
+  }
+  //generate the move of a player after the running search finishes, the engine is locked without the GIL
+  int genLockedMove(char color) {
+    finishSearch();
+    if (aistrategy.count(color) == 0)
+      return -1;
+    ScopedGILRelease release;
+    boost::lock_guard<boost::mutex> lock(mutex);
+    return genMove(color);
+  }
+  //set the move of a player with the engine locked
+  bool setMove(Player& player, int indexofhexgon) {
+    if (indexofhexgon < 1 || indexofhexgon > board.getSizeOfVertices())
+      return false;
+    int row = (indexofhexgon - 1) / board.getNumofhexgons() + 1;
+    int col = (indexofhexgon - 1) % board.getNumofhexgons() + 1;
+    if (!hexboardgame.setMove(player, row, col))
+      return false;
+    cells[indexofhexgon - 1] = static_cast<signed char>(player.getPlayerlabel());
+    return true;
+  }
+  //set many moves of a player
+  int setMoves(Player& player, object indices) {
+    std::vector<int> moves;
+    int numofindices = len(indices);
+    for (int i = 0; i < numofindices; ++i)
+      moves.push_back(extract<int>(indices[i]));
+    finishSearch();
+    EngineLock lock(*this);
+    int numofset = 0;
+    for (std::size_t i = 0; i < moves.size(); ++i)
+      if (setMove(player, moves[i]))
+        ++numofset;
+    return numofset;
+  }
+  //generate the move of a player with the engine locked and without the GIL
+  int genMove(char color) {
+    int move = hexboardgame.genMove(*aistrategy[color]);
+    MonteCarloTreeSearch* mcts = dynamic_cast<MonteCarloTreeSearch*>(
+        aistrategy[color].get());
+    if (mcts != nullptr)
+      recordVisits(mcts->getLastRootStatistics());
+    else
+      std::fill(visits.begin(), visits.end(), 0);
+    return move;
+  }
+  //generate the move of a player in a task of genMoves
+  static void genMoveTask(HexGamePyEngine* engine, char color, int* move) {
+    *move = engine->genMove(color);
+  }
+  //keep the visit counts of the moves at root
+  void recordVisits(
+      const std::vector<MonteCarloTreeSearch::RootStatistics>& statistics) {
+    std::fill(visits.begin(), visits.end(), 0);
+    for (std::size_t i = 0; i < statistics.size(); ++i)
+      if (statistics[i].move >= 1
+          && statistics[i].move <= static_cast<int>(visits.size()))
+        visits[statistics[i].move - 1] = statistics[i].visitcount;
+  }
+  //copy the values of hexgons after the board is reset or resized
+  void syncBoard() {
+    int numofvertices = board.getSizeOfVertices();
+    cells.resize(numofvertices);
+    visits.assign(numofvertices, 0);
+    for (int i = 0; i < numofvertices; ++i)
+      cells[i] = static_cast<signed char>(board.getNodeValue(i + 1));
+  }
   void selectStrategy(AIStrategyKind strategykind, Player& player) {
     hexgame::unique_ptr<AbstractStrategy,
         hexgame::default_delete<AbstractStrategy> > transformer(nullptr);
@@ -99,8 +392,167 @@ class HexGamePyEngine {
                       hexgame::shared_ptr<AbstractStrategy>(transformer.release())));
   }
 };
+///Generate the moves of many engines at once. The searches run on a shared pool of threads without the GIL, hence a Python
+///server advances many games per call
+///@param engines is the sequence of engines, each appearing once
+///@param colors is the color of player to move of every engine, 'R' or 'B'
+///@return the list of moves, -1 for an engine without strategy of the color
+boost::python::list HexGamePyEngine::genMoves(object engines, const std::string& colors) {
+  int numofengines = len(engines);
+  if (static_cast<std::size_t>(numofengines) != colors.size())
+    throw std::invalid_argument("one color per engine is required");
+  std::vector<HexGamePyEngine*> pointers;
+  for (int i = 0; i < numofengines; ++i) {
+    pointers.push_back(&extract<HexGamePyEngine&>(engines[i])());
+    if (colors[i] != 'R' && colors[i] != 'B')
+      throw std::invalid_argument("the color is R or B");
+  }
+  std::vector<HexGamePyEngine*> sorted(pointers);
+  std::sort(sorted.begin(), sorted.end());
+  if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+    throw std::invalid_argument("an engine appears more than once");
+  for (int i = 0; i < numofengines; ++i)
+    pointers[i]->finishSearch();
+  std::vector<int> moves(numofengines, -1);
+  {
+    ScopedGILRelease release;
+    //lock in address order, hence the concurrent batches sharing engines never deadlock
+    std::vector<hexgame::shared_ptr<boost::unique_lock<boost::mutex> > > locks;
+    for (std::size_t i = 0; i < sorted.size(); ++i)
+      locks.push_back(
+          hexgame::shared_ptr<boost::unique_lock<boost::mutex> >(
+              new boost::unique_lock<boost::mutex>(sorted[i]->mutex)));
+    WorkStealingScheduler scheduler(
+        std::min(static_cast<std::size_t>(numofengines),
+                 static_cast<std::size_t>(
+                     std::max(1u, boost::thread::hardware_concurrency()))));
+    for (int i = 0; i < numofengines; ++i)
+      if (pointers[i]->aistrategy.count(colors[i]) > 0)
+        scheduler.submit(
+            boost::bind(&HexGamePyEngine::genMoveTask, pointers[i], colors[i],
+                        &moves[i]));
+    scheduler.wait();
+  }
+  boost::python::list result;
+  for (int i = 0; i < numofengines; ++i)
+    result.append(moves[i]);
+  return result;
+}
+/**
+ * VectorPyEnvironment wraps VectorEnvironment, the moves are passed as a buffer of int32 and the boards, legal masks,
+ * players, winners and results of last step are read through memoryviews without copying. The views keep the
+ * environments alive, whose buffers are never reallocated
+ */
+class VectorPyEnvironment {
+ public:
+  VectorPyEnvironment(std::size_t numofenvs, int numofhexgon)
+      : environment(checkedNumofEnvs(numofenvs, numofhexgon), numofhexgon),
+        results(numofenvs, 0) {
+  }
+  //apply one move per environment from a contiguous int32 buffer (e.g. array('i') or numpy.int32), return the number of
+  //illegal moves
+  std::size_t step(object moves) {
+    Py_buffer view;
+    if (PyObject_GetBuffer(moves.ptr(), &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0)
+      throw_error_already_set();
+    bool isvalid = view.itemsize == sizeof(int)
+        && view.len == static_cast<Py_ssize_t>(environment.getNumofEnvs() * sizeof(int))
+        && (view.format == NULL || std::string(view.format) == "i"
+            || std::string(view.format) == "=i" || std::string(view.format) == "<i");
+    if (!isvalid) {
+      PyBuffer_Release(&view);
+      throw std::invalid_argument(
+          "moves must be a contiguous int32 buffer of one move per environment");
+    }
+    std::size_t numofillegals;
+    {
+      ScopedGILRelease release;
+      numofillegals = environment.step(static_cast<const int*>(view.buf),
+                                       results.data());
+    }
+    PyBuffer_Release(&view);
+    return numofillegals;
+  }
+  void reset() {
+    environment.reset();
+    std::fill(results.begin(), results.end(), 0);
+  }
+  void resetEnv(std::size_t env) {
+    if (env >= environment.getNumofEnvs())
+      throw std::out_of_range("index of environment is out of range");
+    environment.reset(env);
+    results[env] = 0;
+  }
+  void setAutoReset(bool isautoreset) {
+    environment.setAutoReset(isautoreset);
+  }
+  std::size_t getNumofEnvs() const {
+    return environment.getNumofEnvs();
+  }
+  int getNumofhexgons() const {
+    return environment.getNumofhexgons();
+  }
+  std::size_t getNumofWords() const {
+    return environment.getNumofWords();
+  }
+  //the boards as int8 hexgon values, numofenvs x numofhexgons^2
+  static object getBoardView(object self) {
+    VectorPyEnvironment& environments = extract<VectorPyEnvironment&>(self);
+    int numofvertices = environments.getNumofhexgons()
+        * environments.getNumofhexgons();
+    return makeBufferView(
+        self, const_cast<signed char*>(environments.environment.getBoards()),
+        environments.getNumofEnvs() * numofvertices, sizeof(signed char), "b",
+        NULL);
+  }
+  //the legal masks as uint64, numofenvs x numofwords, the bit (move - 1) is set for a legal move
+  static object getMaskView(object self) {
+    VectorPyEnvironment& environments = extract<VectorPyEnvironment&>(self);
+    return makeBufferView(
+        self,
+        const_cast<VectorEnvironment::Word*>(environments.environment.getLegalMasks()),
+        environments.getNumofEnvs() * environments.getNumofWords(),
+        sizeof(VectorEnvironment::Word), "Q", NULL);
+  }
+  //the players to move as int8 hexgon values
+  static object getPlayerView(object self) {
+    VectorPyEnvironment& environments = extract<VectorPyEnvironment&>(self);
+    return makeBufferView(
+        self, const_cast<signed char*>(environments.environment.getPlayers()),
+        environments.getNumofEnvs(), sizeof(signed char), "b", NULL);
+  }
+  //the winners as int8 hexgon values, 0 when the game is not over
+  static object getWinnerView(object self) {
+    VectorPyEnvironment& environments = extract<VectorPyEnvironment&>(self);
+    return makeBufferView(
+        self, const_cast<signed char*>(environments.environment.getWinners()),
+        environments.getNumofEnvs(), sizeof(signed char), "b", NULL);
+  }
+  //the results of last step as int8: 0 when the game goes on, the winner when the move ends the game, -1 when illegal
+  static object getResultView(object self) {
+    VectorPyEnvironment& environments = extract<VectorPyEnvironment&>(self);
+    return makeBufferView(self, environments.results.data(),
+                          environments.results.size(), sizeof(signed char),
+                          "b", NULL);
+  }
+ private:
+  VectorEnvironment environment;
+  std::vector<signed char> results;
+  //reject the arguments which leave the buffers empty before the environments are built
+  static std::size_t checkedNumofEnvs(std::size_t numofenvs, int numofhexgon) {
+    if (numofenvs == 0)
+      throw std::invalid_argument("at least one environment is required");
+    if (numofhexgon < 1)
+      throw std::invalid_argument("at least one hexgon per side is required");
+    return numofenvs;
+  }
+};
 BOOST_PYTHON_MODULE(libhexgame)
 {
+  BufferExporterType = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(
+      &BufferExporterSpec));
+  if (BufferExporterType == NULL)
+    throw_error_already_set();
   enum_<hexgonValKind>("hexgonValKind").value("EMPTY", hexgonValKind_EMPTY)
   .value("RED", hexgonValKind_RED)
   .value("BLUE", hexgonValKind_BLUE);
@@ -108,17 +560,43 @@ BOOST_PYTHON_MODULE(libhexgame)
   .value("NAIVE", AIStrategyKind_NAIVE)
   .value("MCST", AIStrategyKind_MCTS)
   .value("PMCST", AIStrategyKind_PMCTS);
-  class_<HexGamePyEngine>("HexGamePyEngine", init<unsigned>())
+  class_<HexGamePyEngine, boost::noncopyable>("HexGamePyEngine", init<unsigned>())
   .def("showView", &HexGamePyEngine::showView)
   .def("setRedPlayerMove", &HexGamePyEngine::setRedPlayerMove)
   .def("setBluePlayerMove", &HexGamePyEngine::setBluePlayerMove)
+  .def("setRedPlayerMoves", &HexGamePyEngine::setRedPlayerMoves)
+  .def("setBluePlayerMoves", &HexGamePyEngine::setBluePlayerMoves)
   .def("genRedPlayerMove", &HexGamePyEngine::genRedPlayerMove)
   .def("genBluePlayerMove", &HexGamePyEngine::genBluePlayerMove)
+  .def("startRedPlayerSearch", &HexGamePyEngine::startRedPlayerSearch)
+  .def("startBluePlayerSearch", &HexGamePyEngine::startBluePlayerSearch)
+  .def("pollSearch", &HexGamePyEngine::pollSearch)
+  .def("stopSearch", &HexGamePyEngine::stopSearch)
+  .def("waitSearch", &HexGamePyEngine::waitSearch)
   .def("getWinner", &HexGamePyEngine::getWinner)
   .def("getNodeValue", &HexGamePyEngine::getNodeValue)
+  .def("getNodeValues", &HexGamePyEngine::getNodeValues)
+  .def("getBoardView", &HexGamePyEngine::getBoardView)
+  .def("getVisitView", &HexGamePyEngine::getVisitView)
   .def("resetGame", &HexGamePyEngine::resetGame)
   .def("setRedPlayerStrategy", &HexGamePyEngine::setRedPlayerStrategy)
   .def("setBluePlayerStrategy", &HexGamePyEngine::setBluePlayerStrategy)
+  .def("genMoves", &HexGamePyEngine::genMoves)
+  .staticmethod("genMoves")
   .add_property("numofhexgons", &HexGamePyEngine::getNumofhexgons,
       &HexGamePyEngine::setNumofhexgons);
+  class_<VectorPyEnvironment, boost::noncopyable>("VectorEnvironment",
+      init<std::size_t, int>())
+  .def("step", &VectorPyEnvironment::step)
+  .def("reset", &VectorPyEnvironment::reset)
+  .def("resetEnv", &VectorPyEnvironment::resetEnv)
+  .def("setAutoReset", &VectorPyEnvironment::setAutoReset)
+  .def("getBoardView", &VectorPyEnvironment::getBoardView)
+  .def("getMaskView", &VectorPyEnvironment::getMaskView)
+  .def("getPlayerView", &VectorPyEnvironment::getPlayerView)
+  .def("getWinnerView", &VectorPyEnvironment::getWinnerView)
+  .def("getResultView", &VectorPyEnvironment::getResultView)
+  .add_property("numofenvs", &VectorPyEnvironment::getNumofEnvs)
+  .add_property("numofhexgons", &VectorPyEnvironment::getNumofhexgons)
+  .add_property("numofwords", &VectorPyEnvironment::getNumofWords);
 }
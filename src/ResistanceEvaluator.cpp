@@ -0,0 +1,239 @@
+/*
+ * ResistanceEvaluator.cpp
+ * This file defines the implementation of ResistanceEvaluator class
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "ResistanceEvaluator.h"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+const double ResistanceEvaluator::OWNRESISTANCE = 0.01;
+const double ResistanceEvaluator::INFINITE_RESISTANCE = 1e9;
+
+///User defined constructor which takes the tables of board
+///@param topology is the rings of hexgons which should outlive the evaluator
+ResistanceEvaluator::ResistanceEvaluator(const BoardTopology& topology)
+    : topology(topology),
+      numofvertices(topology.getNumofhexgons() * topology.getNumofhexgons()),
+      tolerance(1e-8),
+      numofiterations(0) {
+  resistances[0] = resistances[1] = INFINITE_RESISTANCE;
+}
+///Evaluate the game state given by the moves of both players, i.e. solve the resistor networks of both players
+///@param babywatsons is the moves made by AI player
+///@param opponents is the moves made by the opponent
+///@param isbabywatsonwesttoeast is the winning condition of AI player
+///@return the score of AI player which is the logarithm of the resistance of the opponent over the one of AI player
+double ResistanceEvaluator::evaluate(const vector<int>& babywatsons,
+                                     const vector<int>& opponents,
+                                     bool isbabywatsonwesttoeast) {
+  colors.assign(numofvertices, 0);
+  for (size_t i = 0; i < babywatsons.size(); ++i)
+    if (babywatsons[i] > 0)
+      colors[babywatsons[i] - 1] = 1;
+  for (size_t i = 0; i < opponents.size(); ++i)
+    if (opponents[i] > 0)
+      colors[opponents[i] - 1] = -1;
+  numofiterations = 0;
+  solve(0, !isbabywatsonwesttoeast);
+  solve(1, isbabywatsonwesttoeast);
+  return log(resistances[0] / resistances[1]);
+}
+///Evaluate the game state advanced by the game tree
+///@param state is the game state
+///@param isbabywatsonwesttoeast is the winning condition of AI player
+///@return the score of AI player which is the logarithm of the resistance of the opponent over the one of AI player
+double ResistanceEvaluator::evaluate(DescentState& state,
+                                     bool isbabywatsonwesttoeast) {
+  return evaluate(state.getBabywatsons(), state.getOpponents(),
+                  isbabywatsonwesttoeast);
+}
+///Get the move priors of the empty hexgons in the game state evaluated, i.e. the sum of fractions of the total current of
+///both players through the hexgon scaled to the range of TwoDistanceEvaluator::getPriors
+///@param priors is the container of priors indexed by position - 1, 0 for the occupied hexgons
+///@return NONE
+void ResistanceEvaluator::getPriors(vector<int>& priors) const {
+  int numofhexgons = topology.getNumofhexgons();
+  priors.assign(numofvertices, 0);
+  for (int i = 0; i < numofvertices; ++i) {
+    if (colors[i] != 0)
+      continue;
+    double fraction = 0.0;
+    for (int side = 0; side < 2; ++side)
+      if (resistances[side] < INFINITE_RESISTANCE)
+        fraction += currents[side][i] * resistances[side];
+    priors[i] = static_cast<int>(fraction * numofhexgons + 0.5);
+  }
+}
+///Drop the solutions kept as the initial guess, so the next evaluation starts from scratch
+///@param NONE
+///@return NONE
+void ResistanceEvaluator::reset() {
+  voltages[0].clear();
+  voltages[1].clear();
+}
+///Get the resistance of a hexgon for the player
+///@param cell is the position of hexgon starting from 1
+///@param owner is the player, 1 for AI player and -1 for the opponent
+///@return the resistance, 1 for empty hexgon and OWNRESISTANCE for the stone of the player
+double ResistanceEvaluator::getCellResistance(int cell,
+                                              signed char owner) const {
+  return (colors[cell - 1] == owner) ? OWNRESISTANCE : 1.0;
+}
+///Multiply the system by a vector over the hexgons reachable from the first edge
+///@param operand is the vector indexed by position - 1
+///@param result is the product indexed by position - 1
+///@return NONE
+void ResistanceEvaluator::multiply(const vector<double>& operand,
+                                   vector<double>& result) const {
+  for (int cell = 1; cell <= numofvertices; ++cell) {
+    if (!isactive[cell - 1]) {
+      result[cell - 1] = 0.0;
+      continue;
+    }
+    const int* ring = topology.getRing(cell);
+    const double* conductance = &conductances[(cell - 1)
+        * BoardTopology::SIZEOFRING];
+    double product = diagonals[cell - 1] * operand[cell - 1];
+    for (int k = 0; k < BoardTopology::SIZEOFRING; ++k)
+      if (conductance[k] > 0.0)
+        product -= conductance[k] * operand[ring[k] - 1];
+    result[cell - 1] = product;
+  }
+}
+///Solve the resistor network of a player by conjugate gradient starting from the last solution, then compute the
+///resistance and the currents through hexgons
+///@param side is 1 for AI player and 0 for the opponent
+///@param iswesttoeast is the winning condition of the player
+///@return NONE
+void ResistanceEvaluator::solve(int side, bool iswesttoeast) {
+  const int SIZEOFRING = BoardTopology::SIZEOFRING;
+  signed char owner = side ? 1 : -1;
+  int first = iswesttoeast ? BoardTopology::WEST : BoardTopology::NORTH;
+  int second = iswesttoeast ? BoardTopology::EAST : BoardTopology::SOUTH;
+  currents[side].assign(numofvertices, 0.0);
+
+  //the unknowns are the hexgons reachable from the first edge
+  isactive.assign(numofvertices, false);
+  vector<int> stack;
+  for (int cell = 1; cell <= numofvertices; ++cell)
+    if (colors[cell - 1] != -owner && topology.isOnEdge(cell, first)) {
+      isactive[cell - 1] = true;
+      stack.push_back(cell);
+    }
+  bool isreached = false;
+  while (!stack.empty()) {
+    int cell = stack.back();
+    stack.pop_back();
+    isreached = isreached || topology.isOnEdge(cell, second);
+    const int* ring = topology.getRing(cell);
+    for (int k = 0; k < SIZEOFRING; ++k)
+      if (ring[k] > 0 && !isactive[ring[k] - 1]
+          && colors[ring[k] - 1] != -owner) {
+        isactive[ring[k] - 1] = true;
+        stack.push_back(ring[k]);
+      }
+  }
+  if (!isreached) {
+    resistances[side] = INFINITE_RESISTANCE;
+    return;
+  }
+
+  //assemble the system, the voltage of the first edge is 1 and the one of the second edge is 0
+  conductances.assign(numofvertices * SIZEOFRING, 0.0);
+  sources.assign(numofvertices, 0.0);
+  sinks.assign(numofvertices, 0.0);
+  diagonals.assign(numofvertices, 1.0);
+  vector<double>& solution = voltages[side];
+  if (static_cast<int>(solution.size()) != numofvertices)
+    solution.assign(numofvertices, 0.5);
+  residuals.assign(numofvertices, 0.0);
+  for (int cell = 1; cell <= numofvertices; ++cell) {
+    if (!isactive[cell - 1]) {
+      solution[cell - 1] = 0.0;
+      continue;
+    }
+    double resistance = getCellResistance(cell, owner);
+    const int* ring = topology.getRing(cell);
+    double diagonal = 0.0;
+    for (int k = 0; k < SIZEOFRING; ++k)
+      if (ring[k] > 0 && isactive[ring[k] - 1]) {
+        double conductance = 1.0
+            / (resistance + getCellResistance(ring[k], owner));
+        conductances[(cell - 1) * SIZEOFRING + k] = conductance;
+        diagonal += conductance;
+      }
+    if (topology.isOnEdge(cell, first))
+      sources[cell - 1] = 1.0 / resistance;
+    if (topology.isOnEdge(cell, second))
+      sinks[cell - 1] = 1.0 / resistance;
+    diagonals[cell - 1] = diagonal + sources[cell - 1] + sinks[cell - 1];
+    residuals[cell - 1] = sources[cell - 1];
+  }
+
+  //preconditioned conjugate gradient
+  double bound = 0.0;
+  for (int i = 0; i < numofvertices; ++i)
+    bound += residuals[i] * residuals[i];
+  bound *= tolerance * tolerance;
+  products.assign(numofvertices, 0.0);
+  multiply(solution, products);
+  preconditioned.assign(numofvertices, 0.0);
+  directions.assign(numofvertices, 0.0);
+  double norm = 0.0, rho = 0.0;
+  for (int i = 0; i < numofvertices; ++i) {
+    residuals[i] -= products[i];
+    preconditioned[i] = residuals[i] / diagonals[i];
+    directions[i] = preconditioned[i];
+    norm += residuals[i] * residuals[i];
+    rho += residuals[i] * preconditioned[i];
+  }
+  for (int iteration = 0; iteration < 2 * numofvertices && norm > bound;
+      ++iteration) {
+    multiply(directions, products);
+    double curvature = 0.0;
+    for (int i = 0; i < numofvertices; ++i)
+      curvature += directions[i] * products[i];
+    if (curvature <= 0.0)
+      break;
+    double alpha = rho / curvature, nextrho = 0.0;
+    norm = 0.0;
+    for (int i = 0; i < numofvertices; ++i) {
+      solution[i] += alpha * directions[i];
+      residuals[i] -= alpha * products[i];
+      preconditioned[i] = residuals[i] / diagonals[i];
+      norm += residuals[i] * residuals[i];
+      nextrho += residuals[i] * preconditioned[i];
+    }
+    for (int i = 0; i < numofvertices; ++i)
+      directions[i] = preconditioned[i] + (nextrho / rho) * directions[i];
+    rho = nextrho;
+    ++numofiterations;
+  }
+
+  //the total current leaves the first edge and each current through a hexgon is half of the flows at it
+  double total = 0.0;
+  for (int cell = 1; cell <= numofvertices; ++cell) {
+    if (!isactive[cell - 1])
+      continue;
+    double voltage = solution[cell - 1];
+    total += sources[cell - 1] * (1.0 - voltage);
+    double flow = sources[cell - 1] * fabs(1.0 - voltage)
+        + sinks[cell - 1] * fabs(voltage);
+    const int* ring = topology.getRing(cell);
+    for (int k = 0; k < SIZEOFRING; ++k) {
+      double conductance = conductances[(cell - 1) * SIZEOFRING + k];
+      if (conductance > 0.0)
+        flow += conductance * fabs(voltage - solution[ring[k] - 1]);
+    }
+    currents[side][cell - 1] = flow / 2.0;
+  }
+  resistances[side] = (total > 0.0) ? min(1.0 / total, INFINITE_RESISTANCE) :
+                                      INFINITE_RESISTANCE;
+}
@@ -0,0 +1,107 @@
+/*
+ * ResistanceEvaluator.h
+ * This file declares the static evaluation of game state by the electric resistance between the edges of both players.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef RESISTANCEEVALUATOR_H_
+#define RESISTANCEEVALUATOR_H_
+
+#include <vector>
+
+#include "Global.h"
+#include "DescentState.h"
+#include "BoardTopology.h"
+
+/**
+ * ResistanceEvaluator class is used to evaluate a game state by the resistance model of Hex.<br/>
+ * For each player the board is a resistor network: an empty hexgon has resistance 1, a stone of the player a small
+ * resistance and a stone of the other player is removed; adjacent hexgons are joined by the sum of their resistances and
+ * the hexgons next to an edge are joined to the edge by their own resistance. With the voltage 1 at one edge and 0 at the
+ * other, the Kirchhoff equations of the voltages of hexgons form a sparse symmetric positive definite system of at most six
+ * neighbors per row (the rings of BoardTopology), which is solved by conjugate gradient with Jacobi preconditioner. Only
+ * the hexgons reachable from the first edge are unknowns, so the system is never singular. The solution of the last
+ * evaluation is the initial guess of the next one, hence the cost of evaluating the position after one more move is a few
+ * iterations. The lower resistance is the better one, and the current through a hexgon measures how much it matters to
+ * both players.<br/>
+ * ResistanceEvaluator(const BoardTopology& topology): user defined constructor which takes the tables of board. The
+ * topology should outlive the evaluator<br/>
+ * Sample Usage:<br/>
+ * ResistanceEvaluator evaluator(topology);<br/>
+ * double score = evaluator.evaluate(bwglobal, oppglobal, player.getWestToEastCondition());<br/>
+ * evaluator.getPriors(priors);<br/>
+ */
+class ResistanceEvaluator {
+ private:
+  const BoardTopology& topology;  ///< the rings of hexgons, not owned
+  int numofvertices;  ///< the number of hexgons on board
+  double tolerance;  ///< the relative residual where conjugate gradient stops
+  int numofiterations;  ///< the number of iterations of conjugate gradient in the last evaluation
+  std::vector<signed char> colors;  ///< the owner of each hexgon, 1 for AI player, -1 for the opponent and 0 for empty
+  double resistances[2];  ///< the resistances of the opponent (0) and AI player (1)
+  std::vector<double> voltages[2];  ///< the voltages of hexgons of the opponent (0) and AI player (1) indexed by position - 1, kept as the initial guess of the next evaluation
+  std::vector<double> currents[2];  ///< the currents through hexgons of the opponent (0) and AI player (1) indexed by position - 1
+  std::vector<char> isactive;  ///< the indicators of hexgons reachable from the first edge
+  std::vector<double> conductances;  ///< the conductances between each hexgon and its ring indexed by (position - 1) * 6 + k
+  std::vector<double> sources;  ///< the conductances between each hexgon and the first edge
+  std::vector<double> sinks;  ///< the conductances between each hexgon and the second edge
+  std::vector<double> diagonals;  ///< the diagonal of system
+  std::vector<double> residuals;  ///< the residual of conjugate gradient
+  std::vector<double> preconditioned;  ///< the residual scaled by Jacobi preconditioner
+  std::vector<double> directions;  ///< the search direction of conjugate gradient
+  std::vector<double> products;  ///< the product of system and search direction
+
+  //Get the resistance of a hexgon for the player
+  double getCellResistance(int cell, signed char owner) const;
+  //Multiply the system by a vector
+  void multiply(const std::vector<double>& operand,
+                std::vector<double>& result) const;
+  //Solve the resistor network of a player
+  void solve(int side, bool iswesttoeast);
+
+ public:
+  static const double OWNRESISTANCE;  ///< the resistance of a stone of the player
+  static const double INFINITE_RESISTANCE;  ///< the resistance of a player who cannot connect the edges
+
+  //User defined constructor which takes the tables of board
+  explicit ResistanceEvaluator(const BoardTopology& topology);
+  //Evaluate the game state given by the moves of both players
+  double evaluate(const std::vector<int>& babywatsons,
+                  const std::vector<int>& opponents,
+                  bool isbabywatsonwesttoeast);
+  //Evaluate the game state advanced by the game tree
+  double evaluate(DescentState& state, bool isbabywatsonwesttoeast);
+  //Get the move priors of the empty hexgons in the game state evaluated
+  void getPriors(std::vector<int>& priors) const;
+  //Drop the solutions kept as the initial guess
+  void reset();
+  ///Get the resistance between the edges of a player in the game state evaluated
+  ///@param isbabywatson is TRUE for AI player
+  ///@return the resistance, INFINITE_RESISTANCE if the player cannot connect
+  double getResistance(bool isbabywatson) const {
+    return resistances[isbabywatson];
+  }
+  ///Get the current through a hexgon of a player in the game state evaluated, where the total current is 1 / resistance
+  ///@param move is the position of hexgon starting from 1
+  ///@param isbabywatson is TRUE for AI player
+  ///@return the current through the hexgon
+  double getCurrent(int move, bool isbabywatson) const {
+    return currents[isbabywatson][move - 1];
+  }
+  ///Get the number of iterations of conjugate gradient in the last evaluation
+  ///@param NONE
+  ///@return the number of iterations for both players
+  int getNumofIterations() const {
+    return numofiterations;
+  }
+  ///Set the relative residual where conjugate gradient stops
+  ///@param tolerance is the relative residual, 1e-8 by default
+  ///@return NONE
+  void setTolerance(double tolerance) {
+    this->tolerance = tolerance;
+  }
+};
+
+#endif /* RESISTANCEEVALUATOR_H_ */
@@ -0,0 +1,62 @@
+/*
+ * SearchMonitor.cpp
+ * This file defines the monitor shared by a running simulation and its observers, which publishes the progress of
+ * simulation and carries the request to stop it.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "Global.h"
+#include "SearchMonitor.h"
+
+#include <boost/thread/locks.hpp>
+
+using namespace std;
+
+///Default constructor which publishes a snapshot every 256 simulated games
+SearchMonitor::SearchMonitor()
+    : isstoprequested(false),
+      interval(256) {
+}
+///Clear the snapshot and the request to stop before a new simulation
+///@param NONE
+///@return NONE
+void SearchMonitor::reset() {
+  boost::lock_guard<boost::mutex> lock(mutex);
+  snapshot = Snapshot();
+  staging = Snapshot();
+  isstoprequested.store(false);
+}
+///Publish the snapshot filled by the simulation. The contents are swapped, hence the buffers of the previous snapshot are
+///reused by the next one
+///@param isblocking is TRUE to wait for the observers copying the previous snapshot, FALSE to skip publishing instead
+///@return TRUE if the snapshot is published
+bool SearchMonitor::publish(bool isblocking) {
+  boost::unique_lock<boost::mutex> guard(mutex, boost::defer_lock);
+  if (isblocking)
+    guard.lock();
+  else if (!guard.try_lock())
+    return false;
+  swap(snapshot.bestmove, staging.bestmove);
+  swap(snapshot.winningrate, staging.winningrate);
+  swap(snapshot.numoftrials, staging.numoftrials);
+  snapshot.statistics.swap(staging.statistics);
+  snapshot.isdone = false;
+  return true;
+}
+///Mark the simulation as returned with the move generated, which may come from opening book instead of simulation
+///@param move is the move generated
+///@return NONE
+void SearchMonitor::finish(int move) {
+  boost::lock_guard<boost::mutex> lock(mutex);
+  snapshot.bestmove = move;
+  snapshot.isdone = true;
+}
+///Copy the latest snapshot
+///@param latest stores the latest snapshot
+///@return NONE
+void SearchMonitor::getSnapshot(Snapshot& latest) const {
+  boost::lock_guard<boost::mutex> lock(mutex);
+  latest = snapshot;
+}
@@ -0,0 +1,114 @@
+/*
+ * SearchMonitor.h
+ * This file declares the monitor shared by a running simulation and its observers, which publishes the progress of
+ * simulation and carries the request to stop it.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef SEARCHMONITOR_H_
+#define SEARCHMONITOR_H_
+
+#include <vector>
+
+#include "Global.h"
+#include "MonteCarloTreeSearch.h"
+
+#include <boost/thread/mutex.hpp>
+
+/**
+ * SearchMonitor class is shared by a simulation (see AbstractStrategy::setSearchMonitor) and the threads observing it.<br/>
+ * The simulation publishes a snapshot of the moves at root every given number of simulated games and checks the request to
+ * stop after every simulated game, hence a stop takes effect within one simulated game and the best move found so far is
+ * returned. The simulation never waits for the observers: a snapshot is skipped when an observer is copying the previous
+ * one and the next snapshot is published at the next interval.<br/>
+ * SearchMonitor(): default constructor which publishes a snapshot every 256 simulated games<br/>
+ * Sample Usage:<br/>
+ * SearchMonitor monitor;<br/>
+ * strategy.setSearchMonitor(&monitor); //genMove runs in another thread<br/>
+ * SearchMonitor::Snapshot snapshot;<br/>
+ * monitor.getSnapshot(snapshot); //snapshot.bestmove, snapshot.winningrate and snapshot.statistics<br/>
+ * monitor.requestStop();<br/>
+ */
+class SearchMonitor {
+ public:
+  /**
+   * Snapshot is the progress of simulation
+   */
+  struct Snapshot {
+    int bestmove;  ///< the best move so far, -1 before the first snapshot
+    double winningrate;  ///< the estimated winning rate of the best move
+    std::size_t numoftrials;  ///< the number of simulated games so far
+    std::vector<MonteCarloTreeSearch::RootStatistics> statistics;  ///< the visit and win counts of the moves at root
+    bool isdone;  ///< TRUE when the simulation returns and bestmove is the move generated
+    ///Default constructor of the snapshot before simulation
+    Snapshot()
+        : bestmove(-1),
+          winningrate(0.0),
+          numoftrials(0),
+          isdone(false) {
+    }
+    ;
+  };
+
+ private:
+  hexgame::atomic<bool> isstoprequested;  ///< TRUE when the simulation is requested to stop
+  std::size_t interval;  ///< the number of simulated games between snapshots
+  mutable boost::mutex mutex;  ///< the mutex of snapshot
+  Snapshot snapshot;  ///< the latest snapshot
+  Snapshot staging;  ///< the snapshot being filled, only touched by the simulation
+
+  ///Copy constructor which is not allowed
+  SearchMonitor(const SearchMonitor&);
+  ///Assignment operator which is not allowed
+  SearchMonitor& operator=(const SearchMonitor&);
+
+ public:
+  //Default constructor which publishes a snapshot every 256 simulated games
+  SearchMonitor();
+  ///destructor
+  virtual ~SearchMonitor() {
+  }
+  ;
+  //Clear the snapshot and the request to stop before a new simulation
+  void reset();
+  ///Request the simulation to stop, it returns the best move found so far after the running simulated game
+  ///@param NONE
+  ///@return NONE
+  void requestStop() {
+    isstoprequested.store(true);
+  }
+  ///Check if the simulation is requested to stop, called by the simulation after every simulated game
+  ///@param NONE
+  ///@return TRUE if the simulation should stop
+  bool isStopRequested() const {
+    return isstoprequested.load(hexgame::memory_order_relaxed);
+  }
+  ///Setter for the number of simulated games between snapshots
+  ///@param numoftrials is the number of simulated games, at least one
+  ///@return NONE
+  void setInterval(std::size_t numoftrials) {
+    interval = (numoftrials > 0) ? numoftrials : 1;
+  }
+  ///Getter for the number of simulated games between snapshots
+  ///@param NONE
+  ///@return the number of simulated games
+  std::size_t getInterval() const {
+    return interval;
+  }
+  ///Getter for the snapshot being filled by the simulation, whose buffers are reused across snapshots
+  ///@param NONE
+  ///@return the snapshot to be filled before publish, only touched by the simulation
+  Snapshot& getStaging() {
+    return staging;
+  }
+  //Publish the snapshot filled by the simulation
+  bool publish(bool isblocking);
+  //Mark the simulation as returned with the move generated
+  void finish(int move);
+  //Copy the latest snapshot, called by the observers
+  void getSnapshot(Snapshot& latest) const;
+};
+
+#endif /* SEARCHMONITOR_H_ */
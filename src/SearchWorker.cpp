@@ -0,0 +1,261 @@
+/*
+ * SearchWorker.cpp
+ * This file defines the engine process which searches the game states sent by the coordinator of a search cluster and
+ * the messages exchanged between them.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "Global.h"
+#include "Player.h"
+#include "SearchWorker.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <iostream>
+#include <boost/version.hpp>
+#include <boost/asio/ip/address.hpp>
+
+using namespace std;
+using namespace boost::asio;
+
+///User defined constructor which binds and listens on the given endpoint
+///@param endpoint is "unix:<path>" for Unix domain socket or "<host>:<port>" for TCP where host is an IP address
+SearchWorker::SearchWorker(const std::string& endpoint)
+    : ptrtotable(nullptr) {
+  string path, host, port;
+  if (!parseEndpoint(endpoint, path, host, port))
+    return;
+  boost::system::error_code error;
+  if (!path.empty()) {
+    std::remove(path.c_str());
+    hexgame::shared_ptr<local::stream_protocol::acceptor> acceptor(
+        new local::stream_protocol::acceptor(service));
+    acceptor->open(local::stream_protocol(), error);
+    if (!error)
+      acceptor->bind(local::stream_protocol::endpoint(path), error);
+    if (!error)
+      acceptor->listen(socket_base::max_connections, error);
+    if (!error) {
+      localacceptor = acceptor;
+      localpath = path;
+    }
+  } else {
+    ip::address address = ip::address::from_string(host, error);
+    if (error)
+      return;
+    ip::tcp::endpoint tcpendpoint(
+        address, static_cast<unsigned short>(atoi(port.c_str())));
+    hexgame::shared_ptr<ip::tcp::acceptor> acceptor(
+        new ip::tcp::acceptor(service));
+    acceptor->open(tcpendpoint.protocol(), error);
+    if (!error)
+      acceptor->set_option(ip::tcp::acceptor::reuse_address(true), error);
+    if (!error)
+      acceptor->bind(tcpendpoint, error);
+    if (!error)
+      acceptor->listen(socket_base::max_connections, error);
+    if (!error)
+      tcpacceptor = acceptor;
+  }
+}
+///destructor which closes the endpoint
+SearchWorker::~SearchWorker() {
+  boost::system::error_code error;
+  if (tcpacceptor)
+    tcpacceptor->close(error);
+  if (localacceptor) {
+    localacceptor->close(error);
+    std::remove(localpath.c_str());
+  }
+}
+///Accept the connections of coordinators one by one and answer their requests until each connection is closed
+///@param numofconnections is the number of connections to serve, 0 to serve until the process is terminated
+///@return the number of requests answered
+std::size_t SearchWorker::serve(std::size_t numofconnections) {
+  size_t numofanswers = 0;
+  for (size_t i = 0; isListening() && (numofconnections == 0 || i < numofconnections);
+      ++i) {
+    boost::system::error_code error;
+    if (tcpacceptor) {
+      ip::tcp::iostream stream;
+#if BOOST_VERSION >= 106600
+      tcpacceptor->accept(stream.socket(), error);
+#else
+      tcpacceptor->accept(*stream.rdbuf(), error);
+#endif
+      if (!error)
+        numofanswers += answer(stream);
+    } else {
+      local::stream_protocol::iostream stream;
+#if BOOST_VERSION >= 106600
+      localacceptor->accept(stream.socket(), error);
+#else
+      localacceptor->accept(*stream.rdbuf(), error);
+#endif
+      if (!error)
+        numofanswers += answer(stream);
+    }
+    if (error)
+      break;
+  }
+  return numofanswers;
+}
+///Answer the requests of one connection until the coordinator closes it or sends "quit"
+///@param stream is the connection
+///@return the number of requests answered
+std::size_t SearchWorker::answer(std::iostream& stream) {
+  size_t numofanswers = 0;
+  string line;
+  while (getline(stream, line) && line != "quit") {
+    istringstream in(line);
+    SearchRequest request;
+    vector<MonteCarloTreeSearch::RootStatistics> statistics;
+    if (!readRequest(in, request))
+      stream << "error malformed request" << endl;
+    else if (!search(request, statistics))
+      stream << "error illegal game state" << endl;
+    else {
+      writeStatistics(stream, statistics);
+      ++numofanswers;
+    }
+  }
+  return numofanswers;
+}
+///Search one game state by Monte Carlo Tree Search of the worker
+///@param request is the game state
+///@param statistics stores the statistics of moves at root
+///@return TRUE if the game state is legal and has empty hexgons
+bool SearchWorker::search(
+    const SearchRequest& request,
+    std::vector<MonteCarloTreeSearch::RootStatistics>& statistics) {
+  HexBoard board(request.numofhexgon);
+  Player player(board, request.tomove);
+  const vector<int>* moves[] = { &request.redmoves, &request.bluemoves };
+  hexgonValKind colors[] = { hexgonValKind_RED, hexgonValKind_BLUE };
+  for (int c = 0; c < 2; ++c)
+    for (size_t i = 0; i < moves[c]->size(); ++i) {
+      int move = (*moves[c])[i];
+      if (!board.getEmptyHexIndicators().get()[move - 1])
+        return false;
+      board.setNodeValue(move, colors[c]);
+    }
+  if (board.getNumofemptyhexgons() == 0)
+    return false;
+  MonteCarloTreeSearch mcts(&board, &player, request.numberoftrials);
+  mcts.setTranspositionTable(ptrtotable);
+  mcts.genMove();
+  statistics = mcts.getLastRootStatistics();
+  return true;
+}
+///Split an endpoint into Unix domain socket path or TCP host and port
+///@param endpoint is "unix:<path>" for Unix domain socket or "<host>:<port>" for TCP
+///@param path stores the path of Unix domain socket, empty for TCP
+///@param host stores the host of TCP, empty for Unix domain socket
+///@param port stores the port of TCP, empty for Unix domain socket
+///@return TRUE if the endpoint is well-formed
+bool SearchWorker::parseEndpoint(const std::string& endpoint, std::string& path,
+                                 std::string& host, std::string& port) {
+  path.clear();
+  host.clear();
+  port.clear();
+  if (endpoint.compare(0, 5, "unix:") == 0) {
+    path = endpoint.substr(5);
+    return !path.empty();
+  }
+  size_t colon = endpoint.rfind(':');
+  if (colon == string::npos || colon == 0 || colon + 1 == endpoint.size())
+    return false;
+  host = endpoint.substr(0, colon);
+  port = endpoint.substr(colon + 1);
+  return port.find_first_not_of("0123456789") == string::npos;
+}
+///Write a request as one line
+///@param out is the output stream
+///@param request is the game state
+///@return NONE
+void SearchWorker::writeRequest(std::ostream& out,
+                                const SearchRequest& request) {
+  out << "search " << request.numofhexgon << ' '
+      << (request.tomove == hexgonValKind_RED ? 'R' : 'B') << ' '
+      << request.numberoftrials << ' ' << request.redmoves.size();
+  for (size_t i = 0; i < request.redmoves.size(); ++i)
+    out << ' ' << request.redmoves[i];
+  out << ' ' << request.bluemoves.size();
+  for (size_t i = 0; i < request.bluemoves.size(); ++i)
+    out << ' ' << request.bluemoves[i];
+  out << endl;
+}
+///Read the moves of one color of request
+///@param in is the input stream
+///@param numofvertices is the number of hexgons on board
+///@param moves stores the moves
+///@return TRUE if the moves are in range
+static bool readMoves(std::istream& in, int numofvertices,
+                      std::vector<int>& moves) {
+  int numofmoves;
+  if (!(in >> numofmoves) || numofmoves < 0 || numofmoves > numofvertices)
+    return false;
+  moves.resize(numofmoves);
+  for (int i = 0; i < numofmoves; ++i)
+    if (!(in >> moves[i]) || moves[i] < 1 || moves[i] > numofvertices)
+      return false;
+  return true;
+}
+///Read a request written by writeRequest
+///@param in is the input stream
+///@param request stores the game state
+///@return TRUE if a well-formed request is read
+bool SearchWorker::readRequest(std::istream& in, SearchRequest& request) {
+  string keyword;
+  char color;
+  if (!(in >> keyword >> request.numofhexgon >> color >> request.numberoftrials)
+      || keyword != "search" || request.numofhexgon < 2
+      || request.numofhexgon > MAXNUMOFHEXGON
+      || (color != 'R' && color != 'B') || request.numberoftrials == 0
+      || request.numberoftrials > MAXNUMOFTRIALS)
+    return false;
+  request.tomove = (color == 'R') ? hexgonValKind_RED : hexgonValKind_BLUE;
+  int numofvertices = request.numofhexgon * request.numofhexgon;
+  return readMoves(in, numofvertices, request.redmoves)
+      && readMoves(in, numofvertices, request.bluemoves);
+}
+///Write the statistics of moves at root as one line
+///@param out is the output stream
+///@param statistics is the statistics of moves at root
+///@return NONE
+void SearchWorker::writeStatistics(
+    std::ostream& out,
+    const std::vector<MonteCarloTreeSearch::RootStatistics>& statistics) {
+  out << "statistics " << statistics.size();
+  for (size_t i = 0; i < statistics.size(); ++i)
+    out << ' ' << statistics[i].move << ' ' << statistics[i].visitcount << ' '
+        << statistics[i].wincount;
+  out << endl;
+}
+///Read the statistics written by writeStatistics
+///@param in is the input stream
+///@param statistics stores the statistics of moves at root
+///@return TRUE if well-formed statistics are read, FALSE for an error response or a closed connection
+bool SearchWorker::readStatistics(
+    std::istream& in,
+    std::vector<MonteCarloTreeSearch::RootStatistics>& statistics) {
+  string line, keyword;
+  if (!getline(in, line))
+    return false;
+  istringstream tokens(line);
+  size_t numofmoves;
+  if (!(tokens >> keyword >> numofmoves) || keyword != "statistics"
+      || numofmoves > static_cast<size_t>(MAXNUMOFHEXGON * MAXNUMOFHEXGON))
+    return false;
+  statistics.resize(numofmoves);
+  for (size_t i = 0; i < numofmoves; ++i)
+    if (!(tokens >> statistics[i].move >> statistics[i].visitcount
+        >> statistics[i].wincount) || statistics[i].visitcount < 0
+        || statistics[i].wincount < 0
+        || statistics[i].wincount > statistics[i].visitcount)
+      return false;
+  return true;
+}
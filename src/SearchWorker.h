@@ -0,0 +1,113 @@
+/*
+ * SearchWorker.h
+ * This file declares the engine process which searches the game states sent by the coordinator of a search cluster and
+ * the messages exchanged between them.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef SEARCHWORKER_H_
+#define SEARCHWORKER_H_
+
+#include <string>
+#include <vector>
+#include <iosfwd>
+
+#include "Global.h"
+#include "HexBoard.h"
+#include "MonteCarloTreeSearch.h"
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+
+/**
+ * SearchWorker class is one engine process of a search cluster.<br/>
+ * The worker listens on an endpoint, either "unix:<path>" for Unix domain socket or "<host>:<port>" for TCP, and the
+ * coordinator (see ClusterMonteCarloTreeSearch) connects to every worker of the cluster. For each game state requested by
+ * the coordinator, the worker runs its own Monte Carlo Tree Search with its own random seed and answers the visit and win
+ * counts of the moves at root, which are merged by the coordinator. A connection carries any number of requests until the
+ * coordinator closes it or sends "quit".<br/>
+ * The messages are single lines of text:<br/>
+ * request: search &lt;numofhexgon&gt; &lt;R|B&gt; &lt;numberoftrials&gt; &lt;numofred&gt; &lt;red moves&gt;
+ * &lt;numofblue&gt; &lt;blue moves&gt;<br/>
+ * response: statistics &lt;numofmoves&gt; &lt;move visitcount wincount&gt;... or error &lt;reason&gt;<br/>
+ * SearchWorker(const std::string& endpoint): user defined constructor which binds and listens on the given endpoint. The
+ * path of Unix domain socket is removed before binding and after closing<br/>
+ * Sample Usage:<br/>
+ * SearchWorker worker("unix:/tmp/hexworker0.sock");<br/>
+ * if (worker.isListening())<br/>
+ *   worker.serve(0); //serve the coordinators until the process is terminated<br/>
+ */
+class SearchWorker {
+ public:
+  /**
+   * SearchRequest is the game state to be searched by a worker
+   */
+  struct SearchRequest {
+    int numofhexgon;  ///< the number of hexgons per side
+    hexgonValKind tomove;  ///< the color of player to move
+    std::size_t numberoftrials;  ///< the number of simulated games of the worker
+    std::vector<int> redmoves;  ///< the indices of hexgons occupied by red player
+    std::vector<int> bluemoves;  ///< the indices of hexgons occupied by blue player
+  };
+  static const int MAXNUMOFHEXGON = 32;  ///< the largest board accepted from a request
+  static const std::size_t MAXNUMOFTRIALS = 1 << 24;  ///< the largest number of simulated games accepted from a request
+
+ private:
+  boost::asio::io_service service;  ///< the I/O service of the acceptors
+  hexgame::shared_ptr<boost::asio::ip::tcp::acceptor> tcpacceptor;  ///< the acceptor of TCP endpoint, empty for Unix domain socket
+  hexgame::shared_ptr<boost::asio::local::stream_protocol::acceptor> localacceptor;  ///< the acceptor of Unix domain socket, empty for TCP endpoint
+  std::string localpath;  ///< the path of Unix domain socket, empty for TCP endpoint
+  SharedTranspositionTable* ptrtotable;  ///< the table of position statistics shared with the other processes of host, nullptr if not used
+
+  //Answer the requests of one connection
+  std::size_t answer(std::iostream& stream);
+  //Search one game state
+  bool search(const SearchRequest& request,
+              std::vector<MonteCarloTreeSearch::RootStatistics>& statistics);
+
+  ///Copy constructor which is not allowed
+  SearchWorker(const SearchWorker&);
+  ///Assignment operator which is not allowed
+  SearchWorker& operator=(const SearchWorker&);
+
+ public:
+  //User defined constructor which binds and listens on the given endpoint
+  explicit SearchWorker(const std::string& endpoint);
+  //destructor which closes the endpoint
+  virtual ~SearchWorker();
+  ///Check if the worker is listening on its endpoint
+  ///@param NONE
+  ///@return TRUE if the endpoint is bound successfully
+  bool isListening() const {
+    return tcpacceptor || localacceptor;
+  }
+  ///Setter for the table of position statistics shared with the other processes of host
+  ///@param table is the table which should outlive the worker or nullptr to turn off the table
+  ///@return NONE
+  void setTranspositionTable(SharedTranspositionTable* table) {
+    ptrtotable = table;
+  }
+  //Accept the connections of coordinators one by one and answer their requests
+  std::size_t serve(std::size_t numofconnections);
+
+  //Split an endpoint into Unix domain socket path or TCP host and port
+  static bool parseEndpoint(const std::string& endpoint, std::string& path,
+                            std::string& host, std::string& port);
+  //Write a request as one line
+  static void writeRequest(std::ostream& out, const SearchRequest& request);
+  //Read a request written by writeRequest
+  static bool readRequest(std::istream& in, SearchRequest& request);
+  //Write the statistics of moves at root as one line
+  static void writeStatistics(
+      std::ostream& out,
+      const std::vector<MonteCarloTreeSearch::RootStatistics>& statistics);
+  //Read the statistics written by writeStatistics
+  static bool readStatistics(
+      std::istream& in,
+      std::vector<MonteCarloTreeSearch::RootStatistics>& statistics);
+};
+
+#endif /* SEARCHWORKER_H_ */
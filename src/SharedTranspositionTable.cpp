@@ -0,0 +1,170 @@
+/*
+ * SharedTranspositionTable.cpp
+ * This file defines the lock-free table of position statistics in shared memory attached by several engine processes.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "Global.h"
+#include "SharedTranspositionTable.h"
+
+#include <climits>
+#include <boost/static_assert.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/interprocess/exceptions.hpp>
+
+using namespace std;
+using namespace boost::interprocess;
+
+const int SharedTranspositionTable::MAXVISITCOUNT;
+const std::size_t SharedTranspositionTable::NUMOFSLOTS;
+const boost::uint32_t SharedTranspositionTable::VERSION;
+
+///User defined constructor which creates the table of the given name, or attaches it if it exists
+///@param name is the name of shared memory object, e.g. "hexgame_tt"
+///@param numofentries is the minimal number of entries, rounded up to a power of two of buckets
+SharedTranspositionTable::SharedTranspositionTable(const std::string& name,
+                                                   std::size_t numofentries)
+    : name(name),
+      header(nullptr),
+      slots(nullptr),
+      mask(0) {
+  BOOST_STATIC_ASSERT(sizeof(TableHeader) == 64 && sizeof(Slot) == 16);
+  boost::uint64_t numofbuckets = 1;
+  while (numofbuckets * NUMOFSLOTS < numofentries)
+    numofbuckets <<= 1;
+  try {
+    shared_memory_object object(open_or_create, name.c_str(), read_write);
+    offset_t size = 0;
+    object.get_size(size);
+    if (size == 0)
+      object.truncate(
+          static_cast<offset_t>(sizeof(TableHeader)
+              + numofbuckets * NUMOFSLOTS * sizeof(Slot)));
+    mapped_region mapped(object, read_write);
+    sharedmemory.swap(object);
+    region.swap(mapped);
+  } catch (interprocess_exception&) {
+    return;
+  }
+  if (region.get_size() < sizeof(TableHeader) + NUMOFSLOTS * sizeof(Slot))
+    return;
+
+  //the first process lays out the header, the new pages are filled with zeros hence every slot is empty
+  TableHeader* candidate = static_cast<TableHeader*>(region.get_address());
+  boost::uint32_t expected = 0;
+  if (candidate->state.compare_exchange_strong(expected, 1)) {
+    boost::uint64_t capacity = (region.get_size() - sizeof(TableHeader))
+        / (NUMOFSLOTS * sizeof(Slot));
+    numofbuckets = 1;
+    while (numofbuckets * 2 <= capacity)
+      numofbuckets <<= 1;
+    candidate->version = VERSION;
+    candidate->numofbuckets = numofbuckets;
+    candidate->state.store(2, hexgame::memory_order_release);
+  } else {
+    for (int i = 0;
+        i < 1000 && candidate->state.load(hexgame::memory_order_acquire) != 2;
+        ++i)
+      boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+    if (candidate->state.load(hexgame::memory_order_acquire) != 2)
+      return;
+  }
+  numofbuckets = candidate->numofbuckets;
+  if (candidate->version != VERSION || numofbuckets == 0
+      || (numofbuckets & (numofbuckets - 1)) != 0
+      || sizeof(TableHeader) + numofbuckets * NUMOFSLOTS * sizeof(Slot)
+          > region.get_size())
+    return;
+  header = candidate;
+  slots = reinterpret_cast<Slot*>(candidate + 1);
+  mask = numofbuckets - 1;
+}
+///Pack an entry into one word: 24-bit visit count, 24-bit win count and 16-bit move
+///@param visitcount is the number of simulated games
+///@param wincount is the number of simulated games won
+///@param move is the best move
+///@return the packed entry
+boost::uint64_t SharedTranspositionTable::pack(int visitcount, int wincount,
+                                               int move) {
+  return (static_cast<boost::uint64_t>(visitcount) << 40)
+      | (static_cast<boost::uint64_t>(wincount) << 16)
+      | static_cast<boost::uint64_t>(move);
+}
+///Unpack one word into an entry
+///@param data is the packed entry
+///@param entry stores the entry
+///@return NONE
+void SharedTranspositionTable::unpack(boost::uint64_t data, Entry& entry) {
+  entry.visitcount = static_cast<int>(data >> 40);
+  entry.wincount = static_cast<int>((data >> 16) & 0xFFFFFF);
+  entry.move = static_cast<int>(data & 0xFFFF);
+}
+///Look up the statistics of a position
+///@param key is the position key (see PositionHash)
+///@param entry stores the statistics if found
+///@return TRUE if the position is found
+bool SharedTranspositionTable::probe(boost::uint64_t key, Entry& entry) const {
+  if (!isAttached())
+    return false;
+  const Slot* bucket = slots + (key & mask) * NUMOFSLOTS;
+  for (size_t i = 0; i < NUMOFSLOTS; ++i) {
+    boost::uint64_t check = bucket[i].check.load(hexgame::memory_order_acquire);
+    boost::uint64_t data = bucket[i].data.load(hexgame::memory_order_acquire);
+    if (data != 0 && (check ^ data) == key) {
+      unpack(data, entry);
+      return true;
+    }
+  }
+  return false;
+}
+///Store the statistics of a position. The visit count larger than MAXVISITCOUNT is scaled down together with the win count
+///@param key is the position key (see PositionHash)
+///@param visitcount is the number of simulated games, positive
+///@param wincount is the number of simulated games won, in [0, visitcount]
+///@param move is the best move, in [1, 65535]
+///@return TRUE if the statistics are stored, FALSE if the replaced slot has more simulated games
+bool SharedTranspositionTable::store(boost::uint64_t key, int visitcount,
+                                     int wincount, int move) {
+  if (!isAttached() || visitcount <= 0 || move <= 0 || move > 0xFFFF)
+    return false;
+  if (visitcount > MAXVISITCOUNT) {
+    wincount = static_cast<int>(static_cast<double>(wincount) * MAXVISITCOUNT
+        / visitcount);
+    visitcount = MAXVISITCOUNT;
+  }
+  wincount = (wincount < 0) ? 0 : ((wincount > visitcount) ? visitcount : wincount);
+
+  //the slot of the same key, or else an empty slot, or else the slot with the fewest simulated games
+  Slot* bucket = slots + (key & mask) * NUMOFSLOTS;
+  Slot* target = nullptr;
+  int targetvisits = INT_MAX;
+  for (size_t i = 0; i < NUMOFSLOTS; ++i) {
+    boost::uint64_t check = bucket[i].check.load(hexgame::memory_order_acquire);
+    boost::uint64_t data = bucket[i].data.load(hexgame::memory_order_acquire);
+    Entry entry;
+    unpack(data, entry);
+    if (data != 0 && (check ^ data) == key) {
+      target = &bucket[i];
+      targetvisits = entry.visitcount;
+      break;
+    }
+    if (entry.visitcount < targetvisits) {
+      target = &bucket[i];
+      targetvisits = entry.visitcount;
+    }
+  }
+  if (visitcount < targetvisits)
+    return false;
+  boost::uint64_t data = pack(visitcount, wincount, move);
+  target->data.store(data, hexgame::memory_order_relaxed);
+  target->check.store(key ^ data, hexgame::memory_order_release);
+  return true;
+}
+///Remove the shared memory object of the given name. The processes attached keep their mapping until they detach
+///@param name is the name of shared memory object
+///@return TRUE if the object is removed
+bool SharedTranspositionTable::remove(const std::string& name) {
+  return shared_memory_object::remove(name.c_str());
+}
@@ -0,0 +1,115 @@
+/*
+ * SharedTranspositionTable.h
+ * This file declares the lock-free table of position statistics in shared memory attached by several engine processes.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef SHAREDTRANSPOSITIONTABLE_H_
+#define SHAREDTRANSPOSITIONTABLE_H_
+
+#include <string>
+#include <boost/cstdint.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "Global.h"
+
+/**
+ * SharedTranspositionTable class is a hash table of position statistics shared by the engine processes of one host.<br/>
+ * The table lives in a named POSIX shared memory object which is created by the first process and attached by the others,
+ * so the statistics found by the search of one process are read by the others without any message. The key is the
+ * position key of PositionHash and each entry holds the number of simulated games, the estimated wins and the best move.
+ * <br/>
+ * The table is divided into buckets of four slots, one cache line each. A slot is two 64-bit atomic words, the packed
+ * entry and the key exclusive-ored with the packed entry; a reader accepts a slot only if both words agree, hence a slot
+ * torn by concurrent writers is dropped instead of misread and no lock is taken. A store replaces the slot of the same key,
+ * an empty slot or the slot with the fewest simulated games of the bucket, whichever comes first, as long as the stored
+ * entry does not have fewer simulated games than the replaced one.<br/>
+ * SharedTranspositionTable(const std::string& name, std::size_t numofentries): user defined constructor which creates
+ * the shared memory object of the given name with at least the given number of entries, or attaches it if it already
+ * exists. The processes sharing a table should give the same number of entries<br/>
+ * Sample Usage:<br/>
+ * SharedTranspositionTable table("hexgame_tt", 1 << 20);<br/>
+ * table.store(PositionHash::hashBoard(board, hexgonValKind_RED), 2048, 1300, move);<br/>
+ * SharedTranspositionTable::Entry entry;<br/>
+ * if (table.probe(key, entry)) //entry.move, entry.visitcount and entry.wincount<br/>
+ */
+class SharedTranspositionTable {
+ public:
+  /**
+   * Entry is the statistics of one position
+   */
+  struct Entry {
+    int visitcount;  ///< the number of simulated games spent on the position
+    int wincount;  ///< the estimated number of simulated games won by the player to move through the best move
+    int move;  ///< the best move (index of hexgon starting from 1)
+  };
+  static const int MAXVISITCOUNT = (1 << 24) - 1;  ///< the largest visit count kept, larger counts are scaled down with their wins
+  static const std::size_t NUMOFSLOTS = 4;  ///< the number of slots of a bucket
+
+ private:
+  /**
+   * Slot is one entry packed with its key check
+   */
+  struct Slot {
+    hexgame::atomic<boost::uint64_t> check;  ///< the key exclusive-ored with data
+    hexgame::atomic<boost::uint64_t> data;  ///< the packed entry, 0 if empty
+  };
+  /**
+   * TableHeader is the header of shared memory object
+   */
+  struct TableHeader {
+    hexgame::atomic<boost::uint32_t> state;  ///< 0 before initialization, 1 during and 2 after
+    boost::uint32_t version;  ///< the version of layout
+    boost::uint64_t numofbuckets;  ///< the number of buckets following the header
+    char padding[48];  ///< keep the buckets aligned to cache line
+  };
+  static const boost::uint32_t VERSION = 1;  ///< current version of layout
+
+  std::string name;  ///< the name of shared memory object
+  boost::interprocess::shared_memory_object sharedmemory;  ///< the shared memory object
+  boost::interprocess::mapped_region region;  ///< the mapped region of shared memory object
+  TableHeader* header;  ///< the header inside the mapped region, nullptr if not attached
+  Slot* slots;  ///< the slots inside the mapped region
+  boost::uint64_t mask;  ///< the number of buckets minus one
+
+  //Pack an entry into one word
+  static boost::uint64_t pack(int visitcount, int wincount, int move);
+  //Unpack one word into an entry
+  static void unpack(boost::uint64_t data, Entry& entry);
+
+  ///Copy constructor which is not allowed
+  SharedTranspositionTable(const SharedTranspositionTable&);
+  ///Assignment operator which is not allowed
+  SharedTranspositionTable& operator=(const SharedTranspositionTable&);
+
+ public:
+  //User defined constructor which creates or attaches the table of the given name
+  SharedTranspositionTable(const std::string& name, std::size_t numofentries);
+  ///destructor which detaches the table, the shared memory object is kept for other processes
+  virtual ~SharedTranspositionTable() {
+  }
+  ;
+  ///Check if the table is attached successfully
+  ///@param NONE
+  ///@return TRUE if the table can be probed and stored
+  bool isAttached() const {
+    return header != nullptr;
+  }
+  ///Get the number of entries of the table
+  ///@param NONE
+  ///@return the number of slots, 0 if not attached
+  std::size_t getNumofEntries() const {
+    return isAttached() ? static_cast<std::size_t>((mask + 1) * NUMOFSLOTS) : 0;
+  }
+  //Look up the statistics of a position
+  bool probe(boost::uint64_t key, Entry& entry) const;
+  //Store the statistics of a position
+  bool store(boost::uint64_t key, int visitcount, int wincount, int move);
+  //Remove the shared memory object of the given name, the attached processes keep their mapping
+  static bool remove(const std::string& name);
+};
+
+#endif /* SHAREDTRANSPOSITIONTABLE_H_ */
@@ -0,0 +1,352 @@
+/*
+ * TournamentRunner.cpp
+ * This file defines the runner which plays many games between two AI strategies in parallel and aggregates their results
+ * and timings.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "Global.h"
+#include "Game.h"
+#include "Strategy.h"
+#include "MonteCarloTreeSearch.h"
+#include "MultiMonteCarloTreeSearch.h"
+#include "TournamentRunner.h"
+
+#include <cmath>
+#include <limits>
+#include <cstdlib>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/locks.hpp>
+
+using namespace std;
+
+///Get the winning rate of the first entrant
+///@param NONE
+///@return the fraction of games won by the first entrant, 0.0 if no game is played
+double TournamentRunner::Report::getWinningRate() const {
+  return (numofgames > 0) ?
+      static_cast<double>(numofwins) / static_cast<double>(numofgames) : 0.0;
+}
+///Get the Wilson score interval of the winning rate of the first entrant, which stays within [0, 1] for few games or
+///lopsided results
+///@param lower stores the lower bound of interval
+///@param upper stores the upper bound of interval
+///@param z is the quantile of standard normal distribution, 1.96 for the 95% interval
+///@return NONE
+void TournamentRunner::Report::getConfidenceInterval(double& lower,
+                                                     double& upper,
+                                                     double z) const {
+  if (numofgames == 0) {
+    lower = 0.0;
+    upper = 1.0;
+    return;
+  }
+  double n = static_cast<double>(numofgames);
+  double rate = getWinningRate();
+  double denominator = 1.0 + z * z / n;
+  double center = (rate + z * z / (2.0 * n)) / denominator;
+  double margin = z * sqrt(rate * (1.0 - rate) / n + z * z / (4.0 * n * n))
+      / denominator;
+  lower = max(0.0, center - margin);
+  upper = min(1.0, center + margin);
+}
+///Get the number of moves played per second of wall clock time
+///@param NONE
+///@return the moves per second of both entrants, 0.0 if no time is measured
+double TournamentRunner::Report::getMovesPerSecond() const {
+  return (elapsedseconds > 0.0) ?
+      static_cast<double>(numofmoves) / elapsedseconds : 0.0;
+}
+///Get a percentile of the latencies of moves of an entrant by nearest rank
+///@param entrant is 0 for the first entrant and 1 for the second one
+///@param percentile is the percentile in (0, 100], e.g. 50 for median and 100 for maximum
+///@return the latency in milliseconds, 0.0 if the entrant has no move
+double TournamentRunner::Report::getLatencyPercentile(int entrant,
+                                                      double percentile) const {
+  const vector<double>& sorted = latencies[entrant];
+  if (sorted.empty())
+    return 0.0;
+  double rank = ceil(percentile / 100.0 * static_cast<double>(sorted.size()));
+  size_t index = (rank < 1.0) ? 0 : static_cast<size_t>(rank) - 1;
+  return sorted[min(index, sorted.size() - 1)];
+}
+///User defined constructor which takes the scheduler, the two entrants and the time limit per move
+///@param scheduler is the scheduler running the games which should outlive the runner
+///@param first is the first entrant, whose results are reported
+///@param second is the second entrant
+///@param timelimit is the time limit per move in milliseconds, 0 for no limit
+TournamentRunner::TournamentRunner(WorkStealingScheduler& scheduler,
+                                   const Entrant& first, const Entrant& second,
+                                   std::size_t timelimit)
+    : scheduler(scheduler),
+      timelimit(timelimit),
+      isrunning(false) {
+  entrants[0] = first;
+  entrants[1] = second;
+}
+///Play the given number of games on one board size and aggregate their results. The entrants alternate colors
+///@param numofhexgon is the number of hexgons per side
+///@param numofgames is the number of games
+///@return the report of games with sorted latencies
+TournamentRunner::Report TournamentRunner::run(int numofhexgon,
+                                               std::size_t numofgames) {
+  Report report(numofhexgon);
+  hexgame::unique_ptr<boost::thread, hexgame::default_delete<boost::thread> > referee;
+  isrunning.store(true);
+  if (timelimit > 0)
+    referee.reset(
+        new boost::thread(boost::bind(&TournamentRunner::watchDeadlines, this)));
+
+  hexgame::chrono::steady_clock::time_point start =
+      hexgame::chrono::steady_clock::now();
+  WorkStealingScheduler::TaskGroup group;
+  for (size_t i = 0; i < numofgames; ++i)
+    scheduler.submit(
+        boost::bind(&TournamentRunner::playGame, this, numofhexgon, i, &report),
+        group);
+  scheduler.wait(group);
+  report.elapsedseconds = hexgame::chrono::duration_cast<
+      hexgame::chrono::microseconds>(hexgame::chrono::steady_clock::now() - start)
+      .count() / 1e6;
+
+  isrunning.store(false);
+  if (referee)
+    referee->join();
+  sort(report.latencies[0].begin(), report.latencies[0].end());
+  sort(report.latencies[1].begin(), report.latencies[1].end());
+  return report;
+}
+///Play one game to the end and add its result to the report, the task of run
+///@param numofhexgon is the number of hexgons per side
+///@param index is the index of game, the first entrant plays RED in the even games
+///@param report is the report being filled
+///@return NONE
+void TournamentRunner::playGame(int numofhexgon, std::size_t index,
+                                Report* report) {
+  HexBoard board(numofhexgon);
+  Player redplayer(board, hexgonValKind_RED);
+  Player blueplayer(board, hexgonValKind_BLUE);
+  Game hexboardgame(board);
+
+  //the entrant of RED and BLUE
+  int redentrant = (index % 2 == 0) ? 0 : 1;
+  hexgame::unique_ptr<AbstractStrategy,
+      hexgame::default_delete<AbstractStrategy> > redstrategy(
+      createStrategy(entrants[redentrant], board, redplayer));
+  hexgame::unique_ptr<AbstractStrategy,
+      hexgame::default_delete<AbstractStrategy> > bluestrategy(
+      createStrategy(entrants[1 - redentrant], board, blueplayer));
+  SearchMonitor monitor;
+  monitor.setInterval(numeric_limits<size_t>::max());
+
+  vector<double> latencies[2];
+  size_t numofmoves = 0, numofcutoffs = 0;
+  int winner = -1;  //the entrant who wins
+  bool isforfeited = false;
+  for (bool isred = true; winner < 0; isred = !isred) {
+    Player& player = isred ? redplayer : blueplayer;
+    AbstractStrategy& strategy = isred ? *redstrategy : *bluestrategy;
+    int entrant = isred ? redentrant : 1 - redentrant;
+
+    //the move starts before its deadline is set, hence a move stopped by the referee takes at least the time limit
+    hexgame::chrono::steady_clock::time_point start =
+        hexgame::chrono::steady_clock::now();
+    if (timelimit > 0) {
+      monitor.reset();
+      strategy.setSearchMonitor(&monitor);
+      boost::lock_guard<boost::mutex> lock(mutex);
+      deadlines[&monitor] = hexgame::chrono::steady_clock::now()
+          + hexgame::chrono::milliseconds(timelimit);
+    }
+    int move = hexboardgame.genMove(strategy);
+    double latency = hexgame::chrono::duration_cast<
+        hexgame::chrono::microseconds>(
+        hexgame::chrono::steady_clock::now() - start).count() / 1e3;
+    latencies[entrant].push_back(latency);
+    if (timelimit > 0) {
+      bool isstopped;
+      {
+        boost::lock_guard<boost::mutex> lock(mutex);
+        isstopped = monitor.isStopRequested();
+        deadlines.erase(&monitor);
+      }
+      strategy.setSearchMonitor(nullptr);
+      //neither a search which returns before the referee fires nor NAIVE which ignores the request is cut short
+      if (isstopped && entrants[entrant].strategykind != AIStrategyKind_NAIVE
+          && latency >= static_cast<double>(timelimit))
+        ++numofcutoffs;
+    }
+
+    if (move < 1 || move > numofhexgon * numofhexgon
+        || !hexboardgame.setMove(player, (move - 1) / numofhexgon + 1,
+                                 (move - 1) % numofhexgon + 1)) {
+      winner = 1 - entrant;
+      isforfeited = true;
+    } else {
+      ++numofmoves;
+      if (player.isArriveOpposite())
+        winner = entrant;
+    }
+  }
+
+  boost::lock_guard<boost::mutex> lock(mutex);
+  ++report->numofgames;
+  if (redentrant == 0)
+    ++report->numofgamesasred;
+  if (winner == 0) {
+    ++report->numofwins;
+    if (redentrant == 0)
+      ++report->numofwinsasred;
+  }
+  report->numofmoves += numofmoves;
+  report->numofcutoffs += numofcutoffs;
+  if (isforfeited)
+    ++report->numofforfeits;
+  for (int i = 0; i < 2; ++i)
+    report->latencies[i].insert(report->latencies[i].end(),
+                                latencies[i].begin(), latencies[i].end());
+}
+///Stop the searches whose time limits pass, checked every millisecond until the games of run are played
+///@param NONE
+///@return NONE
+void TournamentRunner::watchDeadlines() {
+  while (isrunning.load()) {
+    {
+      hexgame::chrono::steady_clock::time_point now =
+          hexgame::chrono::steady_clock::now();
+      boost::lock_guard<boost::mutex> lock(mutex);
+      for (map<SearchMonitor*, hexgame::chrono::steady_clock::time_point>::iterator iter =
+          deadlines.begin(); iter != deadlines.end(); ++iter)
+        if (now >= iter->second)
+          iter->first->requestStop();
+    }
+    boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+  }
+}
+///Create the strategy of an entrant for a player
+///@param entrant is the entrant
+///@param board is the board of game
+///@param player is the player using the strategy
+///@return the strategy owned by the caller
+AbstractStrategy* TournamentRunner::createStrategy(const Entrant& entrant,
+                                                   const HexBoard& board,
+                                                   const Player& player) {
+  switch (entrant.strategykind) {
+    case AIStrategyKind_NAIVE:
+      if (entrant.numberoftrials > 0)
+        return new Strategy(&board, &player, entrant.numberoftrials);
+      return new Strategy(&board, &player);
+    case AIStrategyKind_PMCTS:
+      if (entrant.numberoftrials > 0)
+        return new MultiMonteCarloTreeSearch(
+            &board, &player, (entrant.numofthreads > 0) ? entrant.numofthreads : 8,
+            entrant.numberoftrials);
+      if (entrant.numofthreads > 0)
+        return new MultiMonteCarloTreeSearch(&board, &player,
+                                             entrant.numofthreads);
+      return new MultiMonteCarloTreeSearch(&board, &player);
+    default:
+      if (entrant.numberoftrials > 0)
+        return new MonteCarloTreeSearch(&board, &player, entrant.numberoftrials);
+      return new MonteCarloTreeSearch(&board, &player);
+  }
+}
+///Format a report as text: the winning rate of the first entrant with its 95% confidence interval, the winning rates per
+///color, the throughput and the percentiles of latencies of moves
+///@param report is the report returned by run
+///@return the text of report
+std::string TournamentRunner::showReport(const Report& report) const {
+  stringstream strout;
+  double lower, upper;
+  report.getConfidenceInterval(lower, upper);
+  size_t numofgamesasblue = report.numofgames - report.numofgamesasred;
+  size_t numofwinsasblue = report.numofwins - report.numofwinsasred;
+  strout << fixed << setprecision(1);
+  strout << formatEntrant(entrants[0]) << " vs " << formatEntrant(entrants[1])
+         << " on " << report.numofhexgon << " x " << report.numofhexgon
+         << " board, " << report.numofgames << " games\n";
+  strout << "  wins: " << report.numofwins << " (" << 100.0 * report.getWinningRate()
+         << "%, 95% CI " << 100.0 * lower << "% - " << 100.0 * upper << "%)\n";
+  strout << "  as RED: " << report.numofwinsasred << '/' << report.numofgamesasred
+         << ", as BLUE: " << numofwinsasblue << '/' << numofgamesasblue
+         << ", forfeits: " << report.numofforfeits << '\n';
+  strout << "  moves: " << report.numofmoves << " in " << report.elapsedseconds
+         << " s (" << report.getMovesPerSecond() << " moves/s), cut by time limit: "
+         << report.numofcutoffs << '\n';
+  strout << setprecision(2);
+  for (int i = 0; i < 2; ++i)
+    strout << "  latency of " << ((i == 0) ? "first" : "second")
+           << " (ms): p50 " << report.getLatencyPercentile(i, 50) << ", p90 "
+           << report.getLatencyPercentile(i, 90) << ", p99 "
+           << report.getLatencyPercentile(i, 99) << ", max "
+           << report.getLatencyPercentile(i, 100) << '\n';
+  return strout.str();
+}
+///Parse an entrant written as kind[:numberoftrials[:numofthreads]] where kind is naive, mcts or pmcts, e.g. mcts:4096 or
+///pmcts:2048:4
+///@param text is the text of entrant
+///@param entrant stores the entrant parsed
+///@return TRUE if the text is well formed
+bool TournamentRunner::parseEntrant(const std::string& text, Entrant& entrant) {
+  vector<string> fields;
+  stringstream strin(text);
+  string field;
+  while (getline(strin, field, ':'))
+    fields.push_back(field);
+  if (fields.empty() || fields.size() > 3)
+    return false;
+
+  Entrant parsed;
+  if (fields[0] == "naive")
+    parsed.strategykind = AIStrategyKind_NAIVE;
+  else if (fields[0] == "mcts")
+    parsed.strategykind = AIStrategyKind_MCTS;
+  else if (fields[0] == "pmcts")
+    parsed.strategykind = AIStrategyKind_PMCTS;
+  else
+    return false;
+  for (size_t i = 1; i < fields.size(); ++i) {
+    char* end = nullptr;
+    unsigned long value = strtoul(fields[i].c_str(), &end, 10);
+    if (fields[i].empty() || *end != '\0'
+        || fields[i].find('-') != string::npos)
+      return false;
+    if (i == 1)
+      parsed.numberoftrials = value;
+    else
+      parsed.numofthreads = value;
+  }
+  if (parsed.numofthreads > 0 && parsed.strategykind != AIStrategyKind_PMCTS)
+    return false;
+  entrant = parsed;
+  return true;
+}
+///Format an entrant as text which parseEntrant accepts
+///@param entrant is the entrant
+///@return the text of entrant
+std::string TournamentRunner::formatEntrant(const Entrant& entrant) {
+  stringstream strout;
+  switch (entrant.strategykind) {
+    case AIStrategyKind_NAIVE:
+      strout << "naive";
+      break;
+    case AIStrategyKind_PMCTS:
+      strout << "pmcts";
+      break;
+    default:
+      strout << "mcts";
+      break;
+  }
+  if (entrant.numberoftrials > 0 || entrant.numofthreads > 0)
+    strout << ':' << entrant.numberoftrials;
+  if (entrant.numofthreads > 0)
+    strout << ':' << entrant.numofthreads;
+  return strout.str();
+}
@@ -0,0 +1,148 @@
+/*
+ * TournamentRunner.h
+ * This file declares the runner which plays many games between two AI strategies in parallel and aggregates their results
+ * and timings.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef TOURNAMENTRUNNER_H_
+#define TOURNAMENTRUNNER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Global.h"
+#include "Player.h"
+#include "HexBoard.h"
+#include "AbstractStrategy.h"
+#include "SearchMonitor.h"
+#include "WorkStealingScheduler.h"
+
+#include <boost/thread/mutex.hpp>
+
+/**
+ * TournamentRunner class plays many games between two entrants, each a strategy with its own number of simulated games,
+ * on a shared WorkStealingScheduler. Every game is one task with its own board, players and strategies, hence the games
+ * run on all workers at once and no game waits for another. The entrants alternate colors: the first entrant plays RED
+ * (north to south, moving first) in the even games and BLUE (west to east) in the odd ones.<br/>
+ * With a time limit every move is watched by a SearchMonitor and a referee thread requests the search to stop when its
+ * time limit passes, hence the best move found so far is played. The strategies without tree search (NAIVE) ignore the
+ * request and always run all their simulated games. PMCTS runs its own threads per move, so its threads times the workers
+ * should not exceed the cores.<br/>
+ * A game is forfeited by the entrant whose strategy returns a move which can not be played.<br/>
+ * TournamentRunner(WorkStealingScheduler& scheduler, const Entrant& first, const Entrant& second, std::size_t timelimit):
+ * user defined constructor which takes the scheduler running the games, the two entrants and the time limit per move in
+ * milliseconds (0 for no limit)<br/>
+ * Sample Usage:<br/>
+ * WorkStealingScheduler scheduler(8);<br/>
+ * TournamentRunner runner(scheduler, TournamentRunner::Entrant(AIStrategyKind_MCTS, 4096),<br/>
+ *                         TournamentRunner::Entrant(AIStrategyKind_NAIVE, 2048), 100);<br/>
+ * TournamentRunner::Report report = runner.run(9, 1000);<br/>
+ * std::cout << runner.showReport(report);<br/>
+ */
+class TournamentRunner {
+ public:
+  /**
+   * Entrant is a strategy taking part in tournament
+   */
+  struct Entrant {
+    AIStrategyKind strategykind;  ///< the kind of strategy
+    std::size_t numberoftrials;  ///< the number of simulated games per move, 0 for the default of strategy
+    std::size_t numofthreads;  ///< the number of threads of PMCTS, 0 for the default of strategy
+
+    ///User defined constructor which takes the kind of strategy, the number of simulated games and threads
+    Entrant(AIStrategyKind strategykind = AIStrategyKind_MCTS,
+            std::size_t numberoftrials = 0, std::size_t numofthreads = 0)
+        : strategykind(strategykind),
+          numberoftrials(numberoftrials),
+          numofthreads(numofthreads) {
+    }
+  };
+  /**
+   * Report is the aggregated result of the games played on one board size, counted from the view of the first entrant.
+   * The latencies of moves are in milliseconds and sorted
+   */
+  struct Report {
+    int numofhexgon;  ///< the number of hexgons per side
+    std::size_t numofgames;  ///< the number of games played
+    std::size_t numofwins;  ///< the number of games won by the first entrant
+    std::size_t numofgamesasred;  ///< the number of games where the first entrant plays RED
+    std::size_t numofwinsasred;  ///< the number of games won by the first entrant playing RED
+    std::size_t numofmoves;  ///< the number of moves played by both entrants
+    std::size_t numofcutoffs;  ///< the number of moves of tree search stopped by the time limit, never NAIVE ones
+    std::size_t numofforfeits;  ///< the number of games forfeited by an illegal move
+    double elapsedseconds;  ///< the wall clock time of the tournament in seconds
+    std::vector<double> latencies[2];  ///< the latencies of moves of the first and the second entrants
+
+    ///User defined constructor which takes the number of hexgons per side
+    explicit Report(int numofhexgon = 0)
+        : numofhexgon(numofhexgon),
+          numofgames(0),
+          numofwins(0),
+          numofgamesasred(0),
+          numofwinsasred(0),
+          numofmoves(0),
+          numofcutoffs(0),
+          numofforfeits(0),
+          elapsedseconds(0.0) {
+    }
+    //Get the winning rate of the first entrant
+    double getWinningRate() const;
+    //Get the Wilson score interval of the winning rate of the first entrant
+    void getConfidenceInterval(double& lower, double& upper, double z = 1.96) const;
+    //Get the number of moves played per second of wall clock time
+    double getMovesPerSecond() const;
+    //Get a percentile of the latencies of moves of an entrant
+    double getLatencyPercentile(int entrant, double percentile) const;
+  };
+
+ private:
+  WorkStealingScheduler& scheduler;  ///< the scheduler running the games
+  Entrant entrants[2];  ///< the first and the second entrants
+  const std::size_t timelimit;  ///< the time limit per move in milliseconds, 0 for no limit
+  boost::mutex mutex;  ///< the mutex of the report being filled and the deadlines
+  std::map<SearchMonitor*, hexgame::chrono::steady_clock::time_point> deadlines;  ///< the deadlines of moves being searched
+  hexgame::atomic<bool> isrunning;  ///< TRUE while the games of run are played, read by the referee
+
+  //Play one game and add its result to the report
+  void playGame(int numofhexgon, std::size_t index, Report* report);
+  //Stop the searches whose time limits pass until the tournament ends
+  void watchDeadlines();
+  //Create the strategy of an entrant for a player
+  static AbstractStrategy* createStrategy(const Entrant& entrant,
+                                          const HexBoard& board,
+                                          const Player& player);
+
+  ///Copy constructor which is not allowed
+  TournamentRunner(const TournamentRunner&);
+  ///Assignment operator which is not allowed
+  TournamentRunner& operator=(const TournamentRunner&);
+
+ public:
+  //User defined constructor which takes the scheduler, the two entrants and the time limit per move
+  TournamentRunner(WorkStealingScheduler& scheduler, const Entrant& first,
+                   const Entrant& second, std::size_t timelimit);
+  ///destructor
+  virtual ~TournamentRunner() {
+  }
+  //Play the given number of games on one board size and aggregate their results
+  Report run(int numofhexgon, std::size_t numofgames);
+  //Format a report as text
+  std::string showReport(const Report& report) const;
+  ///Get an entrant
+  ///@param entrant is 0 for the first entrant and 1 for the second one
+  ///@return the entrant
+  const Entrant& getEntrant(int entrant) const {
+    return entrants[entrant];
+  }
+
+  //Parse an entrant such as mcts:4096 or pmcts:2048:4
+  static bool parseEntrant(const std::string& text, Entrant& entrant);
+  //Format an entrant as text
+  static std::string formatEntrant(const Entrant& entrant);
+};
+
+#endif /* TOURNAMENTRUNNER_H_ */
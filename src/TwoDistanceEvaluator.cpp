@@ -0,0 +1,219 @@
+/*
+ * TwoDistanceEvaluator.cpp
+ * This file defines the implementation of TwoDistanceEvaluator class
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "TwoDistanceEvaluator.h"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+const int TwoDistanceEvaluator::INFINITE_DISTANCE;
+
+///User defined constructor which takes the tables of board
+///@param topology is the rings of hexgons which should outlive the evaluator
+TwoDistanceEvaluator::TwoDistanceEvaluator(const BoardTopology& topology)
+    : topology(topology),
+      numofvertices(topology.getNumofhexgons() * topology.getNumofhexgons()) {
+  potentials[0] = potentials[1] = INFINITE_DISTANCE;
+}
+///Evaluate the game state given by the moves of both players, i.e. compute the two-distances of both players to their
+///edges and their potentials
+///@param babywatsons is the moves made by AI player
+///@param opponents is the moves made by the opponent
+///@param isbabywatsonwesttoeast is the winning condition of AI player
+///@return the score of AI player which is the potential of the opponent minus the potential of AI player
+int TwoDistanceEvaluator::evaluate(const vector<int>& babywatsons,
+                                   const vector<int>& opponents,
+                                   bool isbabywatsonwesttoeast) {
+  colors.assign(numofvertices, 0);
+  for (size_t i = 0; i < babywatsons.size(); ++i)
+    if (babywatsons[i] > 0)
+      colors[babywatsons[i] - 1] = 1;
+  for (size_t i = 0; i < opponents.size(); ++i)
+    if (opponents[i] > 0)
+      colors[opponents[i] - 1] = -1;
+
+  for (int side = 0; side < 2; ++side) {
+    signed char owner = side ? 1 : -1;
+    bool iswesttoeast = side ? isbabywatsonwesttoeast : !isbabywatsonwesttoeast;
+    bool isjoined = findGroups(owner, iswesttoeast);
+    computeDistances(iswesttoeast ? BoardTopology::WEST : BoardTopology::NORTH,
+                     1, distances[side * 2]);
+    computeDistances(iswesttoeast ? BoardTopology::EAST : BoardTopology::SOUTH,
+                     2, distances[side * 2 + 1]);
+    potentials[side] = isjoined ? 0 : INFINITE_DISTANCE;
+    for (int i = 0; i < numofvertices && !isjoined; ++i)
+      potentials[side] = min(
+          potentials[side],
+          min(distances[side * 2][i] + distances[side * 2 + 1][i],
+              static_cast<int>(INFINITE_DISTANCE)));
+  }
+  return potentials[0] - potentials[1];
+}
+///Evaluate the game state advanced by the game tree
+///@param state is the game state
+///@param isbabywatsonwesttoeast is the winning condition of AI player
+///@return the score of AI player which is the potential of the opponent minus the potential of AI player
+int TwoDistanceEvaluator::evaluate(DescentState& state,
+                                   bool isbabywatsonwesttoeast) {
+  return evaluate(state.getBabywatsons(), state.getOpponents(),
+                  isbabywatsonwesttoeast);
+}
+///Convert the potentials of the game state evaluated to the winning rate of AI player by logistic function of the score,
+///where the player to move gains half a move
+///@param isbabywatsontomove is TRUE if AI player is to move
+///@return the winning rate of AI player which is 1 or 0 if a player already joins the edges
+double TwoDistanceEvaluator::getWinningRate(bool isbabywatsontomove) const {
+  if (potentials[1] == 0)
+    return 1.0;
+  if (potentials[0] == 0)
+    return 0.0;
+  double score = static_cast<double>(potentials[0] - potentials[1])
+      + (isbabywatsontomove ? 0.5 : -0.5);
+  return 1.0 / (1.0 + exp(-score));
+}
+///Get the move priors of the empty hexgons in the game state evaluated. A hexgon on the shortest paths of both players
+///has the highest prior, which decreases with the excess of its sum of two-distances over the potential of each player
+///@param priors is the container of priors indexed by position - 1, 0 for the occupied hexgons
+///@return NONE
+void TwoDistanceEvaluator::getPriors(vector<int>& priors) const {
+  int numofhexgons = topology.getNumofhexgons();
+  priors.assign(numofvertices, 0);
+  for (int i = 0; i < numofvertices; ++i) {
+    if (colors[i] != 0)
+      continue;
+    int prior = 2 * numofhexgons;
+    for (int side = 0; side < 2; ++side) {
+      int excess = numofhexgons;
+      if (distances[side * 2][i] < INFINITE_DISTANCE
+          && distances[side * 2 + 1][i] < INFINITE_DISTANCE)
+        excess = min(
+            excess,
+            distances[side * 2][i] + distances[side * 2 + 1][i]
+                - potentials[side]);
+      prior -= max(excess, 0);
+    }
+    priors[i] = prior;
+  }
+}
+///Find the groups of the player and the empty hexgons next to them
+///@param owner is the player, 1 for AI player and -1 for the opponent
+///@param iswesttoeast is the winning condition of the player
+///@return TRUE if a group touches both edges of the player
+bool TwoDistanceEvaluator::findGroups(signed char owner, bool iswesttoeast) {
+  int first = iswesttoeast ? BoardTopology::WEST : BoardTopology::NORTH;
+  int second = iswesttoeast ? BoardTopology::EAST : BoardTopology::SOUTH;
+  bool isjoined = false;
+  groups.assign(numofvertices, -1);
+  liberties.clear();
+  edgemarks.clear();
+  vector<int>& stack = buckets[0];
+  for (int cell = 1; cell <= numofvertices; ++cell) {
+    if (colors[cell - 1] != owner || groups[cell - 1] >= 0)
+      continue;
+    int group = static_cast<int>(liberties.size());
+    liberties.push_back(vector<int>());
+    edgemarks.push_back(0);
+    groups[cell - 1] = group;
+    stack.assign(1, cell);
+    while (!stack.empty()) {
+      int stone = stack.back();
+      stack.pop_back();
+      if (topology.isOnEdge(stone, first))
+        edgemarks[group] |= 1;
+      if (topology.isOnEdge(stone, second))
+        edgemarks[group] |= 2;
+      const int* ring = topology.getRing(stone);
+      for (int k = 0; k < BoardTopology::SIZEOFRING; ++k) {
+        int neighbor = ring[k];
+        if (neighbor <= 0)
+          continue;
+        if (colors[neighbor - 1] == 0)
+          liberties[group].push_back(neighbor);
+        else if (colors[neighbor - 1] == owner && groups[neighbor - 1] < 0) {
+          groups[neighbor - 1] = group;
+          stack.push_back(neighbor);
+        }
+      }
+    }
+    isjoined = isjoined || (edgemarks[group] == 3);
+  }
+  return isjoined;
+}
+///Compute the two-distances of the empty hexgons to an edge by bucketed breadth-first search, which should be called after
+///the groups of the player are found
+///@param edge is the edgekind of the edge
+///@param edgemark is the mark of groups touching the edge
+///@param result is the container of two-distances indexed by position - 1
+///@return NONE
+void TwoDistanceEvaluator::computeDistances(int edge, unsigned char edgemark,
+                                            vector<int>& result) {
+  result.assign(numofvertices, INFINITE_DISTANCE);
+  counts.assign(numofvertices, 0);
+  stamps.assign(numofvertices, 0);
+  buckets[0].clear();
+  for (int cell = 1; cell <= numofvertices; ++cell)
+    if (colors[cell - 1] == 0 && topology.isOnEdge(cell, edge)) {
+      result[cell - 1] = 1;
+      buckets[0].push_back(cell);
+    }
+  for (size_t group = 0; group < liberties.size(); ++group) {
+    if (!(edgemarks[group] & edgemark))
+      continue;
+    for (size_t i = 0; i < liberties[group].size(); ++i)
+      if (result[liberties[group][i] - 1] != 1) {
+        result[liberties[group][i] - 1] = 1;
+        buckets[0].push_back(liberties[group][i]);
+      }
+  }
+  for (int level = 1; !buckets[0].empty(); ++level) {
+    buckets[1].clear();
+    for (size_t i = 0; i < buckets[0].size(); ++i)
+      visitNeighbors(buckets[0][i], level, result);
+    buckets[0].swap(buckets[1]);
+  }
+}
+///Visit the neighbors of a finalized hexgon, i.e. the empty hexgons next to it or next to the groups of the player next to it
+///@param cell is the position of the finalized hexgon
+///@param level is the two-distance of the finalized hexgon
+///@param result is the container of two-distances indexed by position - 1
+///@return NONE
+void TwoDistanceEvaluator::visitNeighbors(int cell, int level,
+                                          vector<int>& result) {
+  const int* ring = topology.getRing(cell);
+  for (int k = 0; k < BoardTopology::SIZEOFRING; ++k) {
+    int neighbor = ring[k];
+    if (neighbor <= 0)
+      continue;
+    if (colors[neighbor - 1] == 0)
+      touch(neighbor, cell, level, result);
+    else if (groups[neighbor - 1] >= 0) {
+      const vector<int>& group = liberties[groups[neighbor - 1]];
+      for (size_t i = 0; i < group.size(); ++i)
+        touch(group[i], cell, level, result);
+    }
+  }
+}
+///Count a finalized neighbor of the hexgon once, and finalize the hexgon at the next level when it is the second one
+///@param neighbor is the position of the hexgon
+///@param cell is the position of the finalized neighbor
+///@param level is the two-distance of the finalized neighbor
+///@param result is the container of two-distances indexed by position - 1
+///@return NONE
+void TwoDistanceEvaluator::touch(int neighbor, int cell, int level,
+                                 vector<int>& result) {
+  if (neighbor == cell || stamps[neighbor - 1] == cell
+      || result[neighbor - 1] != INFINITE_DISTANCE)
+    return;
+  stamps[neighbor - 1] = cell;
+  if (++counts[neighbor - 1] == 2) {
+    result[neighbor - 1] = level + 1;
+    buckets[1].push_back(neighbor);
+  }
+}
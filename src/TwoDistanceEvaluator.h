@@ -0,0 +1,88 @@
+/*
+ * TwoDistanceEvaluator.h
+ * This file declares the static evaluation of game state by the two-distance of both players to their edges.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef TWODISTANCEEVALUATOR_H_
+#define TWODISTANCEEVALUATOR_H_
+
+#include <vector>
+
+#include "Global.h"
+#include "DescentState.h"
+#include "BoardTopology.h"
+
+/**
+ * TwoDistanceEvaluator class is used to evaluate a game state without playing it out.<br/>
+ * The two-distance of an empty hexgon to an edge of a player is one plus the second smallest two-distance of its neighbors,
+ * since the other player blocks the best neighbor first; a hexgon next to the edge has two-distance 1. The neighbors are
+ * taken through the groups of the player (the empty hexgons next to a group are neighbors of each other) and the stones of
+ * the other player are walls. The distances are computed by bucketed breadth-first search from the edge, i.e. a hexgon is
+ * finalized at level k + 1 once its second neighbor is finalized at level k, so each of the four searches (two edges of
+ * two players) visits each hexgon once. The potential of a player is the minimal sum of two-distances to both edges over
+ * the empty hexgons, 0 if a group already joins the edges; the lower potential is the better one.<br/>
+ * TwoDistanceEvaluator(const BoardTopology& topology): user defined constructor which takes the tables of board. The
+ * topology should outlive the evaluator<br/>
+ * Sample Usage:<br/>
+ * TwoDistanceEvaluator evaluator(topology);<br/>
+ * int score = evaluator.evaluate(bwglobal, oppglobal, player.getWestToEastCondition());<br/>
+ * double winningrate = evaluator.getWinningRate(true);<br/>
+ */
+class TwoDistanceEvaluator {
+ private:
+  const BoardTopology& topology;  ///< the rings of hexgons, not owned
+  int numofvertices;  ///< the number of hexgons on board
+  std::vector<signed char> colors;  ///< the owner of each hexgon, 1 for AI player, -1 for the opponent and 0 for empty
+  std::vector<int> distances[4];  ///< the two-distances indexed by position - 1 to the first and second edge of the opponent (0, 1) and AI player (2, 3)
+  int potentials[2];  ///< the potentials of the opponent (0) and AI player (1)
+  std::vector<int> groups;  ///< the group of each stone indexed by position - 1, -1 for the empty hexgons
+  std::vector<std::vector<int> > liberties;  ///< the empty hexgons next to each group
+  std::vector<unsigned char> edgemarks;  ///< the edges touched by each group, bit 1 for the first and bit 2 for the second edge
+  std::vector<int> counts;  ///< the number of finalized neighbors of each hexgon during search
+  std::vector<int> stamps;  ///< the last hexgon whose neighbors included each hexgon during search
+  std::vector<int> buckets[2];  ///< the hexgons finalized at the current and the next level during search
+
+  //Find the groups of the player and the empty hexgons next to them
+  bool findGroups(signed char owner, bool iswesttoeast);
+  //Compute the two-distances of the empty hexgons to an edge
+  void computeDistances(int edge, unsigned char edgemark,
+                        std::vector<int>& result);
+  //Visit the neighbors of a finalized hexgon
+  void visitNeighbors(int cell, int level, std::vector<int>& result);
+  //Count a finalized neighbor of the hexgon
+  void touch(int neighbor, int cell, int level, std::vector<int>& result);
+
+ public:
+  static const int INFINITE_DISTANCE = 1 << 16;  ///< the two-distance of a hexgon not connected to the edge
+
+  //User defined constructor which takes the tables of board
+  explicit TwoDistanceEvaluator(const BoardTopology& topology);
+  //Evaluate the game state given by the moves of both players
+  int evaluate(const std::vector<int>& babywatsons,
+               const std::vector<int>& opponents, bool isbabywatsonwesttoeast);
+  //Evaluate the game state advanced by the game tree
+  int evaluate(DescentState& state, bool isbabywatsonwesttoeast);
+  //Convert the potentials of the game state evaluated to the winning rate of AI player
+  double getWinningRate(bool isbabywatsontomove) const;
+  //Get the move priors of the empty hexgons in the game state evaluated
+  void getPriors(std::vector<int>& priors) const;
+  ///Get the potential of a player in the game state evaluated
+  ///@param isbabywatson is TRUE for AI player
+  ///@return the minimal sum of two-distances to both edges, INFINITE_DISTANCE if the player cannot connect
+  int getPotential(bool isbabywatson) const {
+    return potentials[isbabywatson];
+  }
+  ///Get the two-distance of an empty hexgon to an edge of a player in the game state evaluated
+  ///@param move is the position of hexgon starting from 1
+  ///@param isbabywatson is TRUE for AI player
+  ///@param isfirst is TRUE for the north or west edge, FALSE for the south or east edge
+  ///@return the two-distance, INFINITE_DISTANCE if the hexgon is occupied or not connected to the edge
+  int getDistance(int move, bool isbabywatson, bool isfirst) const {
+    return distances[isbabywatson * 2 + !isfirst][move - 1];
+  }
+};
+
+#endif /* TWODISTANCEEVALUATOR_H_ */
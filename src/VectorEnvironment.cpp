@@ -0,0 +1,154 @@
+/*
+ * VectorEnvironment.cpp
+ * This file defines the environment which steps many hex board games at once for self-play and reinforcement learning.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "Global.h"
+#include "HexBoard.h"
+#include "VectorEnvironment.h"
+
+#include <algorithm>
+
+using namespace std;
+
+const signed char VectorEnvironment::ILLEGAL;
+static const int WORDBITS = 64;  //the number of bits of a word of legal mask
+static const signed char EMPTYVALUE = static_cast<signed char>(hexgonValKind_EMPTY);
+static const signed char REDVALUE = static_cast<signed char>(hexgonValKind_RED);
+static const signed char BLUEVALUE = static_cast<signed char>(hexgonValKind_BLUE);
+
+///User defined constructor which takes the number of environments and the number of hexgons per side
+///@param numofenvs is the number of environments
+///@param numofhexgon is the number of hexgons per side
+VectorEnvironment::VectorEnvironment(std::size_t numofenvs, int numofhexgon)
+    : topology(HexBoard(numofhexgon)),
+      numofenvs(numofenvs),
+      numofvertices(numofhexgon * numofhexgon),
+      numofnodes(numofhexgon * numofhexgon + 4),
+      numofwords((numofhexgon * numofhexgon + WORDBITS - 1) / WORDBITS),
+      isautoreset(false),
+      boards(numofenvs * numofvertices),
+      parents(numofenvs * numofnodes),
+      masks(numofenvs * numofwords),
+      players(numofenvs),
+      winners(numofenvs),
+      emptymask(numofwords, 0) {
+  for (int i = 0; i < numofvertices; ++i)
+    emptymask[i / WORDBITS] |= static_cast<Word>(1) << (i % WORDBITS);
+  reset();
+}
+///Reset all environments to empty boards
+///@param NONE
+///@return NONE
+void VectorEnvironment::reset() {
+  for (size_t env = 0; env < numofenvs; ++env)
+    reset(env);
+}
+///Reset one environment to an empty board with RED to move
+///@param env is the index of environment
+///@return NONE
+void VectorEnvironment::reset(std::size_t env) {
+  fill(boards.begin() + env * numofvertices,
+       boards.begin() + (env + 1) * numofvertices, EMPTYVALUE);
+  int* forest = &parents[env * numofnodes];
+  for (int i = 0; i < numofnodes; ++i)
+    forest[i] = i;
+  copy(emptymask.begin(), emptymask.end(), masks.begin() + env * numofwords);
+  players[env] = REDVALUE;
+  winners[env] = 0;
+}
+///Apply one move to every environment
+///@param moves is the move of every environment, the index of hexgon starting from 1
+///@param results stores the result of every environment, see step(moves, results, first, last)
+///@return the number of illegal moves
+std::size_t VectorEnvironment::step(const int* moves, signed char* results) {
+  return step(moves, results, 0, numofenvs);
+}
+///Apply one move to the environments of a range for the players to move, e.g. to split a step among threads. The move of
+///a game which is over or onto an occupied or off-board hexgon is not applied
+///@param moves is the move of every environment, the index of hexgon starting from 1, indexed from environment 0
+///@param results stores the result of every environment of range: 0 when the game goes on, the winner when the move ends
+///the game and ILLEGAL when the move is not applied
+///@param first is the first environment of range
+///@param last is the environment past the last one of range
+///@return the number of illegal moves
+std::size_t VectorEnvironment::step(const int* moves, signed char* results,
+                                    std::size_t first, std::size_t last) {
+  size_t numofillegals = 0;
+  for (size_t env = first; env < last; ++env) {
+    results[env] = applyMove(env, moves[env]);
+    if (results[env] == ILLEGAL)
+      ++numofillegals;
+    else if (results[env] != 0 && isautoreset)
+      reset(env);
+  }
+  return numofillegals;
+}
+///Apply a move to one environment and join the sets of its neighbors of the same color, including the edges of the player
+///@param env is the index of environment
+///@param move is the index of hexgon starting from 1
+///@return the winner if the move ends the game, 0 if the game goes on, ILLEGAL if the move is not applied
+signed char VectorEnvironment::applyMove(std::size_t env, int move) {
+  signed char* board = &boards[env * numofvertices];
+  if (winners[env] != 0 || move < 1 || move > numofvertices
+      || board[move - 1] != EMPTYVALUE)
+    return ILLEGAL;
+  signed char player = players[env];
+  board[move - 1] = player;
+  masks[env * numofwords + (move - 1) / WORDBITS] &= ~(static_cast<Word>(1)
+      << ((move - 1) % WORDBITS));
+  players[env] = (player == REDVALUE) ? BLUEVALUE : REDVALUE;
+
+  //RED connects north to south and BLUE connects west to east
+  bool isred = (player == REDVALUE);
+  int* forest = &parents[env * numofnodes];
+  int root = findRoot(forest, move - 1);
+  const int* ring = topology.getRing(move);
+  for (int k = 0; k < BoardTopology::SIZEOFRING; ++k) {
+    int neighbor = ring[k];
+    int node;
+    if (neighbor > 0) {
+      if (board[neighbor - 1] != player)
+        continue;
+      node = neighbor - 1;
+    } else if (neighbor == BoardTopology::NORTH
+        || neighbor == BoardTopology::SOUTH) {
+      if (!isred)
+        continue;
+      node = numofvertices - neighbor - 1;
+    } else if (neighbor == BoardTopology::WEST
+        || neighbor == BoardTopology::EAST) {
+      if (isred)
+        continue;
+      node = numofvertices - neighbor - 1;
+    } else
+      continue;
+    int other = findRoot(forest, node);
+    if (other != root) {
+      forest[root] = other;
+      root = other;
+    }
+  }
+  int firstedge = numofvertices + (isred ? 0 : 2);
+  if (findRoot(forest, firstedge) == findRoot(forest, firstedge + 1)) {
+    winners[env] = player;
+    fill(masks.begin() + env * numofwords,
+         masks.begin() + (env + 1) * numofwords, 0);
+    return player;
+  }
+  return 0;
+}
+///Find the root of a node with path halving
+///@param forest is the disjoint-set forest of a board
+///@param node is the node
+///@return the root of the set of node
+int VectorEnvironment::findRoot(int* forest, int node) const {
+  while (forest[node] != node) {
+    forest[node] = forest[forest[node]];
+    node = forest[node];
+  }
+  return node;
+}
@@ -0,0 +1,136 @@
+/*
+ * VectorEnvironment.h
+ * This file declares the environment which steps many hex board games at once for self-play and reinforcement learning.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef VECTORENVIRONMENT_H_
+#define VECTORENVIRONMENT_H_
+
+#include <vector>
+#include <cstddef>
+
+#include "Global.h"
+#include "BoardTopology.h"
+
+#include <boost/cstdint.hpp>
+
+/**
+ * VectorEnvironment class holds many boards of the same size in contiguous arrays and applies one move to every board per
+ * call of step, without the per-game objects of Game, Player and HexBoard.<br/>
+ * The winner is checked incrementally: every board keeps a disjoint-set forest of its hexgons and four edges, a move joins
+ * the sets of its neighbors of the same color (see BoardTopology::getRing), hence a win is detected in nearly constant time
+ * instead of rebuilding the minimal spanning tree of the player.<br/>
+ * The arrays are laid out environment after environment and exposed as raw pointers for zero-copy access:<br/>
+ * boards: one int8 per hexgon with the value of hexgonValKind (EMPTY 0, BLUE 1, RED 2)<br/>
+ * legal masks: getNumofWords() 64-bit words per environment, the bit (move - 1) is set when the hexgon is empty and the game
+ * is not over<br/>
+ * players to move: one int8 per environment, RED moves first and the players alternate<br/>
+ * winners: one int8 per environment, 0 when the game is not over, otherwise the value of hexgonValKind of winner<br/>
+ * When auto reset is on, a game which ends in step is reset at the end of the same step, so its winner is only reported
+ * by that step.<br/>
+ * VectorEnvironment(std::size_t numofenvs, int numofhexgon): user defined constructor which takes the number of environments
+ * and the number of hexgons per side<br/>
+ * Sample Usage:<br/>
+ * VectorEnvironment envs(1024, 11);<br/>
+ * std::vector<int> moves(1024);<br/>
+ * std::vector<signed char> results(1024);<br/>
+ * //choose moves[i] among the bits of envs.getLegalMasks() + i * envs.getNumofWords()<br/>
+ * envs.step(&moves[0], &results[0]);<br/>
+ */
+class VectorEnvironment {
+ public:
+  typedef boost::uint64_t Word;  ///< the type of word of legal masks
+  static const signed char ILLEGAL = -1;  ///< the result of step for a move which is not applied
+
+ private:
+  BoardTopology topology;  ///< the neighbors of hexgons shared by all environments
+  const std::size_t numofenvs;  ///< the number of environments
+  const int numofvertices;  ///< the number of hexgons per board
+  const int numofnodes;  ///< the number of nodes of disjoint-set forest per board, the hexgons followed by four edges
+  const std::size_t numofwords;  ///< the number of words of legal mask per board
+  bool isautoreset;  ///< TRUE when a finished game is reset at the end of step
+  std::vector<signed char> boards;  ///< the values of hexgons of all boards
+  std::vector<int> parents;  ///< the disjoint-set forests of all boards
+  std::vector<Word> masks;  ///< the legal masks of all boards
+  std::vector<signed char> players;  ///< the player to move of all environments
+  std::vector<signed char> winners;  ///< the winner of all environments
+  std::vector<Word> emptymask;  ///< the legal mask of an empty board
+
+  //Find the root of a node with path halving
+  int findRoot(int* forest, int node) const;
+  //Apply a move to one environment
+  signed char applyMove(std::size_t env, int move);
+
+  ///Copy constructor which is not allowed
+  VectorEnvironment(const VectorEnvironment&);
+  ///Assignment operator which is not allowed
+  VectorEnvironment& operator=(const VectorEnvironment&);
+
+ public:
+  //User defined constructor which takes the number of environments and the number of hexgons per side
+  VectorEnvironment(std::size_t numofenvs, int numofhexgon);
+  virtual ~VectorEnvironment() {
+  }
+  //Reset all environments to empty boards
+  void reset();
+  //Reset one environment to an empty board
+  void reset(std::size_t env);
+  //Apply one move to every environment
+  std::size_t step(const int* moves, signed char* results);
+  //Apply one move to the environments of a range
+  std::size_t step(const int* moves, signed char* results, std::size_t first,
+                   std::size_t last);
+  ///Setter for resetting a game at the end of the step it ends
+  ///@param isautoreset is TRUE to reset the finished games automatically
+  ///@return NONE
+  void setAutoReset(bool isautoreset) {
+    this->isautoreset = isautoreset;
+  }
+  ///Get the number of environments
+  ///@param NONE
+  ///@return the number of environments
+  std::size_t getNumofEnvs() const {
+    return numofenvs;
+  }
+  ///Get the number of hexgons per side
+  ///@param NONE
+  ///@return the number of hexgons per side
+  int getNumofhexgons() const {
+    return topology.getNumofhexgons();
+  }
+  ///Get the number of words of legal mask per environment
+  ///@param NONE
+  ///@return the number of 64-bit words
+  std::size_t getNumofWords() const {
+    return numofwords;
+  }
+  ///Get the boards of all environments
+  ///@param NONE
+  ///@return the pointer to numofenvs x numofhexgon^2 values of hexgonValKind
+  const signed char* getBoards() const {
+    return boards.data();
+  }
+  ///Get the legal masks of all environments
+  ///@param NONE
+  ///@return the pointer to numofenvs x getNumofWords() words
+  const Word* getLegalMasks() const {
+    return masks.data();
+  }
+  ///Get the players to move of all environments
+  ///@param NONE
+  ///@return the pointer to numofenvs values of hexgonValKind
+  const signed char* getPlayers() const {
+    return players.data();
+  }
+  ///Get the winners of all environments
+  ///@param NONE
+  ///@return the pointer to numofenvs values of hexgonValKind, 0 when the game is not over
+  const signed char* getWinners() const {
+    return winners.data();
+  }
+};
+
+#endif /* VECTORENVIRONMENT_H_ */
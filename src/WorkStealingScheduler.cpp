@@ -0,0 +1,190 @@
+/*
+ * WorkStealingScheduler.cpp
+ * This file defines the scheduler of tasks which runs the tasks on a fixed set of workers, each with its own deque of tasks,
+ * and balances them by stealing.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#include "Global.h"
+#include "WorkStealingScheduler.h"
+
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/thread/locks.hpp>
+
+using namespace std;
+
+///User defined constructor which starts the given number of workers
+///@param numofworkers is the number of worker threads, at least one
+WorkStealingScheduler::WorkStealingScheduler(std::size_t numofworkers)
+    : numofqueued(0),
+      nextworker(0),
+      numofexecuted(0),
+      numofsteals(0),
+      isstopped(false) {
+  numofworkers = max(numofworkers, static_cast<size_t>(1));
+  for (size_t i = 0; i < numofworkers; ++i)
+    workers.push_back(hexgame::shared_ptr<Worker>(new Worker()));
+  for (size_t i = 0; i < numofworkers; ++i) {
+    threads.push_back(
+        hexgame::shared_ptr<boost::thread>(
+            new boost::thread(
+                boost::bind(&WorkStealingScheduler::run, this, i))));
+    threadids.push_back(threads.back()->get_id());
+  }
+}
+///destructor which finishes the submitted tasks of all groups and stops the workers
+WorkStealingScheduler::~WorkStealingScheduler() {
+  {
+    boost::lock_guard<boost::mutex> lock(sleepmutex);
+    isstopped.store(true);
+  }
+  wakeup.notify_all();
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i]->join();
+}
+///Submit a task counted by the given group. The task submitted by a worker goes to its own deque, otherwise the workers
+///receive the tasks in turn
+///@param task is the task to be run
+///@param group is the group counting the task which should outlive the task
+///@return NONE
+void WorkStealingScheduler::submit(const Task& task, TaskGroup& group) {
+  group.pending.fetch_add(1);
+  int indexofworker = getWorkerIndex();
+  size_t target =
+      (indexofworker >= 0) ?
+          static_cast<size_t>(indexofworker) :
+          nextworker.fetch_add(1) % workers.size();
+  {
+    boost::lock_guard<boost::mutex> lock(workers[target]->mutex);
+    workers[target]->tasks.push_back(make_pair(task, &group));
+  }
+  numofqueued.fetch_add(1);
+  //the idle workers check the number of queued tasks while holding the mutex, hence the wake up is not lost
+  {
+    boost::lock_guard<boost::mutex> lock(sleepmutex);
+  }
+  wakeup.notify_one();
+}
+///Submit a task which yields to the tasks already queued. The task deferred by a worker goes to the front of its own deque,
+///which the worker takes last, hence the slices of long running tasks on a worker take turns. Otherwise the same as submit
+///@param task is the task to be run
+///@param group is the group counting the task which should outlive the task
+///@return NONE
+void WorkStealingScheduler::defer(const Task& task, TaskGroup& group) {
+  int indexofworker = getWorkerIndex();
+  if (indexofworker < 0) {
+    submit(task, group);
+    return;
+  }
+  group.pending.fetch_add(1);
+  {
+    Worker& own = *workers[indexofworker];
+    boost::lock_guard<boost::mutex> lock(own.mutex);
+    own.tasks.push_front(make_pair(task, &group));
+  }
+  numofqueued.fetch_add(1);
+  {
+    boost::lock_guard<boost::mutex> lock(sleepmutex);
+  }
+  wakeup.notify_one();
+}
+///Wait until the tasks of the given group finish. A worker runs the tasks of any group meanwhile, hence the tasks waiting
+///for their subtasks never exhaust the workers
+///@param group is the group of tasks
+///@return NONE
+void WorkStealingScheduler::wait(TaskGroup& group) {
+  int indexofworker = getWorkerIndex();
+  if (indexofworker >= 0) {
+    Task task;
+    TaskGroup* other = NULL;
+    while (group.pending.load() > 0) {
+      if (take(static_cast<size_t>(indexofworker), task, other))
+        execute(task, other);
+      else
+        boost::this_thread::yield();
+    }
+    //the worker finishing the last task has left the group once its mutex is released
+    boost::lock_guard<boost::mutex> lock(group.mutex);
+    return;
+  }
+  boost::unique_lock<boost::mutex> guard(group.mutex);
+  while (group.pending.load() > 0)
+    group.done.wait(guard);
+}
+///The loop of worker thread which runs the tasks of its own deque, steals the tasks of others when its deque is empty and
+///sleeps when no task is queued. The worker exits when it is stopped and no task is left
+///@param indexofworker is the index of worker
+///@return NONE
+void WorkStealingScheduler::run(std::size_t indexofworker) {
+  Task task;
+  TaskGroup* group = NULL;
+  while (true) {
+    if (take(indexofworker, task, group)) {
+      execute(task, group);
+      continue;
+    }
+    boost::unique_lock<boost::mutex> guard(sleepmutex);
+    if (numofqueued.load() > 0)
+      continue;
+    if (isstopped.load())
+      break;
+    wakeup.wait(guard);
+  }
+}
+///Take a task from the back of own deque or else from the front of the deques of other workers
+///@param indexofworker is the index of worker
+///@param task stores the task taken
+///@param group stores the group of task taken
+///@return TRUE if a task is taken
+bool WorkStealingScheduler::take(std::size_t indexofworker, Task& task,
+                                 TaskGroup*& group) {
+  {
+    Worker& own = *workers[indexofworker];
+    boost::lock_guard<boost::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task.swap(own.tasks.back().first);
+      group = own.tasks.back().second;
+      own.tasks.pop_back();
+      numofqueued.fetch_sub(1);
+      return true;
+    }
+  }
+  for (size_t i = 1; i < workers.size(); ++i) {
+    Worker& victim = *workers[(indexofworker + i) % workers.size()];
+    boost::lock_guard<boost::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task.swap(victim.tasks.front().first);
+      group = victim.tasks.front().second;
+      victim.tasks.pop_front();
+      numofqueued.fetch_sub(1);
+      numofsteals.fetch_add(1);
+      return true;
+    }
+  }
+  return false;
+}
+///Run a task and finish it in its group, the waiters are notified when the last task of group finishes
+///@param task is the task to be run which is cleared afterwards
+///@param group is the group of task
+///@return NONE
+void WorkStealingScheduler::execute(Task& task, TaskGroup* group) {
+  task();
+  task.clear();
+  numofexecuted.fetch_add(1);
+  boost::lock_guard<boost::mutex> lock(group->mutex);
+  if (group->pending.fetch_sub(1) == 1)
+    group->done.notify_all();
+}
+///Get the worker of the calling thread
+///@param NONE
+///@return the index of worker, -1 if the calling thread is not a worker of this scheduler
+int WorkStealingScheduler::getWorkerIndex() const {
+  boost::thread::id id = boost::this_thread::get_id();
+  for (size_t i = 0; i < threadids.size(); ++i)
+    if (threadids[i] == id)
+      return static_cast<int>(i);
+  return -1;
+}
@@ -0,0 +1,154 @@
+/*
+ * WorkStealingScheduler.h
+ * This file declares the scheduler of tasks which runs the tasks on a fixed set of workers, each with its own deque of tasks,
+ * and balances them by stealing.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: renewang
+ */
+
+#ifndef WORKSTEALINGSCHEDULER_H_
+#define WORKSTEALINGSCHEDULER_H_
+
+#include <deque>
+#include <vector>
+
+#include "Global.h"
+
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+/**
+ * WorkStealingScheduler class runs tasks on a fixed set of worker threads.<br/>
+ * Every worker owns a deque of tasks. A task submitted by a worker, e.g. the subtasks of a running task, is pushed to the
+ * back of the deque of that worker and the other tasks are dealt to the workers in turn. A worker runs the tasks from the
+ * back of its own deque, and an idle worker steals from the front of the deques of others instead of waiting, hence a slow
+ * task only holds its own worker and no batch of tasks waits for the slowest one.<br/>
+ * The tasks are counted by TaskGroup. The tasks of independent searches or games are submitted to different groups and
+ * each waits only for its own. A worker waiting for a group runs other tasks in the meantime instead of blocking. The
+ * tasks should not throw.<br/>
+ * WorkStealingScheduler(std::size_t numofworkers): user defined constructor which starts the given number of workers<br/>
+ * Sample Usage:<br/>
+ * WorkStealingScheduler scheduler(8);<br/>
+ * WorkStealingScheduler::TaskGroup group;<br/>
+ * for (int i = 0; i < 2048; ++i)<br/>
+ *   scheduler.submit(boost::bind(&simulate, i), group);<br/>
+ * scheduler.wait(group);<br/>
+ * A long running task may instead run in slices, each deferring the next one (see defer), hence the other tasks queued on
+ * the same worker run in between.<br/>
+ */
+class WorkStealingScheduler {
+ public:
+  typedef boost::function<void()> Task;  ///< the type of task
+
+  /**
+   * TaskGroup is the count of unfinished tasks submitted with the group
+   */
+  class TaskGroup {
+   private:
+    hexgame::atomic<std::size_t> pending;  ///< the number of unfinished tasks
+    boost::mutex mutex;  ///< the mutex of finishing a task
+    boost::condition_variable done;  ///< notified when the last task finishes
+
+    ///Copy constructor which is not allowed
+    TaskGroup(const TaskGroup&);
+    ///Assignment operator which is not allowed
+    TaskGroup& operator=(const TaskGroup&);
+
+    friend class WorkStealingScheduler;
+
+   public:
+    ///Default constructor of the group without tasks
+    TaskGroup()
+        : pending(0) {
+    }
+    ;
+    ///Get the number of unfinished tasks
+    ///@param NONE
+    ///@return the number of tasks submitted with the group which are not finished
+    std::size_t getNumofPending() const {
+      return pending.load();
+    }
+  };
+
+ private:
+  /**
+   * Worker is the deque of tasks owned by one worker thread
+   */
+  struct Worker {
+    boost::mutex mutex;  ///< the mutex of deque
+    std::deque<std::pair<Task, TaskGroup*> > tasks;  ///< the tasks and their groups
+  };
+
+  std::vector<hexgame::shared_ptr<Worker> > workers;  ///< the deques of workers
+  std::vector<hexgame::shared_ptr<boost::thread> > threads;  ///< the threads of workers
+  std::vector<boost::thread::id> threadids;  ///< the ids of threads of workers to find the worker submitting a task
+  TaskGroup defaultgroup;  ///< the group of tasks submitted without group
+  hexgame::atomic<std::size_t> numofqueued;  ///< the number of tasks in the deques
+  hexgame::atomic<std::size_t> nextworker;  ///< the worker receiving the next task submitted by other threads
+  hexgame::atomic<std::size_t> numofexecuted;  ///< the number of finished tasks
+  hexgame::atomic<std::size_t> numofsteals;  ///< the number of tasks stolen from other workers
+  hexgame::atomic<bool> isstopped;  ///< TRUE when the workers should exit
+  boost::mutex sleepmutex;  ///< the mutex of idle workers
+  boost::condition_variable wakeup;  ///< notified when a task is submitted or the workers should exit
+
+  //The loop of worker thread
+  void run(std::size_t indexofworker);
+  //Take a task from the back of own deque or from the front of the deques of others
+  bool take(std::size_t indexofworker, Task& task, TaskGroup*& group);
+  //Run a task and finish it in its group
+  void execute(Task& task, TaskGroup* group);
+  //Get the worker of the calling thread
+  int getWorkerIndex() const;
+
+  ///Copy constructor which is not allowed
+  WorkStealingScheduler(const WorkStealingScheduler&);
+  ///Assignment operator which is not allowed
+  WorkStealingScheduler& operator=(const WorkStealingScheduler&);
+
+ public:
+  //User defined constructor which starts the given number of workers
+  explicit WorkStealingScheduler(std::size_t numofworkers);
+  //destructor which finishes the submitted tasks and stops the workers
+  virtual ~WorkStealingScheduler();
+  //Submit a task counted by the given group
+  void submit(const Task& task, TaskGroup& group);
+  ///Submit a task counted by the default group of scheduler
+  ///@param task is the task to be run
+  ///@return NONE
+  void submit(const Task& task) {
+    submit(task, defaultgroup);
+  }
+  //Submit a task which yields to the tasks already queued
+  void defer(const Task& task, TaskGroup& group);
+  //Wait until the tasks of the given group finish
+  void wait(TaskGroup& group);
+  ///Wait until the tasks submitted without group finish
+  ///@param NONE
+  ///@return NONE
+  void wait() {
+    wait(defaultgroup);
+  }
+  ///Get the number of workers
+  ///@param NONE
+  ///@return the number of worker threads
+  std::size_t getNumofWorkers() const {
+    return workers.size();
+  }
+  ///Get the number of finished tasks
+  ///@param NONE
+  ///@return the number of tasks finished since construction
+  std::size_t getNumofExecuted() const {
+    return numofexecuted.load();
+  }
+  ///Get the number of stolen tasks
+  ///@param NONE
+  ///@return the number of tasks run by a worker other than the one which received them
+  std::size_t getNumofSteals() const {
+    return numofsteals.load();
+  }
+};
+
+#endif /* WORKSTEALINGSCHEDULER_H_ */
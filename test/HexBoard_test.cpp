@@ -5,12 +5,16 @@
  *      Author: renewang
  */
 
+#include <vector>
+#include <cstdlib>
 #include <sstream>
+#include <algorithm>
 
 #include "Game.h"
 #include "Player.h"
 #include "HexBoard.h"
 #include "MinSpanTreeAlgo.h"
+#include "VectorEnvironment.h"
 
 #include "gtest/gtest.h"
 
@@ -387,6 +391,85 @@ TEST_F(HexBoardTest,HexBoardWinningTest3) {
   ASSERT_TRUE(hexboardgame.setMove(playerb, 2, 5));
   EXPECT_EQ("BLUE", hexboardgame.getWinner(playera, playerb));
 }
+TEST_F(HexBoardTest,VectorEnvironmentStep) {
+  const int numofhexgon = 5, numofvertices = numofhexgon * numofhexgon;
+  const size_t numofenvs = 16;
+  VectorEnvironment envs(numofenvs, numofhexgon);
+  EXPECT_EQ(1u, envs.getNumofWords());
+  EXPECT_EQ((static_cast<VectorEnvironment::Word>(1) << numofvertices) - 1,
+            envs.getLegalMasks()[0]);
+
+  //every environment plays its own random game, the winners agree with the players of the same game
+  vector<hexgame::shared_ptr<HexBoard> > boards;
+  vector<hexgame::shared_ptr<Player> > reds, blues;
+  vector<vector<int> > orders(numofenvs);
+  for (size_t i = 0; i < numofenvs; ++i) {
+    boards.push_back(hexgame::shared_ptr<HexBoard>(new HexBoard(numofhexgon)));
+    reds.push_back(
+        hexgame::shared_ptr<Player>(new Player(*boards[i], hexgonValKind_RED)));
+    blues.push_back(
+        hexgame::shared_ptr<Player>(new Player(*boards[i], hexgonValKind_BLUE)));
+    for (int j = 1; j <= numofvertices; ++j)
+      orders[i].push_back(j);
+    srand(static_cast<unsigned>(i + 1));
+    random_shuffle(orders[i].begin(), orders[i].end());
+  }
+  vector<int> moves(numofenvs);
+  vector<signed char> results(numofenvs);
+  vector<bool> isover(numofenvs, false);
+  for (int turn = 0; turn < numofvertices; ++turn) {
+    for (size_t i = 0; i < numofenvs; ++i)
+      moves[i] = orders[i][turn];
+    size_t numofillegals = envs.step(&moves[0], &results[0]);
+    size_t expected = 0;
+    for (size_t i = 0; i < numofenvs; ++i) {
+      if (isover[i]) {
+        ++expected;
+        EXPECT_EQ(VectorEnvironment::ILLEGAL, results[i]);
+        continue;
+      }
+      Player& player = (turn % 2 == 0) ? *reds[i] : *blues[i];
+      Game game(*boards[i]);
+      ASSERT_TRUE(
+          game.setMove(player, (moves[i] - 1) / numofhexgon + 1,
+                       (moves[i] - 1) % numofhexgon + 1));
+      EXPECT_EQ(static_cast<signed char>(player.getPlayerlabel()),
+                envs.getBoards()[i * numofvertices + moves[i] - 1]);
+      if (player.isArriveOpposite()) {
+        isover[i] = true;
+        EXPECT_EQ(static_cast<signed char>(player.getPlayerlabel()), results[i]);
+        EXPECT_EQ(results[i], envs.getWinners()[i]);
+        EXPECT_EQ(0u, envs.getLegalMasks()[i]);
+      } else {
+        EXPECT_EQ(0, results[i]);
+        EXPECT_EQ(0u,
+                  envs.getLegalMasks()[i]
+                      & (static_cast<VectorEnvironment::Word>(1)
+                          << (moves[i] - 1)));
+      }
+    }
+    EXPECT_EQ(expected, numofillegals);
+  }
+  for (size_t i = 0; i < numofenvs; ++i)
+    EXPECT_TRUE(isover[i]);
+
+  //the occupied hexgon is illegal and the finished game is reset at the end of its step
+  envs.reset();
+  envs.setAutoReset(true);
+  vector<int> column(numofenvs, 1);
+  EXPECT_EQ(0u, envs.step(&column[0], &results[0]));
+  EXPECT_EQ(numofenvs, envs.step(&column[0], &results[0]));
+  EXPECT_EQ(static_cast<signed char>(hexgonValKind_BLUE), envs.getPlayers()[0]);
+  for (int row = 1; row < numofhexgon; ++row) {
+    vector<int> blue(numofenvs, row + 1), red(numofenvs, row * numofhexgon + 1);
+    EXPECT_EQ(0u, envs.step(&blue[0], &results[0]));
+    EXPECT_EQ(0u, envs.step(&red[0], &results[0]));
+  }
+  EXPECT_EQ(static_cast<signed char>(hexgonValKind_RED), results[0]);
+  EXPECT_EQ(0, envs.getWinners()[0]);
+  EXPECT_EQ(static_cast<signed char>(hexgonValKind_EMPTY), envs.getBoards()[0]);
+  EXPECT_EQ(static_cast<signed char>(hexgonValKind_RED), envs.getPlayers()[0]);
+}
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
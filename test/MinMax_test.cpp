@@ -2,9 +2,12 @@
  * MinMax_test.cpp
  *
  */
+#include <set>
 #include <bitset>
+#include <cmath>
 #include <limits>
 #include <cstdlib>
+#include <sstream>
 #include <iostream>
 #include <algorithm>
 #include <functional>
@@ -15,6 +18,7 @@
 #include "Global.h"
 #include "Player.h"
 #include "GameTree.h"
+#include "ArgMaxChooser.h"
 #include "MonteCarloTreeSearch.h"
 #include "MultiMonteCarloTreeSearch.h"
 
@@ -214,8 +218,17 @@ TEST_F(MinMaxTest, MCSTSelection) {
     leaf = tree.expandNode(node, position);
     tree.updateNodefromSimulation(leaf, -1);
     cout << tree.printGameTree(0);
-    EXPECT_NE(firstchild, node);
+    //either the root is not fully expanded or one of the tied children is chosen
+    EXPECT_TRUE(node == 0 || tree.getNodeDepth(node) == 1);
   }
+  //the ties are broken at random, so more than one of the tied children is chosen
+  set<int> chosennodes;
+  for (unsigned i = 0; i < 100; ++i) {
+    result = tree.selectMaxBalanceNode(numofmoves - 1);
+    EXPECT_EQ(1u, tree.getNodeDepth(result.first));
+    chosennodes.insert(result.first);
+  }
+  EXPECT_LT(1u, chosennodes.size());
 }
 //test with expansion
 TEST_F(MinMaxTest,MCSTExpansion) {
@@ -573,6 +586,756 @@ TEST_F(MinMaxTest,SimulationCombine) {
   EXPECT_EQ(sum, numberoftrials);
   EXPECT_EQ(resultmove, gametree.getNodePosition(indexofmax));
 }
+TEST_F(MinMaxTest,GameTreeNodeBudget) {
+  int numofhexgon = 5;
+  HexBoard board(numofhexgon);
+  Player playerb(board, hexgonValKind_BLUE);  //west to east, 'X'
+  GameTree gametree(playerb.getViewLabel());
+  MonteCarloTreeSearch mcst(&board, &playerb);
+
+  size_t maxnumofnodes = 64;
+  gametree.setMaxNumofNodes(maxnumofnodes);
+  EXPECT_EQ(maxnumofnodes, gametree.getMaxNumofNodes());
+
+  int currentempty = board.getNumofemptyhexgons();
+  int numberoftrials = 3000;
+  hexgame::shared_ptr<bool> emptyglobal;
+  vector<int> bwglobal, oppglobal;
+  mcst.initGameState(emptyglobal, bwglobal, oppglobal);
+
+  for (int i = 0; i < numberoftrials; ++i) {
+    int proportionofempty = currentempty;
+    vector<int> babywatsons(bwglobal), opponents(oppglobal);
+    hexgame::shared_ptr<bool> emptyindicators = hexgame::shared_ptr<bool>(
+        new bool[board.getSizeOfVertices()], hexgame::default_delete<bool[]>());
+    copy(emptyglobal.get(), emptyglobal.get() + board.getSizeOfVertices(),
+         emptyindicators.get());
+
+    pair<int, int> selectresult = mcst.selection(currentempty, gametree);
+    int expandednode = mcst.expansion(selectresult, emptyindicators,
+                                      proportionofempty, babywatsons, opponents,
+                                      gametree);
+    int winner = mcst.playout(emptyindicators, proportionofempty, babywatsons,
+                              opponents);
+    mcst.backpropagation(expandednode, winner, gametree);
+    ASSERT_LE(gametree.getSizeofNodes(), maxnumofnodes);
+    ASSERT_EQ(gametree.getSizeofNodes() - 1, gametree.getSizeofEdges());
+  }
+  //the statistics of pruned subtrees are kept by their ancestors
+  EXPECT_EQ(numberoftrials,
+            gametree.getNodeValueFeature(0, AbstractUTCPolicy::visitcount));
+  int resultmove = mcst.getBestMove(gametree);
+  EXPECT_TRUE(resultmove > 0 && resultmove <= board.getSizeOfVertices());
+
+  //search through strategy with budget
+  MonteCarloTreeSearch budgetmcst(&board, &playerb, 1000);
+  budgetmcst.setMaxNumofNodes(maxnumofnodes);
+  EXPECT_EQ(maxnumofnodes, budgetmcst.getMaxNumofNodes());
+  int move = budgetmcst.genMove();
+  EXPECT_TRUE(move > 0 && move <= board.getSizeOfVertices());
+
+  gametree.clearAll();
+  EXPECT_EQ(1u, gametree.getSizeofNodes());
+}
+TEST_F(MinMaxTest,GameTreeSnapshotRoundTrip) {
+  int numofhexgon = 5;
+  HexBoard board(numofhexgon);
+  Player playerb(board, hexgonValKind_BLUE);  //west to east, 'X'
+  GameTree gametree(playerb.getViewLabel());
+  MonteCarloTreeSearch mcst(&board, &playerb);
+
+  int currentempty = board.getNumofemptyhexgons();
+  int numberoftrials = 1000, numberofmoretrials = 200;
+  hexgame::shared_ptr<bool> emptyglobal;
+  vector<int> bwglobal, oppglobal;
+  mcst.initGameState(emptyglobal, bwglobal, oppglobal);
+
+  GameTree restoredtree(playerb.getViewLabel());
+  for (int i = 0; i < numberoftrials + numberofmoretrials; ++i) {
+    //warm start the restored tree from the snapshot and keep on searching
+    GameTree& tree = (i < numberoftrials) ? gametree : restoredtree;
+    int proportionofempty = currentempty;
+    vector<int> babywatsons(bwglobal), opponents(oppglobal);
+    hexgame::shared_ptr<bool> emptyindicators = hexgame::shared_ptr<bool>(
+        new bool[board.getSizeOfVertices()], hexgame::default_delete<bool[]>());
+    copy(emptyglobal.get(), emptyglobal.get() + board.getSizeOfVertices(),
+         emptyindicators.get());
+
+    pair<int, int> selectresult = mcst.selection(currentempty, tree);
+    int expandednode = mcst.expansion(selectresult, emptyindicators,
+                                      proportionofempty, babywatsons, opponents,
+                                      tree);
+    int winner = mcst.playout(emptyindicators, proportionofempty, babywatsons,
+                              opponents);
+    mcst.backpropagation(expandednode, winner, tree);
+
+    if (i == numberoftrials - 1) {
+      stringstream snapshot;
+      ASSERT_TRUE(gametree.saveGameTree(snapshot));
+      EXPECT_EQ(24 + 16 * gametree.getSizeofNodes(), snapshot.str().size());
+      ASSERT_TRUE(restoredtree.loadGameTree(snapshot));
+
+      EXPECT_EQ(gametree.getSizeofNodes(), restoredtree.getSizeofNodes());
+      EXPECT_EQ(gametree.getSizeofEdges(), restoredtree.getSizeofEdges());
+      EXPECT_EQ(numberoftrials,
+                restoredtree.getNodeValueFeature(0, AbstractUTCPolicy::visitcount));
+      EXPECT_EQ(gametree.getNodeValueFeature(0, AbstractUTCPolicy::wincount),
+                restoredtree.getNodeValueFeature(0, AbstractUTCPolicy::wincount));
+      EXPECT_EQ(
+          gametree.getNodePosition(gametree.getBestMovefromSimulation().first),
+          restoredtree.getNodePosition(
+              restoredtree.getBestMovefromSimulation().first));
+      //the snapshot of restored tree is identical
+      stringstream resnapshot;
+      ASSERT_TRUE(restoredtree.saveGameTree(resnapshot));
+      EXPECT_EQ(snapshot.str(), resnapshot.str());
+    }
+  }
+  EXPECT_EQ(numberoftrials + numberofmoretrials,
+            restoredtree.getNodeValueFeature(0, AbstractUTCPolicy::visitcount));
+  EXPECT_EQ(restoredtree.getSizeofNodes() - 1, restoredtree.getSizeofEdges());
+
+  //a truncated or corrupted snapshot leaves the tree unchanged
+  stringstream snapshot;
+  ASSERT_TRUE(restoredtree.saveGameTree(snapshot));
+  size_t sizeofnodes = restoredtree.getSizeofNodes();
+  stringstream truncated(snapshot.str().substr(0, snapshot.str().size() - 8));
+  EXPECT_FALSE(restoredtree.loadGameTree(truncated));
+  string corruptedstr = snapshot.str();
+  corruptedstr[0] = 'X';
+  stringstream corrupted(corruptedstr);
+  EXPECT_FALSE(restoredtree.loadGameTree(corrupted));
+  EXPECT_EQ(sizeofnodes, restoredtree.getSizeofNodes());
+  EXPECT_EQ(numberoftrials + numberofmoretrials,
+            restoredtree.getNodeValueFeature(0, AbstractUTCPolicy::visitcount));
+}
+TEST_F(MinMaxTest,UTCTableCalculate) {
+  //the table and fall back values should follow the UTC equation, value + sqrt(2 * ln(parent visits) / visits)
+  int visitcounts[] = { 1, 2, 3, 17, 100, 4095, 4096, 4097, 100000 };
+  int sizeofcounts = sizeof(visitcounts) / sizeof(visitcounts[0]);
+  for (int i = 0; i < sizeofcounts; ++i) {
+    EXPECT_NEAR(std::log(static_cast<double>(visitcounts[i])),
+                UTCTable::log(visitcounts[i]), 1e-12);
+    EXPECT_NEAR(1.0 / std::sqrt(static_cast<double>(visitcounts[i])),
+                UTCTable::invsqrt(visitcounts[i]), 1e-12);
+    for (int j = 0; j <= i; ++j) {
+      UTCPolicy parent, child;
+      parent.update(AbstractUTCPolicy::visitcount, visitcounts[i]);
+      child.update(AbstractUTCPolicy::visitcount, visitcounts[j]);
+      child.update(AbstractUTCPolicy::wincount, visitcounts[j] / 3);
+      double expected = static_cast<double>(visitcounts[j] / 3)
+          / visitcounts[j]
+          + std::sqrt(2.0 * std::log(static_cast<double>(visitcounts[i]))
+                  / visitcounts[j]);
+      EXPECT_NEAR(expected, child.calculate(parent), 1e-12);
+      EXPECT_NEAR(
+          expected,
+          child.calculate(UTCTable::explorationTerm(parent.getCoefficient(),
+                                                    visitcounts[i])),
+          1e-12);
+      EXPECT_NEAR(expected, child.getBalance(), 1e-12);
+    }
+  }
+}
+TEST_F(MinMaxTest,ArgMaxChooserTie) {
+  ArgMaxChooser chooser(12345);
+  double scores[] = { 0.5, 0.9, 0.1, 0.9, -1.0, 0.9, 0.3 };
+  size_t sizeofscores = sizeof(scores) / sizeof(scores[0]);
+  for (size_t i = 0; i < sizeofscores; ++i)
+    chooser.insert(100 + i, scores[i]);
+  ASSERT_EQ(sizeofscores, chooser.size());
+  //without breaking ties, the first maximum is chosen
+  EXPECT_EQ(1u, chooser.argmax(false));
+  EXPECT_EQ(101u, chooser.chooseMax(false));
+  EXPECT_DOUBLE_EQ(0.9, chooser.getScore(chooser.argmax(false)));
+
+  //the ties are chosen uniformly
+  int counts[3] = { 0, 0, 0 };
+  int numoftrials = 3000;
+  for (int i = 0; i < numoftrials; ++i) {
+    size_t chosen = chooser.chooseMax(true);
+    ASSERT_TRUE(chosen == 101 || chosen == 103 || chosen == 105);
+    ++counts[(chosen - 101) / 2];
+  }
+  for (int i = 0; i < 3; ++i)
+    EXPECT_NEAR(numoftrials / 3, counts[i], numoftrials / 10);
+
+  //the cleared chooser is reused
+  chooser.clear();
+  EXPECT_TRUE(chooser.empty());
+  chooser.insert(7, -2.0);
+  EXPECT_EQ(7u, chooser.chooseMax(true));
+}
+TEST_F(MinMaxTest,MCSTDescentState) {
+  int numofhexgon = 5;
+  HexBoard board(numofhexgon);
+  Player playera(board, hexgonValKind_RED);  //north to south, 'O'
+  Player playerb(board, hexgonValKind_BLUE);  //west to east, 'X'
+  Game hexboardgame(board);
+  hexboardgame.setMove(playerb, 1, 1);
+  hexboardgame.setMove(playera, 3, 3);
+  GameTree gametree(playera.getViewLabel());
+  MonteCarloTreeSearch mcst(&board, &playera);
+
+  hexgame::shared_ptr<bool> emptyinit;
+  vector<int> bwinit, oppinit;
+  mcst.initGameState(emptyinit, bwinit, oppinit);
+  int initempty = board.getNumofemptyhexgons();
+
+  DescentState state;
+  int numoftrials = 4 * initempty, firstchild = -1;
+  for (int i = 0; i < numoftrials; ++i) {
+    state.reset(emptyinit, board.getSizeOfVertices(), bwinit, oppinit);
+    ASSERT_EQ(initempty, state.getNumofEmpty());
+
+    pair<int, int> selectresult = mcst.selection(initempty, gametree, state);
+    //the state is the game state of the selected node
+    ASSERT_EQ(initempty - selectresult.second, state.getNumofEmpty());
+    int expandedchild = mcst.expansion(selectresult, state, gametree);
+    ASSERT_EQ(initempty - selectresult.second - 1, state.getNumofEmpty());
+    if (firstchild < 0)
+      firstchild = expandedchild;
+
+    //the moves applied to the state are the moves on the path of the tree
+    vector<int> babywatsons(bwinit), opponents(oppinit);
+    hexgame::unordered_set<int> remainingmoves;
+    for (int j = 0; j < board.getSizeOfVertices(); ++j)
+      if (emptyinit.get()[j])
+        remainingmoves.insert(j + 1);
+    gametree.getMovesfromTreeState(expandedchild, babywatsons, opponents,
+                                   remainingmoves);
+    int move = static_cast<int>(gametree.getNodePosition(expandedchild));
+    remainingmoves.erase(move);
+    sort(babywatsons.begin(), babywatsons.end());
+    sort(opponents.begin(), opponents.end());
+    vector<int> bwstate(state.getBabywatsons()), oppstate(state.getOpponents());
+    sort(bwstate.begin(), bwstate.end());
+    sort(oppstate.begin(), oppstate.end());
+    ASSERT_EQ(babywatsons, bwstate);
+    ASSERT_EQ(opponents, oppstate);
+    for (int j = 1; j <= board.getSizeOfVertices(); ++j)
+      ASSERT_EQ(remainingmoves.count(j) != 0, state.isEmpty(j));
+
+    int winner = mcst.playout(state.getEmptyIndicators(),
+                              state.getNumofEmpty(), state.getBabywatsons(),
+                              state.getOpponents());
+    ASSERT_NE(0, winner);
+    mcst.backpropagation(expandedchild, winner, gametree);
+  }
+  //root is fully expanded without repeating moves
+  vector<size_t> children = gametree.getSiblings(firstchild);
+  set<size_t> moves;
+  moves.insert(gametree.getNodePosition(firstchild));
+  for (size_t j = 0; j < children.size(); ++j)
+    moves.insert(gametree.getNodePosition(children[j]));
+  EXPECT_EQ(static_cast<size_t>(initempty), children.size() + 1);
+  EXPECT_EQ(static_cast<size_t>(initempty), moves.size());
+}
+TEST_F(MinMaxTest,MCSTProgressiveWidening) {
+  ProgressiveWidening disabled, schedule(2.0, 0.5);
+  EXPECT_FALSE(disabled.isEnabled());
+  EXPECT_EQ(10, disabled.getWidth(100, 10));
+  EXPECT_TRUE(schedule.isEnabled());
+  EXPECT_EQ(2, schedule.getWidth(0, 10));
+  EXPECT_EQ(4, schedule.getWidth(4, 10));
+  EXPECT_EQ(10, schedule.getWidth(100, 10));
+
+  int numofhexgon = 7;
+  HexBoard board(numofhexgon);
+  Player playera(board, hexgonValKind_RED);  //north to south, 'O'
+  Player playerb(board, hexgonValKind_BLUE);  //west to east, 'X'
+  Game hexboardgame(board);
+  hexboardgame.setMove(playerb, 4, 4);
+  GameTree gametree(playera.getViewLabel());
+  gametree.setProgressiveWidening(schedule);
+  MonteCarloTreeSearch mcst(&board, &playera);
+
+  hexgame::shared_ptr<bool> emptyinit;
+  vector<int> bwinit, oppinit;
+  mcst.initGameState(emptyinit, bwinit, oppinit);
+  int initempty = board.getNumofemptyhexgons();
+
+  DescentState state;
+  state.setNeighborTable(&mcst.neighbortable);
+  int numoftrials = 200, maxlevel = 0, firstchild = -1;
+  for (int i = 0; i < numoftrials; ++i) {
+    state.reset(emptyinit, board.getSizeOfVertices(), bwinit, oppinit);
+    pair<int, int> selectresult = mcst.selection(initempty, gametree, state);
+    maxlevel = max(maxlevel, selectresult.second);
+    int expandedchild = mcst.expansion(selectresult, state, gametree);
+    if (firstchild < 0)
+      firstchild = expandedchild;
+    int winner = mcst.playout(state.getEmptyIndicators(),
+                              state.getNumofEmpty(), state.getBabywatsons(),
+                              state.getOpponents());
+    mcst.backpropagation(expandedchild, winner, gametree);
+  }
+  //the first expanded move has the highest prior, i.e. next to the only stone on board
+  vector<int> neighbors = board.getNeighbors((4 - 1) * numofhexgon + 4);
+  EXPECT_NE(
+      neighbors.end(),
+      find(neighbors.begin(), neighbors.end(),
+           static_cast<int>(gametree.getNodePosition(firstchild))));
+  //the root only has as many children as its visit count allows, so the tree goes deeper than without widening which
+  //never selects beyond the first level in the same number of trials
+  size_t numofchildren = gametree.getSiblings(firstchild).size() + 1;
+  EXPECT_LE(static_cast<int>(numofchildren),
+            schedule.getWidth(numoftrials, initempty));
+  EXPECT_LT(static_cast<int>(numofchildren), initempty);
+  EXPECT_GE(maxlevel, 2);
+
+  //the shared tree of parallel search is widened in the same way
+  MultiMonteCarloTreeSearch multimcst(&board, &playera, 4, 256);
+  multimcst.setProgressiveWidening(schedule);
+  int move = hexboardgame.genMove(multimcst);
+  ASSERT_GT(move, 0);
+  EXPECT_TRUE(emptyinit.get()[move - 1]);
+}
+TEST_F(MinMaxTest,MCSTRaveStatistics) {
+  //the AMAF winning rate is blended with weight sqrt(k / (3n + k))
+  UTCPolicy policy;
+  policy.update(AbstractUTCPolicy::visitcount, 4);
+  policy.update(AbstractUTCPolicy::wincount, 1);
+  EXPECT_NEAR(0.25, policy.calculate(0.0, 12.0), 1e-12);  //no AMAF statistics yet
+  policy.update(AbstractUTCPolicy::amafvisitcount, 10);
+  policy.update(AbstractUTCPolicy::amafwincount, 8);
+  EXPECT_NEAR(0.25, policy.calculate(0.0, 0.0), 1e-12);  //RAVE is disabled
+  double beta = std::sqrt(12.0 / (3.0 * 4 + 12.0));
+  EXPECT_NEAR((1.0 - beta) * 0.25 + beta * 0.8, policy.calculate(0.0, 12.0),
+              1e-12);
+  EXPECT_NEAR(policy.getValue() + 1.0 / 2.0, policy.calculate(1.0, 12.0),
+              1e-12);
+
+  int numofhexgon = 3;
+  HexBoard board(numofhexgon);
+  Player playera(board, hexgonValKind_RED);  //north to south, 'O'
+  GameTree gametree(playera.getViewLabel());
+  gametree.setRaveEquivalence(100.0);
+  EXPECT_DOUBLE_EQ(100.0, gametree.getRaveEquivalence());
+  MonteCarloTreeSearch mcst(&board, &playera);
+  mcst.setRaveEquivalence(100.0);
+
+  hexgame::shared_ptr<bool> emptyinit;
+  vector<int> bwinit, oppinit;
+  mcst.initGameState(emptyinit, bwinit, oppinit);
+  int initempty = board.getNumofemptyhexgons();
+
+  DescentState state;
+  int numoftrials = 64, firstchild = -1, numofaimoves = 0;
+  for (int i = 0; i < numoftrials; ++i) {
+    state.reset(emptyinit, board.getSizeOfVertices(), bwinit, oppinit);
+    pair<int, int> selectresult = mcst.selection(initempty, gametree, state);
+    int expandedchild = mcst.expansion(selectresult, state, gametree);
+    if (firstchild < 0)
+      firstchild = expandedchild;
+    int winner = mcst.playout(state.getEmptyIndicators(),
+                              state.getNumofEmpty(), state.getBabywatsons(),
+                              state.getOpponents());
+    mcst.backpropagation(expandedchild, winner, gametree, state);
+    numofaimoves += static_cast<int>(state.getBabywatsons().size());
+  }
+  //every move of AI player in a simulated game is counted once for the existing children of root, hence AMAF statistics
+  //are collected for a child in every simulated game it is played
+  vector<size_t> children = gametree.getSiblings(firstchild);
+  children.push_back(firstchild);
+  ASSERT_EQ(static_cast<size_t>(initempty), children.size());
+  int sumofamafvisits = 0;
+  for (size_t j = 0; j < children.size(); ++j) {
+    int visits = gametree.getNodeValueFeature(children[j],
+                                              AbstractUTCPolicy::visitcount);
+    int amafvisits = gametree.getNodeValueFeature(
+        children[j], AbstractUTCPolicy::amafvisitcount);
+    int amafwins = gametree.getNodeValueFeature(
+        children[j], AbstractUTCPolicy::amafwincount);
+    EXPECT_GE(amafvisits, visits);
+    EXPECT_GE(amafwins, 0);
+    EXPECT_LE(amafwins, amafvisits);
+    sumofamafvisits += amafvisits;
+  }
+  //only the first simulated games, which are played while root is being expanded, miss the children not expanded yet
+  EXPECT_LE(sumofamafvisits, numofaimoves);
+  EXPECT_GE(sumofamafvisits,
+            numofaimoves - initempty * static_cast<int>(state.getBabywatsons().size()));
+
+  //the shared tree of parallel search collects AMAF statistics in the same way
+  Game hexboardgame(board);
+  MultiMonteCarloTreeSearch multimcst(&board, &playera, 4, 256);
+  multimcst.setRaveEquivalence(100.0);
+  int move = hexboardgame.genMove(multimcst);
+  ASSERT_GT(move, 0);
+  EXPECT_TRUE(emptyinit.get()[move - 1]);
+}
+TEST_F(MinMaxTest,MCSTPatternPlayout) {
+  int numofhexgon = 5;
+  HexBoard board(numofhexgon);
+  Player playera(board, hexgonValKind_RED);  //north to south, 'O'
+  BoardTopology topology(board);
+  //every entry is a pattern around the indexed carrier: both ends and the other carrier are adjacent to it
+  for (int carrier = 1; carrier <= board.getSizeOfVertices(); ++carrier)
+    for (const BoardTopology::Intrusion* entry = topology.beginIntrusions(
+        carrier); entry != topology.endIntrusions(carrier); ++entry) {
+      EXPECT_TRUE(board.isAdjacent(carrier, entry->response));
+      EXPECT_TRUE(board.isAdjacent(carrier, entry->first));
+      EXPECT_TRUE(board.isAdjacent(entry->response, entry->first));
+      if (entry->second > 0) {
+        EXPECT_TRUE(board.isAdjacent(carrier, entry->second));
+        EXPECT_TRUE(board.isAdjacent(entry->response, entry->second));
+        EXPECT_FALSE(board.isAdjacent(entry->first, entry->second));
+      } else {
+        EXPECT_TRUE(topology.isOnEdge(carrier, entry->second));
+        EXPECT_TRUE(topology.isOnEdge(entry->response, entry->second));
+        EXPECT_FALSE(topology.isOnEdge(entry->first, entry->second));
+      }
+    }
+  //each interior hexgon has six bridges
+  set<int> partners;
+  for (int carrier = 1; carrier <= board.getSizeOfVertices(); ++carrier)
+    for (const BoardTopology::Intrusion* entry = topology.beginIntrusions(
+        carrier); entry != topology.endIntrusions(carrier); ++entry)
+      if (entry->first == 13 && entry->second > 0)
+        partners.insert(entry->second);
+      else if (entry->second == 13)
+        partners.insert(entry->first);
+  EXPECT_EQ(6u, partners.size());
+
+  //the intrusion into bridge (7, 13) or the north edge template of 7 is answered by the other carrier
+  MonteCarloTreeSearch mcst(&board, &playera);
+  hexgame::shared_ptr<bool> emptyinit;
+  vector<int> bwinit, oppinit;
+  mcst.initGameState(emptyinit, bwinit, oppinit);
+  DescentState state;
+  state.reset(emptyinit, board.getSizeOfVertices(), bwinit, oppinit);
+  state.play(7, true);
+  state.play(13, true);
+  state.play(8, false);
+  EXPECT_EQ(8, state.getLastMove());
+  PatternPlayout policy(mcst.topology);
+  policy.reset(state, playera.getWestToEastCondition());
+  EXPECT_EQ(0, policy.getResponse(false, 8));
+  EXPECT_EQ(12, policy.genMove(state, true, 8));
+  state.play(2, false);
+  policy.reset(state, playera.getWestToEastCondition());
+  EXPECT_EQ(3, policy.genMove(state, true, 2));
+  //the opponent connects west to east, so only the east edge template of 19 is its connection but not the north one of 9
+  state.play(19, false);
+  state.play(9, false);
+  state.play(15, true);
+  policy.reset(state, playera.getWestToEastCondition());
+  EXPECT_EQ(20, policy.getResponse(false, 15));
+  state.play(4, true);
+  policy.reset(state, playera.getWestToEastCondition());
+  EXPECT_EQ(0, policy.getResponse(false, 4));
+
+  //play-out by the pattern policy fills up the board
+  GameTree gametree(playera.getViewLabel());
+  mcst.setPatternPlayout(true);
+  EXPECT_TRUE(mcst.isPatternPlayout());
+  int initempty = board.getNumofemptyhexgons();
+  for (int i = 0; i < 32; ++i) {
+    state.reset(emptyinit, board.getSizeOfVertices(), bwinit, oppinit);
+    pair<int, int> selectresult = mcst.selection(initempty, gametree, state);
+    int expandedchild = mcst.expansion(selectresult, state, gametree);
+    int winner = mcst.playout(state, policy);
+    EXPECT_TRUE(winner == 1 || winner == -1);
+    EXPECT_EQ(0, state.getNumofEmpty());
+    EXPECT_EQ(
+        static_cast<size_t>(board.getSizeOfVertices()),
+        state.getBabywatsons().size() + state.getOpponents().size());
+    mcst.backpropagation(expandedchild, winner, gametree, state);
+  }
+
+  //the play-out starts with the player to move, hence the intrusion of AI move into the bridge (7, 13) of opponent which
+  //ends the selected path is answered by the opponent at the other carrier
+  for (int i = 0; i < 32; ++i) {
+    state.reset(emptyinit, board.getSizeOfVertices(), bwinit, oppinit);
+    state.play(7, false);
+    state.play(13, false);
+    state.play(8, true);
+    ASSERT_FALSE(state.isBabywatsonToMove());
+    mcst.playout(state, policy);
+    vector<int>& opponents = state.getOpponents();
+    EXPECT_NE(opponents.end(), find(opponents.begin(), opponents.end(), 12));
+  }
+
+  //the threads of parallel search own their policies
+  Game hexboardgame(board);
+  MultiMonteCarloTreeSearch multimcst(&board, &playera, 4, 256);
+  multimcst.setPatternPlayout(true);
+  int move = hexboardgame.genMove(multimcst);
+  ASSERT_GT(move, 0);
+  EXPECT_TRUE(emptyinit.get()[move - 1]);
+  move = hexboardgame.genMove(mcst);
+  ASSERT_GT(move, 0);
+  EXPECT_TRUE(emptyinit.get()[move - 1]);
+}
+TEST_F(MinMaxTest,MCSTInferiorCells) {
+  int numofhexgon = 5;
+  HexBoard board(numofhexgon);
+  Player playera(board, hexgonValKind_RED);  //north to south, 'O'
+  Game hexboardgame(board);
+  //the ring of 13 is 14, 9, 8, 12, 17, 18 and AI player owns three consecutive of them
+  hexboardgame.setMove(playera, 3, 4);
+  hexboardgame.setMove(playera, 2, 4);
+  hexboardgame.setMove(playera, 2, 3);
+  MonteCarloTreeSearch mcst(&board, &playera);
+  EXPECT_EQ(40u, mcst.topology.getNumofBridges());
+
+  hexgame::shared_ptr<bool> emptyinit;
+  vector<int> bwinit, oppinit;
+  mcst.initGameState(emptyinit, bwinit, oppinit);
+  InferiorCellAnalysis analysis(mcst.topology);
+  analysis.analyze(emptyinit, bwinit, oppinit,
+                   playera.getWestToEastCondition());
+  //13 is not dead yet but killed by AI player at 12 or 18, so it is inferior for the opponent only
+  EXPECT_FALSE(analysis.isDead(13));
+  const vector<int>& inferiors = analysis.getInferiorMoves(false);
+  EXPECT_NE(inferiors.end(), find(inferiors.begin(), inferiors.end(), 13));
+  EXPECT_EQ(inferiors.end(), find(inferiors.begin(), inferiors.end(), 12));
+  const vector<int>& aiinferiors = analysis.getInferiorMoves(true);
+  EXPECT_EQ(aiinferiors.end(),
+            find(aiinferiors.begin(), aiinferiors.end(), 13));
+  //3 and 4 next to the north edge are captured by AI player: an intrusion into one is answered by the other
+  vector<int> filled = analysis.getFilledMoves(true);
+  sort(filled.begin(), filled.end());
+  ASSERT_EQ(2u, filled.size());
+  EXPECT_EQ(3, filled[0]);
+  EXPECT_EQ(4, filled[1]);
+  EXPECT_TRUE(analysis.getFilledMoves(false).empty());
+
+  //the candidates of state exclude the inferior moves of the player to move
+  int initempty = board.getNumofemptyhexgons();
+  EXPECT_EQ(2, analysis.fill(emptyinit, bwinit, oppinit));
+  DescentState state;
+  state.reset(emptyinit, board.getSizeOfVertices(), bwinit, oppinit);
+  analysis.apply(state);
+  EXPECT_TRUE(state.isBabywatsonToMove());
+  EXPECT_EQ(initempty - 2 - static_cast<int>(aiinferiors.size()),
+            state.getNumofCandidates());
+  EXPECT_TRUE(state.isCandidate(13));
+  state.play(25, true);
+  EXPECT_FALSE(state.isBabywatsonToMove());
+  EXPECT_EQ(initempty - 3 - static_cast<int>(inferiors.size()),
+            state.getNumofCandidates());
+  EXPECT_FALSE(state.isCandidate(13));
+  EXPECT_TRUE(state.isCandidate(12));
+
+  //once AI player owns 12 as well, 13 is dead and filled
+  hexboardgame.setMove(playera, 3, 2);
+  mcst.initGameState(emptyinit, bwinit, oppinit);
+  analysis.analyze(emptyinit, bwinit, oppinit,
+                   playera.getWestToEastCondition());
+  EXPECT_TRUE(analysis.isDead(13));
+  const vector<int>& deads = analysis.getFilledMoves(false);
+  EXPECT_NE(deads.end(), find(deads.begin(), deads.end(), 13));
+
+  //the search never plays a filled or an inferior move at root
+  mcst.setInferiorPruning(true);
+  EXPECT_TRUE(mcst.isInferiorPruning());
+  MultiMonteCarloTreeSearch multimcst(&board, &playera, 4, 256);
+  multimcst.setInferiorPruning(true);
+  for (int k = 0; k < 2; ++k) {
+    int move =
+        (k == 0) ?
+            hexboardgame.genMove(mcst) : hexboardgame.genMove(multimcst);
+    ASSERT_GT(move, 0);
+    EXPECT_TRUE(emptyinit.get()[move - 1]);
+    EXPECT_EQ(deads.end(), find(deads.begin(), deads.end(), move));
+    const vector<int>& captured = analysis.getFilledMoves(true);
+    EXPECT_EQ(captured.end(), find(captured.begin(), captured.end(), move));
+    const vector<int>& pruned = analysis.getInferiorMoves(true);
+    EXPECT_EQ(pruned.end(), find(pruned.begin(), pruned.end(), move));
+  }
+}
+TEST_F(MinMaxTest,MCSTVirtualConnections) {
+  int numofhexgon = 5;
+  HexBoard board(numofhexgon);
+  Player playera(board, hexgonValKind_RED);  //north to south, 'O'
+  Player playerb(board, hexgonValKind_BLUE);  //west to east, 'X'
+  Game hexboardgame(board);
+  //8 reaches the north edge by 3 and 4, 17 reaches the south edge by 21 and 22 and they are bridged by 12 and 13
+  hexboardgame.setMove(playera, 2, 3);
+  hexboardgame.setMove(playera, 4, 2);
+  MonteCarloTreeSearch mcst(&board, &playera);
+
+  hexgame::shared_ptr<bool> emptyinit;
+  vector<int> bwinit, oppinit;
+  mcst.initGameState(emptyinit, bwinit, oppinit);
+  vector<signed char> colors(board.getSizeOfVertices(), 0);
+  for (size_t i = 0; i < bwinit.size(); ++i)
+    colors[bwinit[i] - 1] = 1;
+  HSearch connections(mcst.topology, playera.getWestToEastCondition());
+  connections.build(colors);
+  EXPECT_TRUE(connections.isConnected());
+  const vector<HSearch::Connection>* fulls = connections.getConnections(8, 17,
+                                                                        true);
+  ASSERT_TRUE(fulls != NULL);
+  bool isbridged = false;
+  for (size_t i = 0; i < fulls->size(); ++i)
+    isbridged = isbridged
+        || ((*fulls)[i].carrier.count() == 2 && (*fulls)[i].carrier[11]
+            && (*fulls)[i].carrier[12]);
+  EXPECT_TRUE(isbridged);
+
+  //the intrusion into the bridge leaves a semi connection between the edges which is won at 13
+  hexboardgame.setMove(playerb, 3, 2);
+  connections.play(12, false);
+  colors[11] = -1;
+  EXPECT_FALSE(connections.isConnected());
+  EXPECT_EQ(13, connections.getWinningMove());
+  HSearch rebuilt(mcst.topology, playera.getWestToEastCondition());
+  rebuilt.build(colors);
+  EXPECT_FALSE(rebuilt.isConnected());
+  EXPECT_EQ(connections.getWinningMove(), rebuilt.getWinningMove());
+  vector<int> region;
+  EXPECT_TRUE(connections.getMustPlay(region));
+  EXPECT_NE(region.end(), find(region.begin(), region.end(), 13));
+
+  //AI player plays the winning move without simulation
+  mcst.setVCSearch(true);
+  EXPECT_TRUE(mcst.isVCSearch());
+  EXPECT_EQ(13, hexboardgame.genMove(mcst));
+  EXPECT_DOUBLE_EQ(1.0, mcst.getLastWinningRate());
+  MultiMonteCarloTreeSearch multimcst(&board, &playera, 4, 256);
+  multimcst.setVCSearch(true);
+  EXPECT_EQ(13, hexboardgame.genMove(multimcst));
+
+  //the opponent of AI player only plays in the must-play region at root
+  MonteCarloTreeSearch bluemcst(&board, &playerb, 256);
+  bluemcst.setVCSearch(true);
+  int move = hexboardgame.genMove(bluemcst);
+  EXPECT_NE(region.end(), find(region.begin(), region.end(), move));
+  DescentState state;
+  state.reset(emptyinit, board.getSizeOfVertices(), bwinit, oppinit);
+  state.setRootRegion(region);
+  EXPECT_EQ(static_cast<int>(region.size()), state.getNumofCandidates());
+  EXPECT_FALSE(state.isCandidate(1));
+  state.play(region[0], true);
+  EXPECT_TRUE(state.isCandidate(1));
+}
+TEST_F(MinMaxTest,MCSTTwoDistance) {
+  int numofhexgon = 5;
+  HexBoard board(numofhexgon);
+  Player playera(board, hexgonValKind_RED);  //north to south, 'O'
+  Game hexboardgame(board);
+  MonteCarloTreeSearch mcst(&board, &playera, 256);
+  TwoDistanceEvaluator evaluator(mcst.topology);
+  vector<int> babywatsons, opponents;
+
+  //on the empty board the shortest paths of both players are the short diagonal
+  EXPECT_EQ(0, evaluator.evaluate(babywatsons, opponents, false));
+  EXPECT_EQ(6, evaluator.getPotential(true));
+  EXPECT_EQ(6, evaluator.getPotential(false));
+  EXPECT_EQ(3, evaluator.getDistance(13, true, true));
+  EXPECT_EQ(3, evaluator.getDistance(13, true, false));
+  EXPECT_EQ(1, evaluator.getDistance(1, false, true));
+  vector<int> priors;
+  evaluator.getPriors(priors);
+  EXPECT_EQ(2 * numofhexgon, priors[12]);
+  EXPECT_EQ(2 * numofhexgon, priors[20]);
+  EXPECT_LT(priors[0], priors[12]);
+  EXPECT_DOUBLE_EQ(1.0 / (1.0 + exp(-0.5)), evaluator.getWinningRate(true));
+
+  //the stone at center shortens the paths of AI player and lengthens the ones of the opponent
+  babywatsons.push_back(13);
+  EXPECT_EQ(2, evaluator.evaluate(babywatsons, opponents, false));
+  EXPECT_EQ(5, evaluator.getPotential(true));
+  EXPECT_EQ(TwoDistanceEvaluator::INFINITE_DISTANCE,
+            evaluator.getDistance(13, true, true));
+  //a group joining the edges wins
+  int joined[] = { 3, 8, 18, 23 };
+  babywatsons.insert(babywatsons.end(), joined, joined + 4);
+  evaluator.evaluate(babywatsons, opponents, false);
+  EXPECT_EQ(0, evaluator.getPotential(true));
+  EXPECT_DOUBLE_EQ(1.0, evaluator.getWinningRate(false));
+
+  //the priors are used at root only
+  evaluator.evaluate(vector<int>(), vector<int>(), false);
+  evaluator.getPriors(priors);
+  hexgame::shared_ptr<bool> emptyinit;
+  vector<int> bwinit, oppinit;
+  mcst.initGameState(emptyinit, bwinit, oppinit);
+  DescentState state;
+  state.setNeighborTable(&mcst.neighbortable);
+  state.setRootPriors(&priors);
+  state.reset(emptyinit, board.getSizeOfVertices(), bwinit, oppinit);
+  EXPECT_EQ(2 * numofhexgon, state.getPrior(13));
+  state.play(12, true);
+  EXPECT_EQ(1, state.getPrior(13));
+
+  //the fast mode evaluates every simulated game instead of playing it out
+  mcst.setEvaluationRate(1.0);
+  mcst.setTwoDistancePrior(true);
+  EXPECT_DOUBLE_EQ(1.0, mcst.getEvaluationRate());
+  EXPECT_TRUE(mcst.isTwoDistancePrior());
+  MultiMonteCarloTreeSearch multimcst(&board, &playera, 4, 256);
+  multimcst.setEvaluationRate(1.0);
+  multimcst.setTwoDistancePrior(true);
+  for (int k = 0; k < 2; ++k) {
+    int move =
+        (k == 0) ?
+            hexboardgame.genMove(mcst) : hexboardgame.genMove(multimcst);
+    ASSERT_GT(move, 0);
+    EXPECT_TRUE(emptyinit.get()[move - 1]);
+  }
+  EXPECT_GT(mcst.getLastWinningRate(), 0.0);
+}
+TEST_F(MinMaxTest,MCSTResistance) {
+  int numofhexgon = 5;
+  HexBoard board(numofhexgon);
+  Player playera(board, hexgonValKind_RED);  //north to south, 'O'
+  Game hexboardgame(board);
+  MonteCarloTreeSearch mcst(&board, &playera, 256);
+  ResistanceEvaluator evaluator(mcst.topology);
+  vector<int> babywatsons, opponents;
+
+  //both players have the same resistance on the empty board and the current is the highest at center
+  EXPECT_NEAR(0.0, evaluator.evaluate(babywatsons, opponents, false), 1e-6);
+  EXPECT_NEAR(evaluator.getResistance(false), evaluator.getResistance(true),
+              1e-6);
+  EXPECT_GT(evaluator.getNumofIterations(), 0);
+  EXPECT_GT(evaluator.getCurrent(13, true), evaluator.getCurrent(1, true));
+  vector<int> priors;
+  evaluator.getPriors(priors);
+  EXPECT_GT(priors[12], priors[0]);
+  //the same game state is solved by the initial guess
+  evaluator.evaluate(babywatsons, opponents, false);
+  EXPECT_EQ(0, evaluator.getNumofIterations());
+
+  //the solution warm started from the last move agrees with the one from scratch
+  babywatsons.push_back(13);
+  opponents.push_back(12);
+  double score = evaluator.evaluate(babywatsons, opponents, false);
+  ResistanceEvaluator coldevaluator(mcst.topology);
+  EXPECT_NEAR(coldevaluator.evaluate(babywatsons, opponents, false), score,
+              1e-6);
+  EXPECT_DOUBLE_EQ(0.0, evaluator.getCurrent(12, true));
+  babywatsons.pop_back();
+  babywatsons.push_back(8);
+  opponents.clear();
+  EXPECT_GT(evaluator.evaluate(babywatsons, opponents, false), 0.0);
+  //a group joining the edges leaves no path to the opponent
+  int joined[] = { 3, 13, 18, 23 };
+  babywatsons.insert(babywatsons.end(), joined, joined + 4);
+  evaluator.evaluate(babywatsons, opponents, false);
+  EXPECT_DOUBLE_EQ(ResistanceEvaluator::INFINITE_RESISTANCE,
+                   evaluator.getResistance(false));
+  EXPECT_LT(evaluator.getResistance(true), 1.0);
+
+  //the priors of both evaluators order the moves at root
+  mcst.setResistancePrior(true);
+  mcst.setTwoDistancePrior(true);
+  EXPECT_TRUE(mcst.isResistancePrior());
+  MultiMonteCarloTreeSearch multimcst(&board, &playera, 4, 256);
+  multimcst.setResistancePrior(true);
+  for (int k = 0; k < 2; ++k) {
+    int move =
+        (k == 0) ?
+            hexboardgame.genMove(mcst) : hexboardgame.genMove(multimcst);
+    ASSERT_GT(move, 0);
+    EXPECT_TRUE(board.getEmptyHexIndicators().get()[move - 1]);
+  }
+  EXPECT_TRUE(mcst.resistanceevaluator != NULL);
+}
 TEST_F(MinMaxTest,CheckEndofGame) {
   int numofhexgon = 5;
   AbstractStrategy* bluestrategy;
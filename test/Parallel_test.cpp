@@ -14,14 +14,33 @@
 #include "LockableGameTree.h"
 #include "MockLockableUTCPolicy.h"
 #include "MultiMonteCarloTreeSearch.h"
+#include "PipelinedMonteCarloTreeSearch.h"
+#include "GameTree.h"
+#include "MPMCQueue.h"
+#include "SearchWorker.h"
+#include "ClusterMonteCarloTreeSearch.h"
+#include "SharedTranspositionTable.h"
+#include "PositionHash.h"
+#include "NumaTopology.h"
+#include "WorkStealingScheduler.h"
+#include "AsyncSearch.h"
+#include "BatchGameEngine.h"
+#include "GameServer.h"
+#include "TournamentRunner.h"
 
 #include <set>
 #include <vector>
+#include <sstream>
+#include <fstream>
 #include <iostream>
 #include <algorithm>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
 
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/thread.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
 #include <boost/thread/strict_lock.hpp>
 
 using namespace std;
@@ -196,6 +215,56 @@ void SimulationTask(int currentempty, LockableGameTree& gametree,
   int winner = rand() % 2;
   gametree.updateNodefromSimulation(indexofchild, winner);
 }
+//push the elements of a range into the queue, retry when it is full
+void ProduceElements(MPMCQueue<int>& queue, int first, int numofelements) {
+  for (int i = first; i < first + numofelements;)
+    if (queue.tryPush(i))
+      ++i;
+    else
+      boost::this_thread::yield();
+}
+//pop the elements from the queue and count each of them until every element is popped
+void ConsumeElements(MPMCQueue<int>& queue,
+                     vector<hexgame::atomic<int>*>& counts,
+                     hexgame::atomic<int>& numofpopped, int numofelements) {
+  while (numofpopped.load() < numofelements) {
+    int element;
+    if (queue.tryPop(element)) {
+      counts[element]->fetch_add(1);
+      numofpopped.fetch_add(1);
+    } else
+      boost::this_thread::yield();
+  }
+}
+//count one finished task
+void CountTask(hexgame::atomic<int>& count) {
+  count.fetch_add(1);
+}
+//submit the subtasks to the deque of the running worker, hold it for a while and wait for the subtasks
+void SpawnSubtasks(WorkStealingScheduler& scheduler, hexgame::atomic<int>& count,
+                   int numofsubtasks) {
+  WorkStealingScheduler::TaskGroup group;
+  for (int i = 0; i < numofsubtasks; ++i)
+    scheduler.submit(boost::bind(&CountTask, boost::ref(count)), group);
+  boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+  scheduler.wait(group);
+  EXPECT_EQ(0u, group.getNumofPending());
+}
+//generate the move of a search sharing the scheduler with other searches
+void GenerateMove(MultiMonteCarloTreeSearch& mcst, int& move) {
+  move = mcst.genMove();
+}
+//run the event loop of server until it is stopped
+void ServeGames(GameServer& server, size_t& numofcommands) {
+  numofcommands = server.serve();
+}
+//read one response of server, the lines until an empty line
+string ReadResponse(istream& in) {
+  string response, line;
+  while (getline(in, line) && !line.empty())
+    response += (response.empty() ? "" : "\n") + line;
+  return response;
+}
 //create value-parameterized tests, test with numberoftrials (equivalently number of threads)
 class ParallelTest : public ::testing::Test {
   virtual void SetUp() {
@@ -476,6 +545,750 @@ TEST_F(ParallelTest, ThreadIterativeGame) {
     }
   }
 }
+TEST_F(ParallelTest, ThreadNodeBudget) {
+  LockableGameTree gametree('B');
+  HexBoard board(numofhexgon);
+  hexgame::shared_ptr<bool> emptyglobal = board.getEmptyHexIndicators();
+  numberofthreads = 4;
+  size_t maxnumofnodes = 32;
+  gametree.setMaxNumofNodes(maxnumofnodes);
+  EXPECT_EQ(maxnumofnodes, gametree.getMaxNumofNodes());
+
+  for (size_t j = 0; j < (numberoftrials / numberofthreads); ++j) {
+    thread_group threads;
+    for (size_t i = 0; i < numberofthreads; ++i)
+      threads.create_thread(
+          boost::bind(&SimulationTask, currentempty, boost::ref(gametree),
+                      boost::ref(board), boost::ref(emptyglobal)));
+    threads.join_all();
+    //the nodes in use by other threads are never pruned, hence allow the paths of working threads
+    ASSERT_LE(gametree.getSizeofNodes(), maxnumofnodes + numberofthreads);
+    ASSERT_EQ(gametree.getSizeofNodes() - 1, gametree.getSizeofEdges());
+  }
+  //all simulations are still counted at root
+  EXPECT_EQ(numberoftrials,
+            gametree.getNodeValueFeature(0, AbstractUTCPolicy::visitcount));
+  vector<size_t> leaves = gametree.getLeaves();
+  for (vector<size_t>::iterator iter = leaves.begin(); iter != leaves.end();
+      ++iter) {
+    EXPECT_TRUE(gametree.getIsupdated(*iter));
+    EXPECT_TRUE(gametree.getIsupdatedBackpropagation(*iter));
+  }
+}
+TEST_F(ParallelTest, ThreadSnapshotRoundTrip) {
+  LockableGameTree gametree('B'), restoredtree('B');
+  HexBoard board(numofhexgon);
+  hexgame::shared_ptr<bool> emptyglobal = board.getEmptyHexIndicators();
+  numberofthreads = 4;
+  size_t numberofrounds = 64;
+
+  for (size_t j = 0; j < 2 * numberofrounds; ++j) {
+    //warm start the restored tree from the snapshot and keep on searching
+    LockableGameTree& tree = (j < numberofrounds) ? gametree : restoredtree;
+    thread_group threads;
+    for (size_t i = 0; i < numberofthreads; ++i)
+      threads.create_thread(
+          boost::bind(&SimulationTask, currentempty, boost::ref(tree),
+                      boost::ref(board), boost::ref(emptyglobal)));
+    threads.join_all();
+
+    if (j == numberofrounds - 1) {
+      stringstream snapshot;
+      ASSERT_TRUE(gametree.saveGameTree(snapshot));
+      ASSERT_TRUE(restoredtree.loadGameTree(snapshot));
+      EXPECT_EQ(gametree.getSizeofNodes(), restoredtree.getSizeofNodes());
+      EXPECT_EQ(restoredtree.getSizeofNodes() - 1, restoredtree.getSizeofEdges());
+      EXPECT_EQ(gametree.getNodeValueFeature(0, AbstractUTCPolicy::visitcount),
+                restoredtree.getNodeValueFeature(0, AbstractUTCPolicy::visitcount));
+      stringstream resnapshot;
+      ASSERT_TRUE(restoredtree.saveGameTree(resnapshot));
+      EXPECT_EQ(snapshot.str(), resnapshot.str());
+    }
+  }
+  EXPECT_EQ(2 * numberofrounds * numberofthreads,
+            restoredtree.getNodeValueFeature(0, AbstractUTCPolicy::visitcount));
+  vector<size_t> leaves = restoredtree.getLeaves();
+  for (vector<size_t>::iterator iter = leaves.begin(); iter != leaves.end();
+      ++iter) {
+    EXPECT_TRUE(restoredtree.getIsupdated(*iter));
+    EXPECT_TRUE(restoredtree.getIsupdatedBackpropagation(*iter));
+  }
+}
+TEST_F(ParallelTest, ThreadMPMCQueue) {
+  //each element pushed by the producers is popped by the consumers exactly once
+  MPMCQueue<int> queue(8);
+  EXPECT_EQ(8u, queue.getCapacity());
+  int element;
+  EXPECT_FALSE(queue.tryPop(element));
+  for (int i = 0; i < 8; ++i)
+    EXPECT_TRUE(queue.tryPush(i));
+  EXPECT_FALSE(queue.tryPush(8));
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_TRUE(queue.tryPop(element));
+    EXPECT_EQ(i, element);
+  }
+
+  const int numofproducers = 4, numofconsumers = 4, numofelements = 20000;
+  vector<hexgame::atomic<int>*> counts;
+  for (int i = 0; i < numofproducers * numofelements; ++i)
+    counts.push_back(new hexgame::atomic<int>(0));
+  hexgame::atomic<int> numofpopped(0);
+  thread_group threads;
+  for (int i = 0; i < numofproducers; ++i)
+    threads.create_thread(boost::bind(&ProduceElements, boost::ref(queue),
+                                      i * numofelements, numofelements));
+  for (int i = 0; i < numofconsumers; ++i)
+    threads.create_thread(
+        boost::bind(&ConsumeElements, boost::ref(queue), boost::ref(counts),
+                    boost::ref(numofpopped), numofproducers * numofelements));
+  threads.join_all();
+  EXPECT_EQ(numofproducers * numofelements, numofpopped.load());
+  for (size_t i = 0; i < counts.size(); ++i) {
+    EXPECT_EQ(1, counts[i]->load());
+    delete counts[i];
+  }
+}
+TEST_F(ParallelTest, ThreadPipelinedSearch) {
+  //the virtual visits are removed without trace
+  GameTree gametree('B');
+  int child = gametree.expandNode(0, 1, 'B');
+  int grandchild = gametree.expandNode(child, 2);
+  gametree.updateNodefromSimulation(grandchild, -1);
+  int rootvisits = gametree.getNodeValueFeature(0, AbstractUTCPolicy::visitcount);
+  gametree.updateVirtualVisits(grandchild, 3);
+  EXPECT_EQ(rootvisits + 3,
+            gametree.getNodeValueFeature(0, AbstractUTCPolicy::visitcount));
+  EXPECT_EQ(rootvisits + 3,
+            gametree.getNodeValueFeature(grandchild, AbstractUTCPolicy::visitcount));
+  gametree.updateVirtualVisits(grandchild, -3);
+  EXPECT_EQ(rootvisits,
+            gametree.getNodeValueFeature(0, AbstractUTCPolicy::visitcount));
+
+  //a virtual visit is a loss for the opponent choosing among the nodes of root color, hence the equal sibling is selected
+  GameTree opponenttree('B');
+  int children[3];
+  for (int i = 0; i < 3; ++i)
+    children[i] = opponenttree.expandNode(0, i + 1, 'B');
+  int opponentchildren[2];
+  for (int i = 0; i < 2; ++i) {
+    opponentchildren[i] = opponenttree.expandNode(children[0], i + 4);
+    for (int j = 0; j < 10; ++j)
+      opponenttree.updateNodefromSimulation(opponentchildren[i], j % 2 ? 1 : -1);
+  }
+  for (int i = 1; i < 3; ++i)
+    for (int j = 0; j < 10; ++j)
+      opponenttree.updateNodefromSimulation(children[i], -1);
+  opponenttree.updateVirtualVisits(opponentchildren[0], 1);
+  EXPECT_EQ(-6, opponenttree.getNodeValueFeature(opponentchildren[0],
+                                                 AbstractUTCPolicy::wincount));
+  EXPECT_EQ(opponentchildren[1], opponenttree.selectMaxBalanceNode(3, false).first);
+  opponenttree.updateVirtualVisits(opponentchildren[0], -1);
+  EXPECT_EQ(-5, opponenttree.getNodeValueFeature(opponentchildren[0],
+                                                 AbstractUTCPolicy::wincount));
+
+  //the move found by the tree thread and workers is an empty hexgon
+  numofhexgon = 5;
+  HexBoard board(numofhexgon);
+  Player playera(board, hexgonValKind_RED);  //north to south, 'O'
+  Player playerb(board, hexgonValKind_BLUE);  //west to east, 'X'
+  Game hexboardgame(board);
+  hexboardgame.setMove(playerb, 3, 3);
+  PipelinedMonteCarloTreeSearch pipelinedmcst(&board, &playera, 4, 2000);
+  EXPECT_EQ(4u, pipelinedmcst.getNumberofworkers());
+  pipelinedmcst.setPatternPlayout(true);
+  int move = pipelinedmcst.genMove();
+  ASSERT_TRUE(move > 0 && move <= board.getSizeOfVertices());
+  EXPECT_TRUE(board.getEmptyHexIndicators().get()[move - 1]);
+  EXPECT_GT(pipelinedmcst.getLastWinningRate(), 0.0);
+}
+TEST_F(ParallelTest, ThreadSearchCluster) {
+  //the messages survive the round trip
+  SearchWorker::SearchRequest request;
+  request.numofhexgon = 5;
+  request.tomove = hexgonValKind_RED;
+  request.numberoftrials = 300;
+  request.redmoves.push_back(7);
+  request.bluemoves.push_back(13);
+  request.bluemoves.push_back(1);
+  stringstream message;
+  SearchWorker::writeRequest(message, request);
+  SearchWorker::SearchRequest readrequest;
+  ASSERT_TRUE(SearchWorker::readRequest(message, readrequest));
+  EXPECT_EQ(request.numofhexgon, readrequest.numofhexgon);
+  EXPECT_EQ(request.tomove, readrequest.tomove);
+  EXPECT_EQ(request.numberoftrials, readrequest.numberoftrials);
+  EXPECT_EQ(request.redmoves, readrequest.redmoves);
+  EXPECT_EQ(request.bluemoves, readrequest.bluemoves);
+  stringstream malformed("search 5 R 300 1 26 0");
+  EXPECT_FALSE(SearchWorker::readRequest(malformed, readrequest));
+  stringstream error("error illegal game state\n");
+  vector<MonteCarloTreeSearch::RootStatistics> statistics;
+  EXPECT_FALSE(SearchWorker::readStatistics(error, statistics));
+  string path, host, port;
+  EXPECT_TRUE(SearchWorker::parseEndpoint("127.0.0.1:7000", path, host, port));
+  EXPECT_EQ("127.0.0.1", host);
+  EXPECT_EQ("7000", port);
+  EXPECT_FALSE(SearchWorker::parseEndpoint("localhost", path, host, port));
+
+  //the worker processes search the game state of coordinator independently
+  numofhexgon = 5;
+  HexBoard board(numofhexgon);
+  Player playera(board, hexgonValKind_RED);  //north to south, 'O'
+  Player playerb(board, hexgonValKind_BLUE);  //west to east, 'X'
+  Game hexboardgame(board);
+  hexboardgame.setMove(playerb, 3, 3);
+  const size_t numofworkers = 3, numberoftrials = 500;
+  vector<string> endpoints;
+  vector<hexgame::shared_ptr<SearchWorker> > workers;
+  vector<pid_t> pids;
+  for (size_t i = 0; i < numofworkers; ++i) {
+    stringstream endpoint;
+    endpoint << "unix:/tmp/hexworker_" << getpid() << "_" << i << ".sock";
+    endpoints.push_back(endpoint.str());
+    workers.push_back(
+        hexgame::shared_ptr<SearchWorker>(new SearchWorker(endpoint.str())));
+    ASSERT_TRUE(workers.back()->isListening());
+    pid_t pid = fork();
+    ASSERT_NE(-1, pid);
+    if (pid == 0)
+      _exit(workers.back()->serve(1) == 1 ? 0 : 1);
+    pids.push_back(pid);
+  }
+  endpoints.push_back("unix:/tmp/hexworker_missing.sock");
+  ClusterMonteCarloTreeSearch cluster(&board, &playera, endpoints,
+                                      numberoftrials);
+  int move = cluster.genMove();
+  ASSERT_TRUE(move > 0 && move <= board.getSizeOfVertices());
+  EXPECT_TRUE(board.getEmptyHexIndicators().get()[move - 1]);
+  EXPECT_EQ(numofworkers, cluster.getNumofAnswers());
+  int sumofvisits = 0, maxvisits = 0;
+  for (size_t i = 0; i < cluster.getLastRootStatistics().size(); ++i) {
+    const MonteCarloTreeSearch::RootStatistics& merged =
+        cluster.getLastRootStatistics()[i];
+    EXPECT_LE(merged.wincount, merged.visitcount);
+    sumofvisits += merged.visitcount;
+    if (merged.move == move)
+      maxvisits = merged.visitcount;
+  }
+  EXPECT_EQ(static_cast<int>(numofworkers * numberoftrials), sumofvisits);
+  for (size_t i = 0; i < cluster.getLastRootStatistics().size(); ++i)
+    EXPECT_LE(cluster.getLastRootStatistics()[i].visitcount, maxvisits);
+  for (size_t i = 0; i < pids.size(); ++i) {
+    int status;
+    ASSERT_EQ(pids[i], waitpid(pids[i], &status, 0));
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  }
+
+  //the coordinator searches by itself without workers
+  ClusterMonteCarloTreeSearch alone(&board, &playera,
+                                    vector<string>(1, "unix:/tmp/hexworker_missing.sock"),
+                                    numberoftrials);
+  move = alone.genMove();
+  EXPECT_TRUE(move > 0 && move <= board.getSizeOfVertices());
+  EXPECT_EQ(0u, alone.getNumofAnswers());
+
+  //a worker which accepts but never answers is given up when the time limit passes, and the search of coordinator itself
+  //stops at the same deadline however many simulated games it is given
+  stringstream hungendpoint;
+  hungendpoint << "unix:/tmp/hexworker_hung_" << getpid() << ".sock";
+  SearchWorker hungworker(hungendpoint.str());
+  ASSERT_TRUE(hungworker.isListening());
+  ClusterMonteCarloTreeSearch stalled(&board, &playera,
+                                      vector<string>(1, hungendpoint.str()),
+                                      1 << 24);
+  EXPECT_EQ(60000u, stalled.getTimeLimit());
+  stalled.setTimeLimit(500);
+  hexgame::chrono::steady_clock::time_point start =
+      hexgame::chrono::steady_clock::now();
+  move = stalled.genMove();
+  EXPECT_LT(hexgame::chrono::duration_cast<hexgame::chrono::milliseconds>(
+      hexgame::chrono::steady_clock::now() - start).count(), 2500);
+  EXPECT_TRUE(move > 0 && move <= board.getSizeOfVertices());
+  EXPECT_EQ(0u, stalled.getNumofAnswers());
+}
+TEST_F(ParallelTest, ThreadSharedTranspositionTable) {
+  stringstream name;
+  name << "hexgame_tt_test_" << getpid();
+  SharedTranspositionTable::remove(name.str());
+  SharedTranspositionTable table(name.str(), 1 << 14);
+  ASSERT_TRUE(table.isAttached());
+  EXPECT_EQ(static_cast<size_t>(1 << 14), table.getNumofEntries());
+
+  //an entry is replaced only by the one with at least as many simulated games
+  SharedTranspositionTable::Entry entry;
+  EXPECT_FALSE(table.probe(12345, entry));
+  EXPECT_TRUE(table.store(12345, 100, 60, 7));
+  ASSERT_TRUE(table.probe(12345, entry));
+  EXPECT_EQ(100, entry.visitcount);
+  EXPECT_EQ(60, entry.wincount);
+  EXPECT_EQ(7, entry.move);
+  EXPECT_FALSE(table.store(12345, 50, 40, 8));
+  EXPECT_TRUE(table.store(12345, 200, 80, 9));
+  ASSERT_TRUE(table.probe(12345, entry));
+  EXPECT_EQ(9, entry.move);
+  EXPECT_TRUE(table.store(54321, SharedTranspositionTable::MAXVISITCOUNT * 2,
+                          SharedTranspositionTable::MAXVISITCOUNT, 3));
+  ASSERT_TRUE(table.probe(54321, entry));
+  EXPECT_EQ(SharedTranspositionTable::MAXVISITCOUNT, entry.visitcount);
+  EXPECT_EQ(SharedTranspositionTable::MAXVISITCOUNT / 2, entry.wincount);
+
+  //the entries stored by other processes attached to the same table are read without any message
+  const int numofprocesses = 3, numofkeys = 500;
+  vector<pid_t> pids;
+  for (int p = 0; p < numofprocesses; ++p) {
+    pid_t pid = fork();
+    ASSERT_NE(-1, pid);
+    if (pid == 0) {
+      SharedTranspositionTable attached(name.str(), 1);
+      bool isstored = attached.isAttached();
+      for (int i = 0; i < numofkeys && isstored; ++i) {
+        boost::uint64_t key = PositionHash::cellKey(11, p * numofkeys + i + 1,
+                                                    hexgonValKind_RED);
+        isstored = attached.store(key, i + 1, i / 2, p + 1);
+      }
+      _exit(isstored ? 0 : 1);
+    }
+    pids.push_back(pid);
+  }
+  for (size_t i = 0; i < pids.size(); ++i) {
+    int status;
+    ASSERT_EQ(pids[i], waitpid(pids[i], &status, 0));
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  }
+  int numoffound = 0;
+  for (int p = 0; p < numofprocesses; ++p)
+    for (int i = 0; i < numofkeys; ++i)
+      if (table.probe(PositionHash::cellKey(11, p * numofkeys + i + 1,
+                                            hexgonValKind_RED), entry)) {
+        EXPECT_EQ(i + 1, entry.visitcount);
+        EXPECT_EQ(i / 2, entry.wincount);
+        EXPECT_EQ(p + 1, entry.move);
+        ++numoffound;
+      }
+  //only the entries evicted from full buckets are missing
+  EXPECT_GT(numoffound, numofprocesses * numofkeys * 9 / 10);
+
+  //the search stores its result and the next search of the same position reads it
+  numofhexgon = 5;
+  HexBoard board(numofhexgon);
+  Player playera(board, hexgonValKind_RED);  //north to south, 'O'
+  Player playerb(board, hexgonValKind_BLUE);  //west to east, 'X'
+  Game hexboardgame(board);
+  hexboardgame.setMove(playerb, 3, 3);
+  MonteCarloTreeSearch mcst(&board, &playera, 500);
+  mcst.setTranspositionTable(&table);
+  int move = mcst.genMove();
+  boost::uint64_t key = PositionHash::hashBoard(board, hexgonValKind_RED);
+  ASSERT_TRUE(table.probe(key, entry));
+  EXPECT_EQ(move, entry.move);
+  EXPECT_EQ(500, entry.visitcount);
+  MonteCarloTreeSearch othermcst(&board, &playera, 500);
+  othermcst.setTranspositionTable(&table);
+  EXPECT_EQ(move, othermcst.genMove());
+  ASSERT_EQ(1u, othermcst.getLastRootStatistics().size());
+  EXPECT_EQ(500, othermcst.getLastRootStatistics()[0].visitcount);
+  EXPECT_TRUE(SharedTranspositionTable::remove(name.str()));
+}
+TEST_F(ParallelTest, ThreadNumaPlacement) {
+  vector<int> cpus;
+  ASSERT_TRUE(NumaTopology::parseCpuList("0-3,8,10-11\n", cpus));
+  int expectedcpus[] = { 0, 1, 2, 3, 8, 10, 11 };
+  EXPECT_EQ(vector<int>(expectedcpus, expectedcpus + 7), cpus);
+  EXPECT_FALSE(NumaTopology::parseCpuList("3-1", cpus));
+  EXPECT_FALSE(NumaTopology::parseCpuList("0-", cpus));
+
+  //the nodes are discovered in order and the memory only node is dropped
+  stringstream root;
+  root << "/tmp/hexgame_numa_test_" << getpid();
+  string nodes[] = { "node0", "node1", "node2" }, cpulists[] = { "0-1", "2-3",
+      "" };
+  ASSERT_EQ(0, mkdir(root.str().c_str(), 0700));
+  for (int i = 2; i >= 0; --i) {
+    string directory = root.str() + "/" + nodes[i];
+    ASSERT_EQ(0, mkdir(directory.c_str(), 0700));
+    ofstream((directory + "/cpulist").c_str()) << cpulists[i] << endl;
+  }
+  NumaTopology topology(root.str());
+  for (int i = 0; i < 3; ++i) {
+    string directory = root.str() + "/" + nodes[i];
+    unlink((directory + "/cpulist").c_str());
+    rmdir(directory.c_str());
+  }
+  rmdir(root.str().c_str());
+  ASSERT_EQ(2u, topology.getNumofNodes());
+  EXPECT_EQ(4u, topology.getNumofCpus());
+  EXPECT_EQ(2, topology.getCpus(1)[0]);
+
+  //the consecutive threads are placed on the same node
+  vector<int> assignednodes;
+  topology.assign(6, assignednodes, cpus);
+  int expectednodes[] = { 0, 0, 0, 1, 1, 1 }, expectedassigned[] = { 0, 1, 0, 2,
+      3, 2 };
+  EXPECT_EQ(vector<int>(expectednodes, expectednodes + 6), assignednodes);
+  EXPECT_EQ(vector<int>(expectedassigned, expectedassigned + 6), cpus);
+  topology.assign(1, assignednodes, cpus);
+  EXPECT_EQ(vector<int>(1, 0), assignednodes);
+  EXPECT_GE(NumaTopology().getNumofNodes(), 1u);
+
+  //every node searches its own game tree, both pinned to the first CPU which is always present
+  numofhexgon = 5;
+  HexBoard board(numofhexgon);
+  Player playera(board, hexgonValKind_RED);  //north to south, 'O'
+  Player playerb(board, hexgonValKind_BLUE);  //west to east, 'X'
+  Game hexboardgame(board);
+  hexboardgame.setMove(playerb, 3, 3);
+  vector<vector<int> > nodecpus(2, vector<int>(1, 0));
+  MultiMonteCarloTreeSearch mcst(&board, &playera, 4, 400);
+  EXPECT_FALSE(mcst.isNumaPlacement());
+  mcst.setNumaPlacement(true);
+  mcst.setNumaTopology(NumaTopology(nodecpus));
+  EXPECT_TRUE(mcst.isNumaPlacement());
+  EXPECT_EQ(2u, mcst.getNumaTopology().getNumofNodes());
+  for (int i = 0; i < 3; ++i) {
+    int move = mcst.genMove();
+    ASSERT_GE(move, 1);
+    ASSERT_LE(move, numofhexgon * numofhexgon);
+    EXPECT_TRUE(board.getEmptyHexIndicators().get()[move - 1]);
+  }
+
+  //the remainder of simulated games is dealt to the threads and every thread runs at least one
+  SearchMonitor monitor;
+  SearchMonitor::Snapshot snapshot;
+  MultiMonteCarloTreeSearch uneven(&board, &playera, 4, 6);
+  uneven.setNumaPlacement(true);
+  uneven.setNumaTopology(NumaTopology(nodecpus));
+  uneven.setSearchMonitor(&monitor);
+  int move = uneven.genMove();
+  ASSERT_GE(move, 1);
+  EXPECT_TRUE(board.getEmptyHexIndicators().get()[move - 1]);
+  monitor.getSnapshot(snapshot);
+  EXPECT_EQ(6u, snapshot.numoftrials);
+  MultiMonteCarloTreeSearch fewer(&board, &playera, 4, 2);
+  fewer.setNumaPlacement(true);
+  fewer.setNumaTopology(NumaTopology(nodecpus));
+  monitor.reset();
+  fewer.setSearchMonitor(&monitor);
+  move = fewer.genMove();
+  ASSERT_GE(move, 1);
+  ASSERT_LE(move, numofhexgon * numofhexgon);
+  EXPECT_TRUE(board.getEmptyHexIndicators().get()[move - 1]);
+  monitor.getSnapshot(snapshot);
+  EXPECT_EQ(4u, snapshot.numoftrials);
+}
+TEST_F(ParallelTest, ThreadWorkStealingScheduler) {
+  //the tasks submitted by other threads are dealt to the workers
+  WorkStealingScheduler scheduler(4);
+  EXPECT_EQ(4u, scheduler.getNumofWorkers());
+  hexgame::atomic<int> count(0);
+  for (int i = 0; i < 1000; ++i)
+    scheduler.submit(boost::bind(&CountTask, boost::ref(count)));
+  scheduler.wait();
+  EXPECT_EQ(1000, count.load());
+  EXPECT_EQ(1000u, scheduler.getNumofExecuted());
+
+  //the subtasks queued behind a busy worker are stolen by the idle ones
+  count.store(0);
+  WorkStealingScheduler::TaskGroup group;
+  for (int i = 0; i < 2; ++i)
+    scheduler.submit(
+        boost::bind(&SpawnSubtasks, boost::ref(scheduler), boost::ref(count),
+                    64),
+        group);
+  scheduler.wait(group);
+  EXPECT_EQ(128, count.load());
+  EXPECT_GT(scheduler.getNumofSteals(), 0u);
+
+  //two searches of different games run on the same workers at the same time
+  numofhexgon = 5;
+  HexBoard board(numofhexgon), otherboard(numofhexgon);
+  Player playera(board, hexgonValKind_RED);  //north to south, 'O'
+  Player playerb(board, hexgonValKind_BLUE);  //west to east, 'X'
+  Player otherplayera(otherboard, hexgonValKind_RED);
+  Player otherplayerb(otherboard, hexgonValKind_BLUE);
+  Game hexboardgame(board), otherhexboardgame(otherboard);
+  hexboardgame.setMove(playerb, 3, 3);
+  otherhexboardgame.setMove(otherplayerb, 1, 1);
+  MultiMonteCarloTreeSearch mcst(&board, &playera, 4, 500);
+  MultiMonteCarloTreeSearch othermcst(&otherboard, &otherplayera, 4, 500);
+  EXPECT_TRUE(mcst.getScheduler() == nullptr);
+  mcst.setScheduler(&scheduler);
+  othermcst.setScheduler(&scheduler);
+  EXPECT_EQ(&scheduler, mcst.getScheduler());
+  size_t numofexecuted = scheduler.getNumofExecuted();
+  int move = -1, othermove = -1;
+  thread_group threads;
+  threads.create_thread(
+      boost::bind(&GenerateMove, boost::ref(mcst), boost::ref(move)));
+  threads.create_thread(
+      boost::bind(&GenerateMove, boost::ref(othermcst), boost::ref(othermove)));
+  threads.join_all();
+  EXPECT_EQ(numofexecuted + 1000, scheduler.getNumofExecuted());
+  ASSERT_GE(move, 1);
+  ASSERT_GE(othermove, 1);
+  EXPECT_TRUE(board.getEmptyHexIndicators().get()[move - 1]);
+  EXPECT_TRUE(otherboard.getEmptyHexIndicators().get()[othermove - 1]);
+}
+TEST_F(ParallelTest, ThreadAsyncSearch) {
+  numofhexgon = 7;
+  HexBoard board(numofhexgon);
+  Player playera(board, hexgonValKind_RED);  //north to south, 'O'
+  Player playerb(board, hexgonValKind_BLUE);  //west to east, 'X'
+  Game hexboardgame(board);
+  hexboardgame.setMove(playerb, 4, 4);
+  const size_t numberoftrials = 1 << 22;
+  MonteCarloTreeSearch mcst(&board, &playera, numberoftrials);
+  MultiMonteCarloTreeSearch multimcst(&board, &playera, 2, numberoftrials);
+  AbstractStrategy* strategies[] = { &mcst, &multimcst };
+  for (int k = 0; k < 2; ++k) {
+    AsyncSearch search(*strategies[k]);
+    search.getMonitor().setInterval(32);
+    EXPECT_FALSE(search.isStarted());
+    ASSERT_TRUE(search.start());
+    EXPECT_FALSE(search.start());
+
+    //the snapshots are published while the search goes on
+    SearchMonitor::Snapshot snapshot;
+    for (int i = 0; i < 10000 && !search.poll(snapshot); ++i)
+      boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+    ASSERT_GT(snapshot.bestmove, 0);
+    EXPECT_FALSE(snapshot.isdone);
+    EXPECT_GT(snapshot.numoftrials, 0u);
+    ASSERT_FALSE(snapshot.statistics.empty());
+    size_t numofvisits = 0;
+    for (size_t i = 0; i < snapshot.statistics.size(); ++i)
+      numofvisits += snapshot.statistics[i].visitcount;
+    EXPECT_LE(numofvisits, snapshot.numoftrials);
+    EXPECT_GE(snapshot.winningrate, 0.0);
+    EXPECT_LE(snapshot.winningrate, 1.0);
+
+    //the stop cuts the search short and the best move so far is returned
+    search.stop();
+    int move = search.wait();
+    EXPECT_TRUE(search.isDone());
+    EXPECT_FALSE(search.isStarted());
+    ASSERT_GE(move, 1);
+    ASSERT_LE(move, numofhexgon * numofhexgon);
+    EXPECT_TRUE(board.getEmptyHexIndicators().get()[move - 1]);
+    search.poll(snapshot);
+    EXPECT_TRUE(snapshot.isdone);
+    EXPECT_EQ(move, snapshot.bestmove);
+    EXPECT_LT(snapshot.numoftrials, numberoftrials);
+  }
+
+  //the search taking a mutex waits for its holder and releases it when it returns
+  boost::mutex mutex;
+  boost::unique_lock<boost::mutex> lock(mutex);
+  AsyncSearch locked(mcst, mutex);
+  ASSERT_TRUE(locked.start());
+  boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+  SearchMonitor::Snapshot snapshot;
+  EXPECT_FALSE(locked.poll(snapshot));
+  EXPECT_FALSE(locked.isDone());
+  lock.unlock();
+  locked.stop();
+  int move = locked.wait();
+  EXPECT_GE(move, 1);
+  EXPECT_TRUE(lock.try_lock());
+}
+TEST_F(ParallelTest, ThreadBatchGameEngine) {
+  WorkStealingScheduler scheduler(4);
+  BatchGameEngine engine(scheduler, 16);
+
+  //the self-play games share the workers and every one of them is played to the end
+  const int numofgames = 64;
+  vector<int> ids;
+  for (int i = 0; i < numofgames; ++i)
+    ids.push_back(engine.createGame(5, 64));
+  EXPECT_EQ(static_cast<size_t>(numofgames), engine.getNumofGames());
+  for (int i = 0; i < numofgames; ++i)
+    ASSERT_TRUE(engine.startSelfPlay(ids[i], 0));
+  engine.waitAll();
+  size_t numofmoves = 0;
+  for (int i = 0; i < numofgames; ++i) {
+    char winner = engine.getWinner(ids[i]);
+    EXPECT_TRUE(winner == 'R' || winner == 'B');
+    EXPECT_GE(engine.getNumofMoves(ids[i]), 9u);
+    EXPECT_LE(engine.getNumofMoves(ids[i]), 25u);
+    //RED moves first, hence RED plays the last move when the number of moves is odd
+    EXPECT_EQ((engine.getNumofMoves(ids[i]) % 2 == 1) ? 'R' : 'B', winner);
+    numofmoves += engine.getNumofMoves(ids[i]);
+    int move;
+    EXPECT_TRUE(engine.pollMove(ids[i], move));
+    EXPECT_GT(move, 0);
+    EXPECT_FALSE(engine.startSelfPlay(ids[i], 0));
+  }
+  //every move runs 64 simulated games in slices of 16 unless decided without simulation
+  EXPECT_GT(engine.getNumofSlices(), numofmoves);
+  EXPECT_EQ(0u, engine.getNumofCutoffs());
+
+  //the time limit cuts a long search short and the best move so far is played
+  int id = engine.createGame(9, 1 << 22);
+  EXPECT_TRUE(engine.play(id, 'B', 41));
+  EXPECT_FALSE(engine.play(id, 'R', 41));
+  EXPECT_FALSE(engine.play(id, 'R', 82));
+  ASSERT_TRUE(engine.requestMove(id, 'R', 50));
+  EXPECT_FALSE(engine.requestMove(id, 'B', 50));
+  EXPECT_FALSE(engine.play(id, 'B', 1));
+  int move = engine.waitMove(id);
+  ASSERT_GE(move, 1);
+  ASSERT_LE(move, 81);
+  EXPECT_NE(41, move);
+  EXPECT_EQ(2u, engine.getNumofMoves(id));
+  EXPECT_EQ(1u, engine.getNumofCutoffs());
+  EXPECT_TRUE(engine.getStrategy(id, 'R')->getLastWinningRate() >= 0.0);
+
+  //the removed game stops searching without playing its move
+  ASSERT_TRUE(engine.requestMove(id, 'B', 0));
+  EXPECT_TRUE(engine.removeGame(id));
+  EXPECT_FALSE(engine.removeGame(id));
+  engine.waitAll();
+  EXPECT_EQ(static_cast<size_t>(numofgames), engine.getNumofGames());
+  EXPECT_EQ(-1, engine.waitMove(id));
+}
+TEST_F(ParallelTest, ThreadGameServer) {
+  //the vertices are named by the letter of column and the number of row
+  EXPECT_EQ(1, GameServer::parseVertex("a1", 5));
+  EXPECT_EQ(13, GameServer::parseVertex("C3", 5));
+  EXPECT_EQ(-1, GameServer::parseVertex("f1", 5));
+  EXPECT_EQ(-1, GameServer::parseVertex("a0", 5));
+  EXPECT_EQ("e4", GameServer::formatVertex(20, 5));
+  EXPECT_EQ('R', GameServer::parseColor("Red"));
+  EXPECT_EQ('B', GameServer::parseColor("b"));
+  EXPECT_EQ(0, GameServer::parseColor("black"));
+
+  WorkStealingScheduler scheduler(2);
+  stringstream endpoint;
+  endpoint << "unix:/tmp/hexserver_" << getpid() << ".sock";
+  GameServer server(scheduler, endpoint.str(), 64, 0);
+  ASSERT_TRUE(server.isListening());
+  size_t numofcommands = 0;
+  boost::thread loop(
+      boost::bind(&ServeGames, boost::ref(server), boost::ref(numofcommands)));
+
+  //every session plays its own game, the commands after genmove wait for its answer
+  const int numofsessions = 4;
+  boost::asio::local::stream_protocol::iostream clients[numofsessions];
+  for (int i = 0; i < numofsessions; ++i) {
+    clients[i].connect(
+        boost::asio::local::stream_protocol::endpoint(
+            endpoint.str().substr(5)));
+    ASSERT_TRUE(clients[i].good());
+    clients[i] << "1 boardsize 5\nplay red c3 # center\n2 genmove blue\n"
+               << "play blue c3\nshowboard\nfoo\n";
+    clients[i].flush();
+  }
+  for (int i = 0; i < numofsessions; ++i) {
+    EXPECT_EQ("=1", ReadResponse(clients[i]));
+    EXPECT_EQ("=", ReadResponse(clients[i]));
+    string genmove = ReadResponse(clients[i]);
+    ASSERT_EQ(0u, genmove.find("=2 "));
+    int move = GameServer::parseVertex(genmove.substr(3), 5);
+    EXPECT_GE(move, 1);
+    EXPECT_NE(13, move);
+    EXPECT_EQ("? illegal move", ReadResponse(clients[i]));
+    string board = ReadResponse(clients[i]);
+    EXPECT_EQ(0u, board.find("="));
+    EXPECT_NE(string::npos, board.find("NORTH"));
+    EXPECT_EQ("? unknown command", ReadResponse(clients[i]));
+  }
+
+  //the session is closed after quit is answered
+  clients[0] << "boardsize 30\nclear_board\ngenmove red\nquit\nname\n";
+  clients[0].flush();
+  EXPECT_EQ("? unacceptable size", ReadResponse(clients[0]));
+  EXPECT_EQ("=", ReadResponse(clients[0]));
+  EXPECT_EQ(0u, ReadResponse(clients[0]).find("= "));
+  EXPECT_EQ("=", ReadResponse(clients[0]));
+  string line;
+  EXPECT_FALSE(getline(clients[0], line));
+
+  //the commands flooded behind genmove are paused rather than queued without a limit, and all of them are answered
+  const int numofboards = 1000, numofnames = 10000;
+  clients[2] << "boardsize 26\ngenmove red\n";
+  for (int i = 0; i < numofboards; ++i)
+    clients[2] << "showboard\n";
+  for (int i = 0; i < numofnames; ++i)
+    clients[2] << "name\n";
+  clients[2].flush();
+  EXPECT_EQ("=", ReadResponse(clients[2]));
+  EXPECT_EQ(0u, ReadResponse(clients[2]).find("= "));
+  int numofanswers = 0;
+  for (int i = 0; i < numofboards + numofnames; ++i)
+    numofanswers += (ReadResponse(clients[2]).find("=") == 0) ? 1 : 0;
+  EXPECT_EQ(numofboards + numofnames, numofanswers);
+
+  //the session closed by its client while searching is dropped
+  clients[1] << "genmove red\n";
+  clients[1].flush();
+  clients[1].close();
+
+  server.stop();
+  loop.join();
+  EXPECT_GE(numofcommands,
+            static_cast<size_t>(numofsessions * 6 + 4 + 2 + numofboards + numofnames));
+  EXPECT_LE(numofcommands,
+            static_cast<size_t>(numofsessions * 6 + 5 + 2 + numofboards + numofnames));
+}
+TEST_F(ParallelTest, ThreadTournamentRunner) {
+  TournamentRunner::Entrant entrant;
+  ASSERT_TRUE(TournamentRunner::parseEntrant("mcts:256", entrant));
+  EXPECT_EQ(AIStrategyKind_MCTS, entrant.strategykind);
+  EXPECT_EQ(256u, entrant.numberoftrials);
+  ASSERT_TRUE(TournamentRunner::parseEntrant("pmcts:512:2", entrant));
+  EXPECT_EQ(AIStrategyKind_PMCTS, entrant.strategykind);
+  EXPECT_EQ(2u, entrant.numofthreads);
+  EXPECT_EQ("pmcts:512:2", TournamentRunner::formatEntrant(entrant));
+  EXPECT_FALSE(TournamentRunner::parseEntrant("naive:16:2", entrant));
+  EXPECT_FALSE(TournamentRunner::parseEntrant("mcts:-1", entrant));
+  EXPECT_FALSE(TournamentRunner::parseEntrant("alphabeta", entrant));
+
+  WorkStealingScheduler scheduler(4);
+  TournamentRunner runner(scheduler,
+                          TournamentRunner::Entrant(AIStrategyKind_MCTS, 128),
+                          TournamentRunner::Entrant(AIStrategyKind_NAIVE, 16), 0);
+  const size_t numofgames = 32;
+  TournamentRunner::Report report = runner.run(4, numofgames);
+  EXPECT_EQ(4, report.numofhexgon);
+  EXPECT_EQ(numofgames, report.numofgames);
+  //the entrants alternate colors
+  EXPECT_EQ(numofgames / 2, report.numofgamesasred);
+  EXPECT_LE(report.numofwinsasred, report.numofwins);
+  EXPECT_EQ(0u, report.numofforfeits);
+  EXPECT_EQ(0u, report.numofcutoffs);
+  EXPECT_GE(report.numofmoves, numofgames * 7);
+  EXPECT_LE(report.numofmoves, numofgames * 16);
+  EXPECT_EQ(report.numofmoves,
+            report.latencies[0].size() + report.latencies[1].size());
+  EXPECT_GT(report.getMovesPerSecond(), 0.0);
+  double lower, upper;
+  report.getConfidenceInterval(lower, upper);
+  EXPECT_LE(lower, report.getWinningRate());
+  EXPECT_GE(upper, report.getWinningRate());
+  EXPECT_GT(upper - lower, 0.0);
+  EXPECT_LE(report.getLatencyPercentile(0, 50), report.getLatencyPercentile(0, 90));
+  EXPECT_LE(report.getLatencyPercentile(0, 99), report.getLatencyPercentile(0, 100));
+  EXPECT_EQ(report.latencies[0].back(), report.getLatencyPercentile(0, 100));
+  EXPECT_NE(string::npos, runner.showReport(report).find("mcts:128 vs naive:16"));
+
+  //the time limit cuts the long searches short and the games are still played to the end
+  TournamentRunner limitedrunner(
+      scheduler, TournamentRunner::Entrant(AIStrategyKind_MCTS, 1 << 22),
+      TournamentRunner::Entrant(AIStrategyKind_MCTS, 1 << 22), 20);
+  TournamentRunner::Report limitedreport = limitedrunner.run(5, 4);
+  EXPECT_EQ(4u, limitedreport.numofgames);
+  EXPECT_EQ(0u, limitedreport.numofforfeits);
+  EXPECT_GT(limitedreport.numofcutoffs, 0u);
+  EXPECT_LT(limitedreport.getLatencyPercentile(0, 50), 1000.0);
+
+  //NAIVE ignores the time limit and runs all its simulated games, hence its moves are never counted as cut-offs
+  TournamentRunner naiverunner(
+      scheduler, TournamentRunner::Entrant(AIStrategyKind_NAIVE, 256),
+      TournamentRunner::Entrant(AIStrategyKind_NAIVE, 256), 1);
+  TournamentRunner::Report naivereport = naiverunner.run(5, 2);
+  EXPECT_EQ(2u, naivereport.numofgames);
+  EXPECT_GT(naivereport.getLatencyPercentile(0, 100), 1.0);
+  EXPECT_EQ(0u, naivereport.numofcutoffs);
+}
 INSTANTIATE_TEST_CASE_P(
     OnTheFlySetThreadNumber, ParallelTestValue,
     ::testing::Combine(Values(4), Range(1, 26, 1), Values(5)));
@@ -12,6 +12,8 @@
 #include "Game.h"
 #include "Player.h"
 #include "Strategy.h"
+#include "OpeningBook.h"
+#include "PositionHash.h"
 #include "PriorityQueue.h"
 
 #include "gtest/gtest.h"
@@ -534,6 +536,85 @@ TEST_F(StrategyTest, DISABLED_CheckSimulationELEVENTest) {
   }
   cout << "winner is " << winner << endl;
 }
+TEST_F(StrategyTest, CheckOpeningBook) {
+  int numofhexgon = 11;
+  HexBoard board(numofhexgon);
+  Player playera(board, hexgonValKind_RED);  //north to south
+  Player playerb(board, hexgonValKind_BLUE);  //west to east
+  Game hexboardgame(board);
+
+  //hash is independent of the order of moves and distinguishes the player to move
+  vector<int> redmoves, bluemoves;
+  redmoves.push_back(61);
+  redmoves.push_back(3);
+  bluemoves.push_back(17);
+  boost::uint64_t key = PositionHash::hashPosition(numofhexgon, redmoves, bluemoves, hexgonValKind_BLUE);
+  reverse(redmoves.begin(), redmoves.end());
+  EXPECT_EQ(key, PositionHash::hashPosition(numofhexgon, redmoves, bluemoves, hexgonValKind_BLUE));
+  EXPECT_NE(key, PositionHash::hashPosition(numofhexgon, redmoves, bluemoves, hexgonValKind_RED));
+  EXPECT_NE(key, PositionHash::hashPosition(numofhexgon + 2, redmoves, bluemoves, hexgonValKind_BLUE));
+  EXPECT_EQ(121, PositionHash::rotateHexgon(numofhexgon, 1));
+  EXPECT_EQ(61, PositionHash::rotateHexgon(numofhexgon, 61));
+
+  //book with empty board and one red stone at the center
+  vector<OpeningBook::BookEntry> entries;
+  OpeningBook::BookEntry entry;
+  entry.key = PositionHash::hashBoard(board, hexgonValKind_RED);
+  entry.visitcount = 1024;
+  entry.move = 61;
+  entry.winrate = 40000;
+  entries.push_back(entry);
+  vector<int> center(1, 61), none;
+  entry.key = PositionHash::hashPosition(numofhexgon, center, none, hexgonValKind_BLUE);
+  entry.move = 62;
+  entries.push_back(entry);
+  entry.key = PositionHash::hashPosition(numofhexgon, none, center, hexgonValKind_RED);
+  entry.move = 61;  //occupied, should be rejected
+  entries.push_back(entry);
+
+  string filename("hexgame_book_test.bin");
+  ASSERT_TRUE(OpeningBook::write(filename, numofhexgon, 1, entries));
+  OpeningBook book;
+  EXPECT_FALSE(book.isOpen());
+  EXPECT_EQ(-1, book.probe(board, hexgonValKind_RED));
+  ASSERT_TRUE(book.open(filename));
+  EXPECT_EQ(numofhexgon, book.getNumofhexgons());
+  EXPECT_EQ(1, book.getMaxstones());
+  EXPECT_EQ(3u, book.getSizeofEntries());
+  EXPECT_TRUE(book.lookup(0x1234ULL) == nullptr);
+
+  EXPECT_EQ(61, book.probe(board, hexgonValKind_RED));
+  EXPECT_EQ(-1, book.probe(board, hexgonValKind_BLUE));
+  const OpeningBook::BookEntry* found = book.lookup(PositionHash::hashBoard(board, hexgonValKind_RED));
+  ASSERT_TRUE(found != nullptr);
+  EXPECT_EQ(1024u, found->visitcount);
+  EXPECT_EQ(40000u, found->winrate);
+
+  //strategy answers from book without simulation
+  Strategy strategyred(&board, &playera);
+  Strategy strategyblue(&board, &playerb);
+  strategyred.setOpeningBook(&book);
+  strategyblue.setOpeningBook(&book);
+  EXPECT_EQ(61, hexboardgame.genMove(strategyred));
+  ASSERT_TRUE(hexboardgame.setMove(playera, 6, 6));
+  EXPECT_EQ(62, hexboardgame.genMove(strategyblue));
+  ASSERT_TRUE(hexboardgame.setMove(playerb, 6, 7));
+  //out of book
+  EXPECT_EQ(-1, book.probe(board, hexgonValKind_RED));
+
+  //occupied book move is rejected
+  HexBoard otherboard(numofhexgon);
+  otherboard.setNodeValue(61, hexgonValKind_BLUE);
+  EXPECT_EQ(-1, book.probe(otherboard, hexgonValKind_RED));
+  //book for other board size is not used
+  HexBoard smallboard(numofhexgon - 2);
+  EXPECT_EQ(-1, book.probe(smallboard, hexgonValKind_RED));
+
+  book.close();
+  EXPECT_FALSE(book.isOpen());
+  EXPECT_FALSE(book.open(filename + ".missing"));
+  std::remove(filename.c_str());
+}
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();;